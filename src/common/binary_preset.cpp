@@ -0,0 +1,417 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "binary_preset.h"
+#include "utils.h"
+
+#include <cmath>
+#include <limits>
+
+namespace {
+  constexpr char kMagic[] = { 'V', 'I', 'T', 'B' };
+  const std::string kDataFields[] = { "wave_data", "audio_file", "samples", "samples_stereo" };
+
+  // Nesting deeper than any preset, so a corrupted container can't run the reader out of stack.
+  constexpr int kMaxDepth = 64;
+
+  enum CborType {
+    kUnsigned,
+    kNegative,
+    kBytes,
+    kText,
+    kArray,
+    kMap,
+    kTag,
+    kSimple
+  };
+
+  constexpr int kFalse = 20;
+  constexpr int kTrue = 21;
+  constexpr int kNull = 22;
+  constexpr int kHalf = 25;
+  constexpr int kSingle = 26;
+  constexpr int kDouble = 27;
+
+  void writeHead(std::vector<uint8_t>& output, int type, uint64_t argument) {
+    uint8_t initial = static_cast<uint8_t>(type << 5);
+    if (argument < 24) {
+      output.push_back(initial | static_cast<uint8_t>(argument));
+      return;
+    }
+
+    int size_bits = argument <= 0xff ? 0 : argument <= 0xffff ? 1 : argument <= 0xffffffff ? 2 : 3;
+    output.push_back(initial | static_cast<uint8_t>(24 + size_bits));
+    for (int shift = (8 << size_bits) - 8; shift >= 0; shift -= 8)
+      output.push_back(static_cast<uint8_t>(argument >> shift));
+  }
+
+  void writeBytes(std::vector<uint8_t>& output, int type, const void* data, size_t size) {
+    writeHead(output, type, size);
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    output.insert(output.end(), bytes, bytes + size);
+  }
+
+  void writeDouble(std::vector<uint8_t>& output, double number) {
+    uint64_t bits = 0;
+    memcpy(&bits, &number, sizeof(bits));
+    output.push_back(static_cast<uint8_t>((kSimple << 5) | kDouble));
+    for (int shift = 56; shift >= 0; shift -= 8)
+      output.push_back(static_cast<uint8_t>(bits >> shift));
+  }
+
+  // Payloads become byte strings if they're raw already or if packing and their Base64 encodes back
+  // to exactly the same text. Anything else stays text so it converts back unchanged.
+  void writePayload(std::vector<uint8_t>& output, const std::string& text, bool pack) {
+    MemoryOutputStream scratch;
+    const void* bytes = nullptr;
+    if (vital::utils::isRawDataString(text)) {
+      size_t size = vital::utils::readDataString(text, scratch, &bytes);
+      writeBytes(output, kBytes, bytes, size);
+    }
+    else if (pack && !text.empty() && Base64::convertFromBase64(scratch, text) &&
+             Base64::toBase64(scratch.getData(), scratch.getDataSize()) == String(text)) {
+      writeBytes(output, kBytes, scratch.getData(), scratch.getDataSize());
+    }
+    else
+      writeBytes(output, kText, text.data(), text.size());
+  }
+
+  void writeCbor(std::vector<uint8_t>& output, const json& value, bool pack, bool data_field) {
+    switch (value.type()) {
+      case json::value_t::object:
+        writeHead(output, kMap, value.size());
+        for (auto iter = value.begin(); iter != value.end(); ++iter) {
+          const std::string& key = iter.key();
+          writeBytes(output, kText, key.data(), key.size());
+          writeCbor(output, iter.value(), pack, BinaryPreset::isPayloadField(key));
+        }
+        break;
+      case json::value_t::array:
+        writeHead(output, kArray, value.size());
+        for (const json& element : value)
+          writeCbor(output, element, pack, false);
+        break;
+      case json::value_t::string: {
+        const std::string& text = value.get_ref<const std::string&>();
+        if (data_field)
+          writePayload(output, text, pack);
+        else
+          writeBytes(output, kText, text.data(), text.size());
+        break;
+      }
+      case json::value_t::boolean:
+        writeHead(output, kSimple, value.get<bool>() ? kTrue : kFalse);
+        break;
+      case json::value_t::number_unsigned:
+        writeHead(output, kUnsigned, value.get<uint64_t>());
+        break;
+      case json::value_t::number_integer: {
+        int64_t number = value.get<int64_t>();
+        if (number >= 0)
+          writeHead(output, kUnsigned, static_cast<uint64_t>(number));
+        else
+          writeHead(output, kNegative, static_cast<uint64_t>(-(number + 1)));
+        break;
+      }
+      case json::value_t::number_float:
+        writeDouble(output, value.get<double>());
+        break;
+      default:
+        writeHead(output, kSimple, kNull);
+        break;
+    }
+  }
+
+  bool readHead(const uint8_t*& data, const uint8_t* end, int& type, int& info, uint64_t& argument) {
+    if (data >= end)
+      return false;
+
+    type = *data >> 5;
+    info = *data & 0x1f;
+    data++;
+    if (info < 24) {
+      argument = info;
+      return true;
+    }
+    if (info > kDouble)
+      return false;
+
+    int num_bytes = 1 << (info - 24);
+    if (end - data < num_bytes)
+      return false;
+
+    argument = 0;
+    for (int i = 0; i < num_bytes; ++i)
+      argument = (argument << 8) | *data++;
+    return true;
+  }
+
+  double halfToDouble(uint64_t bits) {
+    int exponent = (bits >> 10) & 0x1f;
+    double mantissa = bits & 0x3ff;
+    double magnitude = 0.0;
+    if (exponent == 0)
+      magnitude = std::ldexp(mantissa, -24);
+    else if (exponent == 0x1f)
+      magnitude = mantissa ? std::numeric_limits<double>::quiet_NaN() : std::numeric_limits<double>::infinity();
+    else
+      magnitude = std::ldexp(mantissa + 1024.0, exponent - 25);
+    return (bits & 0x8000) ? -magnitude : magnitude;
+  }
+
+  // Byte strings come back as raw data strings. Version 1 raw payloads were text strings that
+  // already held the raw prefix, so they read back the same way.
+  bool readCbor(const uint8_t*& data, const uint8_t* end, json& value, int depth) {
+    int type = 0, info = 0;
+    uint64_t argument = 0;
+    if (depth > kMaxDepth || !readHead(data, end, type, info, argument))
+      return false;
+
+    switch (type) {
+      case kUnsigned:
+        value = argument;
+        return true;
+      case kNegative:
+        if (argument > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+          return false;
+        value = -1 - static_cast<int64_t>(argument);
+        return true;
+      case kBytes:
+      case kText: {
+        if (argument > static_cast<uint64_t>(end - data))
+          return false;
+        const char* text = reinterpret_cast<const char*>(data);
+        data += argument;
+        if (type == kBytes)
+          value = vital::utils::encodeRawDataString(text, argument);
+        else
+          value = std::string(text, argument);
+        return true;
+      }
+      case kArray: {
+        // Every element takes at least a byte, which bounds the reserve on corrupted lengths.
+        if (argument > static_cast<uint64_t>(end - data))
+          return false;
+        value = json::array();
+        json::array_t& array = value.get_ref<json::array_t&>();
+        array.reserve(argument);
+        for (uint64_t i = 0; i < argument; ++i) {
+          array.emplace_back();
+          if (!readCbor(data, end, array.back(), depth + 1))
+            return false;
+        }
+        return true;
+      }
+      case kMap: {
+        value = json::object();
+        json::object_t& object = value.get_ref<json::object_t&>();
+        for (uint64_t i = 0; i < argument; ++i) {
+          json key;
+          if (!readCbor(data, end, key, depth + 1) || !key.is_string())
+            return false;
+          json& element = object[key.get_ref<const std::string&>()];
+          if (!readCbor(data, end, element, depth + 1))
+            return false;
+        }
+        return true;
+      }
+      case kTag:
+        return readCbor(data, end, value, depth + 1);
+      default:
+        break;
+    }
+
+    if (info == kFalse || info == kTrue)
+      value = info == kTrue;
+    else if (info == kNull)
+      value = nullptr;
+    else if (info == kHalf)
+      value = halfToDouble(argument);
+    else if (info == kSingle) {
+      uint32_t bits = static_cast<uint32_t>(argument);
+      float number = 0.0f;
+      memcpy(&number, &bits, sizeof(number));
+      value = number;
+    }
+    else if (info == kDouble) {
+      double number = 0.0;
+      memcpy(&number, &argument, sizeof(number));
+      value = number;
+    }
+    else
+      return false;
+    return true;
+  }
+
+  void encodePayload(json& value) {
+    const std::string& text = value.get_ref<const std::string&>();
+    if (!vital::utils::isRawDataString(text))
+      return;
+
+    MemoryOutputStream scratch;
+    const void* bytes = nullptr;
+    size_t size = vital::utils::readDataString(text, scratch, &bytes);
+    value = Base64::toBase64(bytes, size).toStdString();
+  }
+
+  void encodeDataFields(json& data) {
+    if (data.is_object()) {
+      for (auto iter = data.begin(); iter != data.end(); ++iter) {
+        if (iter.value().is_string() && BinaryPreset::isPayloadField(iter.key()))
+          encodePayload(iter.value());
+        else
+          encodeDataFields(iter.value());
+      }
+    }
+    else if (data.is_array()) {
+      for (json& element : data)
+        encodeDataFields(element);
+    }
+  }
+} // namespace
+
+bool BinaryPreset::isPayloadField(const std::string& key) {
+  for (const std::string& field : kDataFields) {
+    if (key == field)
+      return true;
+  }
+  return false;
+}
+
+bool BinaryPreset::isBinaryPreset(const File& file) {
+  FileInputStream stream(file);
+  char magic[sizeof(kMagic)];
+  return stream.openedOk() && stream.read(magic, sizeof(kMagic)) == sizeof(kMagic) &&
+         isBinaryPreset(magic, sizeof(kMagic));
+}
+
+bool BinaryPreset::isBinaryPreset(const void* data, size_t size) {
+  return data && size >= sizeof(kMagic) && memcmp(data, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool BinaryPreset::writeToStream(const json& state, OutputStream& stream) {
+  std::vector<uint8_t> payload;
+  writeCbor(payload, state, true, false);
+
+  return stream.write(kMagic, sizeof(kMagic)) &&
+         stream.writeInt(kFormatVersion) &&
+         stream.writeInt64(static_cast<int64>(payload.size())) &&
+         stream.write(payload.data(), payload.size());
+}
+
+BinaryPreset::StateWriter::StateWriter(std::vector<uint8_t>& buffer) : buffer_(buffer) {
+  buffer_.resize(kHeaderSize);
+}
+
+void BinaryPreset::StateWriter::startMap(size_t size) {
+  writeHead(buffer_, kMap, size);
+}
+
+void BinaryPreset::StateWriter::startArray(size_t size) {
+  writeHead(buffer_, kArray, size);
+}
+
+void BinaryPreset::StateWriter::writeText(const std::string& text) {
+  writeBytes(buffer_, kText, text.data(), text.size());
+}
+
+void BinaryPreset::StateWriter::writeNumber(double number) {
+  writeDouble(buffer_, number);
+}
+
+void BinaryPreset::StateWriter::writeJson(const json& value) {
+  writeCbor(buffer_, value, false, false);
+}
+
+void BinaryPreset::StateWriter::writeEncoded(const std::vector<uint8_t>& encoded) {
+  buffer_.insert(buffer_.end(), encoded.begin(), encoded.end());
+}
+
+void BinaryPreset::StateWriter::finish() {
+  uint8_t* header = buffer_.data();
+  memcpy(header, kMagic, sizeof(kMagic));
+  int32 version = ByteOrder::swapIfBigEndian(static_cast<int32>(kFormatVersion));
+  int64 payload_size = ByteOrder::swapIfBigEndian(static_cast<int64>(buffer_.size() - kHeaderSize));
+  memcpy(header + sizeof(kMagic), &version, sizeof(version));
+  memcpy(header + sizeof(kMagic) + sizeof(version), &payload_size, sizeof(payload_size));
+}
+
+void BinaryPreset::encodeValue(const json& value, std::vector<uint8_t>& encoded) {
+  encoded.clear();
+  writeCbor(encoded, value, true, false);
+}
+
+bool BinaryPreset::writeToFile(const json& state, const File& file) {
+  MemoryOutputStream stream;
+  if (!writeToStream(state, stream))
+    return false;
+
+  return file.replaceWithData(stream.getData(), stream.getDataSize());
+}
+
+bool BinaryPreset::readFromMemory(const void* data, size_t size, json& state) {
+  if (size < kHeaderSize || !isBinaryPreset(data, size))
+    return false;
+
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  int version = static_cast<int>(ByteOrder::littleEndianInt(bytes + sizeof(kMagic)));
+  uint64 payload_size = ByteOrder::littleEndianInt64(bytes + sizeof(kMagic) + sizeof(int));
+  if (version < 1 || version > kFormatVersion || payload_size > size - kHeaderSize)
+    return false;
+
+  const uint8_t* position = bytes + kHeaderSize;
+  const uint8_t* end = position + payload_size;
+  json loaded;
+  if (!readCbor(position, end, loaded, 0) || position != end || !loaded.is_object())
+    return false;
+
+  state = std::move(loaded);
+  return true;
+}
+
+bool BinaryPreset::readFromFile(const File& file, json& state) {
+  MemoryMappedFile mapped_file(file, MemoryMappedFile::readOnly);
+  if (mapped_file.getData())
+    return readFromMemory(mapped_file.getData(), mapped_file.getSize(), state);
+
+  MemoryBlock data;
+  if (!file.loadFileAsData(data))
+    return false;
+  return readFromMemory(data.getData(), data.getSize(), state);
+}
+
+void BinaryPreset::encodePayloads(json& state) {
+  encodeDataFields(state);
+}
+
+bool BinaryPreset::convertToBinary(const File& source, const File& destination) {
+  try {
+    json state = json::parse(source.loadFileAsString().toStdString(), nullptr);
+    return writeToFile(state, destination);
+  }
+  catch (const json::exception& e) {
+    return false;
+  }
+}
+
+bool BinaryPreset::convertToJson(const File& source, const File& destination) {
+  json state;
+  if (!readFromFile(source, state))
+    return false;
+
+  encodePayloads(state);
+  return destination.replaceWithText(state.dump());
+}
@@ -0,0 +1,79 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "json/json.h"
+
+using json = nlohmann::json;
+
+// Versioned binary container for presets. The state json is stored as CBOR and the sample and
+// wavetable payloads that .vital files keep as Base64 are stored as CBOR byte strings, so loading is
+// a memory map and a single pass over the data. Converts losslessly to and from .vital json.
+// Loaded payloads stay raw bytes that the sample and wavetable loaders read in place, see
+// vital::utils::readDataString. Call encodePayloads before dumping a loaded state as text.
+class BinaryPreset {
+  public:
+    // Version 1 stored raw payloads as prefixed text strings, version 2 as byte strings.
+    static constexpr int kFormatVersion = 2;
+    static constexpr int kHeaderSize = 16;
+
+    // Sample and wavetable payload fields, Base64 in .vital json and raw bytes once loaded from here.
+    static bool isPayloadField(const std::string& key);
+
+    static bool isBinaryPreset(const File& file);
+    static bool isBinaryPreset(const void* data, size_t size);
+
+    // Streams a container straight into a reusable buffer without building the whole state as json
+    // first, for plugin state the host asks for over and over. Maps and arrays are sized up front and
+    // finish fills in the header once the last value is written.
+    class StateWriter {
+      public:
+        StateWriter(std::vector<uint8_t>& buffer);
+
+        void startMap(size_t size);
+        void startArray(size_t size);
+        void writeText(const std::string& text);
+        void writeNumber(double number);
+        // Raw payloads are written as byte strings, anything else as it is.
+        void writeJson(const json& value);
+        // Writes a value encoded earlier by encodeValue.
+        void writeEncoded(const std::vector<uint8_t>& encoded);
+        void finish();
+
+      private:
+        std::vector<uint8_t>& buffer_;
+    };
+
+    // Encodes a single value with packed payloads so it can be kept and written again unchanged.
+    static void encodeValue(const json& value, std::vector<uint8_t>& encoded);
+
+    static bool writeToStream(const json& state, OutputStream& stream);
+    static bool writeToFile(const json& state, const File& file);
+
+    static bool readFromMemory(const void* data, size_t size, json& state);
+    static bool readFromFile(const File& file, json& state);
+
+    // Turns raw payloads back into Base64 so the state dumps to the same text as .vital json.
+    static void encodePayloads(json& state);
+
+    static bool convertToBinary(const File& source, const File& destination);
+    static bool convertToJson(const File& source, const File& destination);
+
+  private:
+    BinaryPreset() { }
+};
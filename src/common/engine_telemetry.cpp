@@ -0,0 +1,152 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "engine_telemetry.h"
+
+#include "memory.h"
+#include "sound_engine.h"
+#include "synth_module.h"
+
+void MemoryReadout::readSamples(vital::mono_float* output, int num_samples, int offset, int channel) const {
+  VITAL_ASSERT(memory_);
+  memory_->readSamples(output, num_samples, offset, channel, head_);
+}
+
+EngineTelemetry::EngineTelemetry() : engine_(nullptr), live_audio_memory_(nullptr), live_equalizer_memory_(nullptr),
+                                     samples_since_publish_(0), published_version_(0),
+                                     version_(0), oscilloscope_version_(0) {
+  vital::utils::zeroBuffer(oscilloscope_memory_, 2 * vital::kOscilloscopeMemoryResolution);
+}
+
+EngineTelemetry::~EngineTelemetry() { }
+
+void EngineTelemetry::init(vital::SoundEngine* engine, const vital::StereoMemory* audio_memory) {
+  engine_ = engine;
+  live_audio_memory_ = audio_memory;
+  live_equalizer_memory_ = engine->getEqualizerMemory();
+  audio_memory_.setMemory(live_audio_memory_);
+  equalizer_memory_.setMemory(live_equalizer_memory_);
+
+  std::map<std::string, const vital::StatusOutput*> status_outputs;
+  engine->getStatusOutputs(status_outputs);
+  for (auto& status_output : status_outputs) {
+    status_sources_.push_back(status_output.second);
+    status_readouts_.push_back(std::make_unique<vital::StatusOutput>(nullptr));
+    status_readouts_.back()->set(status_output.second->value());
+    status_lookup_[status_output.first] = status_readouts_.back().get();
+  }
+
+  addModulationReadouts(engine->getMonoModulations(), mono_modulations_);
+  addModulationReadouts(engine->getPolyModulations(), poly_modulations_);
+
+  for (int i = 0; i < 3; ++i) {
+    Snapshot& snapshot = snapshots_.getBuffer(i);
+    snapshot.status_values.resize(status_sources_.size());
+    snapshot.modulation_values.resize(modulation_sources_.size());
+    snapshot.modulation_enabled.resize(modulation_sources_.size());
+    vital::utils::zeroBuffer(snapshot.oscilloscope_memory, 2 * vital::kOscilloscopeMemoryResolution);
+    writeSnapshot(snapshot);
+  }
+}
+
+void EngineTelemetry::addModulationReadouts(const vital::output_map& sources, vital::output_map& readouts) {
+  for (auto& source : sources) {
+    modulation_sources_.push_back(source.second);
+    modulation_readouts_.push_back(std::make_unique<vital::cr::Value>());
+    vital::Value* readout = modulation_readouts_.back().get();
+    readout->output()->trigger_value = source.second->trigger_value;
+    readouts[source.first] = readout->output();
+  }
+}
+
+void EngineTelemetry::writeSnapshot(Snapshot& snapshot) {
+  int num_status = static_cast<int>(status_sources_.size());
+  for (int i = 0; i < num_status; ++i)
+    snapshot.status_values[i] = status_sources_[i]->value();
+
+  int num_modulations = static_cast<int>(modulation_sources_.size());
+  for (int i = 0; i < num_modulations; ++i) {
+    const vital::Output* source = modulation_sources_[i];
+    snapshot.modulation_values[i] = source->trigger_value;
+    snapshot.modulation_enabled[i] = source->owner == nullptr || source->owner->enabled();
+  }
+
+  if (live_audio_memory_)
+    snapshot.audio_memory_head = live_audio_memory_->getOffset();
+  if (live_equalizer_memory_)
+    snapshot.equalizer_memory_head = live_equalizer_memory_->getOffset();
+}
+
+void EngineTelemetry::publish(int num_samples, const vital::poly_float* oscilloscope_memory,
+                              int oscilloscope_version) {
+  VITAL_ASSERT(engine_);
+
+  samples_since_publish_ += num_samples;
+  if (samples_since_publish_ < engine_->getSampleRate() / kMaxPublishRate)
+    return;
+
+  samples_since_publish_ = 0;
+  Snapshot& snapshot = snapshots_.getWriteBuffer();
+  writeSnapshot(snapshot);
+  snapshot.version = ++published_version_;
+
+  // The scope only changes once per window so each buffer copies it at most once per window.
+  if (snapshot.oscilloscope_version != oscilloscope_version) {
+    vital::utils::copyBuffer(snapshot.oscilloscope_memory, oscilloscope_memory,
+                             2 * vital::kOscilloscopeMemoryResolution);
+    snapshot.oscilloscope_version = oscilloscope_version;
+  }
+
+  snapshots_.publish();
+}
+
+bool EngineTelemetry::consume() {
+  if (!snapshots_.consume())
+    return false;
+
+  const Snapshot& snapshot = snapshots_.getReadBuffer();
+  version_ = snapshot.version;
+
+  int num_status = static_cast<int>(status_readouts_.size());
+  for (int i = 0; i < num_status; ++i)
+    status_readouts_[i]->set(snapshot.status_values[i]);
+
+  int num_modulations = static_cast<int>(modulation_readouts_.size());
+  for (int i = 0; i < num_modulations; ++i) {
+    vital::Value* readout = modulation_readouts_[i].get();
+    readout->output()->trigger_value = snapshot.modulation_values[i];
+    bool enabled = snapshot.modulation_enabled[i];
+    if (readout->enabled() != enabled)
+      readout->enable(enabled);
+  }
+
+  if (oscilloscope_version_ != snapshot.oscilloscope_version) {
+    vital::utils::copyBuffer(oscilloscope_memory_, snapshot.oscilloscope_memory,
+                             2 * vital::kOscilloscopeMemoryResolution);
+    oscilloscope_version_ = snapshot.oscilloscope_version;
+  }
+
+  audio_memory_.setHead(snapshot.audio_memory_head);
+  equalizer_memory_.setHead(snapshot.equalizer_memory_head);
+  return true;
+}
+
+const vital::StatusOutput* EngineTelemetry::getStatusOutput(const std::string& name) const {
+  auto status_output = status_lookup_.find(name);
+  if (status_output == status_lookup_.end())
+    return nullptr;
+  return status_output->second;
+}
@@ -0,0 +1,117 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "synth_constants.h"
+#include "synth_types.h"
+#include "triple_buffer.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vital {
+  class SoundEngine;
+  class StatusOutput;
+  class StereoMemory;
+  class Value;
+}
+
+// An audio ring as the interface sees it: reads end at the write position of the last consumed snapshot.
+class MemoryReadout {
+  public:
+    MemoryReadout() : memory_(nullptr), head_(0) { }
+
+    void setMemory(const vital::StereoMemory* memory) { memory_ = memory; }
+    void setHead(unsigned int head) { head_ = head; }
+    const vital::StereoMemory* getMemory() const { return memory_; }
+    void readSamples(vital::mono_float* output, int num_samples, int offset, int channel) const;
+
+  private:
+    const vital::StereoMemory* memory_;
+    unsigned int head_;
+};
+
+// Engine state the interface displays. The audio thread publishes a snapshot at most kMaxPublishRate times a
+// second and the interface consumes the newest one once per frame into readouts it owns, so drawing never touches
+// objects the audio thread is writing.
+class EngineTelemetry {
+  public:
+    static constexpr int kMaxPublishRate = 240;
+
+    struct Snapshot {
+      Snapshot() : version(0), oscilloscope_version(0), audio_memory_head(0), equalizer_memory_head(0) { }
+
+      int version;
+      int oscilloscope_version;
+      unsigned int audio_memory_head;
+      unsigned int equalizer_memory_head;
+      std::vector<vital::poly_float> status_values;
+      std::vector<vital::poly_float> modulation_values;
+      std::vector<char> modulation_enabled;
+      vital::poly_float oscilloscope_memory[2 * vital::kOscilloscopeMemoryResolution];
+    };
+
+    EngineTelemetry();
+    ~EngineTelemetry();
+
+    // Must run before audio processing starts.
+    void init(vital::SoundEngine* engine, const vital::StereoMemory* audio_memory);
+
+    // Audio thread.
+    void publish(int num_samples, const vital::poly_float* oscilloscope_memory, int oscilloscope_version);
+
+    // Interface thread. Returns false when nothing new was published since the last call.
+    bool consume();
+
+    int getVersion() const { return version_; }
+    const vital::StatusOutput* getStatusOutput(const std::string& name) const;
+    const vital::output_map& getMonoModulations() const { return mono_modulations_; }
+    const vital::output_map& getPolyModulations() const { return poly_modulations_; }
+    const vital::poly_float* getOscilloscopeMemory() const { return oscilloscope_memory_; }
+    const MemoryReadout* getAudioMemory() const { return &audio_memory_; }
+    const MemoryReadout* getEqualizerMemory() const { return &equalizer_memory_; }
+
+  private:
+    void addModulationReadouts(const vital::output_map& sources, vital::output_map& readouts);
+    void writeSnapshot(Snapshot& snapshot);
+
+    vital::SoundEngine* engine_;
+    const vital::StereoMemory* live_audio_memory_;
+    const vital::StereoMemory* live_equalizer_memory_;
+    std::vector<const vital::StatusOutput*> status_sources_;
+    std::vector<const vital::Output*> modulation_sources_;
+    int samples_since_publish_;
+    int published_version_;
+
+    vital::TripleBuffer<Snapshot> snapshots_;
+
+    std::vector<std::unique_ptr<vital::StatusOutput>> status_readouts_;
+    std::map<std::string, const vital::StatusOutput*> status_lookup_;
+    std::vector<std::unique_ptr<vital::Value>> modulation_readouts_;
+    vital::output_map mono_modulations_;
+    vital::output_map poly_modulations_;
+    vital::poly_float oscilloscope_memory_[2 * vital::kOscilloscopeMemoryResolution];
+    MemoryReadout audio_memory_;
+    MemoryReadout equalizer_memory_;
+    int version_;
+    int oscilloscope_version_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EngineTelemetry)
+};
@@ -0,0 +1,313 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fourier_transform.h"
+
+#if JUCE_LINUX && !INTEL_IPP
+
+namespace vital {
+
+  namespace {
+    constexpr int kTwiddlesPerStage = 6;
+    constexpr double kTwoPi = 2.0 * MathConstants<double>::pi;
+
+    force_inline void complexMultiply(poly_float& real, poly_float& imaginary,
+                                      poly_float twiddle_real, poly_float twiddle_imaginary) {
+      poly_float result_real = real * twiddle_real - imaginary * twiddle_imaginary;
+      imaginary = real * twiddle_imaginary + imaginary * twiddle_real;
+      real = result_real;
+    }
+
+    // Writes the four outputs of a butterfly when the stride is narrower than a poly_float.
+    // The only narrow strides are 1 and, for AVX2, 4 and either way the outputs land in four
+    // consecutive vectors.
+    force_inline void storeNarrow(poly_float* dest, poly_float* out, int stride) {
+    #if VITAL_AVX2
+      if (stride == 1)
+        poly_float::transpose(out[0].value, out[1].value, out[2].value, out[3].value);
+      dest[0] = _mm256_permute2f128_ps(out[0].value, out[1].value, 0x20);
+      dest[1] = _mm256_permute2f128_ps(out[2].value, out[3].value, 0x20);
+      dest[2] = _mm256_permute2f128_ps(out[0].value, out[1].value, 0x31);
+      dest[3] = _mm256_permute2f128_ps(out[2].value, out[3].value, 0x31);
+    #else
+      VITAL_ASSERT(stride == 1);
+      poly_float::transpose(out[0].value, out[1].value, out[2].value, out[3].value);
+      for (int j = 0; j < 4; ++j)
+        dest[j] = out[j];
+    #endif
+    }
+
+    // Buffers hold all real parts followed by all imaginary parts.
+    // Element e = stride * p + q of the input reads a quarter of the buffer apart, output goes to
+    // 4 * stride * p + stride * j + q, so reads are always contiguous and writes are too once the
+    // stride covers a whole poly_float.
+    template<bool inverse>
+    void radix4Stage(const poly_float* source, poly_float* dest, const poly_float* twiddles,
+                     int complex_size, int stride) {
+      static constexpr int kSize = poly_float::kSize;
+      int quarter = complex_size / 4 / kSize;
+      int half = 2 * quarter;
+      int three_quarter = 3 * quarter;
+      int imaginary = complex_size / kSize;
+      const poly_float* w1_real = twiddles;
+      const poly_float* w1_imaginary = twiddles + quarter;
+      const poly_float* w2_real = twiddles + 2 * quarter;
+      const poly_float* w2_imaginary = twiddles + 3 * quarter;
+      const poly_float* w3_real = twiddles + 4 * quarter;
+      const poly_float* w3_imaginary = twiddles + 5 * quarter;
+
+      for (int v = 0; v < quarter; ++v) {
+        const poly_float* real_in = source + v;
+        const poly_float* imaginary_in = source + imaginary + v;
+        poly_float a_real = real_in[0];
+        poly_float b_real = real_in[quarter];
+        poly_float c_real = real_in[half];
+        poly_float d_real = real_in[three_quarter];
+        poly_float a_imaginary = imaginary_in[0];
+        poly_float b_imaginary = imaginary_in[quarter];
+        poly_float c_imaginary = imaginary_in[half];
+        poly_float d_imaginary = imaginary_in[three_quarter];
+
+        poly_float apc_real = a_real + c_real;
+        poly_float apc_imaginary = a_imaginary + c_imaginary;
+        poly_float amc_real = a_real - c_real;
+        poly_float amc_imaginary = a_imaginary - c_imaginary;
+        poly_float bpd_real = b_real + d_real;
+        poly_float bpd_imaginary = b_imaginary + d_imaginary;
+        poly_float jbmd_real = d_imaginary - b_imaginary;
+        poly_float jbmd_imaginary = b_real - d_real;
+        if (inverse) {
+          jbmd_real = -jbmd_real;
+          jbmd_imaginary = -jbmd_imaginary;
+        }
+
+        poly_float out_real[4];
+        poly_float out_imaginary[4];
+        out_real[0] = apc_real + bpd_real;
+        out_imaginary[0] = apc_imaginary + bpd_imaginary;
+        out_real[1] = amc_real - jbmd_real;
+        out_imaginary[1] = amc_imaginary - jbmd_imaginary;
+        out_real[2] = apc_real - bpd_real;
+        out_imaginary[2] = apc_imaginary - bpd_imaginary;
+        out_real[3] = amc_real + jbmd_real;
+        out_imaginary[3] = amc_imaginary + jbmd_imaginary;
+
+        poly_float sign = inverse ? -1.0f : 1.0f;
+        complexMultiply(out_real[1], out_imaginary[1], w1_real[v], sign * w1_imaginary[v]);
+        complexMultiply(out_real[2], out_imaginary[2], w2_real[v], sign * w2_imaginary[v]);
+        complexMultiply(out_real[3], out_imaginary[3], w3_real[v], sign * w3_imaginary[v]);
+
+        int element = v * kSize;
+        if (stride >= kSize) {
+          int q = element % stride;
+          int base = 4 * (element - q) + q;
+          for (int j = 0; j < 4; ++j) {
+            int index = (base + stride * j) / kSize;
+            dest[index] = out_real[j];
+            dest[index + imaginary] = out_imaginary[j];
+          }
+        }
+        else {
+          storeNarrow(dest + 4 * v, out_real, stride);
+          storeNarrow(dest + 4 * v + imaginary, out_imaginary, stride);
+        }
+      }
+    }
+
+    void radix2Stage(const poly_float* source, poly_float* dest, int complex_size) {
+      int half = complex_size / 2 / poly_float::kSize;
+      int imaginary = complex_size / poly_float::kSize;
+
+      for (int v = 0; v < half; ++v) {
+        poly_float a_real = source[v];
+        poly_float b_real = source[v + half];
+        poly_float a_imaginary = source[v + imaginary];
+        poly_float b_imaginary = source[v + half + imaginary];
+        dest[v] = a_real + b_real;
+        dest[v + half] = a_real - b_real;
+        dest[v + imaginary] = a_imaginary + b_imaginary;
+        dest[v + half + imaginary] = a_imaginary - b_imaginary;
+      }
+    }
+  } // namespace
+
+  FourierTransform::FourierTransform(int bits) : bits_(bits), size_(1 << bits), complex_size_(size_ / 2) {
+    VITAL_ASSERT(bits >= kMinBits);
+
+    int complex_bits = bits - 1;
+    num_radix4_stages_ = complex_bits / 2;
+
+    int quarter = complex_size_ / 4;
+    int stage_floats = kTwiddlesPerStage * quarter;
+    stage_twiddles_ = std::make_unique<poly_float[]>(num_radix4_stages_ * stage_floats / poly_float::kSize);
+    float* stage_twiddles = reinterpret_cast<float*>(stage_twiddles_.get());
+
+    int stride = 1;
+    for (int stage = 0; stage < num_radix4_stages_; ++stage) {
+      float* twiddles = stage_twiddles + stage * stage_floats;
+      int length = complex_size_ / stride;
+      for (int e = 0; e < quarter; ++e) {
+        int p = e / stride;
+        for (int j = 1; j < 4; ++j) {
+          double phase = -kTwoPi * j * p / length;
+          twiddles[(2 * j - 2) * quarter + e] = std::cos(phase);
+          twiddles[(2 * j - 1) * quarter + e] = std::sin(phase);
+        }
+      }
+      stride *= 4;
+    }
+
+    real_twiddles_ = std::make_unique<poly_float[]>(2 * complex_size_ / poly_float::kSize);
+    float* real_twiddles = reinterpret_cast<float*>(real_twiddles_.get());
+    for (int k = 0; k < complex_size_; ++k) {
+      double phase = kTwoPi * k / size_;
+      real_twiddles[k] = std::cos(phase);
+      real_twiddles[k + complex_size_] = std::sin(phase);
+    }
+
+    if (bits > kMaxStackBits)
+      scratch_ = std::make_unique<poly_float[]>(4 * complex_size_ / poly_float::kSize);
+  }
+
+  // Transforms up to kMaxStackBits work out of the caller's stack so shared instances stay
+  // reentrant. Larger ones are only used for analysis in the interface and use a member buffer.
+  poly_float* FourierTransform::getScratch(poly_float* stack_scratch) {
+    if (scratch_)
+      return scratch_.get();
+    return stack_scratch;
+  }
+
+  template<bool inverse>
+  poly_float* FourierTransform::transformComplex(poly_float* buffer, poly_float* scratch) {
+    int stage_vectors = kTwiddlesPerStage * complex_size_ / 4 / poly_float::kSize;
+    int stride = 1;
+    for (int stage = 0; stage < num_radix4_stages_; ++stage) {
+      radix4Stage<inverse>(buffer, scratch, stage_twiddles_.get() + stage * stage_vectors, complex_size_, stride);
+      std::swap(buffer, scratch);
+      stride *= 4;
+    }
+
+    if (stride < complex_size_) {
+      radix2Stage(buffer, scratch, complex_size_);
+      std::swap(buffer, scratch);
+    }
+
+    return buffer;
+  }
+
+  void FourierTransform::transformRealForward(float* data) {
+    static constexpr int kSize = poly_float::kSize;
+    poly_float stack_scratch[(4 << (kMaxStackBits - 1)) / kSize];
+    poly_float* scratch = getScratch(stack_scratch);
+    int vectors = complex_size_ / kSize;
+
+    float* input = reinterpret_cast<float*>(scratch);
+    for (int i = 0; i < complex_size_; ++i) {
+      input[i] = data[2 * i];
+      input[i + complex_size_] = data[2 * i + 1];
+    }
+
+    poly_float* result = transformComplex<false>(scratch, scratch + 2 * vectors);
+    poly_float* mirror = result == scratch ? scratch + 2 * vectors : scratch;
+    float* result_data = reinterpret_cast<float*>(result);
+    float* mirror_data = reinterpret_cast<float*>(mirror);
+
+    mirror_data[0] = result_data[0];
+    mirror_data[complex_size_] = result_data[complex_size_];
+    for (int k = 1; k < complex_size_; ++k) {
+      mirror_data[k] = result_data[complex_size_ - k];
+      mirror_data[k + complex_size_] = result_data[2 * complex_size_ - k];
+    }
+
+    const poly_float* cosines = real_twiddles_.get();
+    const poly_float* sines = cosines + vectors;
+    for (int v = 0; v < vectors; ++v) {
+      poly_float real = result[v];
+      poly_float imaginary = result[v + vectors];
+      poly_float mirror_real = mirror[v];
+      poly_float mirror_imaginary = mirror[v + vectors];
+
+      poly_float even_real = (real + mirror_real) * 0.5f;
+      poly_float even_imaginary = (imaginary - mirror_imaginary) * 0.5f;
+      poly_float odd_real = (imaginary + mirror_imaginary) * 0.5f;
+      poly_float odd_imaginary = (mirror_real - real) * 0.5f;
+
+      mirror[v] = even_real + cosines[v] * odd_real + sines[v] * odd_imaginary;
+      mirror[v + vectors] = even_imaginary + cosines[v] * odd_imaginary - sines[v] * odd_real;
+    }
+
+    for (int k = 0; k < complex_size_; ++k) {
+      data[2 * k] = mirror_data[k];
+      data[2 * k + 1] = mirror_data[k + complex_size_];
+    }
+
+    data[1] = 0.0f;
+    data[size_] = result_data[0] - result_data[complex_size_];
+    data[size_ + 1] = 0.0f;
+    memset(data + size_ + 2, 0, (size_ - 2) * sizeof(float));
+  }
+
+  void FourierTransform::transformRealInverse(float* data) {
+    static constexpr int kSize = poly_float::kSize;
+    poly_float stack_scratch[(4 << (kMaxStackBits - 1)) / kSize];
+    poly_float* scratch = getScratch(stack_scratch);
+    int vectors = complex_size_ / kSize;
+
+    poly_float* spectrum = scratch;
+    poly_float* mirror = scratch + 2 * vectors;
+    float* spectrum_data = reinterpret_cast<float*>(spectrum);
+    float* mirror_data = reinterpret_cast<float*>(mirror);
+    for (int k = 0; k < complex_size_; ++k) {
+      spectrum_data[k] = data[2 * k];
+      spectrum_data[k + complex_size_] = data[2 * k + 1];
+      mirror_data[k] = data[size_ - 2 * k];
+      mirror_data[k + complex_size_] = -data[size_ - 2 * k + 1];
+    }
+    spectrum_data[complex_size_] = 0.0f;
+    mirror_data[complex_size_] = 0.0f;
+
+    float scale = 0.5f / complex_size_;
+    const poly_float* cosines = real_twiddles_.get();
+    const poly_float* sines = cosines + vectors;
+    for (int v = 0; v < vectors; ++v) {
+      poly_float real = spectrum[v];
+      poly_float imaginary = spectrum[v + vectors];
+      poly_float mirror_real = mirror[v];
+      poly_float mirror_imaginary = mirror[v + vectors];
+
+      poly_float even_real = real + mirror_real;
+      poly_float even_imaginary = imaginary + mirror_imaginary;
+      poly_float delta_real = real - mirror_real;
+      poly_float delta_imaginary = imaginary - mirror_imaginary;
+      poly_float odd_real = delta_real * cosines[v] - delta_imaginary * sines[v];
+      poly_float odd_imaginary = delta_real * sines[v] + delta_imaginary * cosines[v];
+
+      spectrum[v] = (even_real - odd_imaginary) * scale;
+      spectrum[v + vectors] = (even_imaginary + odd_real) * scale;
+    }
+
+    poly_float* result = transformComplex<true>(spectrum, mirror);
+    float* result_data = reinterpret_cast<float*>(result);
+    for (int i = 0; i < complex_size_; ++i) {
+      data[2 * i] = result_data[i];
+      data[2 * i + 1] = result_data[i + complex_size_];
+    }
+
+    memset(data + size_, 0, size_ * sizeof(float));
+  }
+} // namespace vital
+
+#endif
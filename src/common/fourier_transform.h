@@ -18,6 +18,10 @@
 
 #include "JuceHeader.h"
 
+#if JUCE_LINUX && !INTEL_IPP
+#include "common.h"
+#endif
+
 namespace vital {
   #if INTEL_IPP
 
@@ -52,6 +56,9 @@ namespace vital {
         memset(data + size_, 0, size_ * sizeof(float));
       }
 
+      // Transforms share one work buffer.
+      bool isReentrant() const { return false; }
+
     private:
       int size_;
       IppsFFTSpec_R_32f *ipp_specs_;
@@ -62,6 +69,39 @@ namespace vital {
       JUCE_LEAK_DETECTOR(FourierTransform)
   };
 
+  #elif JUCE_LINUX
+
+  // Real transform computed as a half size complex transform. The complex transform is a radix-4
+  // Stockham FFT with the butterflies on poly_float, so it follows the SSE2/AVX2/NEON build.
+  class FourierTransform {
+    public:
+      FourierTransform(int bits);
+
+      void transformRealForward(float* data);
+      void transformRealInverse(float* data);
+
+      // Sizes up to kMaxStackBits keep their scratch on the caller's stack.
+      bool isReentrant() const { return scratch_ == nullptr; }
+
+    private:
+      static constexpr int kMinBits = 6;
+      static constexpr int kMaxStackBits = 11;
+
+      poly_float* getScratch(poly_float* stack_scratch);
+      template<bool inverse>
+      poly_float* transformComplex(poly_float* buffer, poly_float* scratch);
+
+      int bits_;
+      int size_;
+      int complex_size_;
+      int num_radix4_stages_;
+      std::unique_ptr<poly_float[]> stage_twiddles_;
+      std::unique_ptr<poly_float[]> real_twiddles_;
+      std::unique_ptr<poly_float[]> scratch_;
+
+      JUCE_LEAK_DETECTOR(FourierTransform)
+  };
+
   #elif JUCE_MODULE_AVAILABLE_juce_dsp
 
   class FourierTransform {
@@ -70,6 +110,7 @@ namespace vital {
 
       void transformRealForward(float* data) { fft_.performRealOnlyForwardTransform(data, true); }
       void transformRealInverse(float* data) { fft_.performRealOnlyInverseTransform(data); }
+      bool isReentrant() const { return true; }
 
     private:
       dsp::FFT fft_;
@@ -110,6 +151,8 @@ namespace vital {
         memset(data + size_, 0, size_ * sizeof(float));
       }
 
+      bool isReentrant() const { return true; }
+
     private:
       FFTSetup setup_;
       vDSP_Length bits_;
@@ -158,6 +201,9 @@ namespace vital {
         memset(data + size_, 0, size_ * sizeof(float));
       }
 
+      // Transforms share one work buffer.
+      bool isReentrant() const { return false; }
+
     private:
       size_t bits_;
       size_t size_;
@@ -15,6 +15,8 @@
  */
 
 #include "load_save.h"
+#include "binary_preset.h"
+#include "convolver.h"
 #include "modulation_connection_processor.h"
 #include "sound_engine.h"
 #include "midi_manager.h"
@@ -45,6 +47,20 @@ namespace {
 
     return Time(year, month, day, hour, minute);
   }
+
+  // Payloads hash by their decoded bytes so a table keys the same loaded from .vital json or a binary preset.
+  uint64_t hashPayload(const std::string& text, uint64_t seed) {
+    uint64_t hash = seed * 31 + static_cast<uint64_t>(json::value_t::string);
+    MemoryOutputStream scratch;
+    const void* bytes = nullptr;
+    if (vital::utils::isRawDataString(text)) {
+      size_t size = vital::utils::readDataString(text, scratch, &bytes);
+      return vital::utils::hashData(bytes, size, hash + 1);
+    }
+    if (Base64::convertFromBase64(scratch, text))
+      return vital::utils::hashData(scratch.getData(), scratch.getDataSize(), hash + 1);
+    return vital::utils::hashData(text.data(), text.size(), hash);
+  }
 } // namespace
 
 const std::string LoadSave::kUserDirectoryName = "User";
@@ -62,16 +78,19 @@ void LoadSave::convertBufferToPcm(json& data, const std::string& field) {
     return;
 
   MemoryOutputStream decoded;
-  std::string wave_data = data[field];
-  Base64::convertFromBase64(decoded, wave_data);
-  int size = static_cast<int>(decoded.getDataSize()) / sizeof(float);
+  const std::string& wave_data = data[field].get_ref<const std::string&>();
+  bool raw = vital::utils::isRawDataString(wave_data);
+  const void* bytes = nullptr;
+  int size = static_cast<int>(vital::utils::readDataString(wave_data, decoded, &bytes) / sizeof(float));
   std::unique_ptr<float[]> float_data = std::make_unique<float[]>(size);
-  memcpy(float_data.get(), decoded.getData(), size * sizeof(float));
+  memcpy(float_data.get(), bytes, size * sizeof(float));
   std::unique_ptr<int16_t[]> pcm_data = std::make_unique<int16_t[]>(size);
   vital::utils::floatToPcmData(pcm_data.get(), float_data.get(), size);
 
-  String encoded = Base64::toBase64(pcm_data.get(), sizeof(int16_t) * size);
-  data[field] = encoded.toStdString();
+  if (raw)
+    data[field] = vital::utils::encodeRawDataString(pcm_data.get(), sizeof(int16_t) * size);
+  else
+    data[field] = Base64::toBase64(pcm_data.get(), sizeof(int16_t) * size).toStdString();
 }
 
 void LoadSave::convertPcmToFloatBuffer(json& data, const std::string& field) {
@@ -79,16 +98,17 @@ void LoadSave::convertPcmToFloatBuffer(json& data, const std::string& field) {
     return;
 
   MemoryOutputStream decoded;
-  std::string wave_data = data[field];
-  Base64::convertFromBase64(decoded, wave_data);
-  int size = static_cast<int>(decoded.getDataSize()) / sizeof(int16_t);
-  std::unique_ptr<int16_t[]> pcm_data = std::make_unique<int16_t[]>(size);
-  memcpy(pcm_data.get(), decoded.getData(), size * sizeof(int16_t));
+  const std::string& wave_data = data[field].get_ref<const std::string&>();
+  bool raw = vital::utils::isRawDataString(wave_data);
+  const void* bytes = nullptr;
+  int size = static_cast<int>(vital::utils::readDataString(wave_data, decoded, &bytes) / sizeof(int16_t));
   std::unique_ptr<float[]> float_data = std::make_unique<float[]>(size);
-  vital::utils::pcmToFloatData(float_data.get(), pcm_data.get(), size);
+  vital::utils::pcmToFloatData(float_data.get(), static_cast<const int16_t*>(bytes), size);
 
-  String encoded = Base64::toBase64(float_data.get(), sizeof(float) * size);
-  data[field] = encoded.toStdString();
+  if (raw)
+    data[field] = vital::utils::encodeRawDataString(float_data.get(), sizeof(float) * size);
+  else
+    data[field] = Base64::toBase64(float_data.get(), sizeof(float) * size).toStdString();
 }
 
 json LoadSave::stateToJson(SynthBase* synth, const CriticalSection& critical_section) {
@@ -101,6 +121,10 @@ json LoadSave::stateToJson(SynthBase* synth, const CriticalSection& critical_sec
   if (sample)
     settings_data["sample"] = sample->stateToJson();
 
+  vital::Convolver* convolver = synth->getReverbConvolver();
+  if (convolver && convolver->getImpulseLength())
+    settings_data["reverb_impulse"] = convolver->stateToJson();
+
   json modulations;
   vital::ModulationConnectionBank& modulation_bank = synth->getModulationBank();
   for (int i = 0; i < vital::kMaxModulationConnections; ++i) {
@@ -122,7 +146,10 @@ json LoadSave::stateToJson(SynthBase* synth, const CriticalSection& critical_sec
     json wavetables;
     for (int i = 0; i < vital::kNumOscillators; ++i) {
       WavetableCreator* wavetable_creator = synth->getWavetableCreator(i);
-      wavetables.push_back(wavetable_creator->stateToJson());
+      json wavetable = wavetable_creator->stateToJson();
+      if (wavetable_creator->getStateHash() == 0)
+        wavetable_creator->setStateHash(hashJson(wavetable));
+      wavetables.push_back(std::move(wavetable));
     }
 
     settings_data["wavetables"] = wavetables;
@@ -150,21 +177,152 @@ json LoadSave::stateToJson(SynthBase* synth, const CriticalSection& critical_sec
   return data;
 }
 
-void LoadSave::loadControls(SynthBase* synth, const json& data) {
-  vital::control_map controls = synth->getControls();
+void LoadSave::stateToBuffer(SynthBase* synth, const json& extra_fields, StateBuffers& buffers) {
+  BinaryPreset::StateWriter writer(buffers.state);
+  writer.startMap(6 + vital::kNumMacros + extra_fields.size());
+  writer.writeText("synth_version");
+  writer.writeText(ProjectInfo::versionString);
+  writer.writeText("preset_name");
+  writer.writeText(synth->getPresetName().toStdString());
+  writer.writeText("author");
+  writer.writeText(synth->getAuthor().toStdString());
+  writer.writeText("comments");
+  writer.writeText(synth->getComments().toStdString());
+  writer.writeText("preset_style");
+  writer.writeText(synth->getStyle().toStdString());
+  for (int i = 0; i < vital::kNumMacros; ++i) {
+    writer.writeText("macro" + std::to_string(i + 1));
+    writer.writeText(synth->getMacroName(i).toStdString());
+  }
+
+  for (auto iter = extra_fields.begin(); iter != extra_fields.end(); ++iter) {
+    writer.writeText(iter.key());
+    writer.writeJson(iter.value());
+  }
+
+  vital::control_map& controls = synth->getControls();
+  vital::Sample* sample = synth->getSample();
+  vital::Convolver* convolver = synth->getReverbConvolver();
+  bool has_impulse = convolver && convolver->getImpulseLength();
+  bool has_wavetables = synth->getWavetableCreator(0) != nullptr;
+
+  writer.writeText("settings");
+  writer.startMap(controls.size() + (sample ? 1 : 0) + (has_impulse ? 1 : 0) + (has_wavetables ? 1 : 0) + 2);
   for (auto& control : controls) {
-    std::string name = control.first;
-    if (data.count(name)) {
-      vital::mono_float value = data[name];
-      control.second->set(value);
+    writer.writeText(control.first);
+    writer.writeNumber(control.second->value());
+  }
+
+  if (sample) {
+    writer.writeText("sample");
+    writer.writeJson(sample->stateToJson(true));
+  }
+
+  if (has_impulse) {
+    writer.writeText("reverb_impulse");
+    writer.writeJson(convolver->stateToJson(true));
+  }
+
+  writer.writeText("modulations");
+  writer.startArray(vital::kMaxModulationConnections);
+  vital::ModulationConnectionBank& modulation_bank = synth->getModulationBank();
+  for (int i = 0; i < vital::kMaxModulationConnections; ++i) {
+    vital::ModulationConnection* connection = modulation_bank.atIndex(i);
+    LineGenerator* line_mapping = connection->modulation_processor->lineMapGenerator();
+    writer.startMap(line_mapping->linear() ? 2 : 3);
+    writer.writeText("source");
+    writer.writeText(connection->source_name);
+    writer.writeText("destination");
+    writer.writeText(connection->destination_name);
+    if (!line_mapping->linear()) {
+      writer.writeText("line_mapping");
+      writer.writeJson(line_mapping->stateToJson());
     }
-    else {
-      vital::ValueDetails details = vital::Parameters::getDetails(name);
-      control.second->set(details.default_value);
+  }
+
+  if (has_wavetables) {
+    buffers.wavetables.resize(vital::kNumOscillators);
+    buffers.wavetable_hashes.resize(vital::kNumOscillators, 0);
+
+    writer.writeText("wavetables");
+    writer.startArray(vital::kNumOscillators);
+    for (int i = 0; i < vital::kNumOscillators; ++i) {
+      // Any edit or render clears the creator's state hash, until then the last encoding still holds.
+      WavetableCreator* wavetable_creator = synth->getWavetableCreator(i);
+      uint64_t hash = wavetable_creator->getStateHash();
+      if (hash == 0 || hash != buffers.wavetable_hashes[i]) {
+        json wavetable = wavetable_creator->stateToJson();
+        if (hash == 0) {
+          hash = hashJson(wavetable);
+          wavetable_creator->setStateHash(hash);
+        }
+        BinaryPreset::encodeValue(wavetable, buffers.wavetables[i]);
+        buffers.wavetable_hashes[i] = hash;
+      }
+      writer.writeEncoded(buffers.wavetables[i]);
     }
   }
 
-  synth->modWheelGuiChanged(controls["mod_wheel"]->value());
+  writer.writeText("lfos");
+  writer.startArray(vital::kNumLfos);
+  for (int i = 0; i < vital::kNumLfos; ++i)
+    writer.writeJson(synth->getLfoSource(i)->stateToJson());
+
+  writer.finish();
+}
+
+uint64_t LoadSave::hashJson(const json& data, uint64_t seed) {
+  // Numbers hash by value like json compares them. Binary presets read positive integers back as unsigned.
+  json::value_t type = data.is_number() ? json::value_t::number_float : data.type();
+  uint64_t hash = seed * 31 + static_cast<uint64_t>(type);
+  switch (type) {
+    case json::value_t::object:
+      for (auto iter = data.begin(); iter != data.end(); ++iter) {
+        const std::string& key = iter.key();
+        hash = vital::utils::hashData(key.data(), key.size(), hash);
+        if (iter.value().is_string() && BinaryPreset::isPayloadField(key))
+          hash = hashPayload(iter.value().get_ref<const std::string&>(), hash);
+        else
+          hash = hashJson(iter.value(), hash);
+      }
+      return hash;
+    case json::value_t::array:
+      for (const json& element : data)
+        hash = hashJson(element, hash);
+      return hash;
+    case json::value_t::string: {
+      const std::string& text = data.get_ref<const std::string&>();
+      return vital::utils::hashData(text.data(), text.size(), hash);
+    }
+    case json::value_t::number_float: {
+      double value = data.get<double>();
+      return vital::utils::hashData(&value, sizeof(value), hash);
+    }
+    case json::value_t::boolean: {
+      int64_t value = data.get<bool>();
+      return vital::utils::hashData(&value, sizeof(value), hash);
+    }
+    default:
+      return hash;
+  }
+}
+
+void LoadSave::loadControls(SynthBase* synth, const json& data) {
+  int num_parameters = vital::Parameters::getNumParameters();
+  for (int i = 0; i < num_parameters; ++i) {
+    vital::Value* control = synth->getControl(i);
+    if (control == nullptr)
+      continue;
+
+    const vital::ValueDetails* details = vital::Parameters::getDetails(i);
+    auto value = data.find(details->name);
+    if (value != data.end())
+      control->set(value->get<vital::mono_float>());
+    else
+      control->set(details->default_value);
+  }
+
+  synth->modWheelGuiChanged(synth->getControl(vital::Parameters::getId("mod_wheel"))->value());
 }
 
 void LoadSave::loadModulations(SynthBase* synth, const json& modulations) {
@@ -201,6 +359,17 @@ void LoadSave::loadSample(SynthBase* synth, const json& json_sample) {
     sample->jsonToState(json_sample);
 }
 
+void LoadSave::loadReverbImpulse(SynthBase* synth, const json& settings) {
+  vital::Convolver* convolver = synth->getReverbConvolver();
+  if (convolver == nullptr)
+    return;
+
+  if (settings.count("reverb_impulse"))
+    convolver->jsonToState(settings["reverb_impulse"]);
+  else
+    convolver->clearImpulse();
+}
+
 void LoadSave::loadWavetables(SynthBase* synth, const json& wavetables) {
   if (synth->getWavetableCreator(0) == nullptr)
     return;
@@ -208,8 +377,11 @@ void LoadSave::loadWavetables(SynthBase* synth, const json& wavetables) {
   int i = 0;
   for (const json& wavetable : wavetables) {
     WavetableCreator* wavetable_creator = synth->getWavetableCreator(i);
-    wavetable_creator->jsonToState(wavetable);
-    wavetable_creator->render();
+    uint64_t hash = hashJson(wavetable);
+    if (hash == 0 || hash != wavetable_creator->getStateHash()) {
+      wavetable_creator->jsonToState(wavetable, hash);
+      wavetable_creator->setStateHash(hash);
+    }
     i++;
   }
 }
@@ -1035,15 +1207,16 @@ bool LoadSave::jsonToState(SynthBase* synth, std::map<std::string, String>& save
   if (compare_versions < 0 || data["settings"].count("sub_octave"))
     data = updateFromOldVersion(data);
   
-  json settings = data["settings"];
-  json modulations = settings["modulations"];
-  json sample = settings["sample"];
-  json wavetables = settings["wavetables"];
-  json lfos = settings["lfos"];
+  json& settings = data["settings"];
+  const json& modulations = settings["modulations"];
+  const json& sample = settings["sample"];
+  const json& wavetables = settings["wavetables"];
+  const json& lfos = settings["lfos"];
 
   loadControls(synth, settings);
   loadModulations(synth, modulations);
   loadSample(synth, sample);
+  loadReverbImpulse(synth, settings);
   loadWavetables(synth, wavetables);
   loadLfos(synth, lfos);
   loadSaveState(save_info, data);
@@ -1181,6 +1354,25 @@ File LoadSave::getFavoritesFile() {
 #endif
 }
 
+File LoadSave::getPresetIndexFile() {
+#if defined(JUCE_DATA_STRUCTURES_H_INCLUDED)
+  PropertiesFile::Options config_options;
+  config_options.applicationName = "Vial";
+  config_options.osxLibrarySubFolder = "Application Support";
+  config_options.filenameSuffix = "presetindex";
+
+#ifdef LINUX
+  config_options.folderName = "." + String(ProjectInfo::projectName).toLowerCase();
+#else
+  config_options.folderName = String(ProjectInfo::projectName).toLowerCase();
+#endif
+
+  return config_options.getDefaultFile();
+#else
+  return File();
+#endif
+}
+
 File LoadSave::getDefaultSkin() {
 #if defined(JUCE_DATA_STRUCTURES_H_INCLUDED)
   PropertiesFile::Options config_options;
@@ -1630,6 +1822,24 @@ int LoadSave::getOversamplingAmount() {
   return data["oversampling_amount"];
 }
 
+bool LoadSave::getEffectsAtBaseRate() {
+  json data = getConfigJson();
+
+  if (!data.count("effects_at_base_rate"))
+    return false;
+
+  return data["effects_at_base_rate"];
+}
+
+bool LoadSave::shouldShowFrameTime() {
+  json data = getConfigJson();
+
+  if (!data.count("show_frame_time"))
+    return false;
+
+  return data["show_frame_time"];
+}
+
 float LoadSave::loadWindowSize() {
   static constexpr float kMinWindowSize = 0.25f;
   
@@ -22,6 +22,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 using json = nlohmann::json;
 
@@ -46,6 +47,14 @@ class LoadSave {
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FileSorterAscending)
     };
 
+    // Reusable buffers for streaming the synth state into a binary container. Wavetables keep their
+    // encoding while their creator is unchanged so saving again doesn't encode or hash them.
+    struct StateBuffers {
+      std::vector<uint8_t> state;
+      std::vector<std::vector<uint8_t>> wavetables;
+      std::vector<uint64_t> wavetable_hashes;
+    };
+
     enum PresetStyle {
       kBass,
       kLead,
@@ -72,10 +81,14 @@ class LoadSave {
     static void convertBufferToPcm(json& data, const std::string& field);
     static void convertPcmToFloatBuffer(json& data, const std::string& field);
     static json stateToJson(SynthBase* synth, const CriticalSection& critical_section);
+    // Writes the same state as stateToJson plus the extra top level fields into buffers.state.
+    static void stateToBuffer(SynthBase* synth, const json& extra_fields, StateBuffers& buffers);
+    static uint64_t hashJson(const json& data, uint64_t seed = 0);
 
     static void loadControls(SynthBase* synth, const json& data);
     static void loadModulations(SynthBase* synth, const json& modulations);
     static void loadSample(SynthBase* synth, const json& sample);
+    static void loadReverbImpulse(SynthBase* synth, const json& settings);
     static void loadWavetables(SynthBase* synth, const json& wavetables);
     static void loadLfos(SynthBase* synth, const json& lfos);
     static void loadSaveState(std::map<std::string, String>& save_info, json data);
@@ -94,6 +107,7 @@ class LoadSave {
     static void writeErrorLog(String error_log);
     static json getConfigJson();
     static File getFavoritesFile();
+    static File getPresetIndexFile();
     static File getDefaultSkin();
     static json getFavoritesJson();
     static void addFavorite(const File& new_favorite);
@@ -120,6 +134,8 @@ class LoadSave {
     static bool displayHzFrequency();
     static bool authenticated();
     static int getOversamplingAmount();
+    static bool getEffectsAtBaseRate();
+    static bool shouldShowFrameTime();
     static float loadWindowSize();
     static String loadVersion();
     static String loadContentVersion();
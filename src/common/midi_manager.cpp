@@ -84,8 +84,9 @@ void MidiManager::midiInput(int midi_id, vital::mono_float value) {
     LoadSave::saveMidiMapConfig(this);
   }
 
-  if (midi_learn_map_.count(midi_id)) {
-    for (auto& control : midi_learn_map_[midi_id]) {
+  auto controls = midi_learn_map_.find(midi_id);
+  if (controls != midi_learn_map_.end()) {
+    for (auto& control : controls->second) {
       const vital::ValueDetails* details = control.second;
       vital::mono_float percent = value / kControlMax;
       vital::mono_float range = details->max - details->min;
@@ -93,7 +94,7 @@ void MidiManager::midiInput(int midi_id, vital::mono_float value) {
 
       if (details->value_scale == vital::ValueDetails::kIndexed)
         translated = std::round(translated);
-      listener_->valueChangedThroughMidi(control.first, translated);
+      listener_->valueChangedThroughMidi(*details, translated);
     }
   }
 }
@@ -0,0 +1,292 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "preset_index.h"
+#include "binary_preset.h"
+#include "load_save.h"
+#include "synth_constants.h"
+
+namespace {
+  constexpr int kIndexVersion = 1;
+  constexpr int kStopTimeoutMs = 2000;
+
+  std::string getString(const json& data, const std::string& key) {
+    auto found = data.find(key);
+    if (found == data.end() || !found->is_string())
+      return "";
+    return found->get<std::string>();
+  }
+
+  void readMetadata(const json& data, PresetIndex::Entry& entry) {
+    entry.author = getString(data, "author");
+    entry.style = getString(data, "preset_style");
+    entry.comments = getString(data, "comments");
+    entry.tags.clear();
+
+    auto tags = data.find("tags");
+    if (tags != data.end() && tags->is_array()) {
+      for (const json& tag : *tags) {
+        if (tag.is_string())
+          entry.tags.push_back(tag.get<std::string>());
+      }
+    }
+  }
+
+  json entryToJson(const PresetIndex::Entry& entry) {
+    json data;
+    data["size"] = entry.size;
+    data["modified"] = entry.modified;
+    data["name"] = entry.name;
+    data["author"] = entry.author;
+    data["preset_style"] = entry.style;
+    data["comments"] = entry.comments;
+    data["tags"] = entry.tags;
+    return data;
+  }
+
+  bool jsonToEntry(const json& data, PresetIndex::Entry& entry) {
+    if (!data.is_object() || data.count("size") == 0 || data.count("modified") == 0)
+      return false;
+
+    entry.size = data["size"];
+    entry.modified = data["modified"];
+    entry.name = getString(data, "name");
+    readMetadata(data, entry);
+    return true;
+  }
+} // namespace
+
+PresetIndex::PresetIndex() : index_file_(LoadSave::getPresetIndexFile()), use_preset_directories_(true),
+                             ready_(false), loaded_(false) { }
+
+PresetIndex::PresetIndex(const File& index_file, std::vector<File> directories) :
+    index_file_(index_file), directories_(std::move(directories)), use_preset_directories_(false),
+    ready_(false), loaded_(false) { }
+
+PresetIndex::~PresetIndex() {
+  cancelPendingUpdate();
+  if (scan_thread_)
+    scan_thread_->stopThread(kStopTimeoutMs);
+}
+
+bool PresetIndex::readEntry(const File& file, Entry& entry) {
+  entry.size = file.getSize();
+  entry.modified = file.getLastModificationTime().toMilliseconds();
+  entry.name = file.getFileNameWithoutExtension().toStdString();
+
+  json data;
+  if (BinaryPreset::isBinaryPreset(file)) {
+    if (!BinaryPreset::readFromFile(file, data))
+      return false;
+  }
+  else {
+    // The settings hold nearly all of a preset's bytes and none of the metadata, so they're
+    // skipped instead of built.
+    std::string last_key;
+    json::parser_callback_t skip_settings = [&last_key](int depth, json::parse_event_t event, json& parsed) {
+      if (event == json::parse_event_t::key && depth == 1)
+        last_key = parsed;
+      else if ((event == json::parse_event_t::object_start || event == json::parse_event_t::array_start) &&
+               depth == 1 && last_key == "settings") {
+        return false;
+      }
+      return true;
+    };
+
+    try {
+      data = json::parse(file.loadFileAsString().toStdString(), skip_settings);
+    }
+    catch (const json::exception& e) {
+      return false;
+    }
+  }
+
+  if (!data.is_object())
+    return false;
+
+  readMetadata(data, entry);
+  return true;
+}
+
+void PresetIndex::refresh() {
+  if (scan_thread_) {
+    scan_thread_->notify();
+    return;
+  }
+
+  // The saved index is read up front so the browser can show it while the scan catches up.
+  {
+    ScopedLock update_lock(update_lock_);
+    if (!loaded_) {
+      loaded_ = true;
+      loadIndex();
+    }
+  }
+
+  scan_thread_ = std::make_unique<ScanThread>(this);
+  scan_thread_->startThread(0);
+}
+
+bool PresetIndex::update(Thread* thread) {
+  ScopedLock update_lock(update_lock_);
+  if (!loaded_) {
+    loaded_ = true;
+    loadIndex();
+  }
+
+  bool changed = false;
+  Array<File> files;
+  for (const File& directory : getDirectories()) {
+    if (directory.exists() && directory.isDirectory())
+      directory.findChildFiles(files, File::findFiles, true, String("*.") + vital::kPresetExtension);
+  }
+
+  std::map<std::string, Entry> entries;
+  {
+    ScopedLock lock(lock_);
+    entries = entries_;
+  }
+
+  std::map<std::string, Entry> updated;
+  bool complete = true;
+  for (const File& file : files) {
+    std::string path = file.getFullPathName().toStdString();
+    int64 size = file.getSize();
+    int64 modified = file.getLastModificationTime().toMilliseconds();
+
+    auto found = entries.find(path);
+    if (found != entries.end() && found->second.size == size && found->second.modified == modified) {
+      updated[path] = std::move(found->second);
+      entries.erase(found);
+      continue;
+    }
+
+    if (found != entries.end())
+      entries.erase(found);
+
+    Entry entry;
+    readEntry(file, entry);
+    updated[path] = std::move(entry);
+    changed = true;
+
+    if (thread && thread->threadShouldExit()) {
+      complete = false;
+      break;
+    }
+  }
+
+  // Whatever is left wasn't found on disk, unless we stopped before getting to it.
+  if (complete)
+    changed = changed || !entries.empty();
+  else
+    updated.insert(entries.begin(), entries.end());
+
+  {
+    ScopedLock lock(lock_);
+    entries_.swap(updated);
+  }
+  ready_ = true;
+
+  if (changed)
+    saveIndex();
+  return changed;
+}
+
+int PresetIndex::getNumPresets() {
+  ScopedLock lock(lock_);
+  return static_cast<int>(entries_.size());
+}
+
+void PresetIndex::getPresets(Array<File>& presets) {
+  ScopedLock lock(lock_);
+  presets.clear();
+  presets.ensureStorageAllocated(static_cast<int>(entries_.size()));
+  for (auto& entry : entries_)
+    presets.add(File(entry.first));
+}
+
+bool PresetIndex::getEntry(const File& file, Entry& entry) {
+  ScopedLock lock(lock_);
+  auto found = entries_.find(file.getFullPathName().toStdString());
+  if (found == entries_.end())
+    return false;
+
+  entry = found->second;
+  return true;
+}
+
+void PresetIndex::removeListener(Listener* listener) {
+  listeners_.erase(std::remove(listeners_.begin(), listeners_.end(), listener), listeners_.end());
+}
+
+void PresetIndex::handleAsyncUpdate() {
+  for (Listener* listener : listeners_)
+    listener->presetIndexUpdated();
+}
+
+bool PresetIndex::loadIndex() {
+  if (!index_file_.existsAsFile())
+    return false;
+
+  json data;
+  try {
+    data = json::parse(index_file_.loadFileAsString().toStdString(), nullptr, false);
+  }
+  catch (const json::exception& e) {
+    return false;
+  }
+
+  if (!data.is_object() || data.count("version") == 0 || data["version"] != kIndexVersion)
+    return false;
+
+  std::map<std::string, Entry> entries;
+  json presets = data["presets"];
+  for (auto it = presets.begin(); it != presets.end(); ++it) {
+    Entry entry;
+    if (jsonToEntry(it.value(), entry))
+      entries[it.key()] = std::move(entry);
+  }
+
+  ScopedLock lock(lock_);
+  entries_.swap(entries);
+  ready_ = true;
+  return true;
+}
+
+void PresetIndex::saveIndex() {
+  if (index_file_ == File())
+    return;
+
+  json presets = json::object();
+  {
+    ScopedLock lock(lock_);
+    for (auto& entry : entries_)
+      presets[entry.first] = entryToJson(entry.second);
+  }
+
+  json data;
+  data["version"] = kIndexVersion;
+  data["presets"] = presets;
+
+  index_file_.getParentDirectory().createDirectory();
+  index_file_.replaceWithText(data.dump());
+}
+
+std::vector<File> PresetIndex::getDirectories() const {
+  if (use_preset_directories_)
+    return LoadSave::getPresetDirectories();
+  return directories_;
+}
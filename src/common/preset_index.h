@@ -0,0 +1,110 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "json/json.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+// Metadata for every preset in the preset directories, persisted next to the favorites file.
+// Entries are keyed by path and only re-read when a file's size or modification time changes, so
+// the browser can list, sort and search presets without touching the files.
+class PresetIndex : public AsyncUpdater {
+  public:
+    struct Entry {
+      int64 size = 0;
+      int64 modified = 0;
+      std::string name;
+      std::string author;
+      std::string style;
+      std::string comments;
+      std::vector<std::string> tags;
+    };
+
+    class Listener {
+      public:
+        virtual ~Listener() { }
+        virtual void presetIndexUpdated() = 0;
+    };
+
+    class ScanThread : public Thread {
+      public:
+        ScanThread(PresetIndex* ref) : Thread("Vial Preset Index Thread"), ref_(ref) { }
+        virtual ~ScanThread() { }
+
+        // Scans until asked to exit, refresh() wakes it up for another pass.
+        void run() override {
+          while (!threadShouldExit()) {
+            if (ref_->update(this) && !threadShouldExit())
+              ref_->triggerAsyncUpdate();
+            wait(-1);
+          }
+        }
+
+      private:
+        PresetIndex* ref_;
+    };
+
+    PresetIndex();
+    PresetIndex(const File& index_file, std::vector<File> directories);
+    virtual ~PresetIndex();
+
+    // Reads the metadata the browser shows without building the preset's settings.
+    static bool readEntry(const File& file, Entry& entry);
+
+    // Rescans on a background thread and notifies listeners on the message thread if anything changed.
+    // Never waits on a scan that's running, it gets another pass once it's done instead.
+    void refresh();
+
+    // Loads the saved index if needed, then re-reads new and changed presets and drops removed ones.
+    // Returns true if the index changed. If thread is set and asked to exit it stops after the preset
+    // it's reading, keeps the entries it didn't get to and saves what it read.
+    bool update(Thread* thread = nullptr);
+
+    bool isReady() const { return ready_.load(); }
+    int getNumPresets();
+    void getPresets(Array<File>& presets);
+    bool getEntry(const File& file, Entry& entry);
+
+    void addListener(Listener* listener) { listeners_.push_back(listener); }
+    void removeListener(Listener* listener);
+    void handleAsyncUpdate() override;
+
+  private:
+    bool loadIndex();
+    void saveIndex();
+    std::vector<File> getDirectories() const;
+
+    File index_file_;
+    std::vector<File> directories_;
+    bool use_preset_directories_;
+    std::atomic<bool> ready_;
+    bool loaded_;
+
+    CriticalSection lock_;
+    CriticalSection update_lock_;
+    std::map<std::string, Entry> entries_;
+    std::vector<Listener*> listeners_;
+    std::unique_ptr<ScanThread> scan_thread_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetIndex)
+};
@@ -0,0 +1,184 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "profile_report.h"
+
+#include <algorithm>
+
+namespace {
+  constexpr double kNanosecondsToMicroseconds = 0.001;
+  constexpr double kNanosecondsToMilliseconds = 0.000001;
+  constexpr double kNanosecondsToSeconds = 0.000000001;
+  constexpr int kAudioThreadId = 1;
+
+  double toMilliseconds(int64 nanoseconds) {
+    return nanoseconds * kNanosecondsToMilliseconds;
+  }
+} // namespace
+
+ProfileReport::ProfileReport(bool keep_timeline) :
+    keep_timeline_(keep_timeline), scratch_(std::make_unique<vital::Profiler::BlockRecord>()) {
+  clear();
+}
+
+int ProfileReport::read(vital::Profiler* profiler) {
+  int num_read = 0;
+  while (profiler->readBlock(*scratch_)) {
+    addBlock(*scratch_);
+    num_read++;
+  }
+
+  dropped_blocks_ = profiler->getDroppedBlocks();
+  return num_read;
+}
+
+void ProfileReport::addBlock(const vital::Profiler::BlockRecord& block) {
+  num_blocks_++;
+  num_samples_ += block.num_samples;
+  total_time_ += block.duration;
+  worst_block_ = std::max<int64>(worst_block_, block.duration);
+  max_voices_ = std::max(max_voices_, block.num_voices);
+  voice_blocks_ += block.num_voices;
+
+  if (block.sample_rate > 0) {
+    double seconds = block.num_samples / (1.0 * block.sample_rate);
+    audio_seconds_ += seconds;
+    if (seconds > 0.0)
+      worst_load_ = std::max(worst_load_, block.duration * kNanosecondsToSeconds / seconds);
+  }
+
+  if (static_cast<int>(entries_.size()) < block.num_entries)
+    entries_.resize(block.num_entries);
+
+  if (keep_timeline_)
+    timeline_.push_back({ -1, block.start, block.duration, block.num_voices });
+
+  for (int i = 0; i < block.num_entries; ++i) {
+    const vital::Profiler::EntryTime& time = block.entries[i];
+    if (time.calls == 0)
+      continue;
+
+    EntryStats& stats = entries_[i];
+    stats.total += time.duration;
+    stats.worst = std::max<int64>(stats.worst, time.duration);
+    stats.calls += time.calls;
+    stats.blocks++;
+
+    if (keep_timeline_)
+      timeline_.push_back({ i, block.start + time.start, time.duration, time.calls });
+  }
+}
+
+void ProfileReport::clear() {
+  num_blocks_ = 0;
+  dropped_blocks_ = 0;
+  num_samples_ = 0;
+  total_time_ = 0;
+  worst_block_ = 0;
+  worst_load_ = 0.0;
+  max_voices_ = 0;
+  voice_blocks_ = 0;
+  audio_seconds_ = 0.0;
+  entries_.clear();
+  timeline_.clear();
+}
+
+ProfileReport::EntryStats ProfileReport::getEntry(const std::string& name) const {
+  int num_entries = static_cast<int>(entries_.size());
+  for (int i = 0; i < num_entries; ++i) {
+    if (vital::Profiler::getEntryName(i) == name)
+      return entries_[i];
+  }
+  return EntryStats();
+}
+
+json ProfileReport::toJson() const {
+  std::vector<int> order;
+  int num_entries = static_cast<int>(entries_.size());
+  for (int i = 0; i < num_entries; ++i) {
+    if (entries_[i].calls)
+      order.push_back(i);
+  }
+  std::sort(order.begin(), order.end(), [this](int a, int b) { return entries_[a].total > entries_[b].total; });
+
+  json entries = json::array();
+  for (int index : order) {
+    const EntryStats& stats = entries_[index];
+    json entry;
+    entry["name"] = vital::Profiler::getEntryName(index);
+    entry["total_ms"] = toMilliseconds(stats.total);
+    entry["mean_ms"] = toMilliseconds(stats.total) / stats.blocks;
+    entry["worst_ms"] = toMilliseconds(stats.worst);
+    entry["percent"] = total_time_ ? (100.0 * stats.total) / total_time_ : 0.0;
+    entry["calls"] = stats.calls;
+    entry["blocks"] = stats.blocks;
+    entries.push_back(entry);
+  }
+
+  json data;
+  data["blocks"] = num_blocks_;
+  data["dropped_blocks"] = dropped_blocks_;
+  data["samples"] = num_samples_;
+  data["total_ms"] = toMilliseconds(total_time_);
+  data["mean_block_ms"] = num_blocks_ ? toMilliseconds(total_time_) / num_blocks_ : 0.0;
+  data["worst_block_ms"] = toMilliseconds(worst_block_);
+  data["mean_load"] = audio_seconds_ > 0.0 ? total_time_ * kNanosecondsToSeconds / audio_seconds_ : 0.0;
+  data["worst_load"] = worst_load_;
+  data["mean_voices"] = num_blocks_ ? voice_blocks_ / (1.0 * num_blocks_) : 0.0;
+  data["max_voices"] = max_voices_;
+  data["entries"] = entries;
+  return data;
+}
+
+json ProfileReport::toChromeTrace() const {
+  int64 origin = timeline_.empty() ? 0 : timeline_[0].start;
+  std::vector<std::string> names;
+  int num_entries = static_cast<int>(entries_.size());
+  for (int i = 0; i < num_entries; ++i)
+    names.push_back(vital::Profiler::getEntryName(i));
+
+  json events = json::array();
+  for (const TimelineEvent& event : timeline_) {
+    json trace_event;
+    trace_event["ph"] = "X";
+    trace_event["pid"] = 1;
+    trace_event["tid"] = kAudioThreadId;
+    trace_event["ts"] = (event.start - origin) * kNanosecondsToMicroseconds;
+    trace_event["dur"] = event.duration * kNanosecondsToMicroseconds;
+
+    json args;
+    if (event.id < 0) {
+      trace_event["name"] = "block";
+      args["voices"] = event.calls;
+    }
+    else {
+      trace_event["name"] = names[event.id];
+      args["calls"] = event.calls;
+    }
+    trace_event["args"] = args;
+    events.push_back(trace_event);
+  }
+
+  json data;
+  data["traceEvents"] = events;
+  data["displayTimeUnit"] = "ms";
+  return data;
+}
+
+bool ProfileReport::writeToFile(const File& file, bool chrome_trace) const {
+  json data = chrome_trace ? toChromeTrace() : toJson();
+  return file.replaceWithText(data.dump(chrome_trace ? -1 : 2));
+}
@@ -0,0 +1,85 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "json/json.h"
+#include "profiler.h"
+
+#include <memory>
+#include <vector>
+
+using json = nlohmann::json;
+
+// Collects the blocks a vital::Profiler records into per-entry totals and, optionally, a timeline
+// that can be written in the Chrome trace event format for chrome://tracing or Perfetto.
+class ProfileReport {
+  public:
+    struct EntryStats {
+      int64 total = 0;
+      int64 worst = 0;
+      int64 calls = 0;
+      int blocks = 0;
+    };
+
+    ProfileReport(bool keep_timeline = false);
+
+    // Drains every finished block from the profiler. Call from a single reader thread.
+    int read(vital::Profiler* profiler);
+    void addBlock(const vital::Profiler::BlockRecord& block);
+    void clear();
+
+    int getNumBlocks() const { return num_blocks_; }
+    int getDroppedBlocks() const { return dropped_blocks_; }
+    int64 getTotalTime() const { return total_time_; }
+    int64 getWorstBlockTime() const { return worst_block_; }
+    const std::vector<EntryStats>& getEntries() const { return entries_; }
+    EntryStats getEntry(const std::string& name) const;
+
+    // Totals per block and per entry, entries sorted by total time. Load is time spent over the
+    // real time the block covers.
+    json toJson() const;
+    json toChromeTrace() const;
+    bool writeToFile(const File& file, bool chrome_trace) const;
+
+  private:
+    struct TimelineEvent {
+      int id;
+      int64 start;
+      int64 duration;
+      int calls;
+    };
+
+    bool keep_timeline_;
+    std::unique_ptr<vital::Profiler::BlockRecord> scratch_;
+
+    int num_blocks_;
+    int dropped_blocks_;
+    int64 num_samples_;
+    int64 total_time_;
+    int64 worst_block_;
+    double worst_load_;
+    int max_voices_;
+    int64 voice_blocks_;
+    double audio_seconds_;
+    std::vector<EntryStats> entries_;
+
+    // Blocks use id -1 and store their voice count in calls.
+    std::vector<TimelineEvent> timeline_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfileReport)
+};
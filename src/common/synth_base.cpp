@@ -16,6 +16,9 @@
 
 #include "synth_base.h"
 
+#include "binary_preset.h"
+#include "convolver.h"
+#include "engine_telemetry.h"
 #include "sample_source.h"
 #include "sound_engine.h"
 #include "load_save.h"
@@ -26,13 +29,40 @@
 #include "synth_parameters.h"
 #include "utils.h"
 
-SynthBase::SynthBase() : expired_(false) {
+namespace {
+  // Offline renders outrun the sample streaming thread, so streamed samples load on the render thread.
+  // Effects stay awake through the silent warm up so renders don't depend on where they fell asleep.
+  class ScopedOfflineRender {
+    public:
+      ScopedOfflineRender(vital::SoundEngine* engine) : engine_(engine) {
+        engine_->getSample()->setStreamingSynchronous(true);
+        engine_->setEffectSleepEnabled(false);
+        engine_->setDormantEnabled(false);
+      }
+
+      ~ScopedOfflineRender() {
+        engine_->getSample()->setStreamingSynchronous(false);
+        engine_->setEffectSleepEnabled(true);
+        engine_->setDormantEnabled(true);
+      }
+
+    private:
+      vital::SoundEngine* engine_;
+  };
+
+  int compareValueChangeSamples(vital::control_change left, vital::control_change right) {
+    return right.sample - left.sample;
+  }
+} // namespace
+
+SynthBase::SynthBase() : expired_(false), render_profile_report_(nullptr), value_changes_queued_(false) {
   expired_ = LoadSave::isExpired();
   self_reference_ = std::make_shared<SynthBase*>();
   *self_reference_ = this;
 
   engine_ = std::make_unique<vital::SoundEngine>();
   engine_->setTuning(&tuning_);
+  engine_->setEffectsAtBaseRate(LoadSave::getEffectsAtBaseRate());
 
   mod_connections_.reserve(vital::kMaxModulationConnections);
 
@@ -55,8 +85,26 @@ SynthBase::SynthBase() : expired_(false) {
   memory_reset_period_ = vital::kOscilloscopeMemoryResolution;
   memory_input_offset_ = 0;
   memory_index_ = 0;
+  oscilloscope_version_ = 0;
+  telemetry_ = std::make_unique<EngineTelemetry>();
+  telemetry_->init(engine_.get(), audio_memory_.get());
 
   controls_ = engine_->getControls();
+  control_list_.assign(vital::Parameters::getNumParameters(), nullptr);
+  for (auto& control : controls_)
+    control_list_[vital::Parameters::getId(control.first)] = control.second;
+
+  mod_wheel_id_ = vital::Parameters::getId("mod_wheel");
+  pitch_wheel_id_ = vital::Parameters::getId("pitch_wheel");
+  int num_parameters = vital::Parameters::getNumParameters();
+  queued_value_changes_ = std::make_unique<std::atomic<uint64_t>[]>(num_parameters);
+  value_change_flags_ = std::make_unique<std::atomic<bool>[]>(num_parameters);
+  for (int i = 0; i < num_parameters; ++i) {
+    queued_value_changes_[i] = 0;
+    value_change_flags_[i] = false;
+  }
+  block_value_changes_.reserve(num_parameters);
+  block_samples_ = 0;
 
   Startup::doStartupChecks(midi_manager_.get());
 }
@@ -64,28 +112,34 @@ SynthBase::SynthBase() : expired_(false) {
 SynthBase::~SynthBase() { }
 
 void SynthBase::valueChanged(const std::string& name, vital::mono_float value) {
-  controls_[name]->set(value);
+  valueChanged(vital::Parameters::getId(name), value);
+}
+
+void SynthBase::valueChanged(int id, vital::mono_float value) {
+  control_list_[id]->set(value);
+  engine_->wake();
 }
 
 void SynthBase::valueChangedInternal(const std::string& name, vital::mono_float value) {
-  valueChanged(name, value);
-  setValueNotifyHost(name, value);
+  int id = vital::Parameters::getId(name);
+  valueChanged(id, value);
+  setValueNotifyHost(id, value);
 }
 
-void SynthBase::valueChangedThroughMidi(const std::string& name, vital::mono_float value) {
-  controls_[name]->set(value);
-  ValueChangedCallback* callback = new ValueChangedCallback(self_reference_, name, value);
-  setValueNotifyHost(name, value);
+void SynthBase::valueChangedThroughMidi(const vital::ValueDetails& details, vital::mono_float value) {
+  valueChanged(details.id, value);
+  ValueChangedCallback* callback = new ValueChangedCallback(self_reference_, details.id, value);
+  setValueNotifyHost(details.id, value);
   callback->post();
 }
 
 void SynthBase::pitchWheelMidiChanged(vital::mono_float value) {
-  ValueChangedCallback* callback = new ValueChangedCallback(self_reference_, "pitch_wheel", value);
+  ValueChangedCallback* callback = new ValueChangedCallback(self_reference_, pitch_wheel_id_, value);
   callback->post();
 }
 
 void SynthBase::modWheelMidiChanged(vital::mono_float value) {
-  ValueChangedCallback* callback = new ValueChangedCallback(self_reference_, "mod_wheel", value);
+  ValueChangedCallback* callback = new ValueChangedCallback(self_reference_, mod_wheel_id_, value);
   callback->post();
 }
 
@@ -106,13 +160,14 @@ void SynthBase::presetChangedThroughMidi(File preset) {
 }
 
 void SynthBase::valueChangedExternal(const std::string& name, vital::mono_float value) {
-  valueChanged(name, value);
-  if (name == "mod_wheel")
+  int id = vital::Parameters::getId(name);
+  valueChanged(id, value);
+  if (id == mod_wheel_id_)
     engine_->setModWheelAllChannels(value);
-  else if (name == "pitch_wheel")
+  else if (id == pitch_wheel_id_)
     engine_->setZonedPitchWheel(value, 0, vital::kNumMidiChannels - 1);
 
-  ValueChangedCallback* callback = new ValueChangedCallback(self_reference_, name, value);
+  ValueChangedCallback* callback = new ValueChangedCallback(self_reference_, id, value);
   callback->post();
 }
 
@@ -158,6 +213,7 @@ vital::modulation_change SynthBase::createModulationChange(vital::ModulationConn
     }
   }
   change.num_audio_rate = num_audio_rate;
+  engine_->prepareModulationChange(change);
   return change;
 }
 
@@ -173,6 +229,7 @@ void SynthBase::connectModulation(vital::ModulationConnection* connection) {
   }
   else if (mod_connections_.count(connection) == 0) {
     change.disconnecting = false;
+    engine_->compileModulationConnection(change);
     mod_connections_.push_back(connection);
     modulation_change_queue_.enqueue(change);
   }
@@ -210,8 +267,9 @@ void SynthBase::disconnectModulation(const std::string& source, const std::strin
 }
 
 void SynthBase::clearModulations() {
-  clearModulationQueue();
-  
+  flushModulationChanges();
+
+  std::lock_guard<std::mutex> lock(engine_->getModulationGraphMutex());
   while (mod_connections_.size()) {
     vital::ModulationConnection* connection = *mod_connections_.begin();
     mod_connections_.remove(connection);
@@ -276,7 +334,7 @@ std::vector<vital::ModulationConnection*> SynthBase::getDestinationConnections(c
 }
 
 const vital::StatusOutput* SynthBase::getStatusOutput(const std::string& name) {
-  return engine_->getStatusOutput(name);
+  return telemetry_->getStatusOutput(name);
 }
 
 vital::Wavetable* SynthBase::getWavetable(int index) {
@@ -291,6 +349,10 @@ vital::Sample* SynthBase::getSample() {
   return engine_->getSample();
 }
 
+vital::Convolver* SynthBase::getReverbConvolver() {
+  return engine_->getReverbConvolver();
+}
+
 LineGenerator* SynthBase::getLfoSource(int index) {
   return engine_->getLfoSource(index);
 }
@@ -312,13 +374,15 @@ void SynthBase::initEngine() {
     engine_->getSample()->init();
   }
 
+  engine_->getReverbConvolver()->clearImpulse();
+
   for (int i = 0; i < vital::kNumLfos; ++i)
     getLfoSource(i)->initTriangle();
 
-  vital::control_map controls = engine_->getControls();
-  for (auto& control : controls) {
-    vital::ValueDetails details = vital::Parameters::getDetails(control.first);
-    control.second->set(details.default_value);
+  int num_parameters = static_cast<int>(control_list_.size());
+  for (int i = 0; i < num_parameters; ++i) {
+    if (control_list_[i])
+      control_list_[i]->set(vital::Parameters::getDetails(i)->default_value);
   }
   checkOversampling();
 
@@ -356,7 +420,16 @@ bool SynthBase::loadFromFile(File preset, std::string& error) {
     return false;
   
   try {
-    json parsed_json_state = json::parse(preset.loadFileAsString().toStdString(), nullptr);
+    json parsed_json_state;
+    if (BinaryPreset::isBinaryPreset(preset)) {
+      if (!BinaryPreset::readFromFile(preset, parsed_json_state)) {
+        error = "Preset file is corrupted.";
+        return false;
+      }
+    }
+    else
+      parsed_json_state = json::parse(preset.loadFileAsString().toStdString(), nullptr);
+
     if (!loadFromJson(parsed_json_state)) {
       error = "Preset was created with a newer version.";
       return false;
@@ -380,9 +453,59 @@ bool SynthBase::loadFromFile(File preset, std::string& error) {
   return true;
 }
 
-void SynthBase::renderAudioToFile(File file, float seconds, float bpm, std::vector<int> notes, bool render_images) {
+// The realtime path plays a second of silence so smoothed controls and effect state match a synth
+// that's been running. The fast path jumps smoothed controls to their targets and only plays long
+// enough for the effect delay glides to land. Returns the time the render should start from.
+double SynthBase::warmUpForRender(bool fast) {
+  static constexpr int kBufferSize = 64;
+  static constexpr double kSettleSeconds = 0.25;
+
+  int buffer_size = kBufferSize;
+  int pre_process_samples = getSampleRate();
+  if (fast) {
+    for (auto& control : controls_)
+      control.second->settle();
+
+    buffer_size = vital::kMaxBufferSize;
+    pre_process_samples = kSettleSeconds * getSampleRate();
+  }
+
+  double sample_time = 1.0 / getSampleRate();
+  double current_time = -pre_process_samples * sample_time;
+
+  for (int samples = 0; samples < pre_process_samples; samples += buffer_size) {
+    engine_->correctToTime(current_time);
+    current_time += buffer_size * sample_time;
+    engine_->process(buffer_size);
+  }
+
+  return current_time;
+}
+
+vital::Profiler* SynthBase::getEngineProfiler() {
+  return engine_->profiler();
+}
+
+void SynthBase::startRenderProfile() {
+  if (render_profile_report_)
+    engine_->profiler()->setEnabled(true);
+}
+
+void SynthBase::readRenderProfile() {
+  if (render_profile_report_)
+    render_profile_report_->read(engine_->profiler());
+}
+
+void SynthBase::stopRenderProfile() {
+  if (render_profile_report_) {
+    engine_->profiler()->setEnabled(false);
+    render_profile_report_->read(engine_->profiler());
+  }
+}
+
+void SynthBase::renderAudioToFile(File file, float seconds, float bpm, std::vector<int> notes,
+                                  bool render_images, bool fast) {
   static constexpr int kSampleRate = 44100;
-  static constexpr int kPreProcessSamples = 44100;
   static constexpr int kFadeSamples = 200;
   static constexpr int kBufferSize = 64;
   static constexpr int kVideoRate = 30;
@@ -393,20 +516,17 @@ void SynthBase::renderAudioToFile(File file, float seconds, float bpm, std::vect
   static constexpr float kFadeRatio = 0.3f;
 
   ScopedLock lock(getCriticalSection());
+  ScopedOfflineRender offline_render(engine_.get());
 
-  processModulationChanges();
+  flushModulationChanges();
   engine_->setSampleRate(kSampleRate);
   engine_->setBpm(bpm);
   engine_->updateAllModulationSwitches();
 
+  int buffer_size = fast ? vital::kMaxBufferSize : kBufferSize;
   double sample_time = 1.0 / getSampleRate();
-  double current_time = -kPreProcessSamples * sample_time;
-
-  for (int samples = 0; samples < kPreProcessSamples; samples += kBufferSize) {
-    engine_->correctToTime(current_time);
-    current_time += kBufferSize * sample_time;
-    engine_->process(kBufferSize);
-  }
+  double current_time = warmUpForRender(fast);
+  startRenderProfile();
 
   for (int note : notes)
     engine_->noteOn(note, 0.7f, 0, 0);
@@ -418,8 +538,8 @@ void SynthBase::renderAudioToFile(File file, float seconds, float bpm, std::vect
 
   int on_samples = seconds * kSampleRate;
   int total_samples = on_samples + seconds * kSampleRate * kFadeRatio;
-  std::unique_ptr<float[]> left_buffer = std::make_unique<float[]>(kBufferSize);
-  std::unique_ptr<float[]> right_buffer = std::make_unique<float[]>(kBufferSize);
+  std::unique_ptr<float[]> left_buffer = std::make_unique<float[]>(buffer_size);
+  std::unique_ptr<float[]> right_buffer = std::make_unique<float[]>(buffer_size);
   float* buffers[2] = { left_buffer.get(), right_buffer.get() };
   const vital::mono_float* engine_output = (const vital::mono_float*)engine_->output(0)->buffer;
 
@@ -429,28 +549,29 @@ void SynthBase::renderAudioToFile(File file, float seconds, float bpm, std::vect
   File images_folder = File::getCurrentWorkingDirectory().getChildFile("images");
   if (!images_folder.exists() && render_images)
     images_folder.createDirectory();
-  const vital::poly_float* memory = getOscilloscopeMemory();
+  const vital::poly_float* memory = oscilloscope_memory_;
 #endif
 
-  for (int samples = 0; samples < total_samples; samples += kBufferSize) {
+  for (int samples = 0; samples < total_samples; samples += buffer_size) {
     engine_->correctToTime(current_time);
-    current_time += kBufferSize * sample_time;
-    engine_->process(kBufferSize);
-    updateMemoryOutput(kBufferSize, engine_->output(0)->buffer);
+    current_time += buffer_size * sample_time;
+    engine_->process(buffer_size);
+    readRenderProfile();
+    updateMemoryOutput(buffer_size, engine_->output(0)->buffer);
 
-    if (on_samples > samples && on_samples <= samples + kBufferSize) {
+    if (on_samples > samples && on_samples <= samples + buffer_size) {
       for (int note : notes)
         engine_->noteOff(note, 0.5f, 0, 0);
     }
 
-    for (int i = 0; i < kBufferSize; ++i) {
+    for (int i = 0; i < buffer_size; ++i) {
       vital::mono_float t = (total_samples - samples) / (1.0f * kFadeSamples);
       t = vital::utils::min(t, 1.0f);
       left_buffer[i] = t * engine_output[vital::poly_float::kSize * i];
       right_buffer[i] = t * engine_output[vital::poly_float::kSize * i + 1];
     }
 
-    writer->writeFromFloatArrays(buffers, 2, kBufferSize);
+    writer->writeFromFloatArrays(buffers, 2, buffer_size);
 
   #if JUCE_MODULE_AVAILABLE_juce_graphics
     int image_index = (samples * kVideoRate) / kSampleRate;
@@ -498,6 +619,7 @@ void SynthBase::renderAudioToFile(File file, float seconds, float bpm, std::vect
   #endif
   }
 
+  stopRenderProfile();
   writer->flush();
   file_stream->flush();
 
@@ -505,22 +627,87 @@ void SynthBase::renderAudioToFile(File file, float seconds, float bpm, std::vect
   file_stream.release();
 }
 
-void SynthBase::renderAudioForResynthesis(float* data, int samples, int note) {
-  static constexpr int kPreProcessSamples = 44100;
+bool SynthBase::renderSequenceToFile(File file, const MidiMessageSequence& sequence, double seconds, float bpm,
+                                     int sample_rate, int bit_depth, bool fast) {
+  static constexpr int kFadeSamples = 200;
   static constexpr int kBufferSize = 64;
 
   ScopedLock lock(getCriticalSection());
+  ScopedOfflineRender offline_render(engine_.get());
 
-  double sample_time = 1.0 / getSampleRate();
-  double current_time = -kPreProcessSamples * sample_time;
+  file.deleteFile();
+  std::unique_ptr<FileOutputStream> file_stream = file.createOutputStream();
+  if (file_stream == nullptr)
+    return false;
 
+  WavAudioFormat wav_format;
+  std::unique_ptr<AudioFormatWriter> writer(wav_format.createWriterFor(file_stream.get(), sample_rate,
+                                                                       2, bit_depth, {}, 0));
+  if (writer == nullptr)
+    return false;
+  file_stream.release();
+
+  flushModulationChanges();
   engine_->allSoundsOff();
-  for (int s = 0; s < kPreProcessSamples; s += kBufferSize) {
+  engine_->setSampleRate(sample_rate);
+  engine_->setBpm(bpm);
+  engine_->updateAllModulationSwitches();
+
+  int buffer_size = fast ? vital::kMaxBufferSize : kBufferSize;
+  double sample_time = 1.0 / sample_rate;
+  double current_time = warmUpForRender(fast);
+  startRenderProfile();
+
+  int64 total_samples = static_cast<int64>(seconds * sample_rate);
+  float left_buffer[vital::kMaxBufferSize];
+  float right_buffer[vital::kMaxBufferSize];
+  float* buffers[2] = { left_buffer, right_buffer };
+  const vital::mono_float* engine_output = (const vital::mono_float*)engine_->output(0)->buffer;
+
+  int event_index = 0;
+  int num_events = sequence.getNumEvents();
+  for (int64 samples = 0; samples < total_samples; samples += buffer_size) {
+    int num_samples = static_cast<int>(std::min<int64>(buffer_size, total_samples - samples));
+
+    for (; event_index < num_events; ++event_index) {
+      const MidiMessage& message = sequence.getEventPointer(event_index)->message;
+      int64 event_sample = static_cast<int64>(message.getTimeStamp() * sample_rate);
+      if (event_sample >= samples + num_samples)
+        break;
+
+      midi_manager_->processMidiMessage(message, static_cast<int>(std::max<int64>(0, event_sample - samples)));
+    }
+
     engine_->correctToTime(current_time);
-    current_time += kBufferSize * sample_time;
-    engine_->process(kBufferSize);
+    current_time += num_samples * sample_time;
+    engine_->process(num_samples);
+    readRenderProfile();
+
+    for (int i = 0; i < num_samples; ++i) {
+      vital::mono_float t = (total_samples - samples - i) / (1.0f * kFadeSamples);
+      t = vital::utils::min(t, 1.0f);
+      left_buffer[i] = t * engine_output[vital::poly_float::kSize * i];
+      right_buffer[i] = t * engine_output[vital::poly_float::kSize * i + 1];
+    }
+
+    writer->writeFromFloatArrays(buffers, 2, num_samples);
   }
 
+  stopRenderProfile();
+  engine_->allSoundsOff();
+  return writer->flush();
+}
+
+void SynthBase::renderAudioForResynthesis(float* data, int samples, int note) {
+  static constexpr int kBufferSize = 64;
+
+  ScopedLock lock(getCriticalSection());
+
+  double sample_time = 1.0 / getSampleRate();
+
+  engine_->allSoundsOff();
+  double current_time = warmUpForRender(false);
+
   engine_->noteOn(note, 0.7f, 0, 0);
   const vital::poly_float* engine_output = engine_->output(0)->buffer;
   float max_value = 0.01f;
@@ -606,6 +793,7 @@ void SynthBase::writeAudio(AudioSampleBuffer* buffer, int channels, int samples,
   }
 
   updateMemoryOutput(samples, engine_->output(0)->buffer);
+  telemetry_->publish(samples, oscilloscope_memory_, oscilloscope_version_);
 }
 
 void SynthBase::processMidi(MidiBuffer& midi_messages, int start_sample, int end_sample) {
@@ -621,7 +809,118 @@ void SynthBase::processKeyboardEvents(MidiBuffer& buffer, int num_samples) {
   midi_manager_->replaceKeyboardMessages(buffer, num_samples);
 }
 
+void SynthBase::queueValueChange(int id, vital::mono_float value, int sample) {
+  // Value and sample share one word so a change from another thread can't pair one's value with the other's sample.
+  uint32_t value_bits = 0;
+  memcpy(&value_bits, &value, sizeof(value_bits));
+  queued_value_changes_[id] = (static_cast<uint64_t>(static_cast<uint32_t>(sample)) << 32) | value_bits;
+  value_change_flags_[id] = true;
+  value_changes_queued_ = true;
+}
+
+bool SynthBase::getQueuedValue(int id, vital::mono_float& value) const {
+  if (!value_change_flags_[id].load(std::memory_order_acquire))
+    return false;
+
+  uint32_t value_bits = static_cast<uint32_t>(queued_value_changes_[id].load());
+  memcpy(&value, &value_bits, sizeof(value_bits));
+  return true;
+}
+
+bool SynthBase::collectValueChanges(int num_samples) {
+  block_samples_ = num_samples;
+  if (!value_changes_queued_.exchange(false))
+    return false;
+
+  int last_sample = std::max(0, num_samples - 1);
+  int num_parameters = static_cast<int>(control_list_.size());
+  for (int i = 0; i < num_parameters; ++i) {
+    if (!value_change_flags_[i].load(std::memory_order_relaxed) || !value_change_flags_[i].exchange(false))
+      continue;
+
+    uint64_t packed = queued_value_changes_[i];
+    uint32_t value_bits = static_cast<uint32_t>(packed);
+    vital::control_change change;
+    change.control = control_list_[i];
+    memcpy(&change.value, &value_bits, sizeof(value_bits));
+    change.sample = static_cast<int32_t>(packed >> 32);
+    if (change.sample != kRampedSample)
+      change.sample = vital::utils::iclamp(change.sample, 0, last_sample);
+
+    VITAL_ASSERT(change.control);
+    if (change.control)
+      block_value_changes_.push_back(change);
+  }
+
+  block_value_changes_.sort<compareValueChangeSamples>();
+  return true;
+}
+
+int SynthBase::applyValueChanges(int start_sample, int end_sample) {
+  bool changed = false;
+  while (block_value_changes_.size() && block_value_changes_.front().sample <= start_sample) {
+    vital::control_change change = block_value_changes_.pop_front();
+    if (change.sample == kRampedSample)
+      change.control->ramp(change.value, block_samples_);
+    else
+      change.control->set(change.value);
+    if (change.control == control_list_[mod_wheel_id_])
+      engine_->setModWheelAllChannels(change.value);
+    else if (change.control == control_list_[pitch_wheel_id_])
+      engine_->setZonedPitchWheel(change.value, 0, vital::kNumMidiChannels - 1);
+    changed = true;
+  }
+
+  if (changed)
+    engine_->wake();
+
+  if (block_value_changes_.size())
+    return std::min(end_sample, block_value_changes_.front().sample);
+  return end_sample;
+}
+
+int SynthBase::getNextMidiLearnSample(const MidiBuffer& buffer, int start_sample, int end_sample) {
+  int first_sample = start_sample + kMinMidiLearnSamples;
+  for (auto iter = buffer.findNextSamplePosition(first_sample); iter != buffer.cend(); ++iter) {
+    const MidiMessageMetadata message = *iter;
+    if (message.samplePosition >= end_sample)
+      break;
+
+    if (message.numBytes > 1 && (message.data[0] & 0xf0) == MidiManager::kController &&
+        midi_manager_->isControllerMapped(message.data[1])) {
+      return message.samplePosition;
+    }
+  }
+  return end_sample;
+}
+
+bool SynthBase::flushValueChanges() {
+  bool collected = collectValueChanges(1);
+  applyValueChanges(0, 1);
+  return collected;
+}
+
 void SynthBase::processModulationChanges() {
+  // The message thread is compiling a connection, the changes wait for the next block.
+  std::unique_lock<std::mutex> lock(engine_->getModulationGraphMutex(), std::try_to_lock);
+  if (!lock.owns_lock())
+    return;
+
+  engine_->finishModulationFades();
+
+  vital::modulation_change change;
+  for (int i = 0; i < vital::kMaxModulationChangesPerBlock && getNextModulationChange(change); ++i) {
+    if (change.disconnecting)
+      engine_->fadeOutModulation(change);
+    else
+      engine_->connectModulation(change);
+  }
+}
+
+void SynthBase::flushModulationChanges() {
+  std::lock_guard<std::mutex> lock(engine_->getModulationGraphMutex());
+  engine_->finishModulationFades();
+
   vital::modulation_change change;
   while (getNextModulationChange(change)) {
     if (change.disconnecting)
@@ -656,6 +955,7 @@ void SynthBase::updateMemoryOutput(int samples, const vital::poly_float* audio)
     memory_reset_period_ = std::min(memory_reset_period_, 2.0f * window_length);
     memory_index_ = 0;
     vital::utils::copyBuffer(oscilloscope_memory_, oscilloscope_memory_write_, oscilloscope_samples);
+    oscilloscope_version_++;
   }
   last_num_pressed_ = num_pressed;
 
@@ -672,6 +972,7 @@ void SynthBase::updateMemoryOutput(int samples, const vital::poly_float* audio)
       memory_input_offset_ += memory_reset_period_ - memory_index_ * output_inc;
       memory_index_ = 0;
       vital::utils::copyBuffer(oscilloscope_memory_, oscilloscope_memory_write_, oscilloscope_samples);
+      oscilloscope_version_++;
     }
   }
 
@@ -737,10 +1038,16 @@ String SynthBase::getMacroName(int index) {
   return name;
 }
 
-const vital::StereoMemory* SynthBase::getEqualizerMemory() {
-  if (engine_)
-    return engine_->getEqualizerMemory();
-  return nullptr;
+const vital::poly_float* SynthBase::getOscilloscopeMemory() {
+  return telemetry_->getOscilloscopeMemory();
+}
+
+const MemoryReadout* SynthBase::getAudioMemory() {
+  return telemetry_->getAudioMemory();
+}
+
+const MemoryReadout* SynthBase::getEqualizerMemory() {
+  return telemetry_->getEqualizerMemory();
 }
 
 vital::ModulationConnectionBank& SynthBase::getModulationBank() {
@@ -758,12 +1065,22 @@ void SynthBase::checkOversampling() {
   return engine_->checkOversampling();
 }
 
+void SynthBase::checkOutputMemory() {
+  if (!engine_->needsOutputArenaTrim())
+    return;
+
+  pauseProcessing(true);
+  engine_->trimOutputArena();
+  pauseProcessing(false);
+}
+
 void SynthBase::ValueChangedCallback::messageCallback() {
   if (auto synth_base = listener.lock()) {
     SynthGuiInterface* gui_interface = (*synth_base)->getGuiInterface();
     if (gui_interface) {
-      gui_interface->updateGuiControl(control_name, value);
-      if (control_name != "pitch_wheel")
+      const std::string& name = vital::Parameters::getDetails(control_id)->name;
+      gui_interface->updateGuiControl(name, value);
+      if (control_id != (*synth_base)->pitch_wheel_id_)
         gui_interface->notifyChange();
     }
   }
@@ -22,13 +22,16 @@
 #include "synth_constants.h"
 #include "synth_types.h"
 #include "midi_manager.h"
+#include "profile_report.h"
 #include "tuning.h"
 #include "wavetable_creator.h"
 
+#include <atomic>
 #include <set>
 #include <string>
 
 namespace vital {
+  class Convolver;
   class SoundEngine;
   struct Output;
   class StatusOutput;
@@ -38,18 +41,23 @@ namespace vital {
   class Wavetable;
 }
 
+class EngineTelemetry;
+class MemoryReadout;
 class SynthGuiInterface;
 
 class SynthBase : public MidiManager::Listener {
   public:
     static constexpr float kOutputWindowMinNote = 16.0f;
     static constexpr float kOutputWindowMaxNote = 128.0f;
+    static constexpr int kRampedSample = -1;
+    static constexpr int kMinMidiLearnSamples = 32;
 
     SynthBase();
     virtual ~SynthBase();
 
     void valueChanged(const std::string& name, vital::mono_float value);
-    void valueChangedThroughMidi(const std::string& name, vital::mono_float value) override;
+    void valueChanged(int id, vital::mono_float value);
+    void valueChangedThroughMidi(const vital::ValueDetails& details, vital::mono_float value) override;
     void pitchWheelMidiChanged(vital::mono_float value) override;
     void modWheelMidiChanged(vital::mono_float value) override;
     void pitchWheelGuiChanged(vital::mono_float value);
@@ -76,6 +84,7 @@ class SynthBase : public MidiManager::Listener {
     vital::Wavetable* getWavetable(int index);
     WavetableCreator* getWavetableCreator(int index);
     vital::Sample* getSample();
+    vital::Convolver* getReverbConvolver();
     LineGenerator* getLfoSource(int index);
 
     int getSampleRate();
@@ -83,8 +92,16 @@ class SynthBase : public MidiManager::Listener {
     void loadTuningFile(const File& file);
     void loadInitPreset();
     bool loadFromFile(File preset, std::string& error);
-    void renderAudioToFile(File file, float seconds, float bpm, std::vector<int> notes, bool render_images);
+    void renderAudioToFile(File file, float seconds, float bpm, std::vector<int> notes, bool render_images,
+                           bool fast = false);
+    bool renderSequenceToFile(File file, const MidiMessageSequence& sequence, double seconds, float bpm,
+                              int sample_rate, int bit_depth, bool fast = false);
     void renderAudioForResynthesis(float* data, int samples, int note);
+
+    // Offline renders profile the engine into report while it's set. Realtime callers can enable
+    // getEngineProfiler() themselves and drain it from another thread.
+    void setRenderProfileReport(ProfileReport* report) { render_profile_report_ = report; }
+    vital::Profiler* getEngineProfiler();
     bool saveToFile(File preset);
     bool saveToActiveFile();
     void clearActiveFile() { active_file_ = File(); }
@@ -93,7 +110,7 @@ class SynthBase : public MidiManager::Listener {
     void setMpeEnabled(bool enabled);
     virtual void beginChangeGesture(const std::string& name) { }
     virtual void endChangeGesture(const std::string& name) { }
-    virtual void setValueNotifyHost(const std::string& name, vital::mono_float value) { }
+    virtual void setValueNotifyHost(int id, vital::mono_float value) { }
 
     void armMidiLearn(const std::string& name);
     void cancelMidiLearn();
@@ -112,26 +129,31 @@ class SynthBase : public MidiManager::Listener {
     String getMacroName(int index);
 
     vital::control_map& getControls() { return controls_; }
+    vital::Value* getControl(int id) { return control_list_[id]; }
     vital::SoundEngine* getEngine() { return engine_.get(); }
     MidiKeyboardState* getKeyboardState() { return keyboard_state_.get(); }
-    const vital::poly_float* getOscilloscopeMemory() { return oscilloscope_memory_; }
-    const vital::StereoMemory* getAudioMemory() { return audio_memory_.get(); }
-    const vital::StereoMemory* getEqualizerMemory();
+    EngineTelemetry* getTelemetry() { return telemetry_.get(); }
+    const vital::poly_float* getOscilloscopeMemory();
+    const MemoryReadout* getAudioMemory();
+    const MemoryReadout* getEqualizerMemory();
     vital::ModulationConnectionBank& getModulationBank();
     void notifyOversamplingChanged();
     void checkOversampling();
+    // Polled from a message thread timer. Frees parked module buffers once toggles settle and hands
+    // buffers to modules that are waiting for them.
+    void checkOutputMemory();
     virtual const CriticalSection& getCriticalSection() = 0;
     virtual void pauseProcessing(bool pause) = 0;
     Tuning* getTuning() { return &tuning_; }
 
     struct ValueChangedCallback : public CallbackMessage {
-      ValueChangedCallback(std::shared_ptr<SynthBase*> listener, std::string name, vital::mono_float val) :
-          listener(listener), control_name(std::move(name)), value(val) { }
+      ValueChangedCallback(std::shared_ptr<SynthBase*> listener, int id, vital::mono_float val) :
+          listener(listener), control_id(id), value(val) { }
 
       void messageCallback() override;
 
       std::weak_ptr<SynthBase*> listener;
-      std::string control_name;
+      int control_id;
       vital::mono_float value;
     };
 
@@ -146,21 +168,41 @@ class SynthBase : public MidiManager::Listener {
     inline bool getNextModulationChange(vital::modulation_change& change) {
       return modulation_change_queue_.try_dequeue_non_interleaved(change);
     }
-  
-    inline void clearModulationQueue() {
-      vital::modulation_change change;
-      while (modulation_change_queue_.try_dequeue_non_interleaved(change))
-        ;
-    }
 
+    // Safe from any thread and never allocates. Each parameter keeps only its latest queued change, which the
+    // audio thread applies at sample in its next block. Changes without a sample ramp to their value across
+    // that block. JUCE doesn't pass sample offsets with host automation, so host changes always ramp.
+    void queueValueChange(int id, vital::mono_float value, int sample = kRampedSample);
+    // Returns true with the value of the change queued for id if the audio thread hasn't picked it up yet.
+    bool getQueuedValue(int id, vital::mono_float& value) const;
+    // Moves queued changes into this block's list, ordered by sample. Returns false if nothing was queued.
+    bool collectValueChanges(int num_samples);
+    // Applies this block's changes up to start_sample and returns where the next one lands, at most end_sample.
+    int applyValueChanges(int start_sample, int end_sample);
+    // Returns the first midi learned controller at least kMinMidiLearnSamples after start_sample and before
+    // end_sample, or end_sample. Closer controllers apply at start_sample so dense ones can't shrink sub-blocks.
+    int getNextMidiLearnSample(const MidiBuffer& buffer, int start_sample, int end_sample);
+    // Applies every queued change now and returns false if there were none. Only call while holding the lock
+    // the audio thread renders under.
+    bool flushValueChanges();
+  
     void processAudio(AudioSampleBuffer* buffer, int channels, int samples, int offset);
     void processAudioWithInput(AudioSampleBuffer* buffer, const vital::poly_float* input_buffer,
                                int channels, int samples, int offset);
     void writeAudio(AudioSampleBuffer* buffer, int channels, int samples, int offset);
     void processMidi(MidiBuffer& buffer, int start_sample = 0, int end_sample = 0);
     void processKeyboardEvents(MidiBuffer& buffer, int num_samples);
+    // Applies at most kMaxModulationChangesPerBlock queued changes, fading disconnections out over a block.
+    // Connections are compiled when they're queued, so this only plugs inputs. If the message thread is
+    // compiling one, the changes wait for the next block.
     void processModulationChanges();
+    // Applies every queued change at once, for offline rendering and while processing is paused.
+    void flushModulationChanges();
+    double warmUpForRender(bool fast);
     void updateMemoryOutput(int samples, const vital::poly_float* audio);
+    void startRenderProfile();
+    void readRenderProfile();
+    void stopRenderProfile();
 
     std::unique_ptr<vital::SoundEngine> engine_;
     std::unique_ptr<MidiManager> midi_manager_;
@@ -173,17 +215,27 @@ class SynthBase : public MidiManager::Listener {
     vital::poly_float oscilloscope_memory_[2 * vital::kOscilloscopeMemoryResolution];
     vital::poly_float oscilloscope_memory_write_[2 * vital::kOscilloscopeMemoryResolution];
     std::unique_ptr<vital::StereoMemory> audio_memory_;
+    std::unique_ptr<EngineTelemetry> telemetry_;
+    int oscilloscope_version_;
     vital::mono_float last_played_note_;
     int last_num_pressed_;
     vital::mono_float memory_reset_period_;
     vital::mono_float memory_input_offset_;
     int memory_index_;
     bool expired_;
+    ProfileReport* render_profile_report_;
 
     std::map<std::string, String> save_info_;
     vital::control_map controls_;
+    std::vector<vital::Value*> control_list_;
     vital::CircularQueue<vital::ModulationConnection*> mod_connections_;
-    moodycamel::ConcurrentQueue<vital::control_change> value_change_queue_;
+    std::unique_ptr<std::atomic<uint64_t>[]> queued_value_changes_;
+    std::unique_ptr<std::atomic<bool>[]> value_change_flags_;
+    std::atomic<bool> value_changes_queued_;
+    vital::CircularQueue<vital::control_change> block_value_changes_;
+    int block_samples_;
+    int mod_wheel_id_;
+    int pitch_wheel_id_;
     moodycamel::ConcurrentQueue<vital::modulation_change> modulation_change_queue_;
     Tuning tuning_;
 
@@ -35,6 +35,7 @@ namespace vital {
   constexpr int kMaxActivePolyphony = 32;
   constexpr int kLfoDataResolution = 2048;
   constexpr int kMaxModulationConnections = 64;
+  constexpr int kMaxModulationChangesPerBlock = 8;
 
   constexpr int kOscilloscopeMemorySampleRate = 22000;
   constexpr int kOscilloscopeMemoryResolution = 512;
@@ -16,6 +16,7 @@
 
 #include "synth_gui_interface.h"
 #include "authentication.h"
+#include "engine_telemetry.h"
 #include "modulation_connection_processor.h"
 #include "sound_engine.h"
 #include "load_save.h"
@@ -23,8 +24,8 @@
 
 SynthGuiData::SynthGuiData(SynthBase* synth_base) : synth(synth_base) {
   controls = synth->getControls();
-  mono_modulations = synth->getEngine()->getMonoModulations();
-  poly_modulations = synth->getEngine()->getPolyModulations();
+  mono_modulations = synth->getTelemetry()->getMonoModulations();
+  poly_modulations = synth->getTelemetry()->getPolyModulations();
   modulation_sources = synth->getEngine()->getModulationSources();
   for (int i = 0; i < vital::kNumOscillators; ++i)
     wavetable_creators[i] = synth->getWavetableCreator(i);
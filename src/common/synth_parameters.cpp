@@ -21,6 +21,7 @@
 #include "digital_svf.h"
 #include "synth_constants.h"
 #include "random_lfo.h"
+#include "reverb.h"
 #include "synth_lfo.h"
 #include "synth_oscillator.h"
 #include "synth_strings.h"
@@ -158,6 +159,8 @@ namespace vital {
       ValueDetails::kExponential, false, " Hz", "Reverb Chorus Frequency", nullptr },
     { "reverb_on", 0x000000, 0.0, 1.0, 0.0, 0.0, 1.0,
       ValueDetails::kIndexed, false, "", "Reverb Switch", strings::kOffOnNames },
+    { "reverb_mode", 0x010006, 0.0, vital::Reverb::kNumModes - 1, 0.0, 0.0, 1.0,
+      ValueDetails::kIndexed, false, "", "Reverb Mode", strings::kReverbModeNames },
     { "sub_on", 0x000000, 0.0, 1.0, 0.0, 0.0, 1.0,
       ValueDetails::kIndexed, false, "", "Sub Switch", strings::kOffOnNames },
     { "sub_direct_out", 0x000000, 0.0, 1.0, 0.0, 0.0, 1.0,
@@ -541,7 +544,7 @@ namespace vital {
     int num_parameters = sizeof(parameter_list) / sizeof(ValueDetails);
     for (int i = 0; i < num_parameters; ++i) {
       details_lookup_[parameter_list[i].name] = parameter_list[i];
-      details_list_.push_back(&parameter_list[i]);
+      details_list_.push_back(&details_lookup_[parameter_list[i].name]);
 
       VITAL_ASSERT(parameter_list[i].default_value <= parameter_list[i].max);
       VITAL_ASSERT(parameter_list[i].default_value >= parameter_list[i].min);
@@ -590,6 +593,10 @@ namespace vital {
     details_lookup_["filter_2_osc2_input"].default_value = 1.0f;
 
     std::sort(details_list_.begin(), details_list_.end(), compareValueDetails);
+
+    int num_details = static_cast<int>(details_list_.size());
+    for (int i = 0; i < num_details; ++i)
+      details_lookup_[details_list_[i]->name].id = i;
   }
 
   void ValueDetailsLookup::addParameterGroup(const ValueDetails* list, int num_parameters, int index,
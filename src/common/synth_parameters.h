@@ -50,6 +50,9 @@ namespace vital {
     std::string display_name;
     const std::string* string_lookup = nullptr;
     std::string local_description;
+
+    // Dense index into the parameter table. Only valid within one build so it's never saved.
+    int id = -1;
   } typedef ValueDetails;
 
   class ValueDetailsLookup {
@@ -69,6 +72,12 @@ namespace vital {
         return details_list_[index];
       }
 
+      int getId(const std::string& name) const {
+        auto details = details_lookup_.find(name);
+        VITAL_ASSERT(details != details_lookup_.end());
+        return details->second.id;
+      }
+
       std::string getDisplayName(const std::string& name) const {
         return getDetails(name).display_name;
       }
@@ -122,6 +131,10 @@ namespace vital {
         return lookup_.getDetails(index);
       }
 
+      static int getId(const std::string& name) {
+        return lookup_.getId(name);
+      }
+
       static std::string getDisplayName(const std::string& name) {
         return lookup_.getDisplayName(name);
       }
@@ -93,12 +93,23 @@ namespace vital {
     ValueSwitch* mono_modulation_switch;
     ValueSwitch* poly_modulation_switch;
     ModulationConnectionProcessor* modulation_processor;
+    Processor* destination;
+    const Output* modulation_input;
+    const Output* modulation_output;
+    int connection_id;
+    bool polyphonic;
+    bool audio_rate;
     bool disconnecting;
     int num_audio_rate;
   } modulation_change;
 
+  typedef struct {
+    Value* control;
+    mono_float value;
+    int sample;
+  } control_change;
+
   typedef std::map<std::string, Value*> control_map;
-  typedef std::pair<Value*, mono_float> control_change;
   typedef std::map<std::string, Processor*> input_map;
   typedef std::map<std::string, Output*> output_map;
 } // namespace vital
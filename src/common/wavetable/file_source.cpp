@@ -221,10 +221,10 @@ void FileSource::FileSourceKeyframe::jsonToState(json data) {
   window_size_ = data["window_size"];
 }
 
-FileSource::FileSource() : compute_frame_(&sample_buffer_), overridden_phase_(),
+FileSource::FileSource() : overridden_phase_(),
                            fade_style_(kWaveBlend), phase_style_(kNone),
                            normalize_gain_(false), normalize_mult_(false),
-                           random_generator_(-vital::kPi, vital::kPi) {
+                           random_generator_(-vital::kPi, vital::kPi), encoded_hash_(0) {
   window_size_ = vital::WaveFrame::kWaveformSize;
   random_seed_ = random_generator_.next() * (INT_MAX / vital::kPi);
 }
@@ -239,14 +239,17 @@ void FileSource::render(vital::WaveFrame* wave_frame, float position) {
   if (sample_buffer_.data == nullptr)
     wave_frame->clear();
   else {
-    interpolate(&compute_frame_, position);
-    compute_frame_.setWindowSize(window_size_);
-    compute_frame_.setFadeStyle(fade_style_);
-    compute_frame_.setPhaseStyle(phase_style_);
-    compute_frame_.setInterpolateFromFrame(&interpolate_from_frame_);
-    compute_frame_.setInterpolateToFrame(&interpolate_to_frame_);
-    compute_frame_.setOverriddenPhaseBuffer(overridden_phase_);
-    compute_frame_.render(wave_frame);
+    FileSourceKeyframe compute_frame(&sample_buffer_);
+    WaveSourceKeyframe interpolate_from_frame;
+    WaveSourceKeyframe interpolate_to_frame;
+    interpolate(&compute_frame, position);
+    compute_frame.setWindowSize(window_size_);
+    compute_frame.setFadeStyle(fade_style_);
+    compute_frame.setPhaseStyle(phase_style_);
+    compute_frame.setInterpolateFromFrame(&interpolate_from_frame);
+    compute_frame.setInterpolateToFrame(&interpolate_to_frame);
+    compute_frame.setOverriddenPhaseBuffer(overridden_phase_);
+    compute_frame.render(wave_frame);
     wave_frame->setFrequencyRatio(window_size_ / vital::WaveFrame::kWaveformSize);
     wave_frame->setSampleRate(sample_buffer_.sample_rate);
     if (normalize_mult_)
@@ -275,13 +278,19 @@ json FileSource::stateToJson() {
 
   int save_samples = max_position + 2 * window_size_ + kExtraSaveSamples;
   int num_samples = std::min(sample_buffer_.size, save_samples);
-  String encoded = "";
-  if (getDataBuffer()) {
+  if (getDataBuffer() == nullptr) {
+    data["audio_file"] = "";
+    return data;
+  }
+
+  uint64_t hash = vital::utils::hashData(getDataBuffer(), num_samples * sizeof(float));
+  if (encoded_audio_.empty() || hash != encoded_hash_) {
     std::unique_ptr<int16_t[]> pcm_data = std::make_unique<int16_t[]>(num_samples);
     vital::utils::floatToPcmData(pcm_data.get(), getDataBuffer(), num_samples);
-    encoded = Base64::toBase64(pcm_data.get(), num_samples * sizeof(int16_t));
+    encoded_audio_ = Base64::toBase64(pcm_data.get(), num_samples * sizeof(int16_t)).toStdString();
+    encoded_hash_ = hash;
   }
-  data["audio_file"] = encoded.toStdString();
+  data["audio_file"] = encoded_audio_;
   return data;
 }
 
@@ -312,12 +321,11 @@ void FileSource::jsonToState(json data) {
     sample_rate = data["audio_sample_rate"];
 
   MemoryOutputStream decoded;
-  std::string audio_data = data["audio_file"];
-  Base64::convertFromBase64(decoded, audio_data);
-
-  int size = static_cast<int>(decoded.getDataSize()) / sizeof(int16_t);
+  const void* bytes = nullptr;
+  int size = vital::utils::readDataString(data["audio_file"].get_ref<const std::string&>(), decoded, &bytes) /
+             sizeof(int16_t);
   std::unique_ptr<float[]> float_data = std::make_unique<float[]>(size);
-  vital::utils::pcmToFloatData(float_data.get(), (int16_t*)decoded.getData(), size);
+  vital::utils::pcmToFloatData(float_data.get(), static_cast<const int16_t*>(bytes), size);
   loadBuffer(float_data.get(), size, sample_rate);
 }
 
@@ -335,6 +343,7 @@ void FileSource::setPhaseStyle(PhaseStyle phase_style) {
     random_seed_++;
 
   writePhaseOverrideBuffer();
+  markEdited();
 }
 
 void FileSource::writePhaseOverrideBuffer() {
@@ -361,6 +370,7 @@ void FileSource::loadBuffer(const float* buffer, int size, int sample_rate) {
 
   for (int i = 1; i < kExtraBufferSamples; ++i)
     sample_buffer_.data[sample_buffer_.size + i] = sample_buffer_.data[size];
+  markEdited();
 }
 
 void FileSource::detectPitch(int max_period) {
@@ -134,9 +134,9 @@ class FileSource : public WavetableComponent {
     PhaseStyle getPhaseStyle() { return phase_style_; }
     bool getNormalizeGain() { return normalize_gain_; }
 
-    void setNormalizeGain(bool normalize_gain) { normalize_gain_ = normalize_gain; }
-    void setWindowSize(double window_size) { window_size_ = window_size; }
-    void setFadeStyle(FadeStyle fade_style) { fade_style_ = fade_style; }
+    void setNormalizeGain(bool normalize_gain) { normalize_gain_ = normalize_gain; markEdited(); }
+    void setWindowSize(double window_size) { window_size_ = window_size; markEdited(); }
+    void setFadeStyle(FadeStyle fade_style) { fade_style_ = fade_style; markEdited(); }
     void setPhaseStyle(PhaseStyle phase_style);
     void writePhaseOverrideBuffer();
     double getWindowSize() { return window_size_; }
@@ -153,10 +153,6 @@ class FileSource : public WavetableComponent {
     force_inline const float* getCubicInterpolationBuffer() { return sample_buffer_.data.get(); }
 
   protected:
-    FileSourceKeyframe compute_frame_;
-    WaveSourceKeyframe interpolate_from_frame_;
-    WaveSourceKeyframe interpolate_to_frame_;
-
     SampleBuffer sample_buffer_;
     float overridden_phase_[vital::WaveFrame::kWaveformSize];
     FadeStyle fade_style_;
@@ -169,6 +165,9 @@ class FileSource : public WavetableComponent {
     vital::utils::RandomGenerator random_generator_;
     PitchDetector pitch_detector_;
 
+    uint64_t encoded_hash_;
+    std::string encoded_audio_;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FileSource)
 };
 
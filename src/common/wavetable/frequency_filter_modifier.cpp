@@ -119,10 +119,11 @@ WavetableKeyframe* FrequencyFilterModifier::createKeyframe(int position) {
 }
 
 void FrequencyFilterModifier::render(vital::WaveFrame* wave_frame, float position) {
-  interpolate(&compute_frame_, position);
-  compute_frame_.setStyle(style_);
-  compute_frame_.setNormalize(normalize_);
-  compute_frame_.render(wave_frame);
+  FrequencyFilterModifierKeyframe compute_frame;
+  interpolate(&compute_frame, position);
+  compute_frame.setStyle(style_);
+  compute_frame.setNormalize(normalize_);
+  compute_frame.render(wave_frame);
 }
 
 WavetableComponentFactory::ComponentType FrequencyFilterModifier::getType() {
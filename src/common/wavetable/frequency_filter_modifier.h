@@ -74,13 +74,12 @@ class FrequencyFilterModifier : public WavetableComponent {
       FilterStyle getStyle() { return style_; }
       bool getNormalize() { return normalize_; }
 
-      void setStyle(FilterStyle style) { style_ = style; }
-      void setNormalize(bool normalize) { normalize_ = normalize; }
+      void setStyle(FilterStyle style) { style_ = style; markEdited(); }
+      void setNormalize(bool normalize) { normalize_ = normalize; markEdited(); }
 
     protected:
       FilterStyle style_;
       bool normalize_;
-      FrequencyFilterModifierKeyframe compute_frame_;
 
       JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrequencyFilterModifier)
 };
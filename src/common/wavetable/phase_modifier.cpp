@@ -101,9 +101,10 @@ WavetableKeyframe* PhaseModifier::createKeyframe(int position) {
 }
 
 void PhaseModifier::render(vital::WaveFrame* wave_frame, float position) {
-  compute_frame_.setPhaseStyle(phase_style_);
-  interpolate(&compute_frame_, position);
-  compute_frame_.render(wave_frame);
+  PhaseModifierKeyframe compute_frame;
+  compute_frame.setPhaseStyle(phase_style_);
+  interpolate(&compute_frame, position);
+  compute_frame.render(wave_frame);
 }
 
 WavetableComponentFactory::ComponentType PhaseModifier::getType() {
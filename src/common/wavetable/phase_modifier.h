@@ -67,11 +67,10 @@ class PhaseModifier : public WavetableComponent {
 
     PhaseModifierKeyframe* getKeyframe(int index);
 
-    void setPhaseStyle(PhaseStyle style) { phase_style_ = style; }
+    void setPhaseStyle(PhaseStyle style) { phase_style_ = style; markEdited(); }
     PhaseStyle getPhaseStyle() const { return phase_style_; }
 
   protected:
-    PhaseModifierKeyframe compute_frame_;
     PhaseStyle phase_style_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PhaseModifier)
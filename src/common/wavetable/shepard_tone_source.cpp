@@ -17,9 +17,7 @@
 #include "shepard_tone_source.h"
 #include "wavetable_component_factory.h"
 
-ShepardToneSource::ShepardToneSource() {
-  loop_frame_ = std::make_unique<WaveSourceKeyframe>();
-}
+ShepardToneSource::ShepardToneSource() { }
 
 ShepardToneSource::~ShepardToneSource() { }
 
@@ -29,7 +27,8 @@ void ShepardToneSource::render(vital::WaveFrame* wave_frame, float position) {
 
   WaveSourceKeyframe* keyframe = getKeyframe(0);
   vital::WaveFrame* key_wave_frame = keyframe->wave_frame();
-  vital::WaveFrame* loop_wave_frame = loop_frame_->wave_frame();
+  WaveSourceKeyframe loop_frame;
+  vital::WaveFrame* loop_wave_frame = loop_frame.wave_frame();
 
   for (int i = 0; i < vital::WaveFrame::kWaveformSize / 2; ++i) {
     loop_wave_frame->frequency_domain[i * 2] = key_wave_frame->frequency_domain[i];
@@ -38,9 +37,10 @@ void ShepardToneSource::render(vital::WaveFrame* wave_frame, float position) {
 
   loop_wave_frame->toTimeDomain();
 
-  compute_frame_->setInterpolationMode(interpolation_mode_);
-  compute_frame_->interpolate(keyframe, loop_frame_.get(), position / (vital::kNumOscillatorWaveFrames - 1.0f));
-  wave_frame->copy(compute_frame_->wave_frame());
+  WaveSourceKeyframe compute_frame;
+  compute_frame.setInterpolationMode(interpolation_mode_);
+  compute_frame.interpolate(keyframe, &loop_frame, position / (vital::kNumOscillatorWaveFrames - 1.0f));
+  wave_frame->copy(compute_frame.wave_frame());
 }
 
 WavetableComponentFactory::ComponentType ShepardToneSource::getType() {
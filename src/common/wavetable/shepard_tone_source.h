@@ -28,8 +28,6 @@ class ShepardToneSource : public WaveSource {
     virtual WavetableComponentFactory::ComponentType getType() override;
     virtual bool hasKeyframes() override { return false; }
 
-  protected: 
-    std::unique_ptr<WaveSourceKeyframe> loop_frame_;
-
+  protected:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ShepardToneSource)
 };
\ No newline at end of file
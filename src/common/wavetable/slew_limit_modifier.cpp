@@ -80,8 +80,9 @@ WavetableKeyframe* SlewLimitModifier::createKeyframe(int position) {
 }
 
 void SlewLimitModifier::render(vital::WaveFrame* wave_frame, float position) {
-  interpolate(&compute_frame_, position);
-  compute_frame_.render(wave_frame);
+  SlewLimitModifierKeyframe compute_frame;
+  interpolate(&compute_frame, position);
+  compute_frame.render(wave_frame);
 }
 
 WavetableComponentFactory::ComponentType SlewLimitModifier::getType() {
@@ -56,7 +56,6 @@ class SlewLimitModifier : public WavetableComponent {
     SlewLimitModifierKeyframe* getKeyframe(int index);
 
   protected:
-    SlewLimitModifierKeyframe compute_frame_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SlewLimitModifier)
 };
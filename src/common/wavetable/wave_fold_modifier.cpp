@@ -67,8 +67,9 @@ WavetableKeyframe* WaveFoldModifier::createKeyframe(int position) {
 }
 
 void WaveFoldModifier::render(vital::WaveFrame* wave_frame, float position) {
-  interpolate(&compute_frame_, position);
-  compute_frame_.render(wave_frame);
+  WaveFoldModifierKeyframe compute_frame;
+  interpolate(&compute_frame, position);
+  compute_frame.render(wave_frame);
 }
 
 WavetableComponentFactory::ComponentType WaveFoldModifier::getType() {
@@ -52,7 +52,6 @@ class WaveFoldModifier : public WavetableComponent {
     WaveFoldModifierKeyframe* getKeyframe(int index);
 
   protected:
-    WaveFoldModifierKeyframe compute_frame_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveFoldModifier)
 };
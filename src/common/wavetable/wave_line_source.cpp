@@ -97,8 +97,9 @@ WavetableKeyframe* WaveLineSource::createKeyframe(int position) {
 }
 
 void WaveLineSource::render(vital::WaveFrame* wave_frame, float position) {
-  interpolate(&compute_frame_, position);
-  compute_frame_.render(wave_frame);
+  WaveLineSourceKeyframe compute_frame;
+  interpolate(&compute_frame, position);
+  compute_frame.render(wave_frame);
 }
 
 WavetableComponentFactory::ComponentType WaveLineSource::getType() {
@@ -118,6 +119,7 @@ void WaveLineSource::jsonToState(json data) {
 
 void WaveLineSource::setNumPoints(int num_points) {
   num_points_ = num_points;
+  markEdited();
 }
 
 WaveLineSource::WaveLineSourceKeyframe* WaveLineSource::getKeyframe(int index) {
@@ -56,7 +56,7 @@ class WaveLineSource : public WavetableComponent {
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveLineSourceKeyframe)
     };
 
-    WaveLineSource() : num_points_(kDefaultLinePoints), compute_frame_() { }
+    WaveLineSource() : num_points_(kDefaultLinePoints) { }
     virtual ~WaveLineSource() = default;
 
     virtual WavetableKeyframe* createKeyframe(int position) override;
@@ -71,7 +71,6 @@ class WaveLineSource : public WavetableComponent {
 
   protected:
     int num_points_;
-    WaveLineSourceKeyframe compute_frame_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveLineSource)
 };
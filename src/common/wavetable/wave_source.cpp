@@ -19,7 +19,6 @@
 #include "wavetable_component_factory.h"
 
 WaveSource::WaveSource() {
-  compute_frame_ = std::make_unique<WaveSourceKeyframe>();
   interpolation_mode_ = kFrequency;
 }
 
@@ -32,9 +31,10 @@ WavetableKeyframe* WaveSource::createKeyframe(int position) {
 }
 
 void WaveSource::render(vital::WaveFrame* wave_frame, float position) {
-  compute_frame_->setInterpolationMode(interpolation_mode_);
-  interpolate(compute_frame_.get(), position);
-  wave_frame->copy(compute_frame_->wave_frame());
+  WaveSourceKeyframe compute_frame;
+  compute_frame.setInterpolationMode(interpolation_mode_);
+  interpolate(&compute_frame, position);
+  wave_frame->copy(compute_frame.wave_frame());
 }
 
 WavetableComponentFactory::ComponentType WaveSource::getType() {
@@ -50,7 +50,6 @@ json WaveSource::stateToJson() {
 void WaveSource::jsonToState(json data) {
   WavetableComponent::jsonToState(data);
   interpolation_mode_ = data["interpolation"];
-  compute_frame_->setInterpolationMode(interpolation_mode_);
 }
 
 vital::WaveFrame* WaveSource::getWaveFrame(int index) {
@@ -191,18 +190,34 @@ void WaveSourceKeyframe::smoothInterpolate(const WavetableKeyframe* prev_keyfram
 }
 
 json WaveSourceKeyframe::stateToJson() {
-  String encoded = Base64::toBase64(wave_frame_->time_domain, sizeof(float) * vital::WaveFrame::kWaveformSize);
+  static constexpr size_t kDataSize = sizeof(float) * vital::WaveFrame::kWaveformSize;
+
+  uint64_t hash = vital::utils::hashData(wave_frame_->time_domain, kDataSize);
+  if (encoded_data_.empty() || hash != encoded_hash_) {
+    encoded_data_ = Base64::toBase64(wave_frame_->time_domain, kDataSize).toStdString();
+    encoded_hash_ = hash;
+  }
+
   json data = WavetableKeyframe::stateToJson();
-  data["wave_data"] = encoded.toStdString();
+  data["wave_data"] = encoded_data_;
   return data;
 }
 
 void WaveSourceKeyframe::jsonToState(json data) {
+  static constexpr size_t kDataSize = sizeof(float) * vital::WaveFrame::kWaveformSize;
   WavetableKeyframe::jsonToState(data);
 
-  MemoryOutputStream decoded(sizeof(float) * vital::WaveFrame::kWaveformSize);
-  std::string wave_data = data["wave_data"];
-  Base64::convertFromBase64(decoded, wave_data);
-  memcpy(wave_frame_->time_domain, decoded.getData(), sizeof(float) * vital::WaveFrame::kWaveformSize);
+  MemoryOutputStream decoded(kDataSize);
+  const std::string& wave_data = data["wave_data"].get_ref<const std::string&>();
+  const void* bytes = nullptr;
+  size_t size = vital::utils::readDataString(wave_data, decoded, &bytes);
+  memcpy(wave_frame_->time_domain, bytes, std::min(size, kDataSize));
   wave_frame_->toFrequencyDomain();
+
+  // Raw payloads from binary presets get encoded on the first save instead.
+  encoded_data_.clear();
+  if (size == kDataSize && !vital::utils::isRawDataString(wave_data)) {
+    encoded_hash_ = vital::utils::hashData(wave_frame_->time_domain, kDataSize);
+    encoded_data_ = wave_data;
+  }
 }
\ No newline at end of file
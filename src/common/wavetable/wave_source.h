@@ -41,11 +41,10 @@ class WaveSource : public WavetableComponent {
     vital::WaveFrame* getWaveFrame(int index);
     WaveSourceKeyframe* getKeyframe(int index);
 
-    void setInterpolationMode(InterpolationMode mode) { interpolation_mode_ = mode; }
+    void setInterpolationMode(InterpolationMode mode) { interpolation_mode_ = mode; markEdited(); }
     InterpolationMode getInterpolationMode() const { return interpolation_mode_; }
 
   protected:
-    std::unique_ptr<WaveSourceKeyframe> compute_frame_;
     InterpolationMode interpolation_mode_;
  
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveSource)
@@ -53,7 +52,7 @@ class WaveSource : public WavetableComponent {
 
 class WaveSourceKeyframe : public WavetableKeyframe {
   public:
-    WaveSourceKeyframe() : interpolation_mode_(WaveSource::kFrequency) {
+    WaveSourceKeyframe() : interpolation_mode_(WaveSource::kFrequency), encoded_hash_(0) {
       wave_frame_ = std::make_unique<vital::WaveFrame>();
     }
     virtual ~WaveSourceKeyframe() { }
@@ -93,5 +92,9 @@ class WaveSourceKeyframe : public WavetableKeyframe {
     std::unique_ptr<vital::WaveFrame> wave_frame_;
     WaveSource::InterpolationMode interpolation_mode_;
 
+    // Base64 of the last saved waveform so unchanged frames aren't encoded again on every save.
+    uint64_t encoded_hash_;
+    std::string encoded_data_;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveSourceKeyframe)
 };
@@ -107,10 +107,11 @@ WavetableKeyframe* WaveWarpModifier::createKeyframe(int position) {
 }
 
 void WaveWarpModifier::render(vital::WaveFrame* wave_frame, float position) {
-  interpolate(&compute_frame_, position);
-  compute_frame_.setHorizontalAsymmetric(horizontal_asymmetric_);
-  compute_frame_.setVerticalAsymmetric(vertical_asymmetric_);
-  compute_frame_.render(wave_frame);
+  WaveWarpModifierKeyframe compute_frame;
+  interpolate(&compute_frame, position);
+  compute_frame.setHorizontalAsymmetric(horizontal_asymmetric_);
+  compute_frame.setVerticalAsymmetric(vertical_asymmetric_);
+  compute_frame.render(wave_frame);
 }
 
 WavetableComponentFactory::ComponentType WaveWarpModifier::getType() {
@@ -61,8 +61,14 @@ class WaveWarpModifier : public WavetableComponent {
     virtual json stateToJson() override;
     virtual void jsonToState(json data) override;
 
-    void setHorizontalAsymmetric(bool horizontal_asymmetric) { horizontal_asymmetric_ = horizontal_asymmetric; }
-    void setVerticalAsymmetric(bool vertical_asymmetric) { vertical_asymmetric_ = vertical_asymmetric; }
+    void setHorizontalAsymmetric(bool horizontal_asymmetric) {
+      horizontal_asymmetric_ = horizontal_asymmetric;
+      markEdited();
+    }
+    void setVerticalAsymmetric(bool vertical_asymmetric) {
+      vertical_asymmetric_ = vertical_asymmetric;
+      markEdited();
+    }
 
     bool getHorizontalAsymmetric() const { return horizontal_asymmetric_; }
     bool getVerticalAsymmetric() const { return vertical_asymmetric_; }
@@ -70,7 +76,6 @@ class WaveWarpModifier : public WavetableComponent {
     WaveWarpModifierKeyframe* getKeyframe(int index);
 
   protected:
-    WaveWarpModifierKeyframe compute_frame_;
     bool horizontal_asymmetric_;
     bool vertical_asymmetric_;
 
@@ -94,9 +94,10 @@ WavetableKeyframe* WaveWindowModifier::createKeyframe(int position) {
 }
 
 void WaveWindowModifier::render(vital::WaveFrame* wave_frame, float position) {
-  interpolate(&compute_frame_, position);
-  compute_frame_.setWindowShape(window_shape_);
-  compute_frame_.render(wave_frame);
+  WaveWindowModifierKeyframe compute_frame;
+  interpolate(&compute_frame, position);
+  compute_frame.setWindowShape(window_shape_);
+  compute_frame.render(wave_frame);
 }
 
 WavetableComponentFactory::ComponentType WaveWindowModifier::getType() {
@@ -72,11 +72,10 @@ class WaveWindowModifier : public WavetableComponent {
 
     WaveWindowModifierKeyframe* getKeyframe(int index);
 
-    void setWindowShape(WindowShape window_shape) { window_shape_ = window_shape; }
+    void setWindowShape(WindowShape window_shape) { window_shape_ = window_shape; markEdited(); }
     WindowShape getWindowShape() { return window_shape_; }
 
   protected:
-    WaveWindowModifierKeyframe compute_frame_;
     WindowShape window_shape_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveWindowModifier)
@@ -0,0 +1,91 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "wavetable_cache.h"
+
+int64 WavetableCache::getMemorySize(const vital::Wavetable::WavetableData* data) {
+  int64 frame_size = vital::Wavetable::kWaveformSize * sizeof(vital::mono_float) +
+                     3 * vital::Wavetable::kPolyFrequencySize * sizeof(vital::poly_float);
+  return data->num_frames * frame_size;
+}
+
+WavetableCache::WavetableCache() : memory_budget_(kDefaultMemoryBudget) { }
+
+bool WavetableCache::find(uint64_t key, Entry& entry) {
+  ScopedLock lock(lock_);
+  auto found = tables_.find(key);
+  if (key == 0 || found == tables_.end()) {
+    stats_.misses++;
+    return false;
+  }
+
+  stats_.hits++;
+  recent_.splice(recent_.begin(), recent_, found->second.recent);
+  entry = found->second.entry;
+  return true;
+}
+
+void WavetableCache::insert(uint64_t key, const Entry& entry) {
+  if (key == 0 || entry.data == nullptr)
+    return;
+
+  ScopedLock lock(lock_);
+  auto found = tables_.find(key);
+  if (found != tables_.end()) {
+    recent_.splice(recent_.begin(), recent_, found->second.recent);
+    return;
+  }
+
+  recent_.push_front(key);
+  int64 memory = getMemorySize(entry.data.get());
+  tables_[key] = { entry, memory, recent_.begin() };
+  stats_.num_tables++;
+  stats_.memory += memory;
+  evict();
+}
+
+void WavetableCache::clear() {
+  ScopedLock lock(lock_);
+  tables_.clear();
+  recent_.clear();
+  stats_ = Stats();
+}
+
+void WavetableCache::setMemoryBudget(int64 bytes) {
+  ScopedLock lock(lock_);
+  memory_budget_ = bytes;
+  evict();
+}
+
+int64 WavetableCache::getMemoryBudget() {
+  ScopedLock lock(lock_);
+  return memory_budget_;
+}
+
+WavetableCache::Stats WavetableCache::getStats() {
+  ScopedLock lock(lock_);
+  return stats_;
+}
+
+void WavetableCache::evict() {
+  while (stats_.memory > memory_budget_ && !recent_.empty()) {
+    auto oldest = tables_.find(recent_.back());
+    stats_.memory -= oldest->second.memory;
+    stats_.num_tables--;
+    stats_.evictions++;
+    tables_.erase(oldest);
+    recent_.pop_back();
+  }
+}
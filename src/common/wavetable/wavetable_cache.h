@@ -0,0 +1,76 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "JuceHeader.h"
+#include "wavetable.h"
+
+#include <list>
+#include <map>
+#include <memory>
+
+// Rendered wavetables keyed by a hash of the creator json they came from. Cached tables are shared by
+// every Wavetable that loads them, so a table rendered once serves all oscillators, presets and plugin
+// instances in the process. Once over the memory budget the least recently used tables are dropped;
+// a dropped table stays alive for as long as a Wavetable still holds it.
+class WavetableCache {
+  public:
+    static constexpr int64 kDefaultMemoryBudget = 128 * 1024 * 1024;
+
+    struct Entry {
+      std::shared_ptr<const vital::Wavetable::WavetableData> data;
+      bool shepard = false;
+    };
+
+    struct Stats {
+      int64 hits = 0;
+      int64 misses = 0;
+      int64 evictions = 0;
+      int num_tables = 0;
+      int64 memory = 0;
+    };
+
+    static int64 getMemorySize(const vital::Wavetable::WavetableData* data);
+
+    WavetableCache();
+
+    // Key 0 means the state has no hash and is never cached.
+    bool find(uint64_t key, Entry& entry);
+    void insert(uint64_t key, const Entry& entry);
+    void clear();
+
+    void setMemoryBudget(int64 bytes);
+    int64 getMemoryBudget();
+    Stats getStats();
+
+  private:
+    struct CachedTable {
+      Entry entry;
+      int64 memory;
+      std::list<uint64_t>::iterator recent;
+    };
+
+    void evict();
+
+    CriticalSection lock_;
+    std::map<uint64_t, CachedTable> tables_;
+    std::list<uint64_t> recent_;
+    int64 memory_budget_;
+    Stats stats_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WavetableCache)
+};
+
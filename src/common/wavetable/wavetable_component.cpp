@@ -51,6 +51,7 @@ void WavetableComponent::jsonToState(json data) {
 
   if (data.count("interpolation_style"))
     interpolation_style_ = data["interpolation_style"];
+  markEdited();
 }
 
 json WavetableComponent::stateToJson() {
@@ -68,6 +69,7 @@ json WavetableComponent::stateToJson() {
 void WavetableComponent::reset() {
   keyframes_.clear();
   insertNewKeyframe(0);
+  markEdited();
 }
 
 void WavetableComponent::interpolate(WavetableKeyframe* dest, float position) {
@@ -36,10 +36,11 @@ class WavetableComponent {
       kNumInterpolationStyles
     };
 
-    WavetableComponent() : interpolation_style_(kLinear) { }
+    WavetableComponent() : interpolation_style_(kLinear), edit_stamp_(WavetableKeyframe::nextEditStamp()) { }
     virtual ~WavetableComponent() { }
 
     virtual WavetableKeyframe* createKeyframe(int position) = 0;
+    // Frames of one table may render on several threads at once, so scratch state lives on the stack.
     virtual void render(vital::WaveFrame* wave_frame, float position) = 0;
     virtual WavetableComponentFactory::ComponentType getType() = 0;
     virtual json stateToJson();
@@ -66,12 +67,17 @@ class WavetableComponent {
     WavetableKeyframe* getFrameAtPosition(int position);
     int getLastKeyframePosition();
 
-    void setInterpolationStyle(InterpolationStyle type) { interpolation_style_ = type; }
+    void setInterpolationStyle(InterpolationStyle type) { interpolation_style_ = type; markEdited(); }
     InterpolationStyle getInterpolationStyle() const { return interpolation_style_; }
+
+    // Setters for settings shared by all keyframes call this, which re-renders every frame.
+    void markEdited() { edit_stamp_ = WavetableKeyframe::nextEditStamp(); }
+    uint64_t editStamp() const { return edit_stamp_; }
   
   protected:
     std::vector<std::unique_ptr<WavetableKeyframe>> keyframes_;
     InterpolationStyle interpolation_style_;
+    uint64_t edit_stamp_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WavetableComponent)
 };
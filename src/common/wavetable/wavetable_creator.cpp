@@ -15,6 +15,7 @@
  */
 
 #include "wavetable_creator.h"
+#include "fourier_transform.h"
 #include "line_generator.h"
 #include "load_save.h"
 #include "synth_constants.h"
@@ -24,6 +25,10 @@
 #include "wavetable.h"
 
 namespace {
+  // Cubic interpolation reads two keyframes either side of a segment, so a changed keyframe can
+  // move every frame out to the keyframes two away from it.
+  constexpr int kKeyframeReach = 2;
+
   int getFirstNonZeroSample(const float* audio_buffer, int num_samples) {
     for (int i = 0; i < num_samples; ++i) {
       if (audio_buffer[i])
@@ -33,8 +38,14 @@ namespace {
   }
 }
 
+WavetableCreator::WavetableCreator(vital::Wavetable* wavetable) :
+    wavetable_(wavetable), full_normalize_(true), remove_all_dc_(true), state_hash_(0), structure_hash_(0),
+    last_rendered_frames_(0), max_render_threads_(SystemStats::getNumCpus() - 1),
+    worker_frames_(std::make_unique<vital::WaveFrame[]>(2)), num_worker_frames_(2) { }
+
 int WavetableCreator::getGroupIndex(WavetableGroup* group) {
-  for (int i = 0; i < groups_.size(); ++i) {
+  int num_groups = static_cast<int>(groups_.size());
+  for (int i = 0; i < num_groups; ++i) {
     if (groups_[i].get() == group)
       return i;
   }
@@ -46,50 +57,144 @@ void WavetableCreator::moveUp(int index) {
     return;
   
   groups_[index].swap(groups_[index - 1]);
+  state_hash_ = 0;
 }
 
 void WavetableCreator::moveDown(int index) {
-  if (index < 0 || index >= groups_.size() - 1)
+  if (index < 0 || index >= static_cast<int>(groups_.size()) - 1)
     return;
 
   groups_[index].swap(groups_[index + 1]);
+  state_hash_ = 0;
 }
 
 void WavetableCreator::removeGroup(int index) {
-  if (index < 0 || index >= groups_.size())
+  if (index < 0 || index >= static_cast<int>(groups_.size()))
     return;
 
   std::unique_ptr<WavetableGroup> group = std::move(groups_[index]);
   groups_.erase(groups_.begin() + index);
+  state_hash_ = 0;
 }
 
-float WavetableCreator::render(int position) {
-  compute_frame_combine_.clear();
-  compute_frame_combine_.index = position;
-  compute_frame_.index = position;
+float WavetableCreator::renderFrame(vital::WaveFrame* combine_frame, vital::WaveFrame* compute_frame,
+                                    int position) const {
+  combine_frame->clear();
+  combine_frame->index = position;
+  compute_frame->index = position;
 
   for (auto& group : groups_) {
-    group->render(&compute_frame_, position);
-    compute_frame_combine_.addFrom(&compute_frame_);
+    group->render(compute_frame, position);
+    combine_frame->addFrom(compute_frame);
   }
 
   if (groups_.size() > 1)
-    compute_frame_combine_.multiply(1.0f / groups_.size());
+    combine_frame->multiply(1.0f / groups_.size());
 
   if (remove_all_dc_)
-    compute_frame_combine_.removedDc();
+    combine_frame->removedDc();
 
   float max_value = 0.0f;
   float min_value = 0.0f;
   for (int i = 0; i < vital::WaveFrame::kWaveformSize; ++i) {
-    max_value = std::max(compute_frame_combine_.time_domain[i], max_value);
-    min_value = std::min(compute_frame_combine_.time_domain[i], min_value);
+    max_value = std::max(combine_frame->time_domain[i], max_value);
+    min_value = std::min(combine_frame->time_domain[i], min_value);
   }
 
-  wavetable_->loadWaveFrame(&compute_frame_combine_);
   return max_value - min_value;
 }
 
+float WavetableCreator::render(int position) {
+  state_hash_ = 0;
+  float span = renderFrame(&compute_frame_combine_, &compute_frame_, position);
+  wavetable_->loadWaveFrame(&compute_frame_combine_);
+  return span;
+}
+
+void WavetableCreator::renderStagingFrame(vital::WaveFrame* combine_frame, vital::WaveFrame* compute_frame,
+                                          int position, int last_frame) {
+  frame_spans_[position] = renderFrame(combine_frame, compute_frame, position);
+  wavetable_->loadStagingFrame(combine_frame, position);
+
+  if (position == last_frame) {
+    wavetable_->setStagingFrequencyRatio(compute_frame->frequency_ratio);
+    wavetable_->setStagingSampleRate(compute_frame->sample_rate);
+  }
+}
+
+void WavetableCreator::renderFrameTask(void* context, int task, int worker) {
+  FrameRenderContext* render_context = static_cast<FrameRenderContext*>(context);
+  WavetableCreator* creator = render_context->creator;
+  vital::WaveFrame* frames = creator->worker_frames_.get() + 2 * worker;
+  int position = (*render_context->frames)[task];
+  creator->renderStagingFrame(&frames[0], &frames[1], position, render_context->last_frame);
+}
+
+// Components and keyframes take a new edit stamp whenever they're created or changed, so comparing
+// stamps with the last render finds the edits without saving or hashing anything.
+uint64_t WavetableCreator::getComponentStates(std::vector<ComponentState>& states) {
+  uint64_t structure_hash = remove_all_dc_ ? 1 : 0;
+  for (auto& group : groups_) {
+    int num_components = group->numComponents();
+    structure_hash = vital::utils::hashData(&num_components, sizeof(num_components), structure_hash);
+
+    for (int i = 0; i < num_components; ++i) {
+      WavetableComponent* component = group->getComponent(i);
+      int num_keyframes = component->numFrames();
+      ComponentState state;
+      state.edit_stamp = component->editStamp();
+      state.keyframe_stamps.reserve(num_keyframes);
+      state.positions.reserve(num_keyframes);
+      for (int k = 0; k < num_keyframes; ++k) {
+        WavetableKeyframe* keyframe = component->getFrameAt(k);
+        state.keyframe_stamps.push_back(keyframe->editStamp());
+        state.positions.push_back(keyframe->position());
+      }
+
+      structure_hash = vital::utils::hashData(&state.edit_stamp, sizeof(state.edit_stamp), structure_hash);
+      structure_hash = vital::utils::hashData(&num_keyframes, sizeof(num_keyframes), structure_hash);
+      states.push_back(std::move(state));
+    }
+  }
+
+  return structure_hash;
+}
+
+void WavetableCreator::getChangedFrames(const std::vector<ComponentState>& states,
+                                        std::vector<bool>& changed) const {
+  int last_frame = static_cast<int>(changed.size()) - 1;
+  int num_states = static_cast<int>(states.size());
+  for (int c = 0; c < num_states; ++c) {
+    const ComponentState& state = states[c];
+    const ComponentState& old_state = component_states_[c];
+    int num_keyframes = static_cast<int>(state.positions.size());
+    if (num_keyframes != static_cast<int>(old_state.positions.size())) {
+      std::fill(changed.begin(), changed.end(), true);
+      return;
+    }
+
+    for (int k = 0; k < num_keyframes; ++k) {
+      if (state.keyframe_stamps[k] == old_state.keyframe_stamps[k] &&
+          state.positions[k] == old_state.positions[k]) {
+        continue;
+      }
+
+      int start = 0;
+      int start_index = k - kKeyframeReach;
+      if (start_index >= 0)
+        start = std::min(state.positions[start_index], old_state.positions[start_index]);
+
+      int end = last_frame;
+      int end_index = k + kKeyframeReach;
+      if (end_index < num_keyframes)
+        end = std::min(last_frame, std::max(state.positions[end_index], old_state.positions[end_index]));
+
+      for (int i = start; i <= end; ++i)
+        changed[i] = true;
+    }
+  }
+}
+
 void WavetableCreator::render() {
   int last_waveframe = 0;
   bool shepard = groups_.size() > 0;
@@ -98,23 +203,50 @@ void WavetableCreator::render() {
     last_waveframe = std::max(last_waveframe, group->getLastKeyframePosition());
     shepard = shepard && group->isShepardTone();
   }
-  
-  wavetable_->setNumFrames(last_waveframe + 1);
-  wavetable_->setShepardTable(shepard);
-  float max_span = 0.0f;
-  for (int i = 0; i < last_waveframe + 1; ++i)
-    max_span = std::max(render(i), max_span);
-  wavetable_->setFrequencyRatio(compute_frame_.frequency_ratio);
-  wavetable_->setSampleRate(compute_frame_.sample_rate);
+  state_hash_ = 0;
+
+  int num_frames = last_waveframe + 1;
+  std::vector<ComponentState> states;
+  uint64_t structure_hash = getComponentStates(states);
+  bool render_all = wavetable_->setStagingFrames(num_frames) || structure_hash != structure_hash_ ||
+                    states.size() != component_states_.size();
+
+  std::vector<bool> changed(num_frames, render_all);
+  if (!render_all)
+    getChangedFrames(states, changed);
+  component_states_ = std::move(states);
+  structure_hash_ = structure_hash;
+  frame_spans_.resize(num_frames);
+
+  std::vector<int> frames;
+  for (int i = 0; i < num_frames; ++i) {
+    if (changed[i])
+      frames.push_back(i);
+  }
+  last_rendered_frames_ = static_cast<int>(frames.size());
+
+  FrameRenderContext context = { this, &frames, last_waveframe };
+  if (last_rendered_frames_ >= kMinParallelFrames &&
+      vital::FFT<vital::WaveFrame::kWaveformBits>::transform()->isReentrant()) {
+    render_pool_.setNumThreads(max_render_threads_);
+    int num_worker_frames = 2 * render_pool_.numWorkers();
+    if (num_worker_frames != num_worker_frames_) {
+      worker_frames_ = std::make_unique<vital::WaveFrame[]>(num_worker_frames);
+      num_worker_frames_ = num_worker_frames;
+    }
+    render_pool_.run(renderFrameTask, &context, last_rendered_frames_);
+  }
+  else {
+    for (int frame : frames)
+      renderStagingFrame(&worker_frames_[0], &worker_frames_[1], frame, last_waveframe);
+  }
 
-  postRender(max_span);
-}
+  float max_span = 0.0f;
+  for (float span : frame_spans_)
+    max_span = std::max(max_span, span);
 
-void WavetableCreator::postRender(float max_span) {
-  if (full_normalize_)
-    wavetable_->postProcess(max_span);
-  else
-    wavetable_->postProcess(0.0f);
+  wavetable_->setShepardTable(shepard);
+  wavetable_->publishStaging(full_normalize_ ? max_span : 0.0f);
 }
 
 void WavetableCreator::renderToBuffer(float* buffer, int num_frames, int frame_size) {
@@ -157,6 +289,7 @@ void WavetableCreator::init() {
 
 void WavetableCreator::clear() {
   groups_.clear();
+  state_hash_ = 0;
   remove_all_dc_ = true;
   full_normalize_ = true;
 }
@@ -477,7 +610,7 @@ json WavetableCreator::stateToJson() {
   };
 }
 
-void WavetableCreator::jsonToState(json data) {
+void WavetableCreator::jsonToState(json data, uint64_t hash) {
   if (LineGenerator::isValidJson(data)) {
     LineGenerator generator(vital::WaveFrame::kWaveformSize);
     generator.jsonToState(data);
@@ -485,6 +618,7 @@ void WavetableCreator::jsonToState(json data) {
     return;
   }
 
+  uint64_t cache_key = hash ? hash : LoadSave::hashJson(data);
   clear();
   data = updateJson(data);
 
@@ -512,5 +646,15 @@ void WavetableCreator::jsonToState(json data) {
     addGroup(new_group);
   }
 
+  WavetableCache::Entry cached;
+  if (cache_->find(cache_key, cached)) {
+    wavetable_->setShepardTable(cached.shepard);
+    wavetable_->loadSharedData(cached.data);
+    // The staging table doesn't hold the cached frames so the next render has to start over.
+    wavetable_->clearStaging();
+    return;
+  }
+
   render();
+  cache_->insert(cache_key, { wavetable_->shareData(), wavetable_->isShepardTable() });
 }
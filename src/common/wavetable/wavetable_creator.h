@@ -22,6 +22,10 @@
 #include "file_source.h"
 #include "json/json.h"
 #include "wavetable.h"
+#include "wavetable_cache.h"
+#include "worker_pool.h"
+
+#include <vector>
 
 using json = nlohmann::json;
 
@@ -38,11 +42,16 @@ class WavetableCreator {
       kNumDragLoadStyles
     };
 
-    WavetableCreator(vital::Wavetable* wavetable) : wavetable_(wavetable),
-                                                    full_normalize_(true), remove_all_dc_(true) { }
+    // Renders are spread across helper threads once this many frames need rendering.
+    static constexpr int kMinParallelFrames = 8;
+
+    WavetableCreator(vital::Wavetable* wavetable);
   
     int getGroupIndex(WavetableGroup* group);
-    void addGroup(WavetableGroup* group) { groups_.push_back(std::unique_ptr<WavetableGroup>(group)); }
+    void addGroup(WavetableGroup* group) {
+      groups_.push_back(std::unique_ptr<WavetableGroup>(group));
+      state_hash_ = 0;
+    }
     void removeGroup(int index);
     void moveUp(int index);
     void moveDown(int index);
@@ -50,8 +59,12 @@ class WavetableCreator {
     int numGroups() const { return static_cast<int>(groups_.size()); }
     WavetableGroup* getGroup(int index) const { return groups_[index].get(); }
     float render(int position);
+
+    // Re-renders the frames whose keyframes or components changed since the last full render and
+    // publishes the finished table to the audio thread at once.
     void render();
-    void postRender(float max_span);
+    int getLastRenderedFrames() const { return last_rendered_frames_; }
+    void setMaxRenderThreads(int num_threads) { max_render_threads_ = num_threads; }
     void renderToBuffer(float* buffer, int num_frames, int frame_size);
     void init();
     void clear();
@@ -61,8 +74,8 @@ class WavetableCreator {
     void initFromAudioFile(const float* audio_buffer, int num_samples, int sample_rate,
                            AudioFileLoadStyle load_style, FileSource::FadeStyle fade_style);
 
-    void setName(const std::string& name) { wavetable_->setName(name); }
-    void setAuthor(const std::string& author) { wavetable_->setAuthor(author); }
+    void setName(const std::string& name) { wavetable_->setName(name); state_hash_ = 0; }
+    void setAuthor(const std::string& author) { wavetable_->setAuthor(author); state_hash_ = 0; }
     void setFileLoaded(const std::string& path) { last_file_loaded_ = path; }
     std::string getName() const { return wavetable_->getName(); }
     std::string getAuthor() const { return wavetable_->getAuthor(); }
@@ -71,11 +84,39 @@ class WavetableCreator {
     static bool isValidJson(json data);
     json updateJson(json data);
     json stateToJson();
-    void jsonToState(json data);
+
+    // Loads and renders a table, or takes the rendered table from the process wide cache if the
+    // same json was rendered before. Pass the LoadSave::hashJson of data as hash if it's known already.
+    void jsonToState(json data, uint64_t hash = 0);
+
+    // Hash of the json this creator was last loaded from or saved to. Any edit or render clears it,
+    // so a matching hash means loading that json again would change nothing.
+    uint64_t getStateHash() const { return state_hash_; }
+    void setStateHash(uint64_t hash) { state_hash_ = hash; }
 
     vital::Wavetable* getWavetable() { return wavetable_; }
 
   protected:
+    struct ComponentState {
+      uint64_t edit_stamp;
+      std::vector<uint64_t> keyframe_stamps;
+      std::vector<int> positions;
+    };
+
+    struct FrameRenderContext {
+      WavetableCreator* creator;
+      const std::vector<int>* frames;
+      int last_frame;
+    };
+
+    static void renderFrameTask(void* context, int task, int worker);
+
+    float renderFrame(vital::WaveFrame* combine_frame, vital::WaveFrame* compute_frame, int position) const;
+    void renderStagingFrame(vital::WaveFrame* combine_frame, vital::WaveFrame* compute_frame,
+                            int position, int last_frame);
+    uint64_t getComponentStates(std::vector<ComponentState>& states);
+    void getChangedFrames(const std::vector<ComponentState>& states, std::vector<bool>& changed) const;
+
     void initFromSplicedAudioFile(const float* audio_buffer, int num_samples, int sample_rate,
                                   FileSource::FadeStyle fade_style);
     void initFromVocodedAudioFile(const float* audio_buffer, int num_samples, int sample_rate, bool ttwt);
@@ -90,6 +131,19 @@ class WavetableCreator {
     vital::Wavetable* wavetable_;
     bool full_normalize_;
     bool remove_all_dc_;
+    uint64_t state_hash_;
+
+    std::vector<ComponentState> component_states_;
+    std::vector<float> frame_spans_;
+    uint64_t structure_hash_;
+    int last_rendered_frames_;
+    int max_render_threads_;
+    // Helpers start on the first render that needs them and stay until the creator is deleted.
+    vital::WorkerPool render_pool_;
+    // Two frames per pool worker, one to combine the groups into and one for each group to render to.
+    std::unique_ptr<vital::WaveFrame[]> worker_frames_;
+    int num_worker_frames_;
+    SharedResourcePointer<WavetableCache> cache_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WavetableCreator)
 };
@@ -19,6 +19,13 @@
 #include "utils.h"
 #include "wavetable_component.h"
 
+#include <atomic>
+
+uint64_t WavetableKeyframe::nextEditStamp() {
+  static std::atomic<uint64_t> edit_stamp(0);
+  return ++edit_stamp;
+}
+
 float WavetableKeyframe::linearTween(float point_from, float point_to, float t) {
   return vital::utils::interpolate(point_from, point_to, t);
 }
@@ -48,4 +55,5 @@ json WavetableKeyframe::stateToJson() {
 
 void WavetableKeyframe::jsonToState(json data) {
   position_ = data["position"];
+  markEdited();
 }
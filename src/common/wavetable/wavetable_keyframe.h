@@ -34,7 +34,11 @@ class WavetableKeyframe {
     static float cubicTween(float point_prev, float point_from, float point_to, float point_next,
                             float range_prev, float range, float range_next, float t);
 
-    WavetableKeyframe() : position_(0), owner_(nullptr) { }
+    // Keyframes and components take a new stamp when they're created or edited, so comparing stamps
+    // with the last render finds what changed.
+    static uint64_t nextEditStamp();
+
+    WavetableKeyframe() : position_(0), owner_(nullptr), edit_stamp_(nextEditStamp()) { }
     virtual ~WavetableKeyframe() { }
 
     int index();
@@ -59,9 +63,14 @@ class WavetableKeyframe {
     WavetableComponent* owner() { return owner_; }
     void setOwner(WavetableComponent* owner) { owner_ = owner; }
 
+    // Editors call this after changing the keyframe's data so the next render picks it up.
+    void markEdited() { edit_stamp_ = nextEditStamp(); }
+    uint64_t editStamp() const { return edit_stamp_; }
+
   protected:
     int position_;
     WavetableComponent* owner_;
+    uint64_t edit_stamp_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WavetableKeyframe)
 };
@@ -15,10 +15,16 @@
  */
 
 #include "JuceHeader.h"
+#include "binary_preset.h"
 #include "load_save.h"
+#include "profile_report.h"
 #include "tuning.h"
 #include "synth_base.h"
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 String getArgumentValue(int argc, const char* argv[], const String& flag, const String& full_flag) {
   for (int i = 0; i < argc - 1; ++i) {
     std::string arg = argv[i];
@@ -94,6 +100,7 @@ float getRenderBpm(int argc, const char* argv[]) {
 void doRenderToFile(HeadlessSynth& headless_synth, int argc, const char* argv[]) {
   String string_output_file = getArgumentValue(argc, argv, "-o", "--output");
   bool render_images = hasFlag(argc, argv, "-i", "--render-images");
+  bool fast = hasFlag(argc, argv, "-f", "--fast");
 
   if (string_output_file.isEmpty())
     return;
@@ -110,8 +117,381 @@ void doRenderToFile(HeadlessSynth& headless_synth, int argc, const char* argv[])
   float length = getRenderLength(argc, argv);
   float bpm = getRenderBpm(argc, argv);
   std::vector<int> midi_notes = getRenderMidiNotes(argc, argv);
+
+  String profile_path = getArgumentValue(argc, argv, "-p", "--profile");
+  String trace_path = getArgumentValue(argc, argv, "--trace", "--trace");
+  std::unique_ptr<ProfileReport> profile_report;
+  if (profile_path.isNotEmpty() || trace_path.isNotEmpty()) {
+    profile_report = std::make_unique<ProfileReport>(trace_path.isNotEmpty());
+    headless_synth.setRenderProfileReport(profile_report.get());
+  }
   
-  headless_synth.renderAudioToFile(output_file, length, bpm, midi_notes, render_images);
+  headless_synth.renderAudioToFile(output_file, length, bpm, midi_notes, render_images, fast);
+
+  if (profile_report == nullptr)
+    return;
+
+  headless_synth.setRenderProfileReport(nullptr);
+  File directory = File::getCurrentWorkingDirectory();
+  if (profile_path.isNotEmpty())
+    profile_report->writeToFile(directory.getChildFile(profile_path), false);
+  if (trace_path.isNotEmpty())
+    profile_report->writeToFile(directory.getChildFile(trace_path), true);
+
+  std::cout << profile_report->getNumBlocks() << " blocks, " << profile_report->getTotalTime() / 1000000.0
+            << " ms in engine, worst block " << profile_report->getWorstBlockTime() / 1000000.0 << " ms";
+  if (profile_report->getDroppedBlocks())
+    std::cout << ", " << profile_report->getDroppedBlocks() << " blocks dropped";
+  std::cout << newLine;
+}
+
+namespace {
+  constexpr int kDefaultBatchSampleRate = 44100;
+  constexpr int kDefaultBatchBitDepth = 16;
+  constexpr int kMinBatchSampleRate = 8000;
+  constexpr double kDefaultBatchLength = 5.0;
+  constexpr double kDefaultBatchTailRatio = 0.3;
+  constexpr float kDefaultBatchVelocity = 0.7f;
+
+  struct BatchJob {
+    File preset;
+    File output;
+    File midi;
+    std::vector<int> notes;
+    double length = kDefaultBatchLength;
+    double tail = -1.0;
+    float bpm = 120.0f;
+    float velocity = kDefaultBatchVelocity;
+    int sample_rate = kDefaultBatchSampleRate;
+    int bit_depth = kDefaultBatchBitDepth;
+    bool fast = false;
+    std::string error;
+  };
+
+  struct BatchResult {
+    bool success = false;
+    std::string error;
+    double audio_seconds = 0.0;
+    double wall_seconds = 0.0;
+  };
+
+  template<typename T>
+  T getJobValue(const json& job, const json& defaults, const std::string& key, T default_value) {
+    if (job.count(key))
+      return job[key].get<T>();
+    if (defaults.count(key))
+      return defaults[key].get<T>();
+    return default_value;
+  }
+
+  std::vector<int> getJobNotes(const json& notes) {
+    std::vector<int> midi_notes;
+    for (const json& note : notes) {
+      int midi = -1;
+      if (note.is_number())
+        midi = note.get<int>();
+      else if (note.is_string())
+        midi = Tuning::noteToMidiKey(String(note.get<std::string>()));
+
+      if (midi >= 0 && midi < vital::kMidiSize)
+        midi_notes.push_back(midi);
+    }
+    return midi_notes;
+  }
+
+  bool parseBatchManifest(const File& manifest_file, bool fast, std::vector<BatchJob>& jobs, std::string& error) {
+    json manifest;
+    try {
+      manifest = json::parse(manifest_file.loadFileAsString().toStdString());
+    }
+    catch (const json::exception& e) {
+      error = e.what();
+      return false;
+    }
+
+    if (!manifest.is_object() || !manifest.count("jobs") || !manifest["jobs"].is_array()) {
+      error = "Manifest needs a \"jobs\" array.";
+      return false;
+    }
+
+    File directory = manifest_file.getParentDirectory();
+    json defaults = manifest;
+    defaults.erase("jobs");
+
+    try {
+      for (const json& data : manifest["jobs"]) {
+        BatchJob job;
+        job.preset = directory.getChildFile(getJobValue<std::string>(data, defaults, "preset", ""));
+        job.output = directory.getChildFile(getJobValue<std::string>(data, defaults, "output", ""));
+        job.length = getJobValue<double>(data, defaults, "length", kDefaultBatchLength);
+        job.tail = getJobValue<double>(data, defaults, "tail", -1.0);
+        job.bpm = getJobValue<float>(data, defaults, "bpm", 120.0f);
+        job.velocity = getJobValue<float>(data, defaults, "velocity", kDefaultBatchVelocity);
+        job.sample_rate = getJobValue<int>(data, defaults, "sample_rate", kDefaultBatchSampleRate);
+        job.bit_depth = getJobValue<int>(data, defaults, "bit_depth", kDefaultBatchBitDepth);
+        job.fast = getJobValue<bool>(data, defaults, "fast", fast);
+
+        std::string midi_path = getJobValue<std::string>(data, defaults, "midi", "");
+        if (!midi_path.empty())
+          job.midi = directory.getChildFile(midi_path);
+        else if (data.count("notes"))
+          job.notes = getJobNotes(data["notes"]);
+        else if (defaults.count("notes"))
+          job.notes = getJobNotes(defaults["notes"]);
+
+        if (job.midi == File() && job.notes.empty())
+          job.notes.push_back(48);
+
+        job.length = std::max(job.length, 0.0);
+        job.bpm = vital::utils::clamp(job.bpm, 5.0f, 900.0f);
+        job.velocity = vital::utils::clamp(job.velocity, 0.0f, 1.0f);
+
+        if (job.sample_rate < kMinBatchSampleRate || job.sample_rate > vital::kMaxSampleRate) {
+          job.error = "Sample rate " + std::to_string(job.sample_rate) + " is outside " +
+                      std::to_string(kMinBatchSampleRate) + " to " + std::to_string(vital::kMaxSampleRate) + ".";
+        }
+        else if (!WavAudioFormat().getPossibleBitDepths().contains(job.bit_depth))
+          job.error = "Bit depth " + std::to_string(job.bit_depth) + " isn't supported for wav files.";
+        jobs.push_back(job);
+      }
+    }
+    catch (const json::exception& e) {
+      error = e.what();
+      return false;
+    }
+
+    return true;
+  }
+
+  bool loadJobSequence(const BatchJob& job, MidiMessageSequence& sequence, double& seconds, std::string& error) {
+    if (job.midi != File()) {
+      FileInputStream stream(job.midi);
+      MidiFile midi_file;
+      if (!stream.openedOk() || !midi_file.readFrom(stream)) {
+        error = "Couldn't read midi file " + job.midi.getFullPathName().toStdString();
+        return false;
+      }
+
+      midi_file.convertTimestampTicksToSeconds();
+      for (int i = 0; i < midi_file.getNumTracks(); ++i)
+        sequence.addSequence(*midi_file.getTrack(i), 0.0);
+      sequence.updateMatchedPairs();
+
+      double end_time = sequence.getEndTime();
+      double tail = job.tail >= 0.0 ? job.tail : end_time * kDefaultBatchTailRatio;
+      seconds = end_time + tail;
+      return true;
+    }
+
+    uint8 velocity = static_cast<uint8>(std::round(job.velocity * 127.0f));
+    for (int note : job.notes) {
+      sequence.addEvent(MidiMessage::noteOn(1, note, velocity), 0.0);
+      sequence.addEvent(MidiMessage::noteOff(1, note), job.length);
+    }
+    sequence.sort();
+
+    double tail = job.tail >= 0.0 ? job.tail : job.length * kDefaultBatchTailRatio;
+    seconds = job.length + tail;
+    return true;
+  }
+
+  BatchResult renderBatchJob(HeadlessSynth& synth, const BatchJob& job) {
+    BatchResult result;
+    double start_time = Time::getMillisecondCounterHiRes();
+
+    if (!job.error.empty()) {
+      result.error = job.error;
+      return result;
+    }
+
+    if (!job.preset.existsAsFile() || !synth.loadFromFile(job.preset, result.error)) {
+      if (result.error.empty())
+        result.error = "Couldn't load preset " + job.preset.getFullPathName().toStdString();
+      return result;
+    }
+
+    MidiMessageSequence sequence;
+    if (!loadJobSequence(job, sequence, result.audio_seconds, result.error))
+      return result;
+
+    job.output.getParentDirectory().createDirectory();
+    if (!synth.renderSequenceToFile(job.output, sequence, result.audio_seconds, job.bpm,
+                                    job.sample_rate, job.bit_depth, job.fast)) {
+      result.error = "Couldn't write " + job.output.getFullPathName().toStdString();
+      return result;
+    }
+
+    result.wall_seconds = (Time::getMillisecondCounterHiRes() - start_time) / 1000.0;
+    result.success = true;
+    return result;
+  }
+} // namespace
+
+// Renders every job in a json manifest. Each worker thread owns its own synth and pulls the next
+// job when it finishes, so long and short renders balance out across workers.
+int doBatchRender(int argc, const char* argv[]) {
+  String manifest_path = getArgumentValue(argc, argv, "--batch", "--batch");
+  File manifest_file = File::getCurrentWorkingDirectory().getChildFile(manifest_path);
+  if (!manifest_file.existsAsFile()) {
+    std::cout << "Error: Couldn't find manifest " << manifest_file.getFullPathName() << newLine;
+    return 1;
+  }
+
+  std::vector<BatchJob> jobs;
+  std::string error;
+  bool fast = hasFlag(argc, argv, "-f", "--fast");
+  if (!parseBatchManifest(manifest_file, fast, jobs, error)) {
+    std::cout << "Error: Couldn't parse manifest. " << error << newLine;
+    return 1;
+  }
+
+  int num_workers = SystemStats::getNumCpus();
+  String string_jobs = getArgumentValue(argc, argv, "-j", "--jobs");
+  if (!string_jobs.isEmpty())
+    num_workers = string_jobs.getIntValue();
+  num_workers = vital::utils::iclamp(num_workers, 1, std::max<int>(1, static_cast<int>(jobs.size())));
+
+  std::vector<BatchResult> results(jobs.size());
+  std::atomic<int> next_job(0);
+  std::mutex output_mutex;
+  double start_time = Time::getMillisecondCounterHiRes();
+
+  auto worker = [&]() {
+    HeadlessSynth synth;
+
+    for (int i = next_job++; i < static_cast<int>(jobs.size()); i = next_job++) {
+      results[i] = renderBatchJob(synth, jobs[i]);
+
+      std::lock_guard<std::mutex> lock(output_mutex);
+      const BatchResult& result = results[i];
+      if (result.success) {
+        std::cout << "[" << (i + 1) << "/" << jobs.size() << "] " << jobs[i].output.getFileName()
+                  << ": " << result.audio_seconds << "s audio in " << result.wall_seconds << "s ("
+                  << result.audio_seconds / std::max(result.wall_seconds, 0.000001) << "x realtime)" << std::endl;
+      }
+      else
+        std::cout << "[" << (i + 1) << "/" << jobs.size() << "] Error: " << result.error << std::endl;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 1; i < num_workers; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads)
+    thread.join();
+
+  int failures = 0;
+  double audio_seconds = 0.0;
+  for (const BatchResult& result : results) {
+    if (result.success)
+      audio_seconds += result.audio_seconds;
+    else
+      failures++;
+  }
+
+  double wall_seconds = (Time::getMillisecondCounterHiRes() - start_time) / 1000.0;
+  std::cout << (jobs.size() - failures) << "/" << jobs.size() << " rendered with " << num_workers
+            << " workers: " << audio_seconds << "s audio in " << wall_seconds << "s ("
+            << audio_seconds / std::max(wall_seconds, 0.000001) << "x realtime)" << std::endl;
+  return failures ? 1 : 0;
+}
+
+// Converts a preset to the binary format, or back to .vital json if it's already binary.
+int doConvertPreset(int argc, const char* argv[]) {
+  File directory = File::getCurrentWorkingDirectory();
+  String source_path = getArgumentValue(argc, argv, "--convert-preset", "--convert-preset");
+  String output_path = getArgumentValue(argc, argv, "-o", "--output");
+  File source = directory.getChildFile(source_path);
+  if (source_path.isEmpty() || output_path.isEmpty() || !source.existsAsFile()) {
+    std::cout << "Error: Need an existing preset and an output file." << newLine;
+    return 1;
+  }
+
+  File destination = directory.getChildFile(output_path);
+  bool to_binary = !BinaryPreset::isBinaryPreset(source);
+  bool success = to_binary ? BinaryPreset::convertToBinary(source, destination) :
+                             BinaryPreset::convertToJson(source, destination);
+  if (!success) {
+    std::cout << "Error: Couldn't convert " << source.getFullPathName() << newLine;
+    return 1;
+  }
+
+  std::cout << "Wrote " << (to_binary ? "binary" : "json") << " preset " << destination.getFullPathName()
+            << " (" << source.getSize() << " -> " << destination.getSize() << " bytes)" << newLine;
+  return 0;
+}
+
+// Loads every preset under a directory from .vital json and from the binary format and reports
+// the parse and full load times of each, along with any preset that doesn't convert losslessly.
+int doPresetBenchmark(int argc, const char* argv[]) {
+  File directory = File::getCurrentWorkingDirectory().getChildFile(
+      getArgumentValue(argc, argv, "--preset-benchmark", "--preset-benchmark"));
+  Array<File> presets;
+  directory.findChildFiles(presets, File::findFiles, true, String("*.") + vital::kPresetExtension);
+  if (presets.isEmpty()) {
+    std::cout << "Error: No presets found in " << directory.getFullPathName() << newLine;
+    return 1;
+  }
+
+  HeadlessSynth synth;
+  TemporaryFile temporary_file;
+  File binary_file = temporary_file.getFile();
+
+  double json_parse = 0.0, json_load = 0.0, binary_parse = 0.0, binary_load = 0.0;
+  int64 json_bytes = 0, binary_bytes = 0;
+  int num_loaded = 0, num_mismatched = 0;
+  for (const File& preset : presets) {
+    json state;
+    double start = Time::getMillisecondCounterHiRes();
+    try {
+      state = json::parse(preset.loadFileAsString().toStdString(), nullptr);
+    }
+    catch (const json::exception& e) {
+      std::cout << "Skipping unreadable preset " << preset.getFullPathName() << newLine;
+      continue;
+    }
+    double parsed = Time::getMillisecondCounterHiRes();
+
+    std::string error;
+    if (!synth.loadFromFile(preset, error) || !BinaryPreset::writeToFile(state, binary_file)) {
+      std::cout << "Skipping " << preset.getFullPathName() << " " << error << newLine;
+      continue;
+    }
+    double loaded = Time::getMillisecondCounterHiRes();
+
+    json binary_state;
+    double binary_start = Time::getMillisecondCounterHiRes();
+    bool binary_success = BinaryPreset::readFromFile(binary_file, binary_state);
+    double binary_parsed = Time::getMillisecondCounterHiRes();
+    binary_success = binary_success && synth.loadFromFile(binary_file, error);
+    double binary_loaded = Time::getMillisecondCounterHiRes();
+
+    BinaryPreset::encodePayloads(binary_state);
+    if (!binary_success || binary_state != state) {
+      std::cout << "Binary conversion differs for " << preset.getFullPathName() << newLine;
+      num_mismatched++;
+    }
+
+    json_parse += parsed - start;
+    json_load += loaded - parsed;
+    binary_parse += binary_parsed - binary_start;
+    binary_load += binary_loaded - binary_parsed;
+    json_bytes += preset.getSize();
+    binary_bytes += binary_file.getSize();
+    num_loaded++;
+  }
+
+  if (num_loaded == 0)
+    return 1;
+
+  std::cout << num_loaded << " presets, " << json_bytes / 1024 << " KB json, " << binary_bytes / 1024
+            << " KB binary" << newLine;
+  std::cout << "json:   " << json_parse / num_loaded << " ms parse, " << json_load / num_loaded
+            << " ms load per preset" << newLine;
+  std::cout << "binary: " << binary_parse / num_loaded << " ms parse, " << binary_load / num_loaded
+            << " ms load per preset" << newLine;
+  return num_mismatched ? 1 : 0;
 }
 
 bool loadFromCommandLine(HeadlessSynth& synth, const String& command_line) {
@@ -128,6 +508,13 @@ bool loadFromCommandLine(HeadlessSynth& synth, const String& command_line) {
 }
 
 int main(int argc, const char* argv[]) {
+  if (hasFlag(argc, argv, "--batch", "--batch"))
+    return doBatchRender(argc, argv);
+  if (hasFlag(argc, argv, "--convert-preset", "--convert-preset"))
+    return doConvertPreset(argc, argv);
+  if (hasFlag(argc, argv, "--preset-benchmark", "--preset-benchmark"))
+    return doPresetBenchmark(argc, argv);
+
   HeadlessSynth headless_synth;
   
   bool last_arg_was_option = false;
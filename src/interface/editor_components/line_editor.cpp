@@ -322,6 +322,8 @@ void LineEditor::respondToCallback(int point, int power, int option) {
       model_->setPower(power, 0.0f);
       model_->render();
       resetPositions();
+      for (Listener* listener : listeners_)
+        listener->powersChanged(true);
     }
   }
   else if (option == kEnterPhase || option == kEnterValue) {
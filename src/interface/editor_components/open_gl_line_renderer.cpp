@@ -47,10 +47,19 @@ namespace {
   }
 }
 
+OpenGlLineRenderer::UploadStats OpenGlLineRenderer::upload_stats_;
+
+OpenGlLineRenderer::UploadStats OpenGlLineRenderer::takeUploadStats() {
+  UploadStats stats = upload_stats_;
+  upload_stats_ = UploadStats();
+  return stats;
+}
+
 OpenGlLineRenderer::OpenGlLineRenderer(int num_points, bool loop) :
     num_points_(num_points), boost_(0.0f), fill_(false), fill_center_(0.0f), fit_(false),
     boost_amount_(0.0f), fill_boost_amount_(0.0f), enable_backward_boost_(true),
-    index_(0), dirty_(false), last_drawn_left_(false), loop_(loop), any_boost_value_(false),
+    index_(0), dirty_start_(num_points), dirty_end_(0), last_drawn_left_(false),
+    last_drawn_width_(-1), last_drawn_height_(-1), loop_(loop), any_boost_value_(false),
     shader_(nullptr), fill_shader_(nullptr) {
   addRoundedCorners();
   num_padding_ = 1;
@@ -100,13 +109,13 @@ void OpenGlLineRenderer::init(OpenGlWrapper& open_gl) {
   open_gl.context.extensions.glBindBuffer(GL_ARRAY_BUFFER, line_buffer_);
 
   GLsizeiptr line_vert_size = static_cast<GLsizeiptr>(num_line_floats_ * sizeof(float));
-  open_gl.context.extensions.glBufferData(GL_ARRAY_BUFFER, line_vert_size, line_data_.get(), GL_STATIC_DRAW);
+  open_gl.context.extensions.glBufferData(GL_ARRAY_BUFFER, line_vert_size, line_data_.get(), GL_DYNAMIC_DRAW);
 
   open_gl.context.extensions.glGenBuffers(1, &fill_buffer_);
   open_gl.context.extensions.glBindBuffer(GL_ARRAY_BUFFER, fill_buffer_);
 
   GLsizeiptr fill_vert_size = static_cast<GLsizeiptr>(num_fill_floats_ * sizeof(float));
-  open_gl.context.extensions.glBufferData(GL_ARRAY_BUFFER, fill_vert_size, fill_data_.get(), GL_STATIC_DRAW);
+  open_gl.context.extensions.glBufferData(GL_ARRAY_BUFFER, fill_vert_size, fill_data_.get(), GL_DYNAMIC_DRAW);
 
   open_gl.context.extensions.glGenBuffers(1, &indices_buffer_);
   open_gl.context.extensions.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices_buffer_);
@@ -142,7 +151,7 @@ void OpenGlLineRenderer::boostRightRange(float start, float end, int buffer_vert
 
 void OpenGlLineRenderer::boostRange(float* boosts, float start, float end, int buffer_vertices, float min) {
   any_boost_value_ = true;
-  dirty_ = true;
+  markAllDirty();
   
   int active_points = num_points_ - 2 * buffer_vertices;
   int start_index = std::max((int)std::ceil(start * (active_points - 1)), 0);
@@ -200,8 +209,12 @@ void OpenGlLineRenderer::boostRange(vital::poly_float start, vital::poly_float e
 void OpenGlLineRenderer::decayBoosts(vital::poly_float mult) {
   bool any_boost = false;
   for (int i = 0; i < num_points_; ++i) {
+    if (boost_left_[i] == 0.0f && boost_right_[i] == 0.0f)
+      continue;
+
     boost_left_[i] *= mult[0];
     boost_right_[i] *= mult[1];
+    markDirty(i, i + 1);
     any_boost = any_boost || boost_left_[i] || boost_right_[i];
   }
   
@@ -209,11 +222,15 @@ void OpenGlLineRenderer::decayBoosts(vital::poly_float mult) {
 }
 
 void OpenGlLineRenderer::setFillVertices(bool left) {
+  setFillVertices(left, 0, num_points_);
+}
+
+void OpenGlLineRenderer::setFillVertices(bool left, int start, int end) {
   float* boosts = left ? boost_left_.get() : boost_right_.get();
   float x_adjust = 2.0f / getWidth();
   float y_adjust = 2.0f / getHeight();
 
-  for (int i = 0; i < num_points_; ++i) {
+  for (int i = start; i < end; ++i) {
     int index_top = (i + num_padding_) * kFillFloatsPerPoint;
     int index_bottom = index_top + kFillFloatsPerVertex;
     float x = x_adjust * x_[i] - 1.0f;
@@ -249,24 +266,39 @@ void OpenGlLineRenderer::setFillVertices(bool left) {
 }
 
 void OpenGlLineRenderer::setLineVertices(bool left) {
+  setLineVertices(left, 0, num_points_);
+}
+
+// Each point's vertices depend on the segments to its neighbors, so the range has to start on a point whose
+// incoming segment isn't degenerate. Otherwise the carried direction is only known by walking from the start.
+void OpenGlLineRenderer::setLineVertices(bool left, int start, int end) {
   float* boosts = left ? boost_left_.get() : boost_right_.get();
+  float line_radius = line_width_ / 2.0f + 0.5f;
 
   Point<float> prev_normalized_delta;
-  for (int i = 0; i < num_points_ - 1; ++i) {
-    if (x_[i] != x_[i + 1] || y_[i] != y_[i + 1]) {
-      prev_normalized_delta = normalize(Point<float>(x_[i + 1] - x_[i], y_[i + 1] - y_[i]));
-      break;
+  float prev_magnitude = line_radius;
+  if (start > 0) {
+    Point<float> prev_delta(x_[start] - x_[start - 1], y_[start] - y_[start - 1]);
+    VITAL_ASSERT(prev_delta.x != 0.0f || prev_delta.y != 0.0f);
+    float inverse_magnitude = inverseMagnitudeOfPoint(prev_delta);
+    prev_magnitude = 1.0f / std::max(0.00001f, inverse_magnitude);
+    prev_normalized_delta = Point<float>(prev_delta.x * inverse_magnitude, prev_delta.y * inverse_magnitude);
+  }
+  else {
+    for (int i = 0; i < num_points_ - 1; ++i) {
+      if (x_[i] != x_[i + 1] || y_[i] != y_[i + 1]) {
+        prev_normalized_delta = normalize(Point<float>(x_[i + 1] - x_[i], y_[i + 1] - y_[i]));
+        break;
+      }
     }
   }
 
   Point<float> prev_delta_normal(-prev_normalized_delta.y, prev_normalized_delta.x);
-  float line_radius = line_width_ / 2.0f + 0.5f;
-  float prev_magnitude = line_radius;
 
   float x_adjust = 2.0f / getWidth();
   float y_adjust = 2.0f / getHeight();
 
-  for (int i = 0; i < num_points_; ++i) {
+  for (int i = start; i < end; ++i) {
     float radius = line_radius * (1.0f + boost_amount_ * boosts[i]);
     Point<float> point(x_[i], y_[i]);
     int next_index = i + 1;
@@ -411,25 +443,20 @@ void OpenGlLineRenderer::drawLines(OpenGlWrapper& open_gl, bool left) {
 
   open_gl.context.extensions.glBindVertexArray(vertex_array_object_);
 
-  if (dirty_ || last_drawn_left_ != left) {
-    dirty_ = false;
+  if (last_drawn_left_ != left || last_drawn_width_ != getWidth() || last_drawn_height_ != getHeight()) {
     last_drawn_left_ = left;
-    setLineVertices(left);
-    setFillVertices(left);
-
-    open_gl.context.extensions.glBindBuffer(GL_ARRAY_BUFFER, line_buffer_);
-
-    GLsizeiptr line_vert_size = static_cast<GLsizeiptr>(num_line_floats_ * sizeof(float));
-    open_gl.context.extensions.glBufferData(GL_ARRAY_BUFFER, line_vert_size, line_data_.get(), GL_STATIC_DRAW);
-
-    open_gl.context.extensions.glBindBuffer(GL_ARRAY_BUFFER, fill_buffer_);
-
-    GLsizeiptr fill_vert_size = static_cast<GLsizeiptr>(num_fill_floats_ * sizeof(float));
-    open_gl.context.extensions.glBufferData(GL_ARRAY_BUFFER, fill_vert_size, fill_data_.get(), GL_STATIC_DRAW);
-
-    open_gl.context.extensions.glBindBuffer(GL_ARRAY_BUFFER, 0);
+    last_drawn_width_ = getWidth();
+    last_drawn_height_ = getHeight();
+    markAllDirty();
   }
 
+  int start = 0;
+  int end = 0;
+  if (updateDirtyVertices(left, start, end))
+    uploadVertices(open_gl, start, end);
+  else
+    upload_stats_.unchanged++;
+
   open_gl.context.extensions.glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices_buffer_);
 
   float x_shrink = 1.0f;
@@ -476,6 +503,73 @@ void OpenGlLineRenderer::drawLines(OpenGlWrapper& open_gl, bool left) {
   glDisable(GL_SCISSOR_TEST);
 }
 
+bool OpenGlLineRenderer::updateDirtyVertices(bool left, int& start, int& end) {
+  if (!isDirty())
+    return false;
+
+  start = std::max(0, dirty_start_ - 1);
+  while (start > 0 && x_[start - 1] == x_[start] && y_[start - 1] == y_[start])
+    start--;
+
+  end = std::min(num_points_, dirty_end_ + 1);
+  while (end < num_points_ && x_[end - 1] == x_[end] && y_[end - 1] == y_[end])
+    end++;
+
+  dirty_start_ = num_points_;
+  dirty_end_ = 0;
+  setLineVertices(left, start, end);
+  setFillVertices(left, start, end);
+  return true;
+}
+
+void OpenGlLineRenderer::uploadVertices(OpenGlWrapper& open_gl, int start, int end) {
+  GLsizeiptr line_vert_size = static_cast<GLsizeiptr>(num_line_floats_ * sizeof(float));
+  GLsizeiptr fill_vert_size = static_cast<GLsizeiptr>(num_fill_floats_ * sizeof(float));
+
+  if (start == 0 && end == num_points_) {
+    // Respecifying the whole store orphans the old one so we never wait on a draw still reading it.
+    open_gl.context.extensions.glBindBuffer(GL_ARRAY_BUFFER, line_buffer_);
+    open_gl.context.extensions.glBufferData(GL_ARRAY_BUFFER, line_vert_size, line_data_.get(), GL_DYNAMIC_DRAW);
+    open_gl.context.extensions.glBindBuffer(GL_ARRAY_BUFFER, fill_buffer_);
+    open_gl.context.extensions.glBufferData(GL_ARRAY_BUFFER, fill_vert_size, fill_data_.get(), GL_DYNAMIC_DRAW);
+    open_gl.context.extensions.glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    upload_stats_.full_uploads++;
+    upload_stats_.uploaded_bytes += line_vert_size + fill_vert_size;
+    return;
+  }
+
+  // Padding vertices mirror the ends of the line so they go up with every partial upload.
+  int line_padding_floats = num_padding_ * kLineFloatsPerPoint;
+  int fill_padding_floats = num_padding_ * kFillFloatsPerPoint;
+  int line_end_padding = num_line_floats_ - line_padding_floats;
+  int fill_end_padding = num_fill_floats_ - fill_padding_floats;
+  int line_start = (start + num_padding_) * kLineFloatsPerPoint;
+  int fill_start = (start + num_padding_) * kFillFloatsPerPoint;
+  int num_line_floats = (end - start) * kLineFloatsPerPoint;
+  int num_fill_floats = (end - start) * kFillFloatsPerPoint;
+
+  auto upload = [&](float* data, int offset, int num_floats) {
+    GLintptr byte_offset = static_cast<GLintptr>(offset * sizeof(float));
+    GLsizeiptr byte_size = static_cast<GLsizeiptr>(num_floats * sizeof(float));
+    open_gl.context.extensions.glBufferSubData(GL_ARRAY_BUFFER, byte_offset, byte_size, data + offset);
+    upload_stats_.uploaded_bytes += byte_size;
+  };
+
+  open_gl.context.extensions.glBindBuffer(GL_ARRAY_BUFFER, line_buffer_);
+  upload(line_data_.get(), 0, line_padding_floats);
+  upload(line_data_.get(), line_start, num_line_floats);
+  upload(line_data_.get(), line_end_padding, line_padding_floats);
+
+  open_gl.context.extensions.glBindBuffer(GL_ARRAY_BUFFER, fill_buffer_);
+  upload(fill_data_.get(), 0, fill_padding_floats);
+  upload(fill_data_.get(), fill_start, num_fill_floats);
+  upload(fill_data_.get(), fill_end_padding, fill_padding_floats);
+  open_gl.context.extensions.glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  upload_stats_.partial_uploads++;
+}
+
 void OpenGlLineRenderer::render(OpenGlWrapper& open_gl, bool animate) {
   drawLines(open_gl, true);
 }
@@ -31,6 +31,16 @@ class OpenGlLineRenderer : public OpenGlComponent {
     static constexpr int kLineFloatsPerPoint = kLineVerticesPerPoint * kLineFloatsPerVertex;
     static constexpr int kFillFloatsPerPoint = kFillVerticesPerPoint * kFillFloatsPerVertex;
 
+    // Vertex upload counts across all line renderers, collected on the OpenGL thread.
+    struct UploadStats {
+      int64 full_uploads = 0;
+      int64 partial_uploads = 0;
+      int64 unchanged = 0;
+      int64 uploaded_bytes = 0;
+    };
+
+    static UploadStats takeUploadStats();
+
     OpenGlLineRenderer(int num_points, bool loop = false);
     virtual ~OpenGlLineRenderer();
 
@@ -39,7 +49,11 @@ class OpenGlLineRenderer : public OpenGlComponent {
     virtual void destroy(OpenGlWrapper& open_gl) override;
 
     force_inline void setColor(Colour color) { color_ = color; }
-    force_inline void setLineWidth(float width) { line_width_ = width; }
+    force_inline void setLineWidth(float width) {
+      if (line_width_ != width)
+        markAllDirty();
+      line_width_ = width;
+    }
     force_inline void setBoost(float boost) { boost_ = boost; }
 
     force_inline float boostLeftAt(int index) const { return boost_left_[index]; }
@@ -48,28 +62,49 @@ class OpenGlLineRenderer : public OpenGlComponent {
     force_inline float xAt(int index) const { return x_[index]; }
 
     force_inline void setBoostLeft(int index, float val) {
-      boost_left_[index] = val;
-      dirty_ = true;
       VITAL_ASSERT(num_points_ > index);
+      if (boost_left_[index] == val)
+        return;
+
+      boost_left_[index] = val;
+      markDirty(index, index + 1);
     }
     force_inline void setBoostRight(int index, float val) {
-      boost_right_[index] = val;
-      dirty_ = true;
       VITAL_ASSERT(num_points_ > index);
+      if (boost_right_[index] == val)
+        return;
+
+      boost_right_[index] = val;
+      markDirty(index, index + 1);
     }
     force_inline void setYAt(int index, float val) {
-      y_[index] = val;
-      dirty_ = true;
       VITAL_ASSERT(num_points_ > index);
+      if (y_[index] == val)
+        return;
+
+      y_[index] = val;
+      markDirty(index, index + 1);
     }
     force_inline void setXAt(int index, float val) {
-      x_[index] = val;
-      dirty_ = true;
       VITAL_ASSERT(num_points_ > index);
+      if (x_[index] == val)
+        return;
+
+      x_[index] = val;
+      markDirty(index, index + 1);
     }
 
     void setFillVertices(bool left);
     void setLineVertices(bool left);
+    void setFillVertices(bool left, int start, int end);
+    void setLineVertices(bool left, int start, int end);
+
+    // Recomputes the vertices touched by changes since the last update and returns the point range to upload.
+    bool updateDirtyVertices(bool left, int& start, int& end);
+    force_inline const float* lineData() const { return line_data_.get(); }
+    force_inline const float* fillData() const { return fill_data_.get(); }
+    force_inline int numLineFloats() const { return num_line_floats_; }
+    force_inline int numFillFloats() const { return num_fill_floats_; }
 
     force_inline void setFill(bool fill) { fill_ = fill; }
     force_inline void setFillColor(Colour fill_color) {
@@ -79,10 +114,18 @@ class OpenGlLineRenderer : public OpenGlComponent {
       fill_color_from_ = fill_color_from;
       fill_color_to_ = fill_color_to;
     }
-    force_inline void setFillCenter(float fill_center) { fill_center_ = fill_center; }
+    force_inline void setFillCenter(float fill_center) {
+      if (fill_center_ != fill_center)
+        markAllDirty();
+      fill_center_ = fill_center;
+    }
     force_inline void setFit(bool fit) { fit_ = fit; }
 
-    force_inline void setBoostAmount(float boost_amount) { boost_amount_ = boost_amount; }
+    force_inline void setBoostAmount(float boost_amount) {
+      if (boost_amount_ != boost_amount)
+        markAllDirty();
+      boost_amount_ = boost_amount;
+    }
     force_inline void setFillBoostAmount(float boost_amount) { fill_boost_amount_ = boost_amount; }
     force_inline void setIndex(int index) { index_ = index; }
     void boostLeftRange(float start, float end, int buffer_vertices, float min);
@@ -99,6 +142,16 @@ class OpenGlLineRenderer : public OpenGlComponent {
     bool anyBoostValue() { return any_boost_value_; }
 
   private:
+    force_inline void markDirty(int start, int end) {
+      dirty_start_ = std::min(dirty_start_, start);
+      dirty_end_ = std::max(dirty_end_, end);
+    }
+    force_inline void markAllDirty() { markDirty(0, num_points_); }
+    force_inline bool isDirty() const { return dirty_start_ < dirty_end_; }
+    void uploadVertices(OpenGlWrapper& open_gl, int start, int end);
+
+    static UploadStats upload_stats_;
+
     Colour color_;
     Colour fill_color_from_;
     Colour fill_color_to_;
@@ -115,8 +168,11 @@ class OpenGlLineRenderer : public OpenGlComponent {
     bool enable_backward_boost_;
     int index_;
 
-    bool dirty_;
+    int dirty_start_;
+    int dirty_end_;
     bool last_drawn_left_;
+    int last_drawn_width_;
+    int last_drawn_height_;
     bool last_negative_boost_;
     bool loop_;
     bool any_boost_value_;
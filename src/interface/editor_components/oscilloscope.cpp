@@ -16,6 +16,7 @@
 
 #include "oscilloscope.h"
 
+#include "engine_telemetry.h"
 #include "fourier_transform.h"
 #include "synth_constants.h"
 #include "skin.h"
@@ -21,6 +21,8 @@
 #include "fourier_transform.h"
 #include "open_gl_line_renderer.h"
 
+class MemoryReadout;
+
 class Oscilloscope : public OpenGlLineRenderer {
   public:
     static constexpr int kResolution = 512;
@@ -55,7 +57,7 @@ class Spectrogram : public OpenGlLineRenderer {
 
     void drawWaveform(OpenGlWrapper& open_gl, int index);
     void render(OpenGlWrapper& open_gl, bool animate) override;
-    void setAudioMemory(const vital::StereoMemory* memory) { memory_ = memory; }
+    void setAudioMemory(const MemoryReadout* memory) { memory_ = memory; }
     void paintBackground(Graphics& g) override;
     void setOversampleAmount(int oversample) { oversample_amount_ = oversample; }
     void setMinFrequency(float frequency) { min_frequency_ = frequency; }
@@ -79,7 +81,7 @@ class Spectrogram : public OpenGlLineRenderer {
     float transform_buffer_[2 * kAudioSize];
     float left_amps_[kAudioSize];
     float right_amps_[kAudioSize];
-    const vital::StereoMemory* memory_;
+    const MemoryReadout* memory_;
     vital::FourierTransform transform_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Spectrogram)
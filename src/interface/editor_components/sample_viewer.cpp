@@ -57,14 +57,11 @@ void SampleViewer::setLinePositions() {
     return;
 
   double sample_length = sample_->originalLength();
-  const vital::mono_float* buffer = sample_->buffer();
   float center = getHeight() / 2.0f;
   for (int i = 0; i < kResolution; ++i) {
     int start_index = std::min<int>(sample_length * i / kResolution, sample_length);
     int end_index = std::min<int>((sample_length * (i + 1) + kResolution - 1) / kResolution, sample_length);
-    float max = buffer[start_index];
-    for (int i = start_index + 1; i < end_index; ++i)
-      max = std::max(max, buffer[i]);
+    float max = sample_->getPeak(start_index, end_index);
     setYAt(i, center - max * center);
     bottom_.setYAt(i, center + max * center);
   }
@@ -364,14 +364,27 @@ void Wavetable3d::loadWaveData(int index) {
     wave_height = wave_height_percent_ * height;
   }
 
-  loadIntoTimeDomain(index);
+  FrameCache* cache = getFrameCache(index);
+  int from_frame = 0;
+  int to_frame = 0;
+  float frame_t = getFramePosition(index, from_frame, to_frame);
+  const float* from_wave = nullptr;
+  const float* to_wave = nullptr;
+  if (cache) {
+    from_wave = getCachedWave(cache, index, from_frame);
+    to_wave = frame_t > 0.0f ? getCachedWave(cache, index, to_frame) : from_wave;
+  }
+  else {
+    from_wave = warpFrame(index, frame_t < 0.5f ? from_frame : to_frame);
+    to_wave = from_wave;
+    frame_t = 0.0f;
+  }
 
   OpenGlLineRenderer* renderer = &left_line_renderer_;
   if (index)
     renderer = &right_line_renderer_;
 
   vital::poly_float spread(1.0f, 2.0f, 3.0f, 4.0f);
-  float* time_domain = process_frame_.time_domain;
   float delta = 1.0f / size_;
   for (int i = 0; i < size_ - vital::poly_float::kSize + 1; i += vital::poly_float::kSize) {
     vital::poly_float t = (spread + i) * delta;
@@ -379,7 +392,8 @@ void Wavetable3d::loadWaveData(int index) {
     for (int v = 0; v < vital::poly_float::kSize; ++v) {
       int point_index = i + v + 1;
       renderer->setXAt(point_index, start_x + t[v] * wave_width);
-      float y = start_y - time_domain[i + v] * wave_height + t[v] * wave_range_y;
+      float value = vital::utils::interpolate(from_wave[i + v], to_wave[i + v], frame_t);
+      float y = start_y - value * wave_height + t[v] * wave_range_y;
       renderer->setYAt(point_index, y);
     }
   }
@@ -393,14 +407,25 @@ void Wavetable3d::loadWaveData(int index) {
 }
 
 void Wavetable3d::loadSpectrumData(int index) {
-  static constexpr float kMinDb = -30.0f;
-  static constexpr float kMaxDb = 50.0f;
-  static constexpr float kDbRange = kMaxDb - kMinDb;
-  static constexpr float kDbBoostPerOctave = 3.0f;
-
-  loadIntoTimeDomain(index);
-  process_frame_.toFrequencyDomain();
-  std::complex<float>* frequency_domain = process_frame_.frequency_domain;
+  FrameCache* cache = getFrameCache(index);
+  int from_frame = 0;
+  int to_frame = 0;
+  float frame_t = getFramePosition(index, from_frame, to_frame);
+  int num_points = getNumSpectrumPoints();
+  const float* from_spectrum = nullptr;
+  const float* to_spectrum = nullptr;
+  if (cache) {
+    from_spectrum = getCachedSpectrum(cache, index, from_frame);
+    to_spectrum = frame_t > 0.0f ? getCachedSpectrum(cache, index, to_frame) : from_spectrum;
+  }
+  else {
+    memcpy(process_frame_.time_domain, warpFrame(index, frame_t < 0.5f ? from_frame : to_frame),
+           size_ * sizeof(float));
+    computeSpectrum(num_points, uncached_spectrum_);
+    from_spectrum = uncached_spectrum_;
+    to_spectrum = uncached_spectrum_;
+    frame_t = 0.0f;
+  }
 
   OpenGlLineRenderer* renderer = &left_line_renderer_;
   if (index)
@@ -409,9 +434,6 @@ void Wavetable3d::loadSpectrumData(int index) {
   int width = getWidth();
   int height = getHeight();
   float center = height * 0.5f;
-  int num_points = std::min(width, vital::Wavetable::kWaveformSize / 2);
-  float scale = 1.0f / num_points;
-  int last_frequency = 0;
   for (int i = 0; i <= num_points; ++i) {
     int invert_i = vital::Wavetable::kWaveformSize + 1 - i;
     float t = i * 1.0f / num_points;
@@ -419,21 +441,7 @@ void Wavetable3d::loadSpectrumData(int index) {
     renderer->setXAt(i, x);
     renderer->setXAt(invert_i, x);
 
-    float position = vital::futils::exp2(t * (vital::Wavetable::kFrequencyBins - 1.0f));
-    int frequency = std::min<int>(position, vital::Wavetable::kWaveformSize / 2 - 1);
-    float frequency_t = position - frequency;
-
-    float amplitude_from = std::abs(frequency_domain[frequency]);
-    float amplitude_to = std::abs(frequency_domain[frequency + 1]);
-    float amplitude = vital::utils::interpolate(amplitude_from, amplitude_to, frequency_t) * scale;
-
-    for (int f = last_frequency + 1; f < frequency; ++f)
-      amplitude = std::max(std::abs(frequency_domain[f]) * scale, amplitude);
-
-    last_frequency = frequency;
-
-    float db = vital::utils::magnitudeToDb(amplitude) + t * vital::Wavetable::kFrequencyBins * kDbBoostPerOctave;
-    float y = std::max(db - kMinDb, 0.0f) / kDbRange;
+    float y = vital::utils::interpolate(from_spectrum[i], to_spectrum[i], frame_t);
     renderer->setYAt(i, y * center + center);
     renderer->setYAt(invert_i, -y * center + center);
   }
@@ -767,16 +775,117 @@ vital::poly_int Wavetable3d::getDistortionPhaseValue() {
 }
 
 
-void Wavetable3d::loadIntoTimeDomain(int index) {
-  loadFrequencyData(index);
+bool Wavetable3d::warpMatches(const FrameCache& cache, int index) {
+  return cache.spectral_morph_type == spectral_morph_type_ && cache.spectral_morph == spectral_morph_value_[index] &&
+         cache.distortion_type == distortion_type_ && cache.distortion == distortion_value_[index] &&
+         !(~vital::poly_int::equal(cache.distortion_phase, distortion_phase_)).anyMask();
+}
+
+bool Wavetable3d::frameCacheMatches(const FrameCache& cache, int index, int num_spectrum_points) {
+  return cache.edit_count == wavetable_->getEditCount() && cache.num_spectrum_points == num_spectrum_points &&
+         warpMatches(cache, index);
+}
+
+int Wavetable3d::getNumSpectrumPoints() {
+  return std::min(getWidth(), vital::Wavetable::kWaveformSize / 2);
+}
+
+Wavetable3d::FrameCache* Wavetable3d::getFrameCache(int index) {
+  int num_spectrum_points = getNumSpectrumPoints();
+  if (index && !frame_caches_[0].moving && frameCacheMatches(frame_caches_[0], index, num_spectrum_points))
+    return &frame_caches_[0];
+
+  FrameCache* cache = &frame_caches_[index];
+  if (frameCacheMatches(*cache, index, num_spectrum_points)) {
+    cache->moving = false;
+    return cache;
+  }
+
+  // Returns nullptr while the warp settings change from paint to paint. Caching those frames would compute two
+  // frames per paint only to throw them away, so the caller draws the nearest frame directly instead.
+  cache->moving = cache->edit_count >= 0 && !warpMatches(*cache, index);
+  cache->edit_count = wavetable_->getEditCount();
+  cache->num_spectrum_points = num_spectrum_points;
+  cache->spectral_morph_type = spectral_morph_type_;
+  cache->spectral_morph = spectral_morph_value_[index];
+  cache->distortion_type = distortion_type_;
+  cache->distortion = distortion_value_[index];
+  cache->distortion_phase = distortion_phase_;
+  std::fill(std::begin(cache->wave_ready), std::end(cache->wave_ready), false);
+  std::fill(std::begin(cache->spectrum_ready), std::end(cache->spectrum_ready), false);
+  return cache->moving ? nullptr : cache;
+}
+
+const float* Wavetable3d::warpFrame(int index, int frame) {
+  current_wavetable_data_ = wavetable_->getAllData();
+  wavetable_index_ = std::min(frame, current_wavetable_data_->num_frames - 1);
   warpSpectrumToWave(index);
   warpPhase(index);
+  return process_frame_.time_domain;
 }
 
-void Wavetable3d::loadFrequencyData(int index) {
-  wavetable_index_ = std::round(getOutputsTotal(wave_frame_outputs_, frame_slider_->getValue())[index]);
-  current_wavetable_data_ = wavetable_->getAllData();
-  wavetable_index_ = std::max(0, std::min(wavetable_index_, current_wavetable_data_->num_frames - 1));
+const float* Wavetable3d::getCachedWave(FrameCache* cache, int index, int frame) {
+  if (!cache->wave_ready[frame]) {
+    if (cache->wave_data[frame] == nullptr)
+      cache->wave_data[frame] = std::make_unique<float[]>(size_);
+    memcpy(cache->wave_data[frame].get(), warpFrame(index, frame), size_ * sizeof(float));
+    cache->wave_ready[frame] = true;
+  }
+
+  return cache->wave_data[frame].get();
+}
+
+const float* Wavetable3d::getCachedSpectrum(FrameCache* cache, int index, int frame) {
+  if (cache->spectrum_ready[frame])
+    return cache->spectrum_data[frame].get();
+
+  memcpy(process_frame_.time_domain, getCachedWave(cache, index, frame), size_ * sizeof(float));
+  if (cache->spectrum_data[frame] == nullptr)
+    cache->spectrum_data[frame] = std::make_unique<float[]>(vital::Wavetable::kWaveformSize / 2 + 1);
+
+  computeSpectrum(cache->num_spectrum_points, cache->spectrum_data[frame].get());
+  cache->spectrum_ready[frame] = true;
+  return cache->spectrum_data[frame].get();
+}
+
+// Reads the wave in process_frame_'s time domain and writes num_points + 1 display heights to spectrum.
+void Wavetable3d::computeSpectrum(int num_points, float* spectrum) {
+  static constexpr float kMinDb = -30.0f;
+  static constexpr float kMaxDb = 50.0f;
+  static constexpr float kDbRange = kMaxDb - kMinDb;
+  static constexpr float kDbBoostPerOctave = 3.0f;
+
+  process_frame_.toFrequencyDomain();
+  std::complex<float>* frequency_domain = process_frame_.frequency_domain;
+
+  float scale = 1.0f / num_points;
+  int last_frequency = 0;
+  for (int i = 0; i <= num_points; ++i) {
+    float t = i * 1.0f / num_points;
+    float position = vital::futils::exp2(t * (vital::Wavetable::kFrequencyBins - 1.0f));
+    int frequency = std::min<int>(position, vital::Wavetable::kWaveformSize / 2 - 1);
+    float frequency_t = position - frequency;
+
+    float amplitude_from = std::abs(frequency_domain[frequency]);
+    float amplitude_to = std::abs(frequency_domain[frequency + 1]);
+    float amplitude = vital::utils::interpolate(amplitude_from, amplitude_to, frequency_t) * scale;
+
+    for (int f = last_frequency + 1; f < frequency; ++f)
+      amplitude = std::max(std::abs(frequency_domain[f]) * scale, amplitude);
+
+    last_frequency = frequency;
+
+    float db = vital::utils::magnitudeToDb(amplitude) + t * vital::Wavetable::kFrequencyBins * kDbBoostPerOctave;
+    spectrum[i] = std::max(db - kMinDb, 0.0f) / kDbRange;
+  }
+}
+
+float Wavetable3d::getFramePosition(int index, int& from_frame, int& to_frame) {
+  int last_frame = wavetable_->numFrames() - 1;
+  float position = vital::utils::clamp(wave_frame_[index], 0.0f, 1.0f * last_frame);
+  from_frame = position;
+  to_frame = std::min(from_frame + 1, last_frame);
+  return position - from_frame;
 }
 
 void Wavetable3d::warpSpectrumToWave(int index) {
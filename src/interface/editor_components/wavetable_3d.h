@@ -147,8 +147,38 @@ class Wavetable3d : public OpenGlComponent, public AudioFileDropSource {
     vital::Wavetable* getWavetable() { return wavetable_; }
 
   private:
+    // Display data for each wavetable frame under one set of spectral morph and distortion settings. Frames are
+    // computed the first time they're drawn and kept until the wavetable is edited or the settings change.
+    // Settings that move between paints, like modulated morph or distortion, skip the cache until they settle.
+    struct FrameCache {
+      FrameCache() : edit_count(-1), spectral_morph_type(-1), spectral_morph(0.0f),
+                     distortion_type(-1), distortion(0.0f), distortion_phase(0), num_spectrum_points(0),
+                     moving(false), wave_ready(), spectrum_ready() { }
+
+      int edit_count;
+      int spectral_morph_type;
+      float spectral_morph;
+      int distortion_type;
+      float distortion;
+      vital::poly_int distortion_phase;
+      int num_spectrum_points;
+      bool moving;
+      std::unique_ptr<float[]> wave_data[vital::kNumOscillatorWaveFrames];
+      std::unique_ptr<float[]> spectrum_data[vital::kNumOscillatorWaveFrames];
+      bool wave_ready[vital::kNumOscillatorWaveFrames];
+      bool spectrum_ready[vital::kNumOscillatorWaveFrames];
+    };
+
     bool updateRenderValues();
-    void loadIntoTimeDomain(int index);
+    bool warpMatches(const FrameCache& cache, int index);
+    bool frameCacheMatches(const FrameCache& cache, int index, int num_spectrum_points);
+    int getNumSpectrumPoints();
+    FrameCache* getFrameCache(int index);
+    const float* getCachedWave(FrameCache* cache, int index, int frame);
+    const float* getCachedSpectrum(FrameCache* cache, int index, int frame);
+    const float* warpFrame(int index, int frame);
+    void computeSpectrum(int num_points, float* spectrum);
+    float getFramePosition(int index, int& from_frame, int& to_frame);
     void loadWaveData(int index);
     void loadSpectrumData(int index);
     void drawPosition(OpenGlWrapper& open_gl, int index);
@@ -157,7 +187,6 @@ class Wavetable3d : public OpenGlComponent, public AudioFileDropSource {
     vital::poly_float getDistortionValue();
     vital::poly_float getSpectralMorphValue();
     vital::poly_int getDistortionPhaseValue();
-    void loadFrequencyData(int index);
     void warpSpectrumToWave(int index);
     void warpPhase(int index);
 
@@ -205,6 +234,8 @@ class Wavetable3d : public OpenGlComponent, public AudioFileDropSource {
     vital::poly_float process_wave_data_[vital::SynthOscillator::kSpectralBufferSize];
     const vital::Wavetable::WavetableData* current_wavetable_data_;
     int wavetable_index_;
+    FrameCache frame_caches_[vital::kNumChannels];
+    float uncached_spectrum_[vital::Wavetable::kWaveformSize / 2 + 1];
 
     bool animate_;
     bool loading_wavetable_;
@@ -315,7 +315,8 @@ void EqualizerSection::parentHierarchyChanged() {
 
 void EqualizerSection::renderOpenGlComponents(OpenGlWrapper& open_gl, bool animate) {
   if (parent_) {
-    int oversampling_amount = parent_->getSynth()->getEngine()->getOversamplingAmount();
+    vital::SoundEngine* engine = parent_->getSynth()->getEngine();
+    int oversampling_amount = engine->getEffectsAtBaseRate() ? 1 : engine->getOversamplingAmount();
     if (oversampling_amount >= 1)
       spectrogram_->setOversampleAmount(oversampling_amount);
   }
@@ -21,6 +21,7 @@
 #include "bend_section.h"
 #include "delete_section.h"
 #include "download_section.h"
+#include "engine_telemetry.h"
 #include "expired_section.h"
 #include "extra_mod_section.h"
 #include "skin.h"
@@ -34,6 +35,7 @@
 #include "modulation_manager.h"
 #include "modulation_matrix.h"
 #include "modulation_meter.h"
+#include "open_gl_line_renderer.h"
 #include "wavetable_edit_section.h"
 #include "overlay.h"
 #include "portamento_section.h"
@@ -45,6 +47,73 @@
 #include "update_check_section.h"
 #include "voice_section.h"
 
+// Shows average and worst render times and line vertex uploads when "show_frame_time" is set in the config.
+// Frames are collected on the OpenGL thread and the text is refreshed on the message thread.
+class FrameTimeOverlay : public PlainTextComponent, public Timer {
+  public:
+    static constexpr int kUpdateMs = 500;
+
+    FrameTimeOverlay() : PlainTextComponent("frame time", ""), last_frame_time_(0.0) {
+      setFontType(PlainTextComponent::kMono);
+      setJustification(Justification::centredRight);
+      clearFrames();
+      startTimer(kUpdateMs);
+    }
+
+    void addFrame(double render_ms) {
+      double now = Time::getMillisecondCounterHiRes();
+      OpenGlLineRenderer::UploadStats stats = OpenGlLineRenderer::takeUploadStats();
+
+      ScopedLock lock(frame_lock_);
+      if (last_frame_time_ > 0.0)
+        total_interval_ms_ += now - last_frame_time_;
+      last_frame_time_ = now;
+
+      num_frames_++;
+      total_render_ms_ += render_ms;
+      worst_render_ms_ = std::max(worst_render_ms_, render_ms);
+      line_stats_.full_uploads += stats.full_uploads;
+      line_stats_.partial_uploads += stats.partial_uploads;
+      line_stats_.unchanged += stats.unchanged;
+      line_stats_.uploaded_bytes += stats.uploaded_bytes;
+    }
+
+    void timerCallback() override {
+      ScopedLock lock(frame_lock_);
+      if (num_frames_ == 0)
+        return;
+
+      double frames = num_frames_;
+      String text = String(total_interval_ms_ / frames, 1) + " ms frame  " +
+                    String(total_render_ms_ / frames, 2) + " ms render (" + String(worst_render_ms_, 2) + " worst)  " +
+                    String(line_stats_.full_uploads / frames, 1) + " full / " +
+                    String(line_stats_.partial_uploads / frames, 1) + " partial / " +
+                    String(line_stats_.unchanged / frames, 1) + " unchanged lines  " +
+                    String(line_stats_.uploaded_bytes / (1024.0 * frames), 1) + " KB";
+      clearFrames();
+      setText(text);
+    }
+
+  private:
+    void clearFrames() {
+      num_frames_ = 0;
+      total_interval_ms_ = 0.0;
+      total_render_ms_ = 0.0;
+      worst_render_ms_ = 0.0;
+      line_stats_ = OpenGlLineRenderer::UploadStats();
+    }
+
+    CriticalSection frame_lock_;
+    double last_frame_time_;
+    int num_frames_;
+    double total_interval_ms_;
+    double total_render_ms_;
+    double worst_render_ms_;
+    OpenGlLineRenderer::UploadStats line_stats_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrameTimeOverlay)
+};
+
 FullInterface::FullInterface(SynthGuiData* synth_data) : SynthSection("full_interface"), width_(0), resized_width_(0),
                                                          last_render_scale_(0.0f), display_scale_(1.0f),
                                                          pixel_multiple_(1), setting_all_values_(false),
@@ -52,6 +121,7 @@ FullInterface::FullInterface(SynthGuiData* synth_data) : SynthSection("full_inte
                                                          enable_redo_background_(true), needs_download_(false),
                                                          open_gl_(open_gl_context_) {
   full_screen_section_ = nullptr;
+  telemetry_ = synth_data->synth->getTelemetry();
   Skin default_skin;
   setSkinValues(default_skin, true);
   default_skin.copyValuesToLookAndFeel(DefaultLookAndFeel::instance());
@@ -151,6 +221,12 @@ FullInterface::FullInterface(SynthGuiData* synth_data) : SynthSection("full_inte
   popup_display_2_->setAlwaysOnTop(true);
   popup_display_2_->setWantsKeyboardFocus(false);
 
+  if (LoadSave::shouldShowFrameTime()) {
+    frame_time_overlay_ = std::make_unique<FrameTimeOverlay>();
+    addOpenGlComponent(frame_time_overlay_.get());
+    frame_time_overlay_->setAlwaysOnTop(true);
+  }
+
   bank_exporter_ = std::make_unique<BankExporter>();
   addSubSection(bank_exporter_.get());
   bank_exporter_->setVisible(false);
@@ -242,7 +318,7 @@ FullInterface::FullInterface(SynthGuiData* synth_data) : SynthSection("full_inte
   open_gl_context_.attachTo(*this);
 }
 
-FullInterface::FullInterface() : SynthSection("EMPTY"), open_gl_(open_gl_context_) {
+FullInterface::FullInterface() : SynthSection("EMPTY"), telemetry_(nullptr), open_gl_(open_gl_context_) {
   Skin default_skin;
   setSkinValues(default_skin, true);
 
@@ -491,6 +567,12 @@ void FullInterface::resized() {
   int side_panel_height = height - top_height - padding;
   side_panel_->setBounds(side_panel_x, top + top_height, side_panel_width, side_panel_height);
 
+  if (frame_time_overlay_) {
+    int overlay_width = 520 * ratio;
+    frame_time_overlay_->setBounds(left + width - overlay_width - voice_padding, top, overlay_width, 16 * ratio);
+    frame_time_overlay_->setTextSize(10.0f * ratio);
+  }
+
   about_section_->setBounds(bounds);
   update_check_section_->setBounds(bounds);
   save_section_->setBounds(bounds);
@@ -533,7 +615,7 @@ void FullInterface::setOscilloscopeMemory(const vital::poly_float* memory) {
     master_controls_interface_->setOscilloscopeMemory(memory);
 }
 
-void FullInterface::setAudioMemory(const vital::StereoMemory* memory) {
+void FullInterface::setAudioMemory(const MemoryReadout* memory) {
   if (header_)
     header_->setAudioMemory(memory);
   if (master_controls_interface_)
@@ -625,6 +707,7 @@ void FullInterface::renderOpenGL() {
   if (unsupported_)
     return;
 
+  double render_start = Time::getMillisecondCounterHiRes();
   float render_scale = open_gl_.context.getRenderingScale();
   if (render_scale != last_render_scale_) {
     last_render_scale_ = render_scale;
@@ -632,10 +715,16 @@ void FullInterface::renderOpenGL() {
   }
 
   ScopedLock lock(open_gl_critical_section_);
+  if (telemetry_)
+    telemetry_->consume();
+
   open_gl_.display_scale = display_scale_;
   background_.render(open_gl_);
   modulation_manager_->renderMeters(open_gl_, animate_);
   renderOpenGlComponents(open_gl_, animate_);
+
+  if (frame_time_overlay_)
+    frame_time_overlay_->addFrame(Time::getMillisecondCounterHiRes() - render_start);
 }
 
 void FullInterface::openGLContextClosing() {
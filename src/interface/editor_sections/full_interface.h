@@ -35,11 +35,14 @@ class AboutSection;
 class BankExporter;
 class BendSection;
 class DeleteSection;
+class EngineTelemetry;
 class ExpiredSection;
 class ExtraModSection;
+class FrameTimeOverlay;
 class HeaderSection;
 class KeyboardInterface;
 class MasterControlsInterface;
+class MemoryReadout;
 class ModulationInterface;
 class ModulationManager;
 class PortamentoSection;
@@ -65,7 +68,7 @@ class FullInterface : public SynthSection, public AuthenticationSection::Listene
     virtual ~FullInterface();
 
     void setOscilloscopeMemory(const vital::poly_float* memory);
-    void setAudioMemory(const vital::StereoMemory* memory);
+    void setAudioMemory(const MemoryReadout* memory);
 
     void createModulationSliders(const vital::output_map& mono_modulations,
                                  const vital::output_map& poly_modulations);
@@ -203,6 +206,8 @@ class FullInterface : public SynthSection, public AuthenticationSection::Listene
     std::unique_ptr<DeleteSection> delete_section_;
     std::unique_ptr<DownloadSection> download_section_;
     std::unique_ptr<ExpiredSection> expired_section_;
+    std::unique_ptr<FrameTimeOverlay> frame_time_overlay_;
+    EngineTelemetry* telemetry_;
     SynthSection* full_screen_section_;
 
     int width_;
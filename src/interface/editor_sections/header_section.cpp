@@ -346,7 +346,7 @@ void HeaderSection::setOscilloscopeMemory(const vital::poly_float* memory) {
   oscilloscope_->setOscilloscopeMemory(memory);
 }
 
-void HeaderSection::setAudioMemory(const vital::StereoMemory* memory) {
+void HeaderSection::setAudioMemory(const MemoryReadout* memory) {
   spectrogram_->setAudioMemory(memory);
 }
 
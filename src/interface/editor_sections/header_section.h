@@ -24,6 +24,7 @@
 
 class BankExporter;
 class LogoButton;
+class MemoryReadout;
 class TabSelector;
 class Oscilloscope;
 class Spectrogram;
@@ -92,7 +93,7 @@ class HeaderSection : public SynthSection, public SaveSection::Listener,
     }
 
     void setOscilloscopeMemory(const vital::poly_float* memory);
-    void setAudioMemory(const vital::StereoMemory* memory);
+    void setAudioMemory(const MemoryReadout* memory);
 
     void notifyChange();
     void notifyFresh();
@@ -565,7 +565,7 @@ class OutputDisplays : public SynthSection {
       oscilloscope_->setOscilloscopeMemory(memory);
     }
 
-    void setAudioMemory(const vital::StereoMemory* memory) {
+    void setAudioMemory(const MemoryReadout* memory) {
       spectrogram_->setAudioMemory(memory);
     }
 
@@ -642,6 +642,6 @@ void MasterControlsInterface::setOscilloscopeMemory(const vital::poly_float* mem
   output_displays_->setOscilloscopeMemory(memory);
 }
 
-void MasterControlsInterface::setAudioMemory(const vital::StereoMemory* memory) {
+void MasterControlsInterface::setAudioMemory(const MemoryReadout* memory) {
   output_displays_->setAudioMemory(memory);
 }
@@ -24,6 +24,7 @@
 
 class TextSelector;
 class DisplaySettings;
+class MemoryReadout;
 class OversampleSettings;
 class VoiceSettings;
 class OutputDisplays;
@@ -74,7 +75,7 @@ class MasterControlsInterface  : public SynthSection {
     void setOscillatorBounds(int index, Rectangle<int> bounds) { oscillator_advanceds_[index]->setBounds(bounds); }
     void passOscillatorSection(int index, const OscillatorSection* oscillator);
     void setOscilloscopeMemory(const vital::poly_float* memory);
-    void setAudioMemory(const vital::StereoMemory* memory);
+    void setAudioMemory(const MemoryReadout* memory);
 
   private:
     std::unique_ptr<OscillatorAdvancedSection> oscillator_advanceds_[vital::kNumOscillators];
@@ -53,9 +53,10 @@ namespace {
 }
 
 PresetList::PresetList() : SynthSection("Preset List"),
-    num_view_presets_(0), hover_preset_(-1), click_preset_(-1), cache_position_(0),
+    num_view_presets_(0), source_(kAllPresets), hover_preset_(-1), click_preset_(-1), cache_position_(0),
     highlight_(Shaders::kColorFragment), hover_(Shaders::kColorFragment),
-    view_position_(0), sort_column_(kName), sort_ascending_(true) {
+    view_position_(0), sort_column_(kName), sort_ascending_(true), preset_info_cache_(&preset_index_.get()) {
+  preset_index_->addListener(this);
   addAndMakeVisible(browse_area_);
   browse_area_.setInterceptsMouseClicks(false, false);
   highlight_.setTargetComponent(&browse_area_);
@@ -83,6 +84,10 @@ PresetList::PresetList() : SynthSection("Preset List"),
   favorites_ = LoadSave::getFavorites();
 }
 
+PresetList::~PresetList() {
+  preset_index_->removeListener(this);
+}
+
 void PresetList::paintBackground(Graphics& g) {
   int title_width = getTitleWidth();
   g.setColour(findColour(Skin::kWidgetBackground, true));
@@ -351,19 +356,54 @@ void PresetList::finishRename() {
   renaming_preset_.moveFileTo(new_file);
   renaming_preset_ = File();
 
-  reloadPresets();
+  refreshIndex();
 }
 
 void PresetList::reloadPresets() {
   presets_.clear();
-  if (current_folder_.exists() && current_folder_.isDirectory())
-    current_folder_.findChildFiles(presets_, File::findFiles, true, "*." + vital::kPresetExtension);
+  if (source_ == kFavoritePresets)
+    getFavoritePresets(presets_);
+  else if (source_ == kFolderPresets && current_folder_.exists() && current_folder_.isDirectory()) {
+    if (preset_index_->isReady()) {
+      Array<File> presets;
+      preset_index_->getPresets(presets);
+      for (const File& preset : presets) {
+        if (preset.isAChildOf(current_folder_))
+          presets_.add(preset);
+      }
+    }
+    else
+      current_folder_.findChildFiles(presets_, File::findFiles, true, "*." + vital::kPresetExtension);
+  }
   else
-    LoadSave::getAllPresets(presets_);
+    getAllPresets(presets_);
   sort();
   redoCache();
 }
 
+void PresetList::getAllPresets(Array<File>& presets) {
+  if (preset_index_->isReady())
+    preset_index_->getPresets(presets);
+  else
+    LoadSave::getAllPresets(presets);
+}
+
+void PresetList::getFavoritePresets(Array<File>& presets) {
+  Array<File> all_presets;
+  getAllPresets(all_presets);
+
+  std::set<std::string> favorite_lookup = LoadSave::getFavorites();
+  for (const File& file : all_presets) {
+    if (favorite_lookup.count(file.getFullPathName().toStdString()))
+      presets.add(file);
+  }
+}
+
+void PresetList::presetIndexUpdated() {
+  preset_info_cache_.clear();
+  reloadPresets();
+}
+
 void PresetList::shiftSelectedPreset(int indices) {
   int num_presets = static_cast<int>(filtered_presets_.size());
   if (num_presets == 0)
@@ -402,9 +442,10 @@ void PresetList::filter(String filter_string, const std::set<std::string>& style
     if (match && tokens.size()) {
       String name = preset.getFileNameWithoutExtension().toLowerCase();
       String author = String(preset_info_cache_.getAuthor(preset)).toLowerCase();
+      String tags = preset_info_cache_.getTags(preset);
 
       for (const String& token : tokens) {
-        if (!name.contains(token) && !author.contains(token))
+        if (!name.contains(token) && !author.contains(token) && !tags.contains(token))
           match = false;
       }
     }
@@ -655,8 +696,9 @@ PresetBrowser::PresetBrowser() : SynthSection("preset_browser") {
 #endif
 
   Array<File> presets;
-  LoadSave::getAllPresets(presets);
+  preset_list_->getAllPresets(presets);
   preset_list_->setPresets(presets);
+  preset_list_->refreshIndex();
 
   setWantsKeyboardFocus(true);
   setMouseClickGrabsKeyboardFocus(true);
@@ -851,6 +893,7 @@ Rectangle<int> PresetBrowser::getInfoRect() {
 void PresetBrowser::loadPresets() {
   if (search_box_)
     search_box_->setText("");
+  preset_list_->refreshIndex();
   preset_list_->reloadPresets();
   preset_list_->filter("", std::set<std::string>());
 
@@ -1055,21 +1098,9 @@ void PresetBrowser::newSelection(File selection) {
 }
 
 void PresetBrowser::allSelected() {
-  Array<File> presets;
-  LoadSave::getAllPresets(presets);
-  preset_list_->setPresets(presets);
+  preset_list_->showAllPresets();
 }
 
 void PresetBrowser::favoritesSelected() {
-  Array<File> presets;
-  LoadSave::getAllPresets(presets);
-
-  Array<File> favorites;
-  std::set<std::string> favorite_lookup = LoadSave::getFavorites();
-
-  for (const File& file : presets) {
-    if (favorite_lookup.count(file.getFullPathName().toStdString()))
-      favorites.add(file);
-  }
-  preset_list_->setPresets(favorites);
+  preset_list_->showFavorites();
 }
@@ -25,15 +25,18 @@
 #include "open_gl_multi_quad.h"
 #include "overlay.h"
 #include "popup_browser.h"
+#include "preset_index.h"
 #include "save_section.h"
 #include "synth_section.h"
 
 class PresetInfoCache {
   public:
+    PresetInfoCache(PresetIndex* index = nullptr) : index_(index) { }
+
     std::string getAuthor(const File& preset) {
       std::string path = preset.getFullPathName().toStdString();
       if (author_cache_.count(path) == 0)
-        author_cache_[path] = LoadSave::getAuthorFromFile(preset).toStdString();
+        cacheInfo(preset, path);
 
       return author_cache_[path];
     }
@@ -41,17 +44,51 @@ class PresetInfoCache {
     std::string getStyle(const File& preset) {
       std::string path = preset.getFullPathName().toStdString();
       if (style_cache_.count(path) == 0)
-        style_cache_[path] = LoadSave::getStyleFromFile(preset).toLowerCase().toStdString();
+        cacheInfo(preset, path);
 
       return style_cache_[path];
     }
 
+    std::string getTags(const File& preset) {
+      std::string path = preset.getFullPathName().toStdString();
+      if (tags_cache_.count(path) == 0)
+        cacheInfo(preset, path);
+
+      return tags_cache_[path];
+    }
+
+    void clear() {
+      author_cache_.clear();
+      style_cache_.clear();
+      tags_cache_.clear();
+    }
+
   private:
+    void cacheInfo(const File& preset, const std::string& path) {
+      PresetIndex::Entry entry;
+      if (index_ && index_->getEntry(preset, entry)) {
+        author_cache_[path] = entry.author;
+        style_cache_[path] = String(entry.style).toLowerCase().toStdString();
+        String tags;
+        for (const std::string& tag : entry.tags)
+          tags += String(tag).toLowerCase() + " ";
+        tags_cache_[path] = tags.toStdString();
+        return;
+      }
+
+      author_cache_[path] = LoadSave::getAuthorFromFile(preset).toStdString();
+      style_cache_[path] = LoadSave::getStyleFromFile(preset).toLowerCase().toStdString();
+      tags_cache_[path] = "";
+    }
+
+    PresetIndex* index_;
     std::map<std::string, std::string> author_cache_;
     std::map<std::string, std::string> style_cache_;
+    std::map<std::string, std::string> tags_cache_;
 };
 
-class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::Listener {
+class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::Listener,
+                   public PresetIndex::Listener {
   public:
     class Listener {
       public:
@@ -71,6 +108,13 @@ class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::
       kNumColumns
     };
 
+    enum PresetSource {
+      kAllPresets,
+      kFolderPresets,
+      kFavoritePresets,
+      kNumPresetSources
+    };
+
     enum MenuOptions {
       kCancel,
       kOpenFileLocation,
@@ -216,6 +260,7 @@ class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::
     };
 
     PresetList();
+    virtual ~PresetList();
 
     void paintBackground(Graphics& g) override;
     void paintBackgroundShadow(Graphics& g) override { paintTabShadow(g); }
@@ -242,6 +287,10 @@ class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::
 
     void finishRename();
     void reloadPresets();
+    void getAllPresets(Array<File>& presets);
+    void getFavoritePresets(Array<File>& presets);
+    void refreshIndex() { preset_index_->refresh(); }
+    void presetIndexUpdated() override;
     void shiftSelectedPreset(int indices);
 
     void redoCache();
@@ -256,9 +305,18 @@ class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::
       listeners_.push_back(listener);
     }
     void setCurrentFolder(const File& folder) {
+      source_ = kFolderPresets;
       current_folder_ = folder;
       reloadPresets();
     }
+    void showAllPresets() {
+      source_ = kAllPresets;
+      reloadPresets();
+    }
+    void showFavorites() {
+      source_ = kFavoritePresets;
+      reloadPresets();
+    }
 
   private:
     void viewPositionChanged();
@@ -282,9 +340,11 @@ class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::
     File selected_preset_;
     File renaming_preset_;
     File current_folder_;
+    PresetSource source_;
     int hover_preset_;
     int click_preset_;
 
+    SharedResourcePointer<PresetIndex> preset_index_;
     PresetInfoCache preset_info_cache_;
 
     Component browse_area_;
@@ -16,9 +16,12 @@
 
 #include "reverb_section.h"
 
+#include "convolver.h"
+#include "reverb.h"
 #include "skin.h"
 #include "fonts.h"
 #include "synth_button.h"
+#include "synth_gui_interface.h"
 #include "synth_slider.h"
 #include "tab_selector.h"
 
@@ -197,3 +200,28 @@ void ReverbSection::sliderValueChanged(Slider* slider) {
   else
     SynthSection::sliderValueChanged(slider);
 }
+
+void ReverbSection::audioFileLoaded(const File& file) {
+  SynthGuiInterface* parent = findParentComponentOfClass<SynthGuiInterface>();
+  if (parent == nullptr)
+    return;
+
+  std::unique_ptr<AudioFormatReader> format_reader(formatManager().createReaderFor(file));
+  if (format_reader == nullptr || format_reader->sampleRate <= 0.0)
+    return;
+
+  long long max_samples = vital::Convolver::kMaxSeconds * format_reader->sampleRate;
+  int num_samples = (int)std::min<long long>(format_reader->lengthInSamples, max_samples);
+  if (num_samples <= 0)
+    return;
+
+  AudioSampleBuffer buffer(format_reader->numChannels > 1 ? 2 : 1, num_samples);
+  format_reader->read(&buffer, 0, num_samples, 0, true, true);
+  const float* right = buffer.getNumChannels() > 1 ? buffer.getReadPointer(1) : nullptr;
+
+  SynthBase* synth = parent->getSynth();
+  vital::Convolver* convolver = synth->getReverbConvolver();
+  convolver->loadImpulse(buffer.getReadPointer(0), right, num_samples, (int)format_reader->sampleRate);
+  convolver->setName(file.getFileNameWithoutExtension().toStdString());
+  synth->valueChangedInternal("reverb_mode", vital::Reverb::kConvolution);
+}
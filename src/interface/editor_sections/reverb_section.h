@@ -17,12 +17,13 @@
 #pragma once
 
 #include "JuceHeader.h"
+#include "audio_file_drop_source.h"
 #include "equalizer_response.h"
 #include "synth_section.h"
 
 class SynthButton;
 
-class ReverbSection : public SynthSection, public EqualizerResponse::Listener {
+class ReverbSection : public SynthSection, public EqualizerResponse::Listener, public AudioFileDropSource {
   public:
     static constexpr float kFeedbackFilterBuffer = 0.4f;
 
@@ -38,6 +39,9 @@ class ReverbSection : public SynthSection, public EqualizerResponse::Listener {
     void lowBandSelected() override;
     void midBandSelected() override { }
     void highBandSelected() override;
+
+    // Dropping an audio file loads it as the impulse response and switches to convolution mode.
+    void audioFileLoaded(const File& file) override;
   
   private:
     std::unique_ptr<SynthButton> on_;
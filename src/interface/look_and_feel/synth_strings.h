@@ -45,6 +45,11 @@ namespace strings {
     "Mid Ping Pong",
   };
 
+  const std::string kReverbModeNames[] = {
+    "Network",
+    "Convolution",
+  };
+
   const std::string kCompressorBandNames[] = {
     "Multiband",
     "Low Band",
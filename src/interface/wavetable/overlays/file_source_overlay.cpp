@@ -407,6 +407,7 @@ void FileSourceOverlay::sliderValueChanged(Slider* moved_slider) {
 
   if (moved_slider == window_fade_.get()) {
     current_frame_->setWindowFade(window_fade_->getValue());
+    current_frame_->markEdited();
     audio_thumbnail_->setWindowFade(window_fade_->getValue());
   }
 
@@ -493,6 +494,7 @@ void FileSourceOverlay::positionMovedRelative(float ratio, bool mouse_up) {
 
   if (num_samples && current_frame_) {
     current_frame_->setStartPosition(position);
+    current_frame_->markEdited();
     audio_thumbnail_->setWindowPosition(position / num_samples);
   }
 
@@ -541,6 +543,7 @@ void FileSourceOverlay::loadStartingPositionText() {
     int num_samples = file_source_->buffer()->size;
     if (num_samples) {
       current_frame_->setStartPosition(position);
+      current_frame_->markEdited();
       audio_thumbnail_->setWindowPosition(position / num_samples);
     }
 
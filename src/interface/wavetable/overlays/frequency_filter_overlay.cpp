@@ -141,10 +141,12 @@ void FrequencyFilterOverlay::sliderValueChanged(Slider* moved_slider) {
   else if (moved_slider == cutoff_.get()) {
     float value = cutoff_->getValue();
     current_frame_->setCutoff(value);
+    current_frame_->markEdited();
   }
   else if (moved_slider == shape_.get()) {
     float value = shape_->getValue();
     current_frame_->setShape(value);
+    current_frame_->markEdited();
   }
 
   notifyChanged(moved_slider == style_.get());
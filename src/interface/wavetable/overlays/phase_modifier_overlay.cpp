@@ -152,6 +152,7 @@ void PhaseModifierOverlay::phaseChanged(float phase, bool mouse_up) {
   slider_->setPhase(phase);
   editor_->setPhase(phase);
   current_frame_->setPhase(phase);
+  current_frame_->markEdited();
 
   notifyChanged(mouse_up);
 }
@@ -166,8 +167,10 @@ void PhaseModifierOverlay::sliderValueChanged(Slider* moved_slider) {
     notifyChanged(true);
   }
   else if (moved_slider == mix_.get()) {
-    if (current_frame_)
+    if (current_frame_) {
       current_frame_->setMix(mix_->getValue());
+      current_frame_->markEdited();
+    }
     notifyChanged(false);
   }
   else
@@ -180,7 +183,9 @@ void PhaseModifierOverlay::sliderDragEnded(Slider* moved_slider) {
 
 void PhaseModifierOverlay::setPhase(String phase_string) {
   float phase = 2.0f * vital::kPi / vital::kDegreesPerCycle * phase_string.getFloatValue();
-  if (current_frame_)
+  if (current_frame_) {
     current_frame_->setPhase(phase);
+    current_frame_->markEdited();
+  }
   editor_->setPhase(phase);
 }
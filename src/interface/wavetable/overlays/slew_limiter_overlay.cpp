@@ -97,6 +97,7 @@ void SlewLimiterOverlay::sliderValueChanged(Slider* moved_slider) {
     current_frame_->setSlewDownLimit(value);
   }
 
+  current_frame_->markEdited();
   notifyChanged(false);
 }
 
@@ -66,6 +66,7 @@ void WaveFoldOverlay::setEditBounds(Rectangle<int> bounds) {
 void WaveFoldOverlay::sliderValueChanged(Slider* moved_slider) {
   if (current_frame_) {
     current_frame_->setWaveFoldBoost(wave_fold_amount_->getValue());
+    current_frame_->markEdited();
     notifyChanged(false);
   }
 }
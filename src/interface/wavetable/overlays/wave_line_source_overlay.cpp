@@ -156,13 +156,18 @@ void WaveLineSourceOverlay::lineEditorScrolled(const MouseEvent& e, const MouseW
 }
 
 void WaveLineSourceOverlay::fileLoaded() {
+  if (current_frame_ == nullptr)
+    return;
 
+  current_frame_->markEdited();
+  notifyChanged(true);
 }
 
 void WaveLineSourceOverlay::pointChanged(int index, Point<float> position, bool mouse_up) {
   if (current_frame_ == nullptr)
     return;
 
+  current_frame_->markEdited();
   notifyChanged(mouse_up);
 }
 
@@ -170,6 +175,7 @@ void WaveLineSourceOverlay::powersChanged(bool mouse_up) {
   if (current_frame_ == nullptr)
     return;
 
+  current_frame_->markEdited();
   notifyChanged(mouse_up);
 }
 
@@ -257,8 +263,10 @@ void WaveLineSourceOverlay::sliderValueChanged(Slider* moved_slider) {
   else if (moved_slider == vertical_grid_.get())
     editor_->setGridSizeY(vertical_grid_->getValue());
   else if (moved_slider == pull_power_.get()) {
-    if (current_frame_)
+    if (current_frame_) {
       current_frame_->setPullPower(pull_power_->getValue());
+      current_frame_->markEdited();
+    }
   }
 
   notifyChanged(false);
@@ -37,6 +37,7 @@ namespace {
 } // namespace
 
 WaveSourceOverlay::WaveSourceOverlay() : WavetableComponentOverlay("WAVE SOURCE"), wave_source_(nullptr) {
+  current_keyframe_ = nullptr;
   current_frame_ = nullptr;
   int waveform_size = vital::WaveFrame::kWaveformSize;
   oscillator_ = std::make_unique<WaveSourceEditor>(waveform_size);
@@ -128,12 +129,14 @@ void WaveSourceOverlay::frameSelected(WavetableKeyframe* keyframe) {
     oscillator_->setVisible(false);
     frequency_amplitudes_->setVisible(false);
     frequency_phases_->setVisible(false);
+    current_keyframe_ = nullptr;
     current_frame_ = nullptr;
   }
   else if (keyframe->owner() == wave_source_) {
     oscillator_->setVisible(true);
     frequency_amplitudes_->setVisible(true);
     frequency_phases_->setVisible(true);
+    current_keyframe_ = keyframe;
     current_frame_ = wave_source_->getWaveFrame(keyframe->index());
     oscillator_->loadWaveform(current_frame_->time_domain);
     updateFrequencyDomain(current_frame_->frequency_domain);
@@ -227,6 +230,7 @@ void WaveSourceOverlay::valuesChanged(int start, int end, bool mouse_up) {
   current_frame_->toFrequencyDomain();
   updateFrequencyDomain(current_frame_->frequency_domain);
 
+  current_keyframe_->markEdited();
   notifyChanged(mouse_up);
 }
 
@@ -264,5 +268,6 @@ void WaveSourceOverlay::barsChanged(int start, int end, bool mouse_up) {
   loadFrequencyDomain();
 
   oscillator_->loadWaveform(current_frame_->time_domain);
+  current_keyframe_->markEdited();
   notifyChanged(mouse_up);
 }
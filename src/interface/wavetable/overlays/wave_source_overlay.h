@@ -64,11 +64,13 @@ class WaveSourceOverlay : public WavetableComponentOverlay,
 
     void setWaveSource(WaveSource* wave_source) {
       wave_source_ = wave_source;
+      current_keyframe_ = nullptr;
       current_frame_ = nullptr;
     }
 
   protected:
     WaveSource* wave_source_;
+    WavetableKeyframe* current_keyframe_;
     vital::WaveFrame* current_frame_;
     std::unique_ptr<WaveSourceEditor> oscillator_;
     std::unique_ptr<BarEditor> frequency_amplitudes_;
@@ -134,6 +134,7 @@ void WaveWarpOverlay::sliderValueChanged(Slider* moved_slider) {
     current_frame_->setVerticalPower(value);
   }
 
+  current_frame_->markEdited();
   notifyChanged(false);
 }
 
@@ -146,6 +146,7 @@ void WaveWindowOverlay::windowChanged(bool left, bool mouse_up) {
 
   current_frame_->setLeft(editor_->getLeftPosition());
   current_frame_->setRight(editor_->getRightPosition());
+  current_frame_->markEdited();
   left_position_->setValue(editor_->getLeftPosition(), sendNotificationSync);
   right_position_->setValue(editor_->getRightPosition(), sendNotificationSync);
   notifyChanged(mouse_up);
@@ -166,6 +167,7 @@ void WaveWindowOverlay::sliderValueChanged(Slider* moved_slider) {
     float value = std::min(left_position_->getValue(), right_position_->getValue());
     left_position_->setValue(value, dontSendNotification);
     current_frame_->setLeft(value);
+    current_frame_->markEdited();
     editor_->setPositions(value, right_position_->getValue());
     notifyChanged(false);
   }
@@ -173,6 +175,7 @@ void WaveWindowOverlay::sliderValueChanged(Slider* moved_slider) {
     float value = std::max(right_position_->getValue(), left_position_->getValue());
     right_position_->setValue(value, dontSendNotification);
     current_frame_->setRight(value);
+    current_frame_->markEdited();
     editor_->setPositions(left_position_->getValue(), value);
     notifyChanged(false);
   }
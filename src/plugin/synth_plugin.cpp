@@ -17,27 +17,34 @@
 #include "synth_plugin.h"
 #include "synth_editor.h"
 #include "sound_engine.h"
+#include "binary_preset.h"
 #include "load_save.h"
 
 SynthPlugin::SynthPlugin() {
   last_seconds_time_ = 0.0;
+  host_changes_ = false;
+  block_processed_ = false;
 
   int num_params = vital::Parameters::getNumParameters();
+  bridges_.assign(num_params, nullptr);
   for (int i = 0; i < num_params; ++i) {
     const vital::ValueDetails* details = vital::Parameters::getDetails(i);
-    if (controls_.count(details->name) == 0)
+    if (getControl(i) == nullptr)
       continue;
 
-    ValueBridge* bridge = new ValueBridge(details->name, controls_[details->name]);
+    ValueBridge* bridge = new ValueBridge(details->name, getControl(i));
     bridge->setListener(this);
     bridge_lookup_[details->name] = bridge;
+    bridges_[i] = bridge;
     addParameter(bridge);
   }
 
   bypass_parameter_ = bridge_lookup_["bypass"];
+  startTimerHz(kHostChangeCheckHz);
 }
 
 SynthPlugin::~SynthPlugin() {
+  stopTimer();
   midi_manager_ = nullptr;
   keyboard_state_ = nullptr;
 }
@@ -59,11 +66,10 @@ void SynthPlugin::endChangeGesture(const std::string& name) {
     bridge_lookup_[name]->endChangeGesture();
 }
 
-void SynthPlugin::setValueNotifyHost(const std::string& name, vital::mono_float value) {
-  if (bridge_lookup_.count(name)) {
-    vital::mono_float plugin_value = bridge_lookup_[name]->convertToPluginValue(value);
-    bridge_lookup_[name]->setValueNotifyHost(plugin_value);
-  }
+void SynthPlugin::setValueNotifyHost(int id, vital::mono_float value) {
+  ValueBridge* bridge = bridges_[id];
+  if (bridge)
+    bridge->setValueNotifyHost(bridge->convertToPluginValue(value));
 }
 
 const CriticalSection& SynthPlugin::getCriticalSection() {
@@ -138,12 +144,17 @@ void SynthPlugin::releaseResources() {
 void SynthPlugin::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midi_messages) {
   static constexpr double kSecondsPerMinute = 60.0f;
 
+  int total_samples = buffer.getNumSamples();
+  block_processed_ = true;
+  collectValueChanges(total_samples);
+  applyValueChanges(0, total_samples);
+
   if (bypass_parameter_->getValue()) {
+    applyValueChanges(total_samples, total_samples);
     processBlockBypassed(buffer, midi_messages);
     return;
   }
 
-  int total_samples = buffer.getNumSamples();
   int num_channels = getTotalNumOutputChannels();
   AudioPlayHead* play_head = getPlayHead();
   if (play_head) {
@@ -157,16 +168,24 @@ void SynthPlugin::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midi_messa
     }
   }
 
-  processModulationChanges();
+  if (isNonRealtime())
+    flushModulationChanges();
+  else
+    processModulationChanges();
+
   if (total_samples)
     processKeyboardEvents(midi_messages, total_samples);
 
   double sample_time = 1.0 / AudioProcessor::getSampleRate();
   for (int sample_offset = 0; sample_offset < total_samples;) {
-    int num_samples = std::min<int>(total_samples - sample_offset, vital::kMaxBufferSize);
+    // Parameter changes with a sample and midi learned controllers start their own sub-block to land on it.
+    int end_sample = std::min<int>(total_samples, sample_offset + vital::kMaxBufferSize);
+    end_sample = applyValueChanges(sample_offset, end_sample);
+    end_sample = getNextMidiLearnSample(midi_messages, sample_offset, end_sample);
+    int num_samples = end_sample - sample_offset;
 
     engine_->correctToTime(last_seconds_time_);
-    processMidi(midi_messages, sample_offset, sample_offset + num_samples);
+    processMidi(midi_messages, sample_offset, end_sample);
     processAudio(&buffer, num_channels, num_samples, sample_offset);
 
     last_seconds_time_ += num_samples * sample_time;
@@ -182,37 +201,80 @@ AudioProcessorEditor* SynthPlugin::createEditor() {
   return new SynthEditor(*this);
 }
 
-void SynthPlugin::parameterChanged(std::string name, vital::mono_float value) {
-  valueChangedExternal(name, value);
+void SynthPlugin::parameterChanged(int id, vital::mono_float value) {
+  queueValueChange(id, value);
+  host_changes_ = true;
+}
+
+void SynthPlugin::timerCallback() {
+  checkOutputMemory();
+
+  // Without audio running nothing else applies host changes, so they're applied here instead.
+  if (!block_processed_.exchange(false)) {
+    ScopedLock lock(getCallbackLock());
+    flushValueChanges();
+  }
+
+  if (!host_changes_.exchange(false))
+    return;
+
+  SynthGuiInterface* gui_interface = getGuiInterface();
+  if (gui_interface == nullptr)
+    return;
+
+  for (ValueBridge* bridge : bridges_) {
+    vital::mono_float value = 0.0f;
+    if (bridge && bridge->consumeHostChange(value)) {
+      std::string name = bridge->getControlName().toStdString();
+      gui_interface->updateGuiControl(name, value);
+      if (name != "pitch_wheel")
+        gui_interface->notifyChange();
+    }
+  }
 }
 
 void SynthPlugin::getStateInformation(MemoryBlock& dest_data) {
-  json data = LoadSave::stateToJson(this, getCallbackLock());
-  data["tuning"] = getTuning()->stateToJson();
+  {
+    // The host can change parameters while it isn't processing and those still belong in the saved state.
+    ScopedLock lock(getCallbackLock());
+    flushValueChanges();
+  }
 
-  String data_string = data.dump();
-  MemoryOutputStream stream;
-  stream.writeString(data_string);
-  dest_data.append(stream.getData(), stream.getDataSize());
+  json extra_fields;
+  extra_fields["tuning"] = getTuning()->stateToJson();
+  LoadSave::stateToBuffer(this, extra_fields, state_buffers_);
+  dest_data.append(state_buffers_.state.data(), state_buffers_.state.size());
 }
 
 void SynthPlugin::setStateInformation(const void* data, int size_in_bytes) {
-  MemoryInputStream stream(data, size_in_bytes, false);
-  String data_string = stream.readEntireStreamAsString();
-
   pauseProcessing(true);
+  bool loaded = true;
   try {
-    json json_data = json::parse(data_string.toStdString());
-    LoadSave::jsonToState(this, save_info_, json_data);
+    json json_data;
+    if (BinaryPreset::isBinaryPreset(data, size_in_bytes))
+      loaded = BinaryPreset::readFromMemory(data, size_in_bytes, json_data);
+    else {
+      // Older sessions saved the state as a null terminated json string.
+      const char* text = static_cast<const char*>(data);
+      json_data = json::parse(text, text + strnlen(text, size_in_bytes));
+    }
 
-    if (json_data.count("tuning"))
-      getTuning()->jsonToState(json_data["tuning"]);
+    if (loaded) {
+      LoadSave::jsonToState(this, save_info_, json_data);
+
+      if (json_data.count("tuning"))
+        getTuning()->jsonToState(json_data["tuning"]);
+    }
   }
   catch (const json::exception& e) {
+    loaded = false;
+  }
+  pauseProcessing(false);
+
+  if (!loaded) {
     std::string error = "There was an error open the preset. Preset file is corrupted.";
     AlertWindow::showNativeDialogBox("Error opening preset", error, false);
   }
-  pauseProcessing(false);
 
   SynthGuiInterface* editor = getGuiInterface();
   if (editor)
@@ -18,14 +18,16 @@
 
 #include "JuceHeader.h"
 
+#include "load_save.h"
 #include "synth_base.h"
 #include "value_bridge.h"
 
 class ValueBridge;
 
-class SynthPlugin : public SynthBase, public AudioProcessor, public ValueBridge::Listener {
+class SynthPlugin : public SynthBase, public AudioProcessor, public ValueBridge::Listener, private Timer {
   public:
     static constexpr int kSetProgramWaitMilliseconds = 500;
+    static constexpr int kHostChangeCheckHz = 30;
 
     SynthPlugin();
     virtual ~SynthPlugin();
@@ -33,7 +35,7 @@ class SynthPlugin : public SynthBase, public AudioProcessor, public ValueBridge:
     SynthGuiInterface* getGuiInterface() override;
     void beginChangeGesture(const std::string& name) override;
     void endChangeGesture(const std::string& name) override;
-    void setValueNotifyHost(const std::string& name, vital::mono_float value) override;
+    void setValueNotifyHost(int id, vital::mono_float value) override;
     const CriticalSection& getCriticalSection() override;
     void pauseProcessing(bool pause) override;
 
@@ -67,15 +69,22 @@ class SynthPlugin : public SynthBase, public AudioProcessor, public ValueBridge:
     void setStateInformation(const void* data, int size_in_bytes) override;
     AudioProcessorParameter* getBypassParameter() const override { return bypass_parameter_; }
 
-    void parameterChanged(std::string name, vital::mono_float value) override;
+    void parameterChanged(int id, vital::mono_float value) override;
+    bool getPendingValue(int id, vital::mono_float& value) const override { return getQueuedValue(id, value); }
 
   private:
+    void timerCallback() override;
+
     ValueBridge* bypass_parameter_;
     double last_seconds_time_;
 
     AudioPlayHead::CurrentPositionInfo position_info_;
 
     std::map<std::string, ValueBridge*> bridge_lookup_;
+    std::vector<ValueBridge*> bridges_;
+    std::atomic<bool> host_changes_;
+    std::atomic<bool> block_processed_;
+    LoadSave::StateBuffers state_buffers_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SynthPlugin)
 };
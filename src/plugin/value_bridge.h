@@ -25,14 +25,15 @@ class ValueBridge : public AudioProcessorParameter {
     class Listener {
       public:
         virtual ~Listener() { }
-        virtual void parameterChanged(std::string name, vital::mono_float value) = 0;
+        virtual void parameterChanged(int id, vital::mono_float value) = 0;
+        virtual bool getPendingValue(int id, vital::mono_float& value) const = 0;
     };
 
     ValueBridge() = delete;
 
     ValueBridge(std::string name, vital::Value* value) :
         AudioProcessorParameter(), name_(name), value_(value), listener_(nullptr),
-        source_changed_(false) {
+        source_changed_(false), host_value_(0.0f), host_changed_(false) {
       details_ = vital::Parameters::getDetails(name);
       span_ = details_.max - details_.min;
       if (details_.value_scale == vital::ValueDetails::kIndexed)
@@ -40,6 +41,10 @@ class ValueBridge : public AudioProcessorParameter {
     }
 
     float getValue() const override {
+      // A change the engine hasn't applied yet is still the value the host expects to read back.
+      vital::mono_float pending_value = 0.0f;
+      if (listener_ && listener_->getPendingValue(details_.id, pending_value))
+        return convertToPluginValue(pending_value);
       return convertToPluginValue(value_->value());
     }
 
@@ -47,7 +52,9 @@ class ValueBridge : public AudioProcessorParameter {
       if (listener_ && !source_changed_) {
         source_changed_ = true;
         vital::mono_float synth_value = convertToEngineValue(value);
-        listener_->parameterChanged(name_.toStdString(), synth_value);
+        host_value_ = synth_value;
+        host_changed_ = true;
+        listener_->parameterChanged(details_.id, synth_value);
         source_changed_ = false;
       }
     }
@@ -56,6 +63,17 @@ class ValueBridge : public AudioProcessorParameter {
       listener_ = listener;
     }
 
+    String getControlName() const { return name_; }
+
+    // Returns true once per host change, with the latest value the host set.
+    bool consumeHostChange(vital::mono_float& value) {
+      if (!host_changed_.exchange(false))
+        return false;
+
+      value = host_value_;
+      return true;
+    }
+
     float getDefaultValue() const override {
       return convertToPluginValue(details_.default_value);
     }
@@ -174,6 +192,8 @@ class ValueBridge : public AudioProcessorParameter {
     vital::Value* value_;
     Listener* listener_;
     bool source_changed_;
+    std::atomic<vital::mono_float> host_value_;
+    std::atomic<bool> host_changed_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ValueBridge)
 };
@@ -277,6 +277,7 @@ class SynthApplication : public JUCEApplication {
         std::cout << "  -m, --midi                          Note to play (with --render)." << newLine;
         std::cout << "  -l, --length                        Not length to play (with --render)." << newLine;
         std::cout << "  -b, --bpm                           BPM to play (with --render)." << newLine;
+        std::cout << "  --fast                              Skip the realtime warmup (with --render)." << newLine;
         std::cout << "  --images                            Render oscilloscope images (with --render)." << newLine << newLine;
         quit();
       }
@@ -455,6 +456,7 @@ class SynthApplication : public JUCEApplication {
       }
       else if (command.contains(" --render ")) {
         bool images = command.contains(" --images ");
+        bool fast = command.contains(" --fast ");
         HeadlessSynth synth;
         File output_file;
         StringArray args = getCommandLineParameterArray();
@@ -472,7 +474,8 @@ class SynthApplication : public JUCEApplication {
             break;
           }
 
-          last_arg_was_option = arg[0] == '-' && arg != "--headless" && arg != "--render" && arg != "--images";
+          last_arg_was_option = arg[0] == '-' && arg != "--headless" && arg != "--render" && arg != "--images" &&
+                                arg != "--fast";
         }
 
         int note = 48;
@@ -490,7 +493,7 @@ class SynthApplication : public JUCEApplication {
         if (!bpm_setting.isEmpty())
           bpm = bpm_setting.getIntValue();
 
-        synth.renderAudioToFile(output_file, length, bpm, { note }, images);
+        synth.renderAudioToFile(output_file, length, bpm, { note }, images, fast);
         quit();
       }
       else {
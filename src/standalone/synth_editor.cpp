@@ -123,6 +123,8 @@ void SynthEditor::resized() {
 }
 
 void SynthEditor::timerCallback() {
+  checkOutputMemory();
+
   StringArray midi_ins(MidiInput::getDevices());
 
   for (int i = 0; i < midi_ins.size(); ++i) {
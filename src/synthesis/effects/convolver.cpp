@@ -0,0 +1,333 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "convolver.h"
+
+#include "synth_constants.h"
+#include "utils.h"
+
+#include <thread>
+
+namespace vital {
+
+  namespace {
+    void packSpectrum(const mono_float* buffer, poly_float* dest) {
+      mono_float* real = reinterpret_cast<mono_float*>(dest);
+      mono_float* imaginary = real + Convolver::kPartitionSize;
+      for (int i = 0; i < Convolver::kPartitionSize; ++i) {
+        real[i] = buffer[2 * i];
+        imaginary[i] = buffer[2 * i + 1];
+      }
+      imaginary[0] = buffer[Convolver::kFftSize];
+    }
+
+    void unpackSpectrum(const poly_float* spectrum, mono_float* buffer) {
+      const mono_float* real = reinterpret_cast<const mono_float*>(spectrum);
+      const mono_float* imaginary = real + Convolver::kPartitionSize;
+      for (int i = 0; i < Convolver::kPartitionSize; ++i) {
+        buffer[2 * i] = real[i];
+        buffer[2 * i + 1] = imaginary[i];
+      }
+      buffer[1] = 0.0f;
+      buffer[Convolver::kFftSize] = imaginary[0];
+      buffer[Convolver::kFftSize + 1] = 0.0f;
+    }
+
+    void clearPoly(poly_float* buffer, int size) {
+      for (int i = 0; i < size; ++i)
+        buffer[i] = 0.0f;
+    }
+  } // namespace
+
+  Convolver::Convolver() : source_sample_rate_(kDefaultSampleRate), sample_rate_(kDefaultSampleRate),
+                           transform_(kFftBits), current_(nullptr), active_(nullptr) {
+    transform_buffer_ = std::make_unique<mono_float[]>(2 * kFftSize);
+  }
+
+  Convolver::~Convolver() { }
+
+  void Convolver::loadImpulse(const mono_float* left, const mono_float* right, int length, int sample_rate) {
+    length = std::max(0, std::min(length, kMaxSeconds * sample_rate));
+    left_.assign(left, left + length);
+    if (right)
+      right_.assign(right, right + length);
+    else
+      right_.clear();
+
+    source_sample_rate_ = sample_rate;
+    setKernel(createKernel(sample_rate_));
+  }
+
+  void Convolver::clearImpulse() {
+    name_ = "";
+    left_.clear();
+    right_.clear();
+    setKernel(nullptr);
+  }
+
+  void Convolver::setSampleRate(int sample_rate) {
+    if (sample_rate == sample_rate_)
+      return;
+
+    sample_rate_ = sample_rate;
+    if (!left_.empty())
+      setKernel(createKernel(sample_rate_));
+  }
+
+  int Convolver::getNumPartitions() const {
+    if (kernel_ == nullptr)
+      return 0;
+    return kernel_->num_partitions + 1;
+  }
+
+  std::unique_ptr<Convolver::Kernel> Convolver::createKernel(int sample_rate) const {
+    if (left_.empty() || source_sample_rate_ <= 0 || sample_rate <= 0)
+      return nullptr;
+
+    int num_channels = right_.empty() ? 1 : 2;
+    int source_length = static_cast<int>(left_.size());
+    double ratio = source_sample_rate_ / (1.0 * sample_rate);
+    int length = std::max(1, std::min(static_cast<int>(source_length / ratio), kMaxSeconds * sample_rate));
+
+    // Impulses are resampled linearly to the processing rate and normalized to unit energy so any
+    // length and rate plays back at a similar level.
+    std::vector<mono_float> taps[2];
+    double max_energy = 0.0;
+    for (int channel = 0; channel < num_channels; ++channel) {
+      const std::vector<mono_float>& source = channel ? right_ : left_;
+      taps[channel].resize(length);
+      double energy = 0.0;
+      for (int i = 0; i < length; ++i) {
+        double position = i * ratio;
+        int index = std::min(static_cast<int>(position), source_length - 1);
+        mono_float next = index + 1 < source_length ? source[index + 1] : 0.0f;
+        mono_float t = position - index;
+        taps[channel][i] = source[index] + t * (next - source[index]);
+        energy += taps[channel][i] * taps[channel][i];
+      }
+      max_energy = std::max(max_energy, energy);
+    }
+
+    mono_float scale = max_energy > 0.0 ? 1.0f / sqrtf(max_energy) : 0.0f;
+    std::unique_ptr<Kernel> kernel = std::make_unique<Kernel>();
+    kernel->num_channels = num_channels;
+    kernel->num_partitions = (length - 1) / kPartitionSize;
+    kernel->position = 0;
+    kernel->history_index = 0;
+
+    kernel->head = std::make_unique<poly_float[]>(kPartitionSize);
+    clearPoly(kernel->head.get(), kPartitionSize);
+    for (int i = 0; i < kPartitionSize && i < length; ++i) {
+      kernel->head[i].set(0, scale * taps[0][i]);
+      kernel->head[i].set(1, scale * taps[num_channels - 1][i]);
+    }
+
+    int spectrum_size = 2 * kBinVectors * kernel->num_partitions;
+    kernel->spectra = std::make_unique<poly_float[]>(num_channels * spectrum_size);
+    kernel->history = std::make_unique<poly_float[]>(2 * spectrum_size);
+    kernel->input = std::make_unique<poly_float[]>(2 * kPartitionSize);
+    kernel->tail = std::make_unique<mono_float[]>(2 * kPartitionSize);
+    clearPoly(kernel->history.get(), 2 * spectrum_size);
+    clearPoly(kernel->input.get(), 2 * kPartitionSize);
+
+    FourierTransform transform(kFftBits);
+    std::unique_ptr<mono_float[]> buffer = std::make_unique<mono_float[]>(2 * kFftSize);
+    for (int channel = 0; channel < num_channels; ++channel) {
+      for (int p = 0; p < kernel->num_partitions; ++p) {
+        std::fill(buffer.get(), buffer.get() + 2 * kFftSize, 0.0f);
+        int start = (p + 1) * kPartitionSize;
+        int end = std::min(length, start + kPartitionSize);
+        for (int i = start; i < end; ++i)
+          buffer[i - start] = scale * taps[channel][i];
+
+        transform.transformRealForward(buffer.get());
+        packSpectrum(buffer.get(), kernel->spectra.get() + getSpectrumIndex(kernel.get(), channel, p));
+      }
+    }
+
+    return kernel;
+  }
+
+  void Convolver::setKernel(std::unique_ptr<Kernel> kernel) {
+    std::unique_ptr<Kernel> old_kernel = std::move(kernel_);
+    kernel_ = std::move(kernel);
+
+    current_ = kernel_.get();
+    while (old_kernel && active_.load() == old_kernel.get())
+      std::this_thread::yield(); // Wait for audio thread to finish using old_kernel.
+  }
+
+  void Convolver::reset() {
+    Kernel* kernel = current_.load();
+    if (kernel == nullptr)
+      return;
+
+    kernel->position = 0;
+    kernel->history_index = 0;
+    clearPoly(kernel->history.get(), 2 * 2 * kBinVectors * kernel->num_partitions);
+    clearPoly(kernel->input.get(), 2 * kPartitionSize);
+    std::fill(kernel->tail.get(), kernel->tail.get() + 2 * kPartitionSize, 0.0f);
+  }
+
+  void Convolver::convolveBlock(Kernel* kernel) {
+    int num_partitions = kernel->num_partitions;
+    poly_float* input = kernel->input.get();
+    if (num_partitions) {
+      mono_float* buffer = transform_buffer_.get();
+      kernel->history_index = (kernel->history_index + 1) % num_partitions;
+
+      for (int channel = 0; channel < 2; ++channel) {
+        for (int i = 0; i < kFftSize; ++i)
+          buffer[i] = input[i][channel];
+
+        transform_.transformRealForward(buffer);
+        packSpectrum(buffer, kernel->history.get() + getSpectrumIndex(kernel, channel, kernel->history_index));
+      }
+
+      for (int channel = 0; channel < 2; ++channel) {
+        poly_float real[kBinVectors];
+        poly_float imaginary[kBinVectors];
+        clearPoly(real, kBinVectors);
+        clearPoly(imaginary, kBinVectors);
+        mono_float dc = 0.0f;
+        mono_float nyquist = 0.0f;
+
+        int kernel_channel = channel % kernel->num_channels;
+        for (int p = 0; p < num_partitions; ++p) {
+          int slot = kernel->history_index - p;
+          if (slot < 0)
+            slot += num_partitions;
+
+          const poly_float* response = kernel->spectra.get() + getSpectrumIndex(kernel, kernel_channel, p);
+          const poly_float* history = kernel->history.get() + getSpectrumIndex(kernel, channel, slot);
+          for (int i = 0; i < kBinVectors; ++i) {
+            poly_float history_real = history[i];
+            poly_float history_imaginary = history[kBinVectors + i];
+            poly_float response_real = response[i];
+            poly_float response_imaginary = response[kBinVectors + i];
+            real[i] = poly_float::mulAdd(real[i], history_real, response_real);
+            real[i] = poly_float::mulSub(real[i], history_imaginary, response_imaginary);
+            imaginary[i] = poly_float::mulAdd(imaginary[i], history_real, response_imaginary);
+            imaginary[i] = poly_float::mulAdd(imaginary[i], history_imaginary, response_real);
+          }
+
+          // DC and Nyquist share the first bin and are both real.
+          dc += history[0][0] * response[0][0];
+          nyquist += history[kBinVectors][0] * response[kBinVectors][0];
+        }
+
+        real[0].set(0, dc);
+        imaginary[0].set(0, nyquist);
+
+        poly_float spectrum[2 * kBinVectors];
+        for (int i = 0; i < kBinVectors; ++i) {
+          spectrum[i] = real[i];
+          spectrum[kBinVectors + i] = imaginary[i];
+        }
+        unpackSpectrum(spectrum, buffer);
+        transform_.transformRealInverse(buffer);
+        memcpy(kernel->tail.get() + channel * kPartitionSize, buffer + kPartitionSize,
+               kPartitionSize * sizeof(mono_float));
+      }
+    }
+
+    for (int i = 0; i < kPartitionSize; ++i)
+      input[i] = input[kPartitionSize + i];
+  }
+
+  void Convolver::process(const poly_float* audio_in, poly_float* audio_out, int num_samples) {
+    Kernel* kernel = nullptr;
+    do {
+      kernel = current_.load();
+      active_ = kernel;
+    } while (kernel != current_.load());
+
+    if (kernel == nullptr) {
+      for (int i = 0; i < num_samples; ++i)
+        audio_out[i] = 0.0f;
+      return;
+    }
+
+    poly_float* input = kernel->input.get();
+    const poly_float* head = kernel->head.get();
+    const mono_float* tail = kernel->tail.get();
+    for (int i = 0; i < num_samples; ++i) {
+      int position = kernel->position;
+      poly_float* current = input + kPartitionSize + position;
+      *current = audio_in[i] & constants::kFirstMask;
+
+      poly_float total = 0.0f;
+      for (int t = 0; t < kPartitionSize; ++t)
+        total = poly_float::mulAdd(total, head[t], current[-t]);
+
+      total.set(0, total[0] + tail[position]);
+      total.set(1, total[1] + tail[kPartitionSize + position]);
+      audio_out[i] = total + utils::swapVoices(total);
+
+      kernel->position = position + 1;
+      if (kernel->position == kPartitionSize) {
+        convolveBlock(kernel);
+        kernel->position = 0;
+      }
+    }
+
+    active_ = nullptr;
+  }
+
+  json Convolver::stateToJson(bool raw_data) {
+    json data;
+    data["name"] = name_;
+    int length = getImpulseLength();
+    data["length"] = length;
+    data["sample_rate"] = source_sample_rate_;
+
+    std::unique_ptr<int16_t[]> pcm_data = std::make_unique<int16_t[]>(length);
+    utils::floatToPcmData(pcm_data.get(), left_.data(), length);
+    data["samples"] = utils::encodeDataString(pcm_data.get(), sizeof(int16_t) * length, raw_data);
+    if (!right_.empty()) {
+      utils::floatToPcmData(pcm_data.get(), right_.data(), length);
+      data["samples_stereo"] = utils::encodeDataString(pcm_data.get(), sizeof(int16_t) * length, raw_data);
+    }
+    return data;
+  }
+
+  void Convolver::jsonToState(json data) {
+    std::string name = "";
+    if (data.count("name"))
+      name = data["name"].get<std::string>();
+
+    int length = data["length"];
+    int sample_rate = data["sample_rate"];
+    std::vector<mono_float> channels[2];
+    for (int channel = 0; channel < 2; ++channel) {
+      std::string field = channel ? "samples_stereo" : "samples";
+      if (!data.count(field))
+        continue;
+
+      channels[channel].resize(length);
+      utils::pcmDataStringToFloatData(channels[channel].data(), data[field].get_ref<const std::string&>(), length);
+    }
+
+    if (channels[0].empty()) {
+      clearImpulse();
+      return;
+    }
+
+    const mono_float* right = channels[1].empty() ? nullptr : channels[1].data();
+    loadImpulse(channels[0].data(), right, length, sample_rate);
+    name_ = name;
+  }
+} // namespace vital
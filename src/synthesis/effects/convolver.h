@@ -0,0 +1,108 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+#include "fourier_transform.h"
+#include "json/json.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace vital {
+
+  // Zero latency stereo convolution with a uniformly partitioned impulse response. The first partition is
+  // applied directly and the rest with overlap-save FFTs of kPartitionSize blocks, so the tail of the next
+  // block is ready before it plays. Impulses are resampled and transformed on the loading thread and then
+  // handed to the audio thread.
+  class Convolver {
+    public:
+      static constexpr int kPartitionBits = 7;
+      static constexpr int kPartitionSize = 1 << kPartitionBits;
+      static constexpr int kFftBits = kPartitionBits + 1;
+      static constexpr int kFftSize = 1 << kFftBits;
+      static constexpr int kBinVectors = kPartitionSize / poly_float::kSize;
+      static constexpr int kMaxSeconds = 20;
+
+      Convolver();
+      virtual ~Convolver();
+
+      void loadImpulse(const mono_float* left, const mono_float* right, int length, int sample_rate);
+      void clearImpulse();
+      void setSampleRate(int sample_rate);
+
+      bool hasImpulse() const { return current_.load() != nullptr; }
+      int getImpulseLength() const { return static_cast<int>(left_.size()); }
+      int getNumPartitions() const;
+      void setName(const std::string& name) { name_ = name; }
+      std::string getName() const { return name_; }
+
+      json stateToJson(bool raw_data = false);
+      void jsonToState(json data);
+
+      // Audio thread. The stereo input is in the first two lanes and the output is copied to every voice.
+      void process(const poly_float* audio_in, poly_float* audio_out, int num_samples);
+      void reset();
+
+    protected:
+      struct Kernel {
+        int num_channels;
+        int num_partitions;
+        int position;
+        int history_index;
+
+        // First partition as taps in the stereo lanes.
+        std::unique_ptr<poly_float[]> head;
+
+        // Spectra of the remaining partitions and of past input blocks. Each spectrum holds kBinVectors of
+        // real parts then kBinVectors of imaginary parts, with the Nyquist bin stored in the imaginary part
+        // of the DC bin.
+        std::unique_ptr<poly_float[]> spectra;
+        std::unique_ptr<poly_float[]> history;
+
+        // The previous and current input blocks, and the tail each channel adds to the current block.
+        std::unique_ptr<poly_float[]> input;
+        std::unique_ptr<mono_float[]> tail;
+      };
+
+      std::unique_ptr<Kernel> createKernel(int sample_rate) const;
+      void setKernel(std::unique_ptr<Kernel> kernel);
+      void convolveBlock(Kernel* kernel);
+
+      static force_inline int getSpectrumIndex(const Kernel* kernel, int channel, int partition) {
+        return (channel * kernel->num_partitions + partition) * 2 * kBinVectors;
+      }
+
+      std::string name_;
+      std::vector<mono_float> left_;
+      std::vector<mono_float> right_;
+      int source_sample_rate_;
+      int sample_rate_;
+
+      FourierTransform transform_;
+      std::unique_ptr<mono_float[]> transform_buffer_;
+
+      std::unique_ptr<Kernel> kernel_;
+      std::atomic<Kernel*> current_;
+      std::atomic<Kernel*> active_;
+
+      JUCE_LEAK_DETECTOR(Convolver)
+  };
+} // namespace vital
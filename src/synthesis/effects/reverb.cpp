@@ -16,6 +16,7 @@
 
 #include "reverb.h"
 
+#include "convolver.h"
 #include "futils.h"
 #include "memory.h"
 #include "synth_constants.h"
@@ -43,13 +44,15 @@ namespace vital {
     { 4521.54f, 6518.97f, 5265.56f, 5630.25f }
   };
 
-  Reverb::Reverb() : Processor(kNumInputs, 1), chorus_phase_(0.0f), chorus_amount_(0.0f), feedback_(0.0f),
+  Reverb::Reverb() : Processor(kNumInputs, 1), convolving_(false),
+                     chorus_phase_(0.0f), chorus_amount_(0.0f), feedback_(0.0f),
                      damping_(0.0f), dry_(0.0f), wet_(0.0f), write_index_(0),
                      max_allpass_size_(0), max_feedback_size_(0),
                      feedback_mask_(0), allpass_mask_(0), poly_allpass_mask_(0) {
     setupBuffersForSampleRate(kDefaultSampleRate);
 
     memory_ = std::make_unique<StereoMemory>(kMaxSampleRate);
+    convolver_ = std::make_unique<Convolver>();
 
     for (int i = 0; i < kNetworkContainers; ++i)
       decays_[i] = 0.0f;
@@ -63,6 +66,8 @@ namespace vital {
     sample_delay_ = kMinDelay;
   }
 
+  Reverb::~Reverb() { }
+
   void Reverb::setupBuffersForSampleRate(int sample_rate) {
     int buffer_scale = getBufferScale(sample_rate);
     int max_feedback_size = buffer_scale * (1 << (kBaseFeedbackBits + kMaxSizePower));
@@ -91,6 +96,17 @@ namespace vital {
   }
 
   void Reverb::processWithInput(const poly_float* audio_in, int num_samples) {
+    bool convolving = input(kMode)->at(0)[0] == kConvolution && convolver_->hasImpulse();
+    if (convolving != convolving_) {
+      convolving_ = convolving;
+      hardReset();
+    }
+
+    if (convolving) {
+      processConvolution(audio_in, num_samples);
+      return;
+    }
+
     for (int i = 0; i < kNetworkSize; ++i)
       wrapFeedbackBuffer(feedback_memories_[i].get());
 
@@ -147,14 +163,17 @@ namespace vital {
     const mono_float* allpass_lookup3 = (mono_float*)allpass_lookups_[2].get();
     const mono_float* allpass_lookup4 = (mono_float*)allpass_lookups_[3].get();
 
-    mono_float* feedback_lookups1[] = { feedback_lookups_[0], feedback_lookups_[1],
-                                        feedback_lookups_[2], feedback_lookups_[3] };
-    mono_float* feedback_lookups2[] = { feedback_lookups_[4], feedback_lookups_[5],
-                                        feedback_lookups_[6], feedback_lookups_[7] };
-    mono_float* feedback_lookups3[] = { feedback_lookups_[8], feedback_lookups_[9],
-                                        feedback_lookups_[10], feedback_lookups_[11] };
-    mono_float* feedback_lookups4[] = { feedback_lookups_[12], feedback_lookups_[13],
-                                        feedback_lookups_[14], feedback_lookups_[15] };
+    mono_float* feedback_lookups1[poly_float::kSize];
+    mono_float* feedback_lookups2[poly_float::kSize];
+    mono_float* feedback_lookups3[poly_float::kSize];
+    mono_float* feedback_lookups4[poly_float::kSize];
+    for (size_t i = 0; i < poly_float::kSize; ++i) {
+      int line = i % kContainerLines;
+      feedback_lookups1[i] = feedback_lookups_[line];
+      feedback_lookups2[i] = feedback_lookups_[kContainerLines + line];
+      feedback_lookups3[i] = feedback_lookups_[2 * kContainerLines + line];
+      feedback_lookups4[i] = feedback_lookups_[3 * kContainerLines + line];
+    }
 
     poly_float size = utils::clamp(input(kSize)->at(0), 0.0f, 1.0f);
     poly_float size_mult = futils::pow(2.0f, size * kSizePowerRange + kMinSizePower);
@@ -262,7 +281,8 @@ namespace vital {
       poly_float allpass_output4 = allpass_read4 + allpass_delay_input4 * kAllpassFeedback;
 
       poly_float total_rows = allpass_output1 + allpass_output2 + allpass_output3 + allpass_output4;
-      poly_float other_feedback = poly_float::mulAdd(total_rows.sum() * 0.25f, total_rows, -0.5f);
+      poly_float other_feedback = poly_float::mulAdd(total_rows.sum() * (1.0f / poly_float::kSize),
+                                                     total_rows, -0.5f);
 
       poly_float write1 = other_feedback + allpass_output1;
       poly_float write2 = other_feedback + allpass_output2;
@@ -323,7 +343,8 @@ namespace vital {
       write_index_ = (write_index_ + 1) & feedback_mask_;
 
       poly_float total_allpass = store1 + store2 + store3 + store4;
-      poly_float other_feedback_allpass = poly_float::mulAdd(total_allpass.sum() * 0.25f, total_allpass, -0.5f);
+      poly_float other_feedback_allpass = poly_float::mulAdd(total_allpass.sum() * (1.0f / poly_float::kSize),
+                                                             total_allpass, -0.5f);
 
       poly_float feed_forward1 = other_feedback_allpass + store1;
       poly_float feed_forward2 = other_feedback_allpass + store2;
@@ -358,14 +379,68 @@ namespace vital {
     sample_delay_ = current_sample_delay;
   }
 
+  void Reverb::processConvolution(const poly_float* audio_in, int num_samples) {
+    poly_float* audio_out = output()->buffer;
+    VITAL_ASSERT(audio_out != audio_in);
+    mono_float tick_increment = 1.0f / num_samples;
+
+    poly_float current_dry = dry_;
+    poly_float current_wet = wet_;
+    poly_float current_low_pre_coefficient = low_pre_coefficient_;
+    poly_float current_high_pre_coefficient = high_pre_coefficient_;
+
+    poly_float wet_in = utils::clamp(input(kWet)->at(0), 0.0f, 1.0f);
+    wet_ = futils::equalPowerFade(wet_in);
+    dry_ = futils::equalPowerFadeInverse(wet_in);
+    poly_float delta_wet = (wet_ - current_wet) * tick_increment;
+    poly_float delta_dry = (dry_ - current_dry) * tick_increment;
+
+    int sample_rate = getSampleRate();
+    poly_float low_pre_cutoff_midi = utils::clamp(input(kPreLowCutoff)->at(0), 0.0f, 130.0f);
+    low_pre_coefficient_ = OnePoleFilter<>::computeCoefficient(utils::midiNoteToFrequency(low_pre_cutoff_midi),
+                                                               sample_rate);
+    poly_float high_pre_cutoff_midi = utils::clamp(input(kPreHighCutoff)->at(0), 0.0f, 130.0f);
+    high_pre_coefficient_ = OnePoleFilter<>::computeCoefficient(utils::midiNoteToFrequency(high_pre_cutoff_midi),
+                                                                sample_rate);
+    poly_float delta_low_pre_coefficient = (low_pre_coefficient_ - current_low_pre_coefficient) * tick_increment;
+    poly_float delta_high_pre_coefficient = (high_pre_coefficient_ - current_high_pre_coefficient) * tick_increment;
+
+    // The impulse replaces the network, so only the pre filters and the mix apply.
+    for (int i = 0; i < num_samples; ++i) {
+      current_low_pre_coefficient += delta_low_pre_coefficient;
+      current_high_pre_coefficient += delta_high_pre_coefficient;
+      poly_float input = audio_in[i] & constants::kFirstMask;
+      poly_float filtered_input = high_pre_filter_.tickBasic(input, current_high_pre_coefficient);
+      audio_out[i] = low_pre_filter_.tickBasic(input, current_low_pre_coefficient) - filtered_input;
+    }
+
+    convolver_->process(audio_out, audio_out, num_samples);
+
+    for (int i = 0; i < num_samples; ++i) {
+      poly_float input = audio_in[i] & constants::kFirstMask;
+      input += utils::swapVoices(input);
+      audio_out[i] = current_wet * audio_out[i] + current_dry * input;
+      current_dry += delta_dry;
+      current_wet += delta_wet;
+    }
+  }
+
   void Reverb::setSampleRate(int sample_rate) {
     Processor::setSampleRate(sample_rate);
     setupBuffersForSampleRate(getSampleRate());
+    convolver_->setSampleRate(getSampleRate());
   }
 
   void Reverb::setOversampleAmount(int oversample_amount) {
     Processor::setOversampleAmount(oversample_amount);
     setupBuffersForSampleRate(getSampleRate());
+    convolver_->setSampleRate(getSampleRate());
+  }
+
+  int Reverb::getTailSamples() const {
+    if (convolving_)
+      return convolver_->getNumPartitions() * Convolver::kPartitionSize;
+    return max_feedback_size_ + max_allpass_size_;
   }
 
   void Reverb::hardReset() {
@@ -374,6 +449,7 @@ namespace vital {
     low_pre_filter_.reset(constants::kFullMask);
     high_pre_filter_.reset(constants::kFullMask);
     chorus_amount_ = utils::clamp(input(kChorusAmount)->at(0)[0], 0.0f, 1.0f) * kMaxChorusDrift;
+    convolver_->reset();
 
     for (int i = 0; i < kNetworkContainers; ++i) {
       low_shelf_filters_[i].reset(constants::kFullMask);
@@ -21,6 +21,7 @@
 
 namespace vital {
 
+  class Convolver;
   class StereoMemory;
 
   class Reverb : public Processor {
@@ -35,7 +36,11 @@ namespace vital {
       static constexpr int kBaseFeedbackBits = 14;
       static constexpr int kExtraLookupSample = 4;
       static constexpr int kBaseAllpassBits = 10;
-      static constexpr int kNetworkContainers = kNetworkSize / poly_float::kSize;
+      // Each container holds four lines of the network. Wider registers carry a copy in every group of four lanes,
+      // so the 8 lane build runs the same 16 line network twice and doubles the delay memory without changing
+      // the output. Spreading 32 lines across the lanes would change the sound of the reverb.
+      static constexpr int kContainerLines = 4;
+      static constexpr int kNetworkContainers = kNetworkSize / kContainerLines;
       static constexpr int kMinSizePower = -3;
       static constexpr int kMaxSizePower = 1;
       static constexpr float kSizePowerRange = kMaxSizePower - kMinSizePower;
@@ -58,14 +63,22 @@ namespace vital {
         kSize,
         kDelay,
         kWet,
+        kMode,
         kNumInputs
       };
 
+      enum Mode {
+        kNetwork,
+        kConvolution,
+        kNumModes
+      };
+
       Reverb();
-      virtual ~Reverb() { }
+      virtual ~Reverb();
 
       void process(int num_samples) override;
       void processWithInput(const poly_float* audio_in, int num_samples) override;
+      void processConvolution(const poly_float* audio_in, int num_samples);
       force_inline float getSampleRateRatio(int sample_rate) { return sample_rate / (1.0f * kBaseSampleRate); }
       force_inline int getBufferScale(int sample_rate) {
         int scale = 1;
@@ -104,8 +117,13 @@ namespace vital {
 
       virtual Processor* clone() const override { VITAL_ASSERT(false); return nullptr; }
 
+      Convolver* getConvolver() { return convolver_.get(); }
+      int getTailSamples() const;
+
     private:
       std::unique_ptr<StereoMemory> memory_;
+      std::unique_ptr<Convolver> convolver_;
+      bool convolving_;
 
       std::unique_ptr<poly_float[]> allpass_lookups_[kNetworkContainers];
       std::unique_ptr<mono_float[]> feedback_memories_[kNetworkSize];
@@ -258,8 +258,7 @@ namespace vital {
         ModulationConnectionProcessor* processor = modulation_bank_.atIndex(i)->modulation_processor.get();
         if (processor->enabled()) {
           poly_float* buffer = processor->output()->buffer;
-          poly_float masked_value = buffer[0] & voice_mask;
-          buffer[0] = masked_value + utils::swapVoices(masked_value);
+          buffer[0] = utils::sumVoices(buffer[0] & voice_mask);
         }
       }
       for (auto& status_source : data_->status_outputs)
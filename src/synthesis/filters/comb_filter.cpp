@@ -139,6 +139,25 @@ namespace vital {
     reset(constants::kFullMask);
   }
 
+  void CombFilter::copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) {
+    const CombFilter* source_filter = static_cast<const CombFilter*>(source);
+    copy(max_period_, source_filter->max_period_);
+    copy(feedback_, source_filter->feedback_);
+    copy(filter_coefficient_, source_filter->filter_coefficient_);
+    copy(filter2_coefficient_, source_filter->filter2_coefficient_);
+    copy(low_gain_, source_filter->low_gain_);
+    copy(high_gain_, source_filter->high_gain_);
+    copy(scale_, source_filter->scale_);
+    copy(filter_midi_cutoff_, source_filter->filter_midi_cutoff_);
+    copy(filter2_midi_cutoff_, source_filter->filter2_midi_cutoff_);
+
+    feedback_filter_.copyVoiceState(source_filter->feedback_filter_, copy);
+    feedback_filter2_.copyVoiceState(source_filter->feedback_filter2_, copy);
+
+    for (int i = 0; i < VoiceLaneCopy::kLanesPerVoice; ++i)
+      memory_->copyChannel(*source_filter->memory_, copy.sourceLane() + i, copy.destinationLane() + i);
+  }
+
   void CombFilter::setupFilter(const FilterState& filter_state) {
     feedback_style_ = getFeedbackStyle(filter_state.style);
     poly_float resonance = utils::clamp(filter_state.resonance_percent, 0.0f, 1.0f);
@@ -72,6 +72,7 @@ namespace vital {
 
       void reset(poly_mask reset_mask) override;
       void hardReset() override;
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override;
 
       poly_float getDrive() { return scale_; }
       poly_float getResonance() { return feedback_; }
@@ -431,4 +431,25 @@ namespace vital {
     drive_ = 0.0f;
     post_multiply_ = 0.0f;
   }
+
+  void DigitalSvf::copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) {
+    const DigitalSvf* source_filter = static_cast<const DigitalSvf*>(source);
+    copy(midi_cutoff_, source_filter->midi_cutoff_);
+    copy(resonance_, source_filter->resonance_);
+    copy(blends1_.v0, source_filter->blends1_.v0);
+    copy(blends1_.v1, source_filter->blends1_.v1);
+    copy(blends1_.v2, source_filter->blends1_.v2);
+    copy(blends2_.v0, source_filter->blends2_.v0);
+    copy(blends2_.v1, source_filter->blends2_.v1);
+    copy(blends2_.v2, source_filter->blends2_.v2);
+    copy(drive_, source_filter->drive_);
+    copy(post_multiply_, source_filter->post_multiply_);
+    copy(low_amount_, source_filter->low_amount_);
+    copy(band_amount_, source_filter->band_amount_);
+    copy(high_amount_, source_filter->high_amount_);
+    copy(ic1eq_pre_, source_filter->ic1eq_pre_);
+    copy(ic2eq_pre_, source_filter->ic2eq_pre_);
+    copy(ic1eq_, source_filter->ic1eq_);
+    copy(ic2eq_, source_filter->ic2eq_);
+  }
 } // namespace vital
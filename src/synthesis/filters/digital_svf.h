@@ -76,6 +76,7 @@ namespace vital {
       void processWithInput(const poly_float* audio_in, int num_samples) override;
       void reset(poly_mask reset_masks) override;
       void hardReset() override;
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override;
 
       void setupFilter(const FilterState& filter_state) override;
       void setResonanceBounds(mono_float min, mono_float max);
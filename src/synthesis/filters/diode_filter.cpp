@@ -39,6 +39,24 @@ namespace vital {
     post_multiply_ = 0.0f;
   }
 
+  void DiodeFilter::copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) {
+    const DiodeFilter* source_filter = static_cast<const DiodeFilter*>(source);
+    copy(resonance_, source_filter->resonance_);
+    copy(drive_, source_filter->drive_);
+    copy(post_multiply_, source_filter->post_multiply_);
+    copy(high_pass_ratio_, source_filter->high_pass_ratio_);
+    copy(high_pass_amount_, source_filter->high_pass_amount_);
+    copy(feedback_high_pass_coefficient_, source_filter->feedback_high_pass_coefficient_);
+
+    high_pass_1_.copyVoiceState(source_filter->high_pass_1_, copy);
+    high_pass_2_.copyVoiceState(source_filter->high_pass_2_, copy);
+    high_pass_feedback_.copyVoiceState(source_filter->high_pass_feedback_, copy);
+    stage1_.copyVoiceState(source_filter->stage1_, copy);
+    stage2_.copyVoiceState(source_filter->stage2_, copy);
+    stage3_.copyVoiceState(source_filter->stage3_, copy);
+    stage4_.copyVoiceState(source_filter->stage4_, copy);
+  }
+
   void DiodeFilter::process(int num_samples) {
     VITAL_ASSERT(inputMatchesBufferSize(kAudio));
 
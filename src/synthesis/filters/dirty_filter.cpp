@@ -46,6 +46,26 @@ namespace vital {
     high_pass_amount_ = 0.0f;
   }
 
+  void DirtyFilter::copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) {
+    const DirtyFilter* source_filter = static_cast<const DirtyFilter*>(source);
+    copy(coefficient_, source_filter->coefficient_);
+    copy(resonance_, source_filter->resonance_);
+    copy(drive_, source_filter->drive_);
+    copy(drive_boost_, source_filter->drive_boost_);
+    copy(drive_blend_, source_filter->drive_blend_);
+    copy(drive_mult_, source_filter->drive_mult_);
+    copy(low_pass_amount_, source_filter->low_pass_amount_);
+    copy(band_pass_amount_, source_filter->band_pass_amount_);
+    copy(high_pass_amount_, source_filter->high_pass_amount_);
+
+    pre_stage1_.copyVoiceState(source_filter->pre_stage1_, copy);
+    pre_stage2_.copyVoiceState(source_filter->pre_stage2_, copy);
+    stage1_.copyVoiceState(source_filter->stage1_, copy);
+    stage2_.copyVoiceState(source_filter->stage2_, copy);
+    stage3_.copyVoiceState(source_filter->stage3_, copy);
+    stage4_.copyVoiceState(source_filter->stage4_, copy);
+  }
+
   void DirtyFilter::process(int num_samples) {
     VITAL_ASSERT(inputMatchesBufferSize(kAudio));
 
@@ -81,6 +81,7 @@ namespace vital {
 
       void reset(poly_mask reset_mask) override;
       void hardReset() override;
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override;
 
       force_inline poly_float getResonance() {
         poly_float resonance_in = utils::clamp(tuneResonance(resonance_, coefficient_ * 2.0f), 0.0f, 1.0f);
@@ -0,0 +1,87 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "iir_halfband_upsampler.h"
+
+namespace vital {
+
+  IirHalfbandUpsampler::IirHalfbandUpsampler() : Processor(kNumInputs, 1) {
+    reset(constants::kFullMask);
+  }
+
+  void IirHalfbandUpsampler::process(int num_samples) {
+    processWithInput(input(kAudio)->source->buffer, num_samples);
+  }
+
+  void IirHalfbandUpsampler::processWithInput(const poly_float* audio_in, int num_samples) {
+    int oversample_amount = getOversampleAmount();
+    VITAL_ASSERT(oversample_amount <= (1 << kMaxStages));
+
+    poly_float* audio_out = output()->buffer;
+    poly_float stage_in[1 << kMaxStages];
+    poly_float stage_out[1 << kMaxStages];
+
+    for (int i = 0; i < num_samples; ++i) {
+      stage_in[0] = audio_in[i];
+      int num_stage_samples = 1;
+
+      // The first stage runs at the lowest rate so it needs the sharpest cutoff, the reverse of the decimator.
+      for (int stage = 0; (1 << stage) < oversample_amount; ++stage) {
+        int num_taps = IirHalfbandDecimator::kNumTaps9;
+        const poly_float* taps = IirHalfbandDecimator::kTaps9;
+        if (stage == 0) {
+          num_taps = IirHalfbandDecimator::kNumTaps25;
+          taps = IirHalfbandDecimator::kTaps25;
+        }
+
+        poly_float* in_memory = in_memory_[stage];
+        poly_float* out_memory = out_memory_[stage];
+        for (int s = 0; s < num_stage_samples; ++s) {
+          // Runs each channel through both allpass branches, one per lane, and splits them into two samples.
+          poly_float result = utils::consolidateAudio(stage_in[s], stage_in[s]);
+          for (int tap_index = 0; tap_index < num_taps; ++tap_index) {
+            poly_float delta = result - out_memory[tap_index];
+            poly_float new_result = utils::mulAdd(in_memory[tap_index], taps[tap_index], delta);
+            in_memory[tap_index] = result;
+            out_memory[tap_index] = new_result;
+            result = new_result;
+          }
+
+          poly_float swapped = utils::swapStereo(result);
+          stage_out[2 * s] = utils::swapInner(utils::maskLoad(result, swapped, constants::kLeftMask));
+          stage_out[2 * s + 1] = utils::swapInner(utils::maskLoad(result, swapped, constants::kRightMask));
+        }
+
+        num_stage_samples *= 2;
+        for (int s = 0; s < num_stage_samples; ++s)
+          stage_in[s] = stage_out[s];
+      }
+
+      int offset = i * oversample_amount;
+      for (int s = 0; s < oversample_amount; ++s)
+        audio_out[offset + s] = stage_in[s];
+    }
+  }
+
+  void IirHalfbandUpsampler::reset(poly_mask reset_mask) {
+    for (int stage = 0; stage < kMaxStages; ++stage) {
+      for (int i = 0; i < IirHalfbandDecimator::kNumTaps25; ++i) {
+        in_memory_[stage][i] = 0.0f;
+        out_memory_[stage][i] = 0.0f;
+      }
+    }
+  }
+} // namespace vital
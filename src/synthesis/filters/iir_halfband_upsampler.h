@@ -0,0 +1,51 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "iir_halfband_decimator.h"
+#include "processor.h"
+#include "synth_constants.h"
+
+namespace vital {
+
+  // Upsamples by powers of two with the same polyphase allpass halfband filters the IirHalfbandDecimator uses, so
+  // a nonlinear stage run between the two doesn't see the images a sample and hold would leave.
+  class IirHalfbandUpsampler : public Processor {
+    public:
+      static constexpr int kMaxStages = 3;
+
+      enum {
+        kAudio,
+        kNumInputs
+      };
+
+      IirHalfbandUpsampler();
+      virtual ~IirHalfbandUpsampler() { }
+
+      virtual Processor* clone() const override { VITAL_ASSERT(false); return nullptr; }
+
+      virtual void process(int num_samples) override;
+      virtual void processWithInput(const poly_float* audio_in, int num_samples) override;
+      void reset(poly_mask reset_mask) override;
+
+    private:
+      poly_float in_memory_[kMaxStages][IirHalfbandDecimator::kNumTaps25];
+      poly_float out_memory_[kMaxStages][IirHalfbandDecimator::kNumTaps25];
+
+      JUCE_LEAK_DETECTOR(IirHalfbandUpsampler)
+  };
+} // namespace vital
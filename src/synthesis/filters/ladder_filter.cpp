@@ -37,6 +37,18 @@ namespace vital {
     post_multiply_ = 0.0f;
   }
 
+  void LadderFilter::copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) {
+    const LadderFilter* source_filter = static_cast<const LadderFilter*>(source);
+    copy(resonance_, source_filter->resonance_);
+    copy(drive_, source_filter->drive_);
+    copy(post_multiply_, source_filter->post_multiply_);
+    copy(stage_scales_, source_filter->stage_scales_, kNumStages + 1);
+    copy(filter_input_, source_filter->filter_input_);
+
+    for (int i = 0; i < kNumStages; ++i)
+      stages_[i].copyVoiceState(source_filter->stages_[i], copy);
+  }
+
   void LadderFilter::process(int num_samples) {
     VITAL_ASSERT(inputMatchesBufferSize(kAudio));
 
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "common.h"
+#include "processor.h"
 #include "synth_constants.h"
 #include "utils.h"
 
@@ -37,6 +38,12 @@ namespace vital {
 
       virtual ~OnePoleFilter() { }
 
+      force_inline void copyVoiceState(const OnePoleFilter& source, const VoiceLaneCopy& copy) {
+        copy(current_state_, source.current_state_);
+        copy(filter_state_, source.filter_state_);
+        copy(sat_filter_state_, source.sat_filter_state_);
+      }
+
       force_inline poly_float tickBasic(poly_float audio_in, poly_float coefficient) {
         poly_float delta = coefficient * (audio_in - filter_state_);
         filter_state_ += delta;
@@ -44,6 +44,22 @@ namespace vital {
     allpass_output_ = 0.0f;
   }
 
+  void PhaserFilter::copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) {
+    const PhaserFilter* source_filter = static_cast<const PhaserFilter*>(source);
+    copy(resonance_, source_filter->resonance_);
+    copy(drive_, source_filter->drive_);
+    copy(peak1_amount_, source_filter->peak1_amount_);
+    copy(peak3_amount_, source_filter->peak3_amount_);
+    copy(peak5_amount_, source_filter->peak5_amount_);
+    copy(invert_mult_, source_filter->invert_mult_);
+    copy(allpass_output_, source_filter->allpass_output_);
+
+    for (int i = 0; i < kMaxStages; ++i)
+      stages_[i].copyVoiceState(source_filter->stages_[i], copy);
+    remove_lows_stage_.copyVoiceState(source_filter->remove_lows_stage_, copy);
+    remove_highs_stage_.copyVoiceState(source_filter->remove_highs_stage_, copy);
+  }
+
   void PhaserFilter::process(int num_samples) {
     VITAL_ASSERT(inputMatchesBufferSize(kAudio));
     processWithInput(input(kAudio)->source->buffer, num_samples);
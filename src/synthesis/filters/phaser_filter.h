@@ -44,6 +44,7 @@ namespace vital {
 
       void reset(poly_mask reset_mask) override;
       void hardReset() override;
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override;
       void setClean(bool clean) { clean_ = clean; }
 
       poly_float getResonance() { return resonance_; }
@@ -43,6 +43,23 @@ namespace vital {
     high_pass_amount_ = 0.0f;
   }
 
+  void SallenKeyFilter::copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) {
+    const SallenKeyFilter* source_filter = static_cast<const SallenKeyFilter*>(source);
+    copy(cutoff_, source_filter->cutoff_);
+    copy(resonance_, source_filter->resonance_);
+    copy(drive_, source_filter->drive_);
+    copy(post_multiply_, source_filter->post_multiply_);
+    copy(low_pass_amount_, source_filter->low_pass_amount_);
+    copy(band_pass_amount_, source_filter->band_pass_amount_);
+    copy(high_pass_amount_, source_filter->high_pass_amount_);
+    copy(stage1_input_, source_filter->stage1_input_);
+
+    pre_stage1_.copyVoiceState(source_filter->pre_stage1_, copy);
+    pre_stage2_.copyVoiceState(source_filter->pre_stage2_, copy);
+    stage1_.copyVoiceState(source_filter->stage1_, copy);
+    stage2_.copyVoiceState(source_filter->stage2_, copy);
+  }
+
   void SallenKeyFilter::process(int num_samples) {
     VITAL_ASSERT(inputMatchesBufferSize(kAudio));
     processWithInput(input(kAudio)->source->buffer, num_samples);
@@ -68,6 +68,7 @@ namespace vital {
     
       void reset(poly_mask reset_mask) override;
       void hardReset() override;
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override;
 
       poly_float getResonance() { return resonance_; }
       poly_float getDrive() { return drive_; }
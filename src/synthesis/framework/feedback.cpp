@@ -38,4 +38,13 @@ namespace vital {
       index = (index + 1) % kMaxBufferSize;
     }
   }
+
+  void Feedback::copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) {
+    const Feedback* source_feedback = static_cast<const Feedback*>(source);
+    for (int i = 0; i < kMaxBufferSize; ++i) {
+      int index = (buffer_index_ + i) % kMaxBufferSize;
+      int source_index = (source_feedback->buffer_index_ + i) % kMaxBufferSize;
+      copy(buffer_[index], source_feedback->buffer_[source_index]);
+    }
+  }
 } // namespace vital
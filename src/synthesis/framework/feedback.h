@@ -32,6 +32,7 @@ namespace vital {
       virtual Processor* clone() const override { return new Feedback(*this); }
       virtual void process(int num_samples) override;
       virtual void refreshOutput(int num_samples);
+      virtual void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override;
 
       force_inline void tick(int i) {
         buffer_[i] = input(0)->source->buffer[i];
@@ -64,6 +65,10 @@ namespace vital {
           output()->buffer[0] = last_value_;
         }
 
+        void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override {
+          copy(last_value_, static_cast<const cr::Feedback*>(source)->last_value_);
+        }
+
       protected:
         poly_float last_value_;
     };
@@ -37,12 +37,27 @@ namespace vital {
       row3 = poly_float::mulAdd(row3, other.row3 - row3, t);
     }
 
+#if VITAL_AVX2
+    // Before transposing, row n holds lane n in its low half and lane n + 4 in its high half.
+    force_inline void interpolateRows(const matrix& other, poly_float t) {
+      row0 = poly_float::mulAdd(row0, other.row0 - row0, rowValues(t, 0));
+      row1 = poly_float::mulAdd(row1, other.row1 - row1, rowValues(t, 1));
+      row2 = poly_float::mulAdd(row2, other.row2 - row2, rowValues(t, 2));
+      row3 = poly_float::mulAdd(row3, other.row3 - row3, rowValues(t, 3));
+    }
+
+    static force_inline poly_float rowValues(poly_float t, int row) {
+      return _mm256_permutevar8x32_ps(t.value, _mm256_setr_epi32(row, row, row, row,
+                                                                 row + 4, row + 4, row + 4, row + 4));
+    }
+#else
     force_inline void interpolateRows(const matrix& other, poly_float t) {
       row0 = poly_float::mulAdd(row0, other.row0 - row0, t[0]);
       row1 = poly_float::mulAdd(row1, other.row1 - row1, t[1]);
       row2 = poly_float::mulAdd(row2, other.row2 - row2, t[2]);
       row3 = poly_float::mulAdd(row3, other.row3 - row3, t[3]);
     }
+#endif
 
     force_inline poly_float sumRows() {
       return row0 + row1 + row2 + row3;
@@ -239,10 +239,18 @@ namespace vital {
         VITAL_ASSERT(inputMatchesBufferSize(i));
 
         const poly_float* source = input(i)->source->buffer;
+        int stride = input(i)->source->owner->getOversampleAmount() / getOversampleAmount();
 
-        for (int s = 0; s < num_samples; ++s) {
-          poly_float value = source[s];
-          dest[s] += value;
+        if (stride > 1) {
+          // Sources running at a higher rate than this sum are read at this rate's sample times.
+          for (int s = 0; s < num_samples; ++s)
+            dest[s] += source[s * stride];
+        }
+        else {
+          for (int s = 0; s < num_samples; ++s) {
+            poly_float value = source[s];
+            dest[s] += value;
+          }
         }
       }
     }
@@ -173,6 +173,10 @@ namespace vital {
 
       virtual bool hasState() const override { return true; }
 
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override {
+        copy(control_value_, static_cast<const ModulationSum*>(source)->control_value_);
+      }
+
     private:
       poly_float control_value_;
 
@@ -224,6 +228,10 @@ namespace vital {
 
       virtual void process(int num_samples) override;
 
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override {
+        copy(multiply_, static_cast<const SmoothMultiply*>(source)->multiply_);
+      }
+
     protected:
       void processMultiply(int num_samples, poly_float multiply);
 
@@ -347,6 +355,12 @@ namespace vital {
 
       bool hasState() const override { return true; }
 
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override {
+        const StereoEncoder* source_encoder = static_cast<const StereoEncoder*>(source);
+        copy(cos_mult_, source_encoder->cos_mult_);
+        copy(sin_mult_, source_encoder->sin_mult_);
+      }
+
     protected:
       poly_float cos_mult_;
       poly_float sin_mult_;
@@ -0,0 +1,242 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "output_arena.h"
+
+#include "processor.h"
+#include "utils.h"
+
+#include <algorithm>
+
+namespace vital {
+
+  namespace {
+    constexpr int kSilenceSize = kMaxBufferSize * kMaxOversample;
+
+    force_inline size_t bufferBytes(int size) {
+      return sizeof(poly_float) * size;
+    }
+  } // namespace
+
+  OutputArena::OutputArena() : pooled_bytes_(0), peak_pooled_bytes_(0), num_allocations_(0), num_toggles_(0),
+                               starved_(false), over_reserve_(false), last_polled_toggles_(0) {
+    silence_ = std::make_unique<poly_float[]>(kSilenceSize);
+    utils::zeroBuffer(silence_.get(), kSilenceSize);
+  }
+
+  OutputArena::Pool* OutputArena::findPool(int size) {
+    auto pool = pools_.find(size);
+    if (pool == pools_.end())
+      return nullptr;
+    return &pool->second;
+  }
+
+  void OutputArena::addModule(std::vector<Output*>& outputs) {
+    outputs.erase(std::remove_if(outputs.begin(), outputs.end(), [this](const Output* output) {
+      return output->isControlRate() || output->buffer_size > kSilenceSize ||
+             std::find(outputs_.begin(), outputs_.end(), output) != outputs_.end();
+    }), outputs.end());
+    if (outputs.empty())
+      return;
+
+    std::map<int, int> num_outputs;
+    for (Output* output : outputs) {
+      outputs_.push_back(output);
+      num_outputs[output->buffer_size]++;
+    }
+
+    // A pooled buffer always belongs to a released output so release() never grows a pool past its capacity.
+    for (auto& size_outputs : num_outputs) {
+      Pool& pool = pools_[size_outputs.first];
+      pool.buffers.reserve(pool.buffers.capacity() + size_outputs.second);
+      pool.reserve = std::max(pool.reserve, size_outputs.second);
+    }
+    modules_.push_back(outputs);
+  }
+
+  void OutputArena::removeModule(const std::vector<Output*>& outputs) {
+    for (Output* output : outputs) {
+      if (output->owned_buffer == nullptr) {
+        Pool* pool = findPool(output->buffer_size);
+        if (pool && !pool->buffers.empty()) {
+          output->owned_buffer = std::move(pool->buffers.back());
+          pool->buffers.pop_back();
+          pooled_bytes_ -= bufferBytes(output->buffer_size);
+        }
+        else {
+          output->owned_buffer = std::make_unique<poly_float[]>(output->buffer_size);
+          num_allocations_++;
+        }
+
+        output->buffer = output->owned_buffer.get();
+        output->clearBuffer();
+      }
+      outputs_.erase(std::remove(outputs_.begin(), outputs_.end(), output), outputs_.end());
+    }
+
+    modules_.erase(std::remove(modules_.begin(), modules_.end(), outputs), modules_.end());
+  }
+
+  void OutputArena::release(Output* output) {
+    if (output->owned_buffer == nullptr)
+      return;
+
+    VITAL_ASSERT(output->buffer == output->owned_buffer.get());
+    Pool* pool = findPool(output->buffer_size);
+    VITAL_ASSERT(pool && pool->buffers.size() < pool->buffers.capacity());
+    if (pool == nullptr)
+      return;
+
+    pooled_bytes_ += bufferBytes(output->buffer_size);
+    peak_pooled_bytes_ = std::max(peak_pooled_bytes_, pooled_bytes_);
+    pool->buffers.push_back(std::move(output->owned_buffer));
+    output->buffer = silence_.get();
+
+    if (static_cast<int>(pool->buffers.size()) > pool->reserve)
+      over_reserve_ = true;
+    num_toggles_++;
+  }
+
+  bool OutputArena::acquire(const std::vector<Output*>& outputs) {
+    for (const Output* output : outputs) {
+      if (output->owned_buffer)
+        continue;
+
+      Pool* pool = findPool(output->buffer_size);
+      VITAL_ASSERT(pool);
+      if (pool == nullptr)
+        return false;
+      pool->requested++;
+    }
+
+    bool available = true;
+    for (const Output* output : outputs) {
+      Pool* pool = output->owned_buffer ? nullptr : findPool(output->buffer_size);
+      if (pool == nullptr || pool->requested == 0)
+        continue;
+
+      int shortfall = pool->requested - static_cast<int>(pool->buffers.size());
+      if (shortfall > 0) {
+        pool->shortfall = std::max(pool->shortfall, shortfall);
+        available = false;
+      }
+      pool->requested = 0;
+    }
+
+    if (!available) {
+      starved_ = true;
+      return false;
+    }
+
+    for (Output* output : outputs) {
+      if (output->owned_buffer)
+        continue;
+
+      Pool* pool = findPool(output->buffer_size);
+      output->owned_buffer = std::move(pool->buffers.back());
+      pool->buffers.pop_back();
+      pooled_bytes_ -= bufferBytes(output->buffer_size);
+
+      output->buffer = output->owned_buffer.get();
+      output->clearBuffer();
+    }
+    num_toggles_++;
+    return true;
+  }
+
+  bool OutputArena::needsTrim() {
+    if (starved_)
+      return true;
+
+    int num_toggles = num_toggles_;
+    if (num_toggles != last_polled_toggles_) {
+      last_polled_toggles_ = num_toggles;
+      return false;
+    }
+    return over_reserve_;
+  }
+
+  void OutputArena::trim() {
+    std::map<int, int> num_outputs;
+    std::map<int, int> num_released;
+    for (const Output* output : outputs_) {
+      num_outputs[output->buffer_size]++;
+      if (output->owned_buffer == nullptr)
+        num_released[output->buffer_size]++;
+    }
+
+    std::map<int, int> reserve;
+    for (const std::vector<Output*>& module : modules_) {
+      std::map<int, int> module_outputs;
+      for (const Output* output : module)
+        module_outputs[output->buffer_size]++;
+      for (auto& size_outputs : module_outputs)
+        reserve[size_outputs.first] = std::max(reserve[size_outputs.first], size_outputs.second);
+    }
+
+    std::map<int, Pool> pools;
+    pooled_bytes_ = 0;
+    for (auto& size_outputs : num_outputs) {
+      int size = size_outputs.first;
+      Pool* old_pool = findPool(size);
+      Pool& pool = pools[size];
+      pool.buffers.reserve(size_outputs.second);
+      pool.reserve = reserve[size];
+
+      // Waiting modules get their buffers on top of the reserve, the rest of the pool is freed.
+      int shortfall = old_pool ? old_pool->shortfall : 0;
+      int num_buffers = std::min(num_released[size], shortfall + pool.reserve);
+      for (int i = 0; i < num_buffers; ++i) {
+        if (old_pool && !old_pool->buffers.empty()) {
+          pool.buffers.push_back(std::move(old_pool->buffers.back()));
+          old_pool->buffers.pop_back();
+        }
+        else {
+          pool.buffers.push_back(std::make_unique<poly_float[]>(size));
+          num_allocations_++;
+        }
+      }
+      pooled_bytes_ += num_buffers * bufferBytes(size);
+    }
+
+    pools_ = std::move(pools);
+    peak_pooled_bytes_ = std::max(peak_pooled_bytes_, pooled_bytes_);
+    starved_ = false;
+    over_reserve_ = false;
+  }
+
+  OutputArena::Report OutputArena::report() const {
+    Report report;
+    report.num_outputs = static_cast<int>(outputs_.size());
+    report.num_released = 0;
+    report.active_bytes = 0;
+    report.released_bytes = 0;
+    report.pooled_bytes = pooled_bytes_;
+    report.peak_pooled_bytes = peak_pooled_bytes_;
+    report.num_allocations = num_allocations_;
+
+    for (const Output* output : outputs_) {
+      if (output->owned_buffer) {
+        report.active_bytes += bufferBytes(output->buffer_size);
+        continue;
+      }
+
+      report.num_released++;
+      report.released_bytes += bufferBytes(output->buffer_size);
+    }
+    return report;
+  }
+} // namespace vital
@@ -0,0 +1,95 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace vital {
+
+  struct Output;
+
+  // Holds the buffers of outputs that belong to modules which are switched off. A released output reads
+  // from a shared silent buffer and hands its own buffer to the arena, which gives it to the next output
+  // of the same size that is switched back on. release() and acquire() never allocate so modules can
+  // switch on the audio thread. Pooled buffers beyond a spare reserve, enough to switch on the largest
+  // module, are freed by trim() on the message thread once toggles settle. A module that finds the pool
+  // short stays off until the next trim() hands it buffers.
+  // Outputs are shared between voice clones so there is one arena per engine, not per voice.
+  class OutputArena {
+    public:
+      struct Report {
+        int num_outputs;
+        int num_released;
+        size_t active_bytes;
+        size_t released_bytes;
+        size_t pooled_bytes;
+        size_t peak_pooled_bytes;
+        int num_allocations;
+      };
+
+      OutputArena();
+
+      // Registers the outputs of one module. Outputs the arena won't manage are removed from _outputs_,
+      // control rate outputs have nothing to save.
+      void addModule(std::vector<Output*>& outputs);
+      // Gives every output of the module its own buffer back, allocating if the pool ran dry.
+      void removeModule(const std::vector<Output*>& outputs);
+
+      void release(Output* output);
+      // Takes buffers for all of _outputs_ or none of them.
+      bool acquire(const std::vector<Output*>& outputs);
+
+      // True when a module is waiting for buffers, or when toggles have settled since the last call and
+      // the pool holds more than its reserve. Call from the message thread.
+      bool needsTrim();
+      // Frees pooled buffers beyond the reserve and allocates the ones waiting modules need.
+      // Call off the audio thread while processing is paused.
+      void trim();
+      Report report() const;
+
+    private:
+      struct Pool {
+        Pool() : reserve(0), shortfall(0), requested(0) { }
+
+        std::vector<std::unique_ptr<poly_float[]>> buffers;
+        int reserve;
+        int shortfall;
+        int requested;
+      };
+
+      Pool* findPool(int size);
+
+      std::vector<Output*> outputs_;
+      std::vector<std::vector<Output*>> modules_;
+      std::map<int, Pool> pools_;
+      std::unique_ptr<poly_float[]> silence_;
+      size_t pooled_bytes_;
+      size_t peak_pooled_bytes_;
+      int num_allocations_;
+      std::atomic<int> num_toggles_;
+      std::atomic<bool> starved_;
+      std::atomic<bool> over_reserve_;
+      int last_polled_toggles_;
+
+      JUCE_LEAK_DETECTOR(OutputArena)
+  };
+} // namespace vital
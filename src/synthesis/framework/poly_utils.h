@@ -161,6 +161,28 @@ namespace vital {
     #endif
     }
 
+  #if VITAL_AVX2
+    force_inline poly_float toPolyFloatFromUnaligned(const mono_float* unaligned_low,
+                                                     const mono_float* unaligned_high) {
+      return _mm256_loadu2_m128(unaligned_high, unaligned_low);
+    }
+
+    // Row n holds the four values for lane n in its low half and for lane n + 4 in its high half so
+    // matrix::transpose() leaves one tap per row.
+    force_inline matrix getValueMatrix(const mono_float* buffer, poly_int indices) {
+      return matrix(toPolyFloatFromUnaligned(buffer + indices[0], buffer + indices[4]),
+                    toPolyFloatFromUnaligned(buffer + indices[1], buffer + indices[5]),
+                    toPolyFloatFromUnaligned(buffer + indices[2], buffer + indices[6]),
+                    toPolyFloatFromUnaligned(buffer + indices[3], buffer + indices[7]));
+    }
+
+    force_inline matrix getValueMatrix(const mono_float* const* buffers, poly_int indices) {
+      return matrix(toPolyFloatFromUnaligned(buffers[0] + indices[0], buffers[4] + indices[4]),
+                    toPolyFloatFromUnaligned(buffers[1] + indices[1], buffers[5] + indices[5]),
+                    toPolyFloatFromUnaligned(buffers[2] + indices[2], buffers[6] + indices[6]),
+                    toPolyFloatFromUnaligned(buffers[3] + indices[3], buffers[7] + indices[7]));
+    }
+  #else
     force_inline matrix getValueMatrix(const mono_float* buffer, poly_int indices) {
       return matrix(toPolyFloatFromUnaligned(buffer + indices[0]),
                     toPolyFloatFromUnaligned(buffer + indices[1]),
@@ -174,6 +196,7 @@ namespace vital {
                     toPolyFloatFromUnaligned(buffers[2] + indices[2]),
                     toPolyFloatFromUnaligned(buffers[3] + indices[3]));
     }
+  #endif
 
     force_inline poly_float interpolate(poly_float from, poly_float to, poly_float t) {
       return mulAdd(from, to - from, t);
@@ -287,7 +310,7 @@ namespace vital {
 
     force_inline poly_int swapVoices(poly_int value) {
     #if VITAL_AVX2
-      return _mm256_shuffle_epi32(value.value, value.value, _MM_SHUFFLE(1, 0, 3, 2));
+      return _mm256_shuffle_epi32(value.value, _MM_SHUFFLE(1, 0, 3, 2));
     #elif VITAL_SSE2
       return _mm_shuffle_epi32(value.value, _MM_SHUFFLE(1, 0, 3, 2));
     #elif VITAL_NEON
@@ -337,18 +360,34 @@ namespace vital {
     #endif
     }
 
+    // Adds every voice of an aggregate voice together and leaves the total in each voice's lanes.
+    force_inline poly_float sumVoices(poly_float value) {
+    #if VITAL_AVX2
+      poly_float pair_sum = value + swapVoices(value);
+      return pair_sum + poly_float(_mm256_permute2f128_ps(pair_sum.value, pair_sum.value, 1));
+    #else
+      return value + swapVoices(value);
+    #endif
+    }
+
     force_inline poly_float sumSplitAudio(poly_float sum) {
       poly_float totals = sum + utils::swapStereo(sum);
       return utils::swapInner(totals);
     }
 
     force_inline mono_float maxFloat(poly_float values) {
+    #if VITAL_AVX2
+      values = utils::max(values, _mm256_permute2f128_ps(values.value, values.value, 1));
+    #endif
       poly_float swap_voices = swapVoices(values);
       poly_float max_voice = utils::max(values, swap_voices);
       return utils::max(max_voice, utils::swapStereo(max_voice))[0];
     }
 
     force_inline mono_float minFloat(poly_float values) {
+    #if VITAL_AVX2
+      values = utils::min(values, _mm256_permute2f128_ps(values.value, values.value, 1));
+    #endif
       poly_float swap_voices = swapVoices(values);
       poly_float min_voice = utils::min(values, swap_voices);
       return utils::min(min_voice, utils::swapStereo(min_voice))[0];
@@ -565,7 +604,7 @@ namespace vital {
     template<size_t shift>
     force_inline poly_int shiftRight(poly_int integer) {
     #if VITAL_AVX2
-      return _mm256_srli_epi32(integers.value, shift);
+      return _mm256_srli_epi32(integer.value, shift);
     #elif VITAL_SSE2
       return _mm_srli_epi32(integer.value, shift);
     #elif VITAL_NEON
@@ -576,7 +615,7 @@ namespace vital {
     template<size_t shift>
     force_inline poly_int shiftLeft(poly_int integer) {
     #if VITAL_AVX2
-      return _mm256_slli_epi32(integers.value, shift);
+      return _mm256_slli_epi32(integer.value, shift);
     #elif VITAL_SSE2
       return _mm_slli_epi32(integer.value, shift);
     #elif VITAL_NEON
@@ -124,6 +124,32 @@ namespace vital {
     plugNext(source->output());
   }
 
+  void Processor::plugPrepared(const Output* source, unsigned int input_index) {
+    VITAL_ASSERT(input_index < inputs_->size());
+    VITAL_ASSERT(source);
+    VITAL_ASSERT(inputs_->at(input_index));
+
+    inputs_->at(input_index)->source = source;
+    numInputsChanged();
+  }
+
+  void Processor::plugNextPrepared(const Output* source) {
+    int num_inputs = static_cast<int>(inputs_->size());
+    for (int i = plugging_start_; i < num_inputs; ++i) {
+      Input* input = inputs_->at(i);
+      if (input && input->source == &Processor::null_source_) {
+        plugPrepared(source, i);
+        return;
+      }
+    }
+
+    std::shared_ptr<Input> input = std::make_shared<Input>();
+    owned_inputs_.push_back(input);
+    input->source = source;
+    inputs_->push_back(input.get());
+    numInputsChanged();
+  }
+
   void Processor::useInput(Input* input) {
     useInput(input, 0);
   }
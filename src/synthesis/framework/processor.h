@@ -18,6 +18,7 @@
 
 #include "common.h"
 #include "poly_utils.h"
+#include "profiler.h"
 
 #include <cstring>
 #include <vector>
@@ -53,8 +54,10 @@ namespace vital {
       trigger_offset = 0;
     }
 
+    // A null owned buffer means an OutputArena holds it while the owning module is off.
     void clearBuffer() {
-      utils::zeroBuffer(owned_buffer.get(), buffer_size);
+      if (owned_buffer)
+        utils::zeroBuffer(owned_buffer.get(), buffer_size);
     }
 
     force_inline bool isControlRate() const { return buffer_size == 1; }
@@ -64,6 +67,9 @@ namespace vital {
         return;
 
       buffer_size = new_max_buffer_size;
+      if (owned_buffer == nullptr)
+        return;
+
       bool buffer_is_original = buffer == owned_buffer.get();
       owned_buffer = std::make_unique<poly_float[]>(buffer_size);
       if (buffer_is_original)
@@ -103,6 +109,7 @@ namespace vital {
       control_rate = false;
       enabled = true;
       initialized = false;
+      profile_id = -1;
     }
 
     int sample_rate;
@@ -110,6 +117,7 @@ namespace vital {
     bool control_rate;
     bool enabled;
     bool initialized;
+    int profile_id;
   };
 
   namespace cr {
@@ -125,6 +133,42 @@ namespace vital {
     };
   } // namespace cr
 
+  // Copies the lanes of one voice in a processor clone into the lanes of a voice in another clone.
+  class VoiceLaneCopy {
+    public:
+      static constexpr int kLanesPerVoice = 2;
+
+      VoiceLaneCopy(int source_voice, int destination_voice) :
+          source_lane_(kLanesPerVoice * source_voice), destination_lane_(kLanesPerVoice * destination_voice) { }
+
+      template<class T>
+      force_inline void operator()(T& destination, const T& source) const {
+        for (int i = 0; i < kLanesPerVoice; ++i)
+          destination.set(destination_lane_ + i, source[source_lane_ + i]);
+      }
+
+      template<class T>
+      force_inline void operator()(T* destination, const T* source, int size) const {
+        for (int i = 0; i < size; ++i)
+          operator()(destination[i], source[i]);
+      }
+
+      // Returns where lane _lane_ of the source voice ends up, or -1 if it isn't one of the voice's lanes.
+      force_inline int destinationLane(int lane) const {
+        int voice_lane = lane - source_lane_;
+        if (voice_lane < 0 || voice_lane >= kLanesPerVoice)
+          return -1;
+        return destination_lane_ + voice_lane;
+      }
+
+      force_inline int sourceLane() const { return source_lane_; }
+      force_inline int destinationLane() const { return destination_lane_; }
+
+    private:
+      int source_lane_;
+      int destination_lane_;
+  };
+
   class Processor {
     public:
       Processor(int num_inputs, int num_outputs, bool control_rate = false, int max_oversample = 1);
@@ -153,6 +197,10 @@ namespace vital {
       // Override this to handle state resetting when the Processor is turned off/on.
       virtual void hardReset() { reset(poly_mask(-1)); }
 
+      // Override this to take over a voice's state from another clone when voices are repacked. Outputs are
+      // shared between clones so only member state needs copying.
+      virtual void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) { }
+
       bool initialized() { return state_->initialized; }
 
       // Subclasses should override this if they need to adjust for change in
@@ -192,6 +240,15 @@ namespace vital {
         return state_->control_rate;
       }
 
+      // Voice clones share the entry so their time is summed under one name.
+      void setProfileName(const std::string& name) {
+        state_->profile_id = Profiler::registerEntry(name);
+      }
+
+      force_inline int profileId() const {
+        return state_->profile_id;
+      }
+
       virtual void setControlRate(bool control_rate) {
         state_->control_rate = control_rate;
       }
@@ -204,15 +261,14 @@ namespace vital {
       force_inline void clearOutputBufferForReset(poly_mask reset_mask, int input_index, int output_index) const {
         poly_float* audio_out = output(output_index)->buffer;
         poly_int trigger_offset = input(input_index)->source->trigger_offset & reset_mask;
-        int num_samples_first = trigger_offset[0];
-        poly_int mask(0, 0, -1, -1);
-        for (int i = 0; i < num_samples_first; ++i)
-          audio_out[i] = audio_out[i] & mask;
-
-        mask = poly_int(-1, -1, 0, 0);
-        int num_samples_second = trigger_offset[2];
-        for (int i = 0; i < num_samples_second; ++i)
-          audio_out[i] = audio_out[i] & mask;
+        for (size_t v = 0; v < poly_float::kSize; v += 2) {
+          int num_samples_voice = trigger_offset[v];
+          poly_int mask = -1;
+          mask.set(v, 0);
+          mask.set(v + 1, 0);
+          for (int i = 0; i < num_samples_voice; ++i)
+            audio_out[i] = audio_out[i] & mask;
+        }
       }
 
       bool inputMatchesBufferSize(int input = 0);
@@ -232,6 +288,11 @@ namespace vital {
       void plugNext(const Output* source);
       void plugNext(const Processor* source);
 
+      // Attaches an output without notifying the router, for connections it already ordered with
+      // ProcessorRouter::prepareConnection().
+      void plugPrepared(const Output* source, unsigned int input_index);
+      void plugNextPrepared(const Output* source);
+
       // Use an existing input as our input.
       void useInput(Input* input);
       void useInput(Input* input, int index);
@@ -20,6 +20,7 @@
 #include "synth_constants.h"
 
 #include <algorithm>
+#include <thread>
 #include <vector>
 
 namespace vital {
@@ -30,7 +31,8 @@ namespace vital {
       global_reorder_(new CircularQueue<Processor*>(kMaxModulationConnections)),
       local_order_(kMaxModulationConnections),
       global_feedback_order_(new std::vector<const Feedback*>()),
-      global_changes_(new int(0)), local_changes_(0),
+      global_feedback_sources_(new std::vector<const Output*>()),
+      global_changes_(new std::atomic<int>(0)), local_changes_(0), schedule_(new ScheduleBuffer(this)),
       dependencies_(new CircularQueue<const Processor*>(kMaxModulationConnections)),
       dependencies_visited_(new CircularQueue<const Processor*>(kMaxModulationConnections)),
       dependency_inputs_(new CircularQueue<const Processor*>(kMaxModulationConnections)) { }
@@ -38,30 +40,56 @@ namespace vital {
   ProcessorRouter::ProcessorRouter(const ProcessorRouter& original) :
       Processor(original), global_order_(original.global_order_), global_reorder_(original.global_reorder_),
       global_feedback_order_(original.global_feedback_order_),
+      global_feedback_sources_(original.global_feedback_sources_),
       global_changes_(original.global_changes_),
-      local_changes_(original.local_changes_) {
-    local_order_.reserve(global_order_->capacity());
-    local_order_.assign(global_order_->size(), 0);
-    local_feedback_order_.assign(global_feedback_order_->size(), nullptr);
+      local_changes_(original.local_changes_), schedule_(original.schedule_) {
+    schedule_->clones.push_back(this);
+    reserveSlots(schedule_->slot_capacity);
 
-    int num_processors = global_order_->size();
+    Schedule* schedule = acquireSchedule();
+    local_changes_ = schedule->version;
+
+    int num_processors = static_cast<int>(schedule->order.size());
+    local_order_.reserve(global_order_->capacity());
+    local_order_.assign(num_processors, 0);
     for (int i = 0; i < num_processors; ++i) {
-      const Processor* next = global_order_->at(i);
+      const Processor* next = schedule->order[i];
+      int slot = schedule->slots[i];
       std::unique_ptr<Processor> clone(next->clone());
       local_order_[i] = clone.get();
-      processors_[next] = { 0, std::move(clone) };
+      local_slots_[slot].global = next;
+      local_slots_[slot].local = clone.get();
+      local_slots_[slot].version = local_changes_;
+      local_slots_[slot].copy = clone.get();
+      processors_[next] = { slot, std::move(clone) };
     }
 
-    int num_feedbacks = static_cast<int>(global_feedback_order_->size());
+    // Spare Feedback nodes get a copy too so they can be scheduled again without one being made.
+    for (auto& feedback : schedule_->original->feedback_processors_) {
+      int slot = feedback.second.first;
+      local_slots_[slot].feedback_copy.reset((Feedback*)feedback.second.second->clone());
+    }
+
+    int num_feedbacks = static_cast<int>(schedule->feedbacks.size());
+    local_feedback_order_.assign(num_feedbacks, nullptr);
     for (int i = 0; i < num_feedbacks; ++i) {
-      const Feedback* next = global_feedback_order_->at(i);
-      std::unique_ptr<Feedback> clone((Feedback*)(next->clone()));
-      local_feedback_order_[i] = clone.get();
-      feedback_processors_[next] = { 0, std::move(clone) };
+      int slot = schedule->feedback_slots[i];
+      local_feedback_order_[i] = local_slots_[slot].feedback_copy.get();
+      local_slots_[slot].global = schedule->feedbacks[i];
+      local_slots_[slot].local = local_feedback_order_[i];
+      local_slots_[slot].version = local_changes_;
+      local_slots_[slot].feedback = true;
     }
+
+    releaseSchedule(schedule);
   }
 
-  ProcessorRouter::~ProcessorRouter() { }
+  ProcessorRouter::~ProcessorRouter() {
+    if (isClone()) {
+      std::vector<ProcessorRouter*>& clones = schedule_->clones;
+      clones.erase(std::remove(clones.begin(), clones.end(), this), clones.end());
+    }
+  }
 
   void ProcessorRouter::process(int num_samples) {
     if (shouldUpdate())
@@ -73,12 +101,14 @@ namespace vital {
       local_feedback_order_[i]->refreshOutput(num_samples);
 
     // Run all the main processors.
+    Profiler* profiler = Profiler::active();
     int normal_samples = std::max(1, num_samples / getOversampleAmount());
     for (Processor* processor : local_order_) {
       if (processor->enabled()) {
         int processor_samples = normal_samples * processor->getOversampleAmount();
 
         VITAL_ASSERT(processor->checkInputAndOutputSize(processor_samples));
+        Profiler::Scope profile(profiler, processor->profileId());
         processor->process(processor_samples);
         VITAL_ASSERT(utils::isFinite(processor->output()->buffer, processor->isControlRate() ? 0 : processor_samples));
       }
@@ -86,7 +116,7 @@ namespace vital {
 
     // Store the outputs into the Feedback objects for next time.
     for (int i = 0; i < num_feedbacks; ++i) {
-      if (global_feedback_order_->at(i)->enabled())
+      if (local_feedback_order_[i]->enabled())
         local_feedback_order_[i]->process(num_samples);
     }
   }
@@ -96,6 +126,12 @@ namespace vital {
 
     for (Processor* processor : local_order_)
       processor->init();
+
+    // Clones made while the graph was built copy what they're missing once it's initialized.
+    for (ProcessorRouter* clone : schedule_->clones) {
+      for (auto& processor : processors_)
+        clone->addSlotCopy(processor.first, processor.second.first);
+    }
   }
 
   void ProcessorRouter::setSampleRate(int sample_rate) {
@@ -134,24 +170,31 @@ namespace vital {
     global_order_->ensureSpace();
     global_reorder_->ensureCapacity(global_order_->capacity());
     local_order_.ensureSpace();
+    global_feedback_order_->reserve(global_order_->capacity());
+    global_feedback_sources_->reserve(global_order_->capacity());
+    schedule_->reserve(global_order_->capacity());
     addProcessorRealTime(processor);
   }
 
   void ProcessorRouter::addProcessorRealTime(Processor* processor) {
     VITAL_ASSERT(processor->router() == nullptr);
-    (*global_changes_)++;
-    local_changes_++;
-
     processor->router(this);
     if (getOversampleAmount() > 1)
       processor->setOversampleAmount(getOversampleAmount());
 
     global_order_->push_back(processor);
-    processors_[processor] = { 0, std::unique_ptr<Processor>(processor) };
+    int slot = allocateSlot();
+    processors_[processor] = { slot, std::unique_ptr<Processor>(processor) };
     local_order_.push_back(processor);
+    if (initialized()) {
+      for (ProcessorRouter* clone : schedule_->clones)
+        clone->addSlotCopy(processor, slot);
+    }
 
     for (int i = 0; i < processor->numInputs(); ++i)
       connect(processor, processor->input(i)->source, i);
+
+    publishSchedule();
   }
 
   void ProcessorRouter::addIdleProcessor(Processor *processor) {
@@ -164,8 +207,6 @@ namespace vital {
       disconnect(processor, processor->input(i)->source);
 
     VITAL_ASSERT(processor->router() == this);
-    (*global_changes_)++;
-    local_changes_++;
     global_order_->remove(processor);
     local_order_.remove(processor);
 
@@ -173,16 +214,18 @@ namespace vital {
     VITAL_ASSERT(old_processor == processor);
     UNUSED(old_processor);
     processor->router(nullptr);
+    freeSlot(processors_[processor].first);
     processors_.erase(processor);
+    for (ProcessorRouter* clone : schedule_->clones)
+      clone->removeSlotCopy(processor);
+
+    publishSchedule();
   }
 
   void ProcessorRouter::connect(Processor* destination, const Output* source, int index) {
     if (isDownstream(destination, source->owner)) {
       // We are introducing a cycle so insert a Feedback node.
-      Feedback* feedback = new cr::Feedback();
-      feedback->plug(source);
-      destination->plug(feedback, index);
-      addFeedback(feedback);
+      destination->plug(addFeedback(source), index);
     }
     else {
       // Not introducing a cycle so just make sure _destination_ is in order.
@@ -198,7 +241,7 @@ namespace vital {
 
         if (feedback_processors_.find(owner) != feedback_processors_.end()) {
           Feedback* feedback = feedback_processors_[owner].second.get();
-          if (feedback->input()->source == source)
+          if (getCompiledSource(feedback, 0) == source)
             removeFeedback(feedback);
           destination->input(i)->source = &Processor::null_source_;
         }
@@ -206,14 +249,72 @@ namespace vital {
     }
   }
 
-  void ProcessorRouter::reorder(Processor* processor) {
-    (*global_changes_)++;
-    local_changes_++;
+  const Output* ProcessorRouter::prepareConnection(Processor* destination, const Output* source,
+                                                   std::vector<Connection>& pending) {
+    collectFeedbacks();
+
+    const Output* connected = source;
+    if (isDownstream(destination, source->owner, &pending))
+      connected = addFeedback(source)->output();
+
+    pending.push_back({ destination, connected });
+    reorder(destination, &pending);
+    return connected;
+  }
+
+  void ProcessorRouter::disconnectPrepared(Processor* destination, const Output* source) {
+    // Feedback nodes are found through the published schedule, the graph maps belong to the message thread.
+    Schedule* schedule = acquireSchedule();
+    int num_feedbacks = static_cast<int>(schedule->feedbacks.size());
+    for (int i = 0; i < destination->numInputs(); ++i) {
+      Input* input = destination->input(i);
+      if (input == nullptr)
+        continue;
+
+      if (input->source == source) {
+        destination->unplugIndex(i);
+        continue;
+      }
+
+      for (int f = 0; f < num_feedbacks; ++f) {
+        if (input->source == schedule->feedbacks[f]->output() && schedule->feedback_sources[f] == source) {
+          schedule_->released_feedbacks[schedule->feedback_slots[f]].store(true);
+          destination->unplugIndex(i);
+          break;
+        }
+      }
+    }
+    releaseSchedule(schedule);
+  }
+
+  void ProcessorRouter::collectFeedbacks() {
+    int num_feedbacks = static_cast<int>(global_feedback_order_->size());
+    int num_kept = 0;
+    for (int i = 0; i < num_feedbacks; ++i) {
+      const Feedback* feedback = global_feedback_order_->at(i);
+      auto& feedback_processor = feedback_processors_[feedback];
+      if (schedule_->released_feedbacks[feedback_processor.first].exchange(false))
+        spare_feedbacks_.push_back(feedback_processor.second.get());
+      else {
+        global_feedback_sources_->at(num_kept) = global_feedback_sources_->at(i);
+        global_feedback_order_->at(num_kept++) = feedback;
+      }
+    }
+
+    if (num_kept == num_feedbacks)
+      return;
+
+    global_feedback_order_->resize(num_kept);
+    global_feedback_sources_->resize(num_kept);
+    publishSchedule();
+  }
 
-    getDependencies(processor);
+  void ProcessorRouter::reorder(Processor* processor, const std::vector<Connection>* pending) {
+    getDependencies(processor, pending);
     if (dependencies_->size() == 0) {
+      publishSchedule();
       if (router_)
-        router_->reorder(processor);
+        router_->reorder(processor, pending);
 
       return;
     }
@@ -239,12 +340,14 @@ namespace vital {
     for (int i = 0; i < num_processors; ++i)
       global_order_->at(i) = global_reorder_->at(i);
 
+    publishSchedule();
     if (router_)
-      router_->reorder(processor);
+      router_->reorder(processor, pending);
   }
 
-  bool ProcessorRouter::isDownstream(const Processor* first, const Processor* second) const {
-    getDependencies(second);
+  bool ProcessorRouter::isDownstream(const Processor* first, const Processor* second,
+                                     const std::vector<Connection>* pending) const {
+    getDependencies(second, pending);
     return dependencies_->contains(first);
   }
 
@@ -288,93 +391,258 @@ namespace vital {
       feedback->reset(reset_mask);
   }
 
-  void ProcessorRouter::addFeedback(Feedback* feedback) {
-    feedback->router(this);
+  void ProcessorRouter::copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) {
+    Processor::copyVoiceState(source, copy);
+    const ProcessorRouter* source_router = static_cast<const ProcessorRouter*>(source);
+
+    // Clones are matched through the global processor they were copied from.
+    for (auto& processor : processors_) {
+      auto source_processor = source_router->processors_.find(processor.first);
+      if (source_processor != source_router->processors_.end())
+        processor.second.second->copyVoiceState(source_processor->second.second.get(), copy);
+    }
+
+    // Feedback copies live in the same slots in every clone.
+    int num_slots = static_cast<int>(std::min(local_slots_.size(), source_router->local_slots_.size()));
+    for (int i = 0; i < num_slots; ++i) {
+      const Feedback* source_feedback = source_router->local_slots_[i].feedback_copy.get();
+      if (local_slots_[i].feedback_copy && source_feedback)
+        local_slots_[i].feedback_copy->copyVoiceState(source_feedback, copy);
+    }
+  }
+
+  Feedback* ProcessorRouter::addFeedback(const Output* source) {
+    Feedback* feedback = nullptr;
+    if (spare_feedbacks_.empty()) {
+      feedback = new cr::Feedback();
+      feedback->plug(source);
+      feedback->router(this);
+
+      int slot = allocateSlot();
+      feedback_processors_[feedback] = { slot, std::unique_ptr<Feedback>(feedback) };
+      for (ProcessorRouter* clone : schedule_->clones)
+        clone->local_slots_[slot].feedback_copy.reset((Feedback*)feedback->clone());
+    }
+    else {
+      // Clones may still be running a spare node, its input is plugged once the schedule is picked up.
+      feedback = spare_feedbacks_.back();
+      spare_feedbacks_.pop_back();
+    }
+
     global_feedback_order_->push_back(feedback);
-    local_feedback_order_.push_back(feedback);
-    feedback_processors_[feedback] = { 0, std::unique_ptr<Feedback>(feedback) };
+    global_feedback_sources_->push_back(source);
+    publishSchedule();
+    return feedback;
   }
 
   void ProcessorRouter::removeFeedback(Feedback* feedback) {
-    (*global_changes_)++;
-    local_changes_++;
-
     auto pos = std::find(global_feedback_order_->begin(), global_feedback_order_->end(), feedback);
     VITAL_ASSERT(pos != global_feedback_order_->end());
+    int index = static_cast<int>(pos - global_feedback_order_->begin());
     global_feedback_order_->erase(pos, pos + 1);
+    global_feedback_sources_->erase(global_feedback_sources_->begin() + index);
+    spare_feedbacks_.push_back(feedback);
+    publishSchedule();
+  }
 
-    auto local_pos = std::find(local_feedback_order_.begin(), local_feedback_order_.end(), feedback);
-    VITAL_ASSERT(local_pos != local_feedback_order_.end());
-    local_feedback_order_.erase(local_pos, local_pos + 1);
+  void ProcessorRouter::updateAllProcessors() {
+    Schedule* schedule = acquireSchedule();
+    int version = schedule->version;
+    if (local_changes_ == version) {
+      releaseSchedule(schedule);
+      return;
+    }
 
-    feedback_processors_.erase(feedback);
+    // The global router keeps the order processors were added in and only picks up Feedback changes.
+    int num_feedbacks = static_cast<int>(schedule->feedbacks.size());
+    VITAL_ASSERT(static_cast<size_t>(num_feedbacks) <= local_feedback_order_.capacity());
+    local_feedback_order_.resize(num_feedbacks);
+    if (!isClone()) {
+      for (int i = 0; i < num_feedbacks; ++i) {
+        local_feedback_order_[i] = const_cast<Feedback*>(schedule->feedbacks[i]);
+        if (local_feedback_order_[i]->input()->source != schedule->feedback_sources[i])
+          local_feedback_order_[i]->plugPrepared(schedule->feedback_sources[i], 0);
+      }
+
+      local_changes_ = version;
+      releaseSchedule(schedule);
+      return;
+    }
+
+    VITAL_ASSERT(schedule->num_slots <= static_cast<int>(local_slots_.size()));
+    int num_processors = static_cast<int>(schedule->order.size());
+    if (num_processors > local_order_.capacity())
+      local_order_.reserve(global_order_->capacity());
+
+    local_order_.assign(num_processors, nullptr);
+    for (int i = 0; i < num_processors; ++i)
+      local_order_[i] = getSlotProcessor(schedule->order[i], schedule->slots[i], version, false);
+
+    for (int i = 0; i < num_feedbacks; ++i) {
+      Processor* feedback = const_cast<Feedback*>(schedule->feedbacks[i]);
+      int slot = schedule->feedback_slots[i];
+      bool scheduled = local_slots_[slot].global == feedback && local_slots_[slot].version == local_changes_;
+      local_feedback_order_[i] = (Feedback*)getSlotProcessor(feedback, slot, version, true);
+      if (local_feedback_order_[i]->input()->source != schedule->feedback_sources[i])
+        local_feedback_order_[i]->plugPrepared(schedule->feedback_sources[i], 0);
+
+      // A reused Feedback node shouldn't replay what it held for its last connection.
+      if (!scheduled)
+        local_feedback_order_[i]->reset(constants::kFullMask);
+    }
+
+    // Anything we didn't see was removed from the global order. Feedback copies are kept for reuse.
+    int num_slots = static_cast<int>(local_slots_.size());
+    for (int i = 0; i < num_slots; ++i) {
+      if (local_slots_[i].global && local_slots_[i].version != version && !local_slots_[i].feedback)
+        releaseSlot(i);
+    }
+
+    local_changes_ = version;
+    releaseSchedule(schedule);
   }
 
-  void ProcessorRouter::updateAllProcessors() {
-    if (local_changes_ == *global_changes_)
+  void ProcessorRouter::ScheduleBuffer::reserve(int num_processors) {
+    if (num_processors <= capacity)
       return;
 
-    createAddedProcessors();
-    deleteRemovedProcessors();
+    capacity = num_processors;
+    slot_capacity = capacity + kMaxModulationConnections;
+    for (Schedule& schedule : schedules) {
+      schedule.order.reserve(capacity);
+      schedule.slots.reserve(capacity);
+      schedule.feedbacks.reserve(slot_capacity);
+      schedule.feedback_slots.reserve(slot_capacity);
+      schedule.feedback_sources.reserve(slot_capacity);
+    }
+    free_slots.reserve(slot_capacity);
+
+    // Only grows while the graph is built, before anything can be released.
+    std::unique_ptr<std::atomic<bool>[]> released(new std::atomic<bool>[slot_capacity]);
+    for (int i = 0; i < slot_capacity; ++i)
+      released[i] = i < num_slots && released_feedbacks[i].load();
+    released_feedbacks = std::move(released);
 
-    local_changes_ = *global_changes_;
+    original->reserveSlots(slot_capacity);
+    for (ProcessorRouter* clone : clones)
+      clone->reserveSlots(slot_capacity);
   }
 
-  void ProcessorRouter::createAddedProcessors() {
-    if (global_order_->size() > local_order_.capacity())
-      local_order_.reserve(global_order_->capacity());
-   
-    local_order_.assign(global_order_->size(), nullptr);
-    local_feedback_order_.assign(global_feedback_order_->size(), nullptr);
+  void ProcessorRouter::publishSchedule() {
+    // Clones only hold on to a schedule while they copy their order out of it.
+    Schedule* next = nullptr;
+    while (next == nullptr) {
+      Schedule* current = schedule_->current.load();
+      for (Schedule& schedule : schedule_->schedules) {
+        if (&schedule != current && schedule.readers.load() == 0) {
+          next = &schedule;
+          break;
+        }
+      }
+
+      if (next == nullptr)
+        std::this_thread::yield();
+    }
 
     int num_processors = global_order_->size();
+    next->order.resize(num_processors);
+    next->slots.resize(num_processors);
     for (int i = 0; i < num_processors; ++i) {
-      Processor* next = global_order_->at(i);
-      if (next->hasState()) {
-        if (processors_.count(next) == 0)
-          processors_[next] = { 0, std::unique_ptr<Processor>(next->clone()) };
-        local_order_[i] = processors_[next].second.get();
-      }
-      else
-        local_order_[i] = next;
+      Processor* processor = global_order_->at(i);
+      next->order[i] = processor;
+      next->slots[i] = processors_.find(processor)->second.first;
     }
 
     int num_feedbacks = static_cast<int>(global_feedback_order_->size());
+    next->feedbacks.resize(num_feedbacks);
+    next->feedback_slots.resize(num_feedbacks);
+    next->feedback_sources.resize(num_feedbacks);
     for (int i = 0; i < num_feedbacks; ++i) {
-      const Feedback* next = global_feedback_order_->at(i);
-      if (feedback_processors_.count(next) == 0)
-        feedback_processors_[next] = { 0, std::unique_ptr<Feedback>((Feedback*)(next->clone())) };
-      local_feedback_order_[i] = feedback_processors_[next].second.get();
+      const Feedback* feedback = global_feedback_order_->at(i);
+      next->feedbacks[i] = feedback;
+      next->feedback_slots[i] = feedback_processors_.find(feedback)->second.first;
+      next->feedback_sources[i] = global_feedback_sources_->at(i);
     }
-  }
 
-  void ProcessorRouter::deleteRemovedProcessors() {
-    for (const Processor* global_processor : *global_order_)
-      processors_[global_processor].first = *global_changes_;
+    next->num_slots = schedule_->num_slots;
+    next->version = global_changes_->load() + 1;
+    schedule_->current.store(next);
+    global_changes_->store(next->version);
+  }
 
-    for (auto iter = processors_.cbegin(); iter != processors_.cend();) {
-      if (iter->second.first != *global_changes_)
-        iter = processors_.erase(iter);
-      else
-        iter++;
+  ProcessorRouter::Schedule* ProcessorRouter::acquireSchedule() const {
+    while (true) {
+      Schedule* schedule = schedule_->current.load();
+      schedule->readers++;
+      if (schedule_->current.load() == schedule)
+        return schedule;
+      schedule->readers--;
     }
+  }
 
-    for (const Feedback* global_feedback : *global_feedback_order_)
-      feedback_processors_[global_feedback].first = *global_changes_;
+  int ProcessorRouter::allocateSlot() {
+    // Only a graph bigger than addProcessor() reserved for gets here, which happens while it's being built.
+    if (schedule_->free_slots.empty() && schedule_->num_slots == schedule_->slot_capacity)
+      schedule_->reserve(schedule_->capacity + kMaxModulationConnections);
 
-    for (auto iter = feedback_processors_.cbegin(); iter != feedback_processors_.cend();) {
-      if (iter->second.first != *global_changes_)
-        iter = feedback_processors_.erase(iter);
-      else
-        iter++;
-    }
+    if (schedule_->free_slots.empty())
+      return schedule_->num_slots++;
 
-    int num_feedbacks = static_cast<int>(global_feedback_order_->size());
-    local_feedback_order_.clear();
-    for (int i = 0; i < num_feedbacks; ++i) {
-      const Feedback* next = global_feedback_order_->at(i);
-      local_feedback_order_.push_back(feedback_processors_[next].second.get());
+    int slot = schedule_->free_slots.back();
+    schedule_->free_slots.pop_back();
+    return slot;
+  }
+
+  void ProcessorRouter::freeSlot(int slot) {
+    schedule_->free_slots.push_back(slot);
+  }
+
+  void ProcessorRouter::reserveSlots(int slot_capacity) {
+    if (isClone() && slot_capacity > static_cast<int>(local_slots_.size()))
+      local_slots_.resize(slot_capacity);
+    local_feedback_order_.reserve(slot_capacity);
+  }
+
+  Processor* ProcessorRouter::getSlotProcessor(Processor* global_processor, int slot, int version, bool feedback) {
+    // A processor removed and added back gets a new copy in the same slot.
+    LocalSlot& local_slot = local_slots_[slot];
+    if (local_slot.global != global_processor || (!feedback && local_slot.local != local_slot.copy)) {
+      local_slot.global = global_processor;
+      local_slot.local = feedback ? local_slot.feedback_copy.get() : local_slot.copy;
+      local_slot.feedback = feedback;
+      VITAL_ASSERT(local_slot.local || !global_processor->hasState());
     }
+
+    local_slot.version = version;
+    if (feedback || global_processor->hasState())
+      return local_slot.local;
+    return global_processor;
+  }
+
+  void ProcessorRouter::releaseSlot(int slot) {
+    LocalSlot& local_slot = local_slots_[slot];
+    local_slot.global = nullptr;
+    local_slot.local = nullptr;
+    local_slot.version = 0;
+    local_slot.feedback = false;
+  }
+
+  void ProcessorRouter::addSlotCopy(const Processor* global_processor, int slot) {
+    if (!global_processor->hasState() || processors_.find(global_processor) != processors_.end())
+      return;
+
+    std::unique_ptr<Processor> copy(global_processor->clone());
+    local_slots_[slot].copy = copy.get();
+    processors_[global_processor] = { slot, std::move(copy) };
+  }
+
+  void ProcessorRouter::removeSlotCopy(const Processor* global_processor) {
+    auto found = processors_.find(global_processor);
+    if (found == processors_.end())
+      return;
+
+    local_slots_[found->second.first].copy = nullptr;
+    processors_.erase(found);
   }
 
   const Processor* ProcessorRouter::getContext(const Processor* processor) const {
@@ -391,7 +659,22 @@ namespace vital {
     return processors_[global_processor].second.get();
   }
 
-  void ProcessorRouter::getDependencies(const Processor* processor) const {
+  const Output* ProcessorRouter::getCompiledSource(const Processor* processor, int index) const {
+    const Output* source = processor->ownedInput(index)->source;
+    const ProcessorRouter* router = processor->router();
+    if (router == nullptr || router->feedback_processors_.find(processor) == router->feedback_processors_.end())
+      return source;
+
+    // Spare Feedback nodes aren't scheduled and don't read anything.
+    const std::vector<const Feedback*>& feedbacks = *router->global_feedback_order_;
+    for (size_t i = 0; i < feedbacks.size(); ++i) {
+      if (feedbacks[i] == processor)
+        return router->global_feedback_sources_->at(i);
+    }
+    return nullptr;
+  }
+
+  void ProcessorRouter::getDependencies(const Processor* processor, const std::vector<Connection>* pending) const {
     dependencies_->clear();
     dependencies_visited_->clear();
     dependency_inputs_->clear();
@@ -409,17 +692,30 @@ namespace vital {
         }
 
         for (int j = 0; j < dependency_inputs_->at(i)->numInputs(); ++j) {
-          const Input* input = dependency_inputs_->at(i)->ownedInput(j);
-          if (input->source && input->source->owner && !dependencies_visited_->contains(input->source->owner)) {
+          const Output* source = getCompiledSource(dependency_inputs_->at(i), j);
+          if (source && source->owner && !dependencies_visited_->contains(source->owner)) {
             dependency_inputs_->ensureSpace();
-            dependency_inputs_->push_back(input->source->owner);
+            dependency_inputs_->push_back(source->owner);
 
-            if (!dependencies_visited_->contains(input->source->owner)) {
+            if (!dependencies_visited_->contains(source->owner)) {
               dependencies_visited_->ensureSpace();
-              dependencies_visited_->push_back(input->source->owner);
+              dependencies_visited_->push_back(source->owner);
             }
           }
         }
+
+        if (pending == nullptr)
+          continue;
+
+        for (const Connection& connection : *pending) {
+          const Processor* owner = connection.source->owner;
+          if (connection.destination == dependency_inputs_->at(i) && !dependencies_visited_->contains(owner)) {
+            dependency_inputs_->ensureSpace();
+            dependency_inputs_->push_back(owner);
+            dependencies_visited_->ensureSpace();
+            dependencies_visited_->push_back(owner);
+          }
+        }
       }
     }
 
@@ -19,6 +19,7 @@
 #include "processor.h"
 #include "circular_queue.h"
 
+#include <atomic>
 #include <map>
 #include <set>
 #include <vector>
@@ -42,19 +43,39 @@ namespace vital {
       virtual void init() override;
       virtual void setSampleRate(int sample_rate) override;
       virtual void setOversampleAmount(int oversample) override;
+      virtual void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override;
 
       virtual void addProcessor(Processor* processor);
       virtual void addProcessorRealTime(Processor* processor);
       virtual void addIdleProcessor(Processor* processor);
       virtual void removeProcessor(Processor* processor);
 
+      // A connection that has been compiled into the schedules but isn't plugged in yet.
+      struct Connection {
+        const Processor* destination;
+        const Output* source;
+      };
+
       // Any time new dependencies are added into the ProcessorRouter graph, we
       // should call _connect_ on the destination Processor and source Output.
       void connect(Processor* destination, const Output* source, int index);
       void disconnect(const Processor* destination, const Output* source);
-      bool isDownstream(const Processor* first, const Processor* second) const;
+      bool isDownstream(const Processor* first, const Processor* second,
+                        const std::vector<Connection>* pending = nullptr) const;
       bool areOrdered(const Processor* first, const Processor* second) const;
 
+      // Orders _destination_ after _source_ as if it were plugged in along with the _pending_ connections,
+      // publishes the new schedules and appends the connection to _pending_. Returns what to plug into
+      // _destination_ with Processor::plugPrepared(), which is a Feedback node's output if it closes a cycle.
+      // This lets the graph be walked off the audio thread while plugging in stays cheap.
+      const Output* prepareConnection(Processor* destination, const Output* source,
+                                      std::vector<Connection>& pending);
+
+      // Unplugs _source_ from _destination_, or the Feedback node between them if there is one, without
+      // walking the graph. The Feedback node is marked released and keeps running until the next
+      // prepareConnection() collects it.
+      void disconnectPrepared(Processor* destination, const Output* source);
+
       virtual bool isPolyphonic(const Processor* processor) const;
 
       virtual ProcessorRouter* getMonoRouter();
@@ -62,30 +83,103 @@ namespace vital {
       virtual void resetFeedbacks(poly_mask reset_mask);
 
     protected:
+      // A flat, read only copy of the global processing order. Graph edits compile one into a spare buffer
+      // and publish it with a single atomic store, clones then rebuild their local order from it without
+      // walking maps or dependencies in process().
+      struct Schedule {
+        Schedule() : version(0), num_slots(0), readers(0) { }
+
+        int version;
+        int num_slots;
+        std::vector<Processor*> order;
+        std::vector<int> slots;
+        std::vector<const Feedback*> feedbacks;
+        std::vector<int> feedback_slots;
+        // What each Feedback node reads. Routers plug it in when they pick up the schedule, so Feedback
+        // inputs are only written on the audio thread once the node is scheduled.
+        std::vector<const Output*> feedback_sources;
+        std::atomic<int> readers;
+      };
+
+      // Shared between a router and all of its clones. A Schedule is only rewritten once it is no longer
+      // current and no clone is reading from it.
+      struct ScheduleBuffer {
+        static constexpr int kNumSchedules = 3;
+
+        ScheduleBuffer(ProcessorRouter* router) : current(&schedules[0]), original(router),
+                                                  num_slots(0), capacity(0), slot_capacity(0) { }
+
+        // Sizes every schedule and clone for _num_processors_ plus a Feedback node per modulation, so
+        // compiling and picking up a schedule doesn't allocate.
+        void reserve(int num_processors);
+
+        Schedule schedules[kNumSchedules];
+        std::atomic<Schedule*> current;
+        ProcessorRouter* original;
+        std::vector<ProcessorRouter*> clones;
+        std::vector<int> free_slots;
+        // Set by disconnectPrepared() for a Feedback node's slot, cleared when collectFeedbacks() takes it.
+        std::unique_ptr<std::atomic<bool>[]> released_feedbacks;
+        int num_slots;
+        int capacity;
+        int slot_capacity;
+      };
+
+      // Where a clone keeps its copy of the global processor compiled into a Schedule slot. Copies are made
+      // on the message thread when the processor or Feedback node is added and kept until it's removed, the
+      // audio thread only picks up what the slot already holds.
+      struct LocalSlot {
+        const Processor* global = nullptr;
+        Processor* local = nullptr;
+        int version = 0;
+        bool feedback = false;
+        Processor* copy = nullptr;
+        std::unique_ptr<Feedback> feedback_copy;
+      };
+
       // When we create a cycle into the ProcessorRouter graph, we must insert
-      // a Feedback node and add it here.
-      virtual void addFeedback(Feedback* feedback);
+      // a Feedback node and add it here. Removed Feedback nodes are kept to be reused.
+      virtual Feedback* addFeedback(const Output* source);
       virtual void removeFeedback(Feedback* feedback);
 
+      // Removes Feedback nodes that disconnectPrepared() released.
+      void collectFeedbacks();
+
       // Makes sure _processor_ runs in a topologically sorted order in
       // relation to all other Processors in _this_.
-      void reorder(Processor* processor);
+      void reorder(Processor* processor, const std::vector<Connection>* pending = nullptr);
 
       // Ensures our local copies of all processors and feedback processors match the master order.
       virtual void updateAllProcessors();
 
-      force_inline bool shouldUpdate() { return local_changes_ != *global_changes_; }
+      force_inline bool shouldUpdate() { return local_changes_ != global_changes_->load(); }
+      force_inline bool isClone() const { return schedule_->original != this; }
+
+      // Compiles the global order into a spare Schedule and makes it current, waiting for a clone to finish
+      // reading if none is spare.
+      void publishSchedule();
+      Schedule* acquireSchedule() const;
+      force_inline void releaseSchedule(Schedule* schedule) const { schedule->readers--; }
 
-      // Will create local copies of added processors. 
-      virtual void createAddedProcessors();
+      int allocateSlot();
+      void freeSlot(int slot);
+      void reserveSlots(int slot_capacity);
 
-      // Will delete local copies of removed processors. 
-      virtual void deleteRemovedProcessors();
+      // Returns our copy of _global_processor_ for _slot_, or the global processor if it has no state.
+      Processor* getSlotProcessor(Processor* global_processor, int slot, int version, bool feedback);
+      void releaseSlot(int slot);
+
+      // Copies are made once the processor is initialized. Processors are only added and removed while the
+      // graph is built, not while clones are processing.
+      void addSlotCopy(const Processor* global_processor, int slot);
+      void removeSlotCopy(const Processor* global_processor);
 
       // Returns the ancestor of _processor_ which is a child of _this_.
       // Returns null if _processor_ is not a descendant of _this_.
       const Processor* getContext(const Processor* processor) const;
-      void getDependencies(const Processor* processor) const;
+      void getDependencies(const Processor* processor, const std::vector<Connection>* pending = nullptr) const;
+      // A Feedback node's input only follows its compiled source once the audio thread picks it up.
+      const Output* getCompiledSource(const Processor* processor, int index) const;
 
       // Returns the processor for this voice from the globally created one.
       Processor* getLocalProcessor(const Processor* global_processor);
@@ -97,12 +191,17 @@ namespace vital {
       std::map<const Processor*, std::unique_ptr<Processor>> idle_processors_;
 
       std::shared_ptr<std::vector<const Feedback*>> global_feedback_order_;
+      std::shared_ptr<std::vector<const Output*>> global_feedback_sources_;
       std::vector<Feedback*> local_feedback_order_;
       std::map<const Processor*, std::pair<int, std::unique_ptr<Feedback>>> feedback_processors_;
+      std::vector<Feedback*> spare_feedbacks_;
 
-      std::shared_ptr<int> global_changes_;
+      std::shared_ptr<std::atomic<int>> global_changes_;
       int local_changes_;
 
+      std::shared_ptr<ScheduleBuffer> schedule_;
+      std::vector<LocalSlot> local_slots_;
+
       std::shared_ptr<CircularQueue<const Processor*>> dependencies_;
       std::shared_ptr<CircularQueue<const Processor*>> dependencies_visited_;
       std::shared_ptr<CircularQueue<const Processor*>> dependency_inputs_;
@@ -0,0 +1,125 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "profiler.h"
+
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace vital {
+
+  namespace {
+    std::mutex& entryMutex() {
+      static std::mutex mutex;
+      return mutex;
+    }
+
+    std::vector<std::string>& entryNames() {
+      static std::vector<std::string> names;
+      return names;
+    }
+  } // namespace
+
+  thread_local Profiler* Profiler::active_ = nullptr;
+  std::atomic<int> Profiler::num_entries_(0);
+
+  int Profiler::registerEntry(const std::string& name) {
+    std::lock_guard<std::mutex> lock(entryMutex());
+    std::vector<std::string>& names = entryNames();
+    int num_names = static_cast<int>(names.size());
+    for (int i = 0; i < num_names; ++i) {
+      if (names[i] == name)
+        return i;
+    }
+
+    if (names.size() >= kMaxEntries)
+      return -1;
+
+    names.push_back(name);
+    num_entries_.store(static_cast<int>(names.size()), std::memory_order_release);
+    return static_cast<int>(names.size()) - 1;
+  }
+
+  std::string Profiler::getEntryName(int id) {
+    std::lock_guard<std::mutex> lock(entryMutex());
+    std::vector<std::string>& names = entryNames();
+    if (id < 0 || id >= static_cast<int>(names.size()))
+      return "";
+    return names[id];
+  }
+
+  Profiler::Profiler() : enabled_(false), recording_(false), block_start_(0), current_(),
+                         write_index_(0), read_index_(0), dropped_blocks_(0) { }
+
+  void Profiler::setEnabled(bool enabled) {
+    if (enabled && ring_ == nullptr)
+      ring_ = std::make_unique<BlockRecord[]>(kRingSize);
+    enabled_ = enabled;
+  }
+
+  void Profiler::beginBlock() {
+    recording_ = enabled_.load();
+    if (!recording_)
+      return;
+
+    active_ = this;
+    memset(current_, 0, sizeof(current_));
+    block_start_ = now();
+  }
+
+  void Profiler::endBlock(int num_samples, int sample_rate, int num_voices) {
+    if (!recording_)
+      return;
+
+    int64_t end = now();
+    active_ = nullptr;
+    recording_ = false;
+
+    int write_index = write_index_.load(std::memory_order_relaxed);
+    if (write_index - read_index_.load(std::memory_order_acquire) >= kRingSize) {
+      dropped_blocks_++;
+      return;
+    }
+
+    BlockRecord& record = ring_[write_index % kRingSize];
+    record.start = block_start_;
+    record.duration = end - block_start_;
+    record.num_samples = num_samples;
+    record.sample_rate = sample_rate;
+    record.num_voices = num_voices;
+    record.num_entries = numEntries();
+    memcpy(record.entries, current_, record.num_entries * sizeof(EntryTime));
+    write_index_.store(write_index + 1, std::memory_order_release);
+  }
+
+  bool Profiler::readBlock(BlockRecord& record) {
+    int read_index = read_index_.load(std::memory_order_relaxed);
+    if (read_index == write_index_.load(std::memory_order_acquire))
+      return false;
+
+    const BlockRecord& stored = ring_[read_index % kRingSize];
+    record.start = stored.start;
+    record.duration = stored.duration;
+    record.num_samples = stored.num_samples;
+    record.sample_rate = stored.sample_rate;
+    record.num_voices = stored.num_voices;
+    record.num_entries = stored.num_entries;
+    memcpy(record.entries, stored.entries, stored.num_entries * sizeof(EntryTime));
+    read_index_.store(read_index + 1, std::memory_order_release);
+    return true;
+  }
+} // namespace vital
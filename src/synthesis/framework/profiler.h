@@ -0,0 +1,123 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace vital {
+
+  // Opt-in timing of named processors and modules. Processors are tagged with an entry through
+  // Processor::setProfileName and every call of a tagged processor is timed while a profiler is active
+  // on the audio thread. Each block's totals go into a lock-free ring that one reader thread drains.
+  class Profiler {
+    public:
+      static constexpr int kMaxEntries = 256;
+      static constexpr int kRingSize = 256;
+
+      struct EntryTime {
+        int64_t start;
+        int64_t duration;
+        int calls;
+      };
+
+      // Times are nanoseconds. Entry starts are relative to the block start and durations include
+      // every call in the block, so per-voice calls of the same processor are summed.
+      struct BlockRecord {
+        int64_t start;
+        int64_t duration;
+        int num_samples;
+        int sample_rate;
+        int num_voices;
+        int num_entries;
+        EntryTime entries[kMaxEntries];
+      };
+
+      // Times one call of a tagged processor if a profiler is active.
+      class Scope {
+        public:
+          force_inline Scope(Profiler* profiler, int id) :
+              profiler_(id >= 0 ? profiler : nullptr), id_(id), start_(0) {
+            if (profiler_)
+              start_ = now();
+          }
+
+          force_inline ~Scope() {
+            if (profiler_)
+              profiler_->record(id_, start_, now());
+          }
+
+        private:
+          Profiler* profiler_;
+          int id_;
+          int64_t start_;
+      };
+
+      static int registerEntry(const std::string& name);
+      static int numEntries() { return num_entries_.load(std::memory_order_acquire); }
+      static std::string getEntryName(int id);
+
+      static force_inline Profiler* active() { return active_; }
+      static force_inline int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+      Profiler();
+
+      // Allocates the ring so it must not be called from the audio thread.
+      void setEnabled(bool enabled);
+      bool isEnabled() const { return enabled_.load(); }
+
+      // Called by the engine around each block on the audio thread.
+      void beginBlock();
+      void endBlock(int num_samples, int sample_rate, int num_voices);
+
+      force_inline void record(int id, int64_t start, int64_t end) {
+        EntryTime& entry = current_[id];
+        if (entry.calls == 0)
+          entry.start = start - block_start_;
+        entry.duration += end - start;
+        entry.calls++;
+      }
+
+      // Reader side, pops the oldest finished block. Only one thread may read.
+      bool readBlock(BlockRecord& record);
+      int getDroppedBlocks() const { return dropped_blocks_.load(); }
+
+    private:
+      static thread_local Profiler* active_;
+      static std::atomic<int> num_entries_;
+
+      std::atomic<bool> enabled_;
+      bool recording_;
+      int64_t block_start_;
+      EntryTime current_[kMaxEntries];
+
+      std::unique_ptr<BlockRecord[]> ring_;
+      std::atomic<int> write_index_;
+      std::atomic<int> read_index_;
+      std::atomic<int> dropped_blocks_;
+
+      JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Profiler)
+  };
+} // namespace vital
@@ -16,6 +16,7 @@
 
 #include "synth_module.h"
 
+#include "output_arena.h"
 #include "synth_constants.h"
 #include "smooth_value.h"
 #include "value_switch.h"
@@ -325,6 +326,14 @@ namespace vital {
     return nullptr;
   }
 
+  void SynthModule::getStatusOutputs(std::map<std::string, const StatusOutput*>& status_outputs) const {
+    for (auto& status_output : data_->status_outputs)
+      status_outputs.insert({ status_output.first, status_output.second.get() });
+
+    for (SynthModule* sub_module : data_->sub_modules)
+      sub_module->getStatusOutputs(status_outputs);
+  }
+
   Processor* SynthModule::getModulationDestination(std::string name, bool poly) {
     Processor* poly_destination = getPolyModulationDestination(name);
 
@@ -470,6 +479,88 @@ namespace vital {
       
     ProcessorRouter::enable(enable);
     enableOwnedProcessors(enable);
+
+    if (enable)
+      acquireOutputs();
+    else
+      releaseOutputs();
+  }
+
+  void SynthModule::process(int num_samples) {
+    // A module switched on while the arena was short waits for its buffers instead of writing into silence.
+    if (acquireOutputs())
+      ProcessorRouter::process(num_samples);
+  }
+
+  void SynthModule::setOutputArena(OutputArena* arena) {
+    if (data_->output_arena)
+      data_->output_arena->removeModule(data_->arena_outputs);
+
+    data_->output_arena = arena;
+    data_->arena_outputs.clear();
+    data_->outputs_released = false;
+    if (arena == nullptr)
+      return;
+
+    std::vector<Output*> outputs;
+    std::set<const Output*> shared;
+    for (int i = 0; i < numOutputs(); ++i)
+      shared.insert(output(i));
+    getInternalOutputs(outputs, shared);
+
+    for (Output* output : outputs) {
+      bool aliased = output->buffer != output->owned_buffer.get();
+      if (!aliased && shared.count(output) == 0)
+        data_->arena_outputs.push_back(output);
+    }
+    arena->addModule(data_->arena_outputs);
+
+    if (!enabled())
+      releaseOutputs();
+  }
+
+  void SynthModule::releaseOutputs() {
+    if (data_->output_arena == nullptr || data_->outputs_released)
+      return;
+
+    for (Output* output : data_->arena_outputs)
+      data_->output_arena->release(output);
+    data_->outputs_released = true;
+  }
+
+  bool SynthModule::acquireOutputs() {
+    if (data_->output_arena == nullptr || !data_->outputs_released)
+      return true;
+
+    if (!data_->output_arena->acquire(data_->arena_outputs))
+      return false;
+    data_->outputs_released = false;
+    return true;
+  }
+
+  void SynthModule::getInternalOutputs(std::vector<Output*>& outputs, std::set<const Output*>& shared) {
+    for (auto& processor : processors_) {
+      Processor* owned = processor.second.second.get();
+      for (int i = 0; i < owned->numOwnedOutputs(); ++i)
+        outputs.push_back(owned->ownedOutput(i));
+    }
+
+    // Idle processors like ValueSwitch point their outputs at their sources or get read directly.
+    for (auto& idle_processor : idle_processors_) {
+      Processor* idle = idle_processor.second.get();
+      for (int i = 0; i < idle->numInputs(); ++i) {
+        if (idle->input(i))
+          shared.insert(idle->input(i)->source);
+      }
+      for (int i = 0; i < idle->numOutputs(); ++i)
+        shared.insert(idle->output(i));
+    }
+
+    for (auto& mod_source : data_->mod_sources)
+      shared.insert(mod_source.second);
+
+    for (SynthModule* sub_module : data_->sub_modules)
+      sub_module->getInternalOutputs(outputs, shared);
   }
 
   void SynthModule::addMonoProcessor(Processor* processor, bool own) {
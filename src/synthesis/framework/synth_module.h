@@ -20,9 +20,11 @@
 #include "processor_router.h"
 
 #include <climits>
+#include <set>
 #include <vector>
 
 namespace vital {
+  class OutputArena;
   class ValueSwitch;
   class SynthModule;
 
@@ -35,8 +37,7 @@ namespace vital {
       force_inline poly_float value() const { return value_; }
 
       force_inline void update(poly_mask voice_mask) {
-        poly_float masked_value = source_->buffer[0] & voice_mask;
-        value_ = masked_value + utils::swapVoices(masked_value);
+        value_ = utils::sumVoices(source_->buffer[0] & voice_mask);
       }
 
       force_inline void update() {
@@ -44,6 +45,7 @@ namespace vital {
       }
 
       force_inline void clear() { value_ = kClearValue; }
+      force_inline void set(poly_float value) { value_ = value; }
       force_inline bool isClearValue(poly_float value) const { return poly_float::equal(value, kClearValue).anyMask(); }
       force_inline bool isClearValue(float value) const { return value == kClearValue; }
 
@@ -55,6 +57,8 @@ namespace vital {
   };
 
   struct ModuleData {
+    ModuleData() : output_arena(nullptr), outputs_released(false) { }
+
     std::vector<Processor*> owned_mono_processors;
     std::vector<SynthModule*> sub_modules;
 
@@ -68,6 +72,10 @@ namespace vital {
     std::map<std::string, ValueSwitch*> mono_modulation_switches;
     std::map<std::string, ValueSwitch*> poly_modulation_switches;
 
+    OutputArena* output_arena;
+    std::vector<Output*> arena_outputs;
+    bool outputs_released;
+
     JUCE_LEAK_DETECTOR(ModuleData)
   };
 
@@ -84,6 +92,7 @@ namespace vital {
 
       Output* getModulationSource(std::string name);
       const StatusOutput* getStatusOutput(std::string name) const;
+      void getStatusOutputs(std::map<std::string, const StatusOutput*>& status_outputs) const;
       Processor* getModulationDestination(std::string name, bool poly);
       Processor* getMonoModulationDestination(std::string name);
       Processor* getPolyModulationDestination(std::string name);
@@ -99,14 +108,26 @@ namespace vital {
       virtual output_map& getMonoModulations();
       virtual output_map& getPolyModulations();
       virtual void correctToTime(double seconds) { }
+
+      // Samples an effect can keep sounding after its input goes silent, not counting feedback decay.
+      virtual int getTailSamples() const { return 0; }
       void enableOwnedProcessors(bool enable);
       virtual void enable(bool enable) override;
+      virtual void process(int num_samples) override;
       void addMonoProcessor(Processor* processor, bool own = true);
       void addIdleMonoProcessor(Processor* processor);
 
       virtual Processor* clone() const override { return new SynthModule(*this); }
       void addSubmodule(SynthModule* module) { data_->sub_modules.push_back(module); }
 
+      // Hands the buffers of outputs only read inside this module to _arena_ while the module is off.
+      // Call on the global module after init, outputs are shared with the voice clones. A null arena
+      // gives every buffer back to its output.
+      virtual void setOutputArena(OutputArena* arena);
+      void releaseOutputs();
+      // Returns false while the arena has no buffers to give back, the module stays silent until it does.
+      bool acquireOutputs();
+
     protected:
       // Creates a basic linear non-scaled control.
       Value* createBaseControl(std::string name, bool audio_rate = false, bool smooth_value = false);
@@ -129,6 +150,10 @@ namespace vital {
 
       void createStatusOutput(std::string name, Output* source);
 
+      // Collects outputs owned by processors of this module and its submodules, and the outputs that
+      // are read or aliased from outside the processing graph of the module.
+      void getInternalOutputs(std::vector<Output*>& outputs, std::set<const Output*>& shared);
+
       std::shared_ptr<ModuleData> data_;
 
       JUCE_LEAK_DETECTOR(SynthModule)
@@ -0,0 +1,63 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+
+#include <atomic>
+
+namespace vital {
+
+  // Single producer, single consumer hand off of whole values. The producer fills the back buffer and publishes
+  // it, the consumer swaps in the newest published buffer. Neither side ever waits or sees a partial write.
+  template<class T>
+  class TripleBuffer {
+    public:
+      TripleBuffer() : write_index_(0), read_index_(1), shared_index_(2) { }
+
+      force_inline T& getWriteBuffer() { return buffers_[write_index_]; }
+      force_inline const T& getReadBuffer() const { return buffers_[read_index_]; }
+
+      // Only safe before either thread starts using the buffer.
+      T& getBuffer(int index) { return buffers_[index]; }
+
+      force_inline void publish() {
+        write_index_ = shared_index_.exchange(write_index_ | kFreshBit, std::memory_order_acq_rel) & kIndexMask;
+      }
+
+      force_inline bool consume() {
+        if ((shared_index_.load(std::memory_order_relaxed) & kFreshBit) == 0)
+          return false;
+
+        read_index_ = shared_index_.exchange(read_index_, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+      }
+
+    private:
+      enum {
+        kIndexMask = 3,
+        kFreshBit = 4
+      };
+
+      T buffers_[3];
+      int write_index_;
+      int read_index_;
+      std::atomic<int> shared_index_;
+
+      JUCE_DECLARE_NON_COPYABLE(TripleBuffer)
+  };
+} // namespace vital
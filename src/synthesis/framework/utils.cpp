@@ -21,6 +21,7 @@ namespace vital {
   constexpr float kPcmScale = 32767.0f;
   constexpr float kComplexAmplitudePcmScale = 50.0f;
   constexpr float kComplexPhasePcmScale = 10000.0f;
+  constexpr char kRawDataPrefix[] = { '\0', 'r', 'a', 'w' };
 
   namespace utils {
     int RandomGenerator::next_seed_ = 0;
@@ -91,5 +92,64 @@ namespace vital {
         complex_data[i] = std::polar(amp, phase);
       }
     }
+
+    bool isRawDataString(const std::string& data) {
+      return data.size() >= sizeof(kRawDataPrefix) && memcmp(data.data(), kRawDataPrefix, sizeof(kRawDataPrefix)) == 0;
+    }
+
+    std::string encodeRawDataString(const void* data, size_t size) {
+      std::string result(sizeof(kRawDataPrefix) + size, '\0');
+      memcpy(&result[0], kRawDataPrefix, sizeof(kRawDataPrefix));
+      if (size)
+        memcpy(&result[sizeof(kRawDataPrefix)], data, size);
+      return result;
+    }
+
+    std::string encodeDataString(const void* data, size_t size, bool raw) {
+      if (raw)
+        return encodeRawDataString(data, size);
+      return Base64::toBase64(data, size).toStdString();
+    }
+
+    size_t readDataString(const std::string& data, MemoryOutputStream& scratch, const void** bytes) {
+      if (isRawDataString(data)) {
+        *bytes = data.data() + sizeof(kRawDataPrefix);
+        return data.size() - sizeof(kRawDataPrefix);
+      }
+
+      Base64::convertFromBase64(scratch, data);
+      *bytes = scratch.getData();
+      return scratch.getDataSize();
+    }
+
+    void pcmDataStringToFloatData(float* float_data, const std::string& data, int size) {
+      MemoryOutputStream scratch;
+      const void* bytes = nullptr;
+      int num_samples = std::min<int>(size, readDataString(data, scratch, &bytes) / sizeof(int16_t));
+      pcmToFloatData(float_data, static_cast<const int16_t*>(bytes), num_samples);
+      std::fill(float_data + num_samples, float_data + size, 0.0f);
+    }
+
+    uint64_t hashData(const void* data, size_t size, uint64_t seed) {
+      constexpr uint64_t kMultiplier = 0x9e3779b97f4a7c15ULL;
+      const uint8_t* bytes = static_cast<const uint8_t*>(data);
+      uint64_t hash = seed ^ (size * kMultiplier);
+
+      size_t num_words = size / sizeof(uint64_t);
+      for (size_t i = 0; i < num_words; ++i) {
+        uint64_t word;
+        memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+        hash = (hash ^ (word * kMultiplier)) * kMultiplier;
+        hash ^= hash >> 29;
+      }
+
+      uint64_t tail = 0;
+      size_t tail_size = size - num_words * sizeof(uint64_t);
+      if (tail_size)
+        memcpy(&tail, bytes + num_words * sizeof(uint64_t), tail_size);
+
+      hash = (hash ^ (tail * kMultiplier)) * kMultiplier;
+      return hash ^ (hash >> 32);
+    }
   } // namespace utils
 } // namespace vital
@@ -240,6 +240,19 @@ namespace vital {
     void complexToPcmData(int16_t* pcm_data, const std::complex<float>* complex_data, int size);
     void pcmToFloatData(float* float_data, const int16_t* pcm_data, int size);
     void pcmToComplexData(std::complex<float>* complex_data, const int16_t* pcm_data, int size);
+
+    // Binary presets load sample and wavetable payloads as raw bytes behind a prefix Base64 can't
+    // produce, .vital json holds them as Base64. readDataString points bytes at the payload either
+    // way and only decodes into scratch for Base64, so raw payloads are read in place.
+    bool isRawDataString(const std::string& data);
+    std::string encodeRawDataString(const void* data, size_t size);
+    std::string encodeDataString(const void* data, size_t size, bool raw);
+    size_t readDataString(const std::string& data, MemoryOutputStream& scratch, const void** bytes);
+    // Reads a 16 bit pcm payload into size floats, zero filling past the end of a short payload.
+    void pcmDataStringToFloatData(float* float_data, const std::string& data, int size);
+
+    // Fast non-cryptographic hash used to spot payloads that haven't changed since they were encoded.
+    uint64_t hashData(const void* data, size_t size, uint64_t seed = 0);
   } // namespace utils
 } // namespace vital
 
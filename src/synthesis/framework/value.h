@@ -36,6 +36,11 @@ namespace vital {
       force_inline mono_float value() const { return value_[0]; }
       virtual void set(poly_float value);
 
+      // Jumps straight to the target for values that would otherwise glide toward it.
+      virtual void settle() { }
+      // Glides linearly to value over the next num_samples samples where the value glides, otherwise sets it.
+      virtual void ramp(poly_float value, int) { set(value); }
+
     protected:
       poly_float value_;
 
@@ -59,6 +59,23 @@ namespace vital {
     force_inline int pressedCompareHighestFirst(int left, int right) {
       return getNote(left) - getNote(right);
     }
+
+    force_inline int numLiveVoices(const AggregateVoice* aggregate_voice) {
+      int live_voices = 0;
+      for (Voice* voice : aggregate_voice->voices) {
+        if (voice->key_state() != Voice::kDead)
+          live_voices++;
+      }
+      return live_voices;
+    }
+
+    force_inline bool hasNewEvents(const AggregateVoice* aggregate_voice) {
+      for (Voice* voice : aggregate_voice->voices) {
+        if (voice->hasNewEvent())
+          return true;
+      }
+      return false;
+    }
   } // namespace
 
   Voice::Voice(AggregateVoice* parent) : voice_index_(0), voice_mask_(0), event_sample_(-1),
@@ -72,10 +89,11 @@ namespace vital {
     state_.channel = 0;
     key_state_ = kDead;
     last_key_state_ = kDead;
+    key_state_changed_ = false;
   }
 
   VoiceHandler::VoiceHandler(int num_outputs, int polyphony, bool control_rate) :
-      SynthModule(kNumInputs, num_outputs, control_rate), polyphony_(0), legato_(false),
+      SynthModule(kNumInputs, num_outputs, control_rate), polyphony_(0), legato_(false), repack_voices_(true), repack_passes_(0),
       voice_killer_(nullptr), last_num_voices_(0), last_played_note_(-1.0f),
       sustain_(), sostenuto_(), mod_wheel_values_(), pitch_wheel_values_(), zoned_pitch_wheel_values_(),
       pressure_values_(), slide_values_(), tuning_(nullptr),
@@ -222,6 +240,80 @@ namespace vital {
     voice->processor->process(num_samples);
   }
 
+  bool VoiceHandler::consumeKeyStateChanges() {
+    bool changed = false;
+    for (auto& voice : all_voices_)
+      changed = voice->consumeKeyStateChange() || changed;
+    return changed;
+  }
+
+  // Voices in aggregate voices with dead lanes are moved into the dead lanes of other aggregate voices when that
+  // empties their own aggregate voice, so the same voices take fewer aggregate voices to process.
+  void VoiceHandler::repackVoices() {
+    repack_passes_++;
+    while (true) {
+      AggregateVoice* source = nullptr;
+      int source_live_voices = kParallelVoices;
+      int open_voices = 0;
+      for (auto& aggregate_voice : all_aggregate_voices_) {
+        int live_voices = numLiveVoices(aggregate_voice.get());
+        if (live_voices == 0 || live_voices == kParallelVoices)
+          continue;
+
+        open_voices += kParallelVoices - live_voices;
+        if (live_voices < source_live_voices && !hasNewEvents(aggregate_voice.get())) {
+          source = aggregate_voice.get();
+          source_live_voices = live_voices;
+        }
+      }
+
+      if (source == nullptr || open_voices - (kParallelVoices - source_live_voices) < source_live_voices)
+        return;
+
+      for (Voice* voice : source->voices) {
+        if (voice->key_state() != Voice::kDead)
+          moveVoice(voice, grabRepackVoice(source));
+      }
+    }
+  }
+
+  // Returns a dead voice from the fullest aggregate voice that has one, other than _source_.
+  Voice* VoiceHandler::grabRepackVoice(AggregateVoice* source) {
+    Voice* destination = nullptr;
+    int destination_live_voices = 0;
+    for (auto& aggregate_voice : all_aggregate_voices_) {
+      int live_voices = numLiveVoices(aggregate_voice.get());
+      if (aggregate_voice.get() == source || live_voices <= destination_live_voices || live_voices == kParallelVoices)
+        continue;
+
+      for (Voice* voice : aggregate_voice->voices) {
+        if (voice->key_state() == Voice::kDead) {
+          destination = voice;
+          destination_live_voices = live_voices;
+          break;
+        }
+      }
+    }
+
+    VITAL_ASSERT(destination);
+    return destination;
+  }
+
+  void VoiceHandler::moveVoice(Voice* source, Voice* destination) {
+    VITAL_ASSERT(free_voices_.count(destination));
+    VoiceLaneCopy copy(source->voice_index(), destination->voice_index());
+    destination->parent()->processor->copyVoiceState(source->parent()->processor.get(), copy);
+    destination->takeOver(source);
+
+    for (Voice*& voice : active_voices_) {
+      if (voice == source)
+        voice = destination;
+    }
+
+    free_voices_.remove(destination);
+    free_voices_.push_back(source);
+  }
+
   void VoiceHandler::clearAccumulatedOutputs() {
     for (auto& output : accumulated_outputs_)
       utils::zeroBuffer(output.second->buffer, output.second->buffer_size);
@@ -249,7 +341,7 @@ namespace vital {
       poly_float* dest = output.second->buffer;
 
       for (int i = 0; i < buffer_size; ++i)
-        dest[i] += utils::swapVoices(dest[i]);
+        dest[i] = utils::sumVoices(dest[i]);
     }
   }
 
@@ -263,7 +355,7 @@ namespace vital {
 
       for (int i = 0; i < buffer_size; ++i) {
         poly_float masked = source[i] & voice_mask;
-        dest[i] = masked + utils::swapVoices(masked);
+        dest[i] = utils::sumVoices(masked);
       }
     }
   }
@@ -293,16 +385,19 @@ namespace vital {
     int voice_override = utils::roundToInt(input(kVoiceOverride)->at(0))[0];
     voice_override_ = static_cast<VoiceOverride>(voice_override);
 
+    if (repack_voices_ && consumeKeyStateChanges())
+      repackVoices();
+
     clearAccumulatedOutputs();
 
     active_aggregate_voices_.clear();
     AggregateVoice* last_aggregate_voice = nullptr;
-    int last_aggregate_index = 0;
+    poly_mask last_voice_mask = 0;
     for (Voice* active_voice : active_voices_) {
       if (active_aggregate_voices_.count(active_voice->parent()) == 0)
         active_aggregate_voices_.push_back(active_voice->parent());
       last_aggregate_voice = active_voice->parent();
-      last_aggregate_index = active_voice->voice_index();
+      last_voice_mask = active_voice->voice_mask();
     }
 
     if (last_aggregate_voice) {
@@ -335,14 +430,8 @@ namespace vital {
     combineAccumulatedOutputs(num_samples);
 
     if (active_voices_.size()) {
-      poly_mask voice_mask = constants::kFirstMask;
-      if (last_aggregate_index)
-        voice_mask = ~voice_mask;
-
-      writeNonaccumulatedOutputs(voice_mask, num_samples);
-
-      last_played_note_ = voice_midi_->trigger_value & voice_mask;
-      last_played_note_ += utils::swapVoices(last_played_note_);
+      writeNonaccumulatedOutputs(last_voice_mask, num_samples);
+      last_played_note_ = utils::sumVoices(voice_midi_->trigger_value & last_voice_mask);
     }
 
     last_num_voices_ = num_voices;
@@ -495,11 +584,8 @@ namespace vital {
   }
 
   poly_mask VoiceHandler::getCurrentVoiceMask() {
-    if (active_voices_.size()) {
-      if (active_voices_.back()->voice_index())
-        return ~constants::kFirstMask;
-      return constants::kFirstMask;
-    }
+    if (active_voices_.size())
+      return active_voices_.back()->voice_mask();
 
     return 0;
   }
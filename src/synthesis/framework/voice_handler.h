@@ -103,11 +103,20 @@ namespace vital {
       force_inline void setKeyState(KeyState key_state) {
         last_key_state_ = key_state_;
         key_state_ = key_state;
+        key_state_changed_ = true;
       }
 
       force_inline void sustain() {
         last_key_state_ = key_state_;
         key_state_ = kSustained;
+        key_state_changed_ = true;
+      }
+
+      // Returns whether the key state changed since the last call.
+      force_inline bool consumeKeyStateChange() {
+        bool changed = key_state_changed_;
+        key_state_changed_ = false;
+        return changed;
       }
 
       force_inline bool sustained() {
@@ -221,6 +230,22 @@ namespace vital {
         voice_mask_ = voice_mask;
       }
 
+      // Takes over the note another voice is playing when voices are repacked, leaving the other voice dead.
+      force_inline void takeOver(Voice* other) {
+        event_sample_ = other->event_sample_;
+        state_ = other->state_;
+        last_key_state_ = other->last_key_state_;
+        key_state_ = other->key_state_;
+        key_state_changed_ = true;
+        aftertouch_sample_ = other->aftertouch_sample_;
+        aftertouch_ = other->aftertouch_;
+        slide_sample_ = other->slide_sample_;
+        slide_ = other->slide_;
+
+        other->clearEvents();
+        other->markDead();
+      }
+
     private:
       int voice_index_;
       poly_mask voice_mask_;
@@ -229,6 +254,7 @@ namespace vital {
       VoiceState state_;
       KeyState last_key_state_;
       KeyState key_state_;
+      bool key_state_changed_;
 
       int aftertouch_sample_;
       mono_float aftertouch_;
@@ -286,6 +312,9 @@ namespace vital {
       void setTuning(const Tuning* tuning) { tuning_ = tuning; }
 
       int getNumActiveVoices();
+      int getNumActiveAggregateVoices() const { return active_aggregate_voices_.size(); }
+      // Voices are only checked for repacking in blocks after a voice changed key state.
+      int64_t getRepackPasses() const { return repack_passes_; }
       force_inline int getNumPressedNotes() { return pressed_notes_.size(); }
       bool isNotePlaying(int note);
       bool isNotePlaying(int note, int channel);
@@ -400,6 +429,10 @@ namespace vital {
         return legato_;
       }
 
+      force_inline void setVoiceRepacking(bool repack_voices) {
+        repack_voices_ = repack_voices;
+      }
+
       bool isPolyphonic(const Processor* processor) const override;
 
       virtual void setOversampleAmount(int oversample) override {
@@ -423,6 +456,10 @@ namespace vital {
       int grabNextUnplayedPressedNote();
       void sortVoicePriority();
       void addParallelVoices();
+      bool consumeKeyStateChanges();
+      void repackVoices();
+      Voice* grabRepackVoice(AggregateVoice* source);
+      void moveVoice(Voice* source, Voice* destination);
       void prepareVoiceTriggers(AggregateVoice* aggregate_voice, int num_samples);
       void prepareVoiceValues(AggregateVoice* aggregate_voice);
       void processVoice(AggregateVoice* aggregate_voice, int num_samples);
@@ -434,6 +471,8 @@ namespace vital {
 
       int polyphony_;
       bool legato_;
+      bool repack_voices_;
+      int64_t repack_passes_;
       std::map<Output*, std::unique_ptr<Output>> last_voice_outputs_;
       CircularQueue<std::pair<Output*, Output*>> nonaccumulated_outputs_;
       std::map<Output*, std::unique_ptr<Output>> accumulated_outputs_;
@@ -0,0 +1,154 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "worker_pool.h"
+
+#include "utils.h"
+
+namespace vital {
+
+  namespace {
+    constexpr int kSpinsBeforeSleep = 4096;
+
+    force_inline void pause() {
+    #if VITAL_AVX2 || VITAL_SSE2
+      _mm_pause();
+    #else
+      std::this_thread::yield();
+    #endif
+    }
+
+    // Helpers take on the caller's rounding and denormal flags so results match a serial render.
+    force_inline unsigned int getFloatState() {
+    #if VITAL_AVX2 || VITAL_SSE2
+      return _mm_getcsr();
+    #else
+      return 0;
+    #endif
+    }
+
+    force_inline void setFloatState(unsigned int state) {
+    #if VITAL_AVX2 || VITAL_SSE2
+      if (_mm_getcsr() != state)
+        _mm_setcsr(state);
+    #endif
+    }
+  } // namespace
+
+  WorkerPool::WorkerPool() : ticket_(kIndexMask), function_(nullptr), context_(nullptr), num_tasks_(0),
+                             remaining_tasks_(0), float_state_(0), sleeping_threads_(0), running_(false) { }
+
+  WorkerPool::~WorkerPool() {
+    setNumThreads(0);
+  }
+
+  void WorkerPool::setNumThreads(int num_threads) {
+    num_threads = utils::iclamp(num_threads, 0, kMaxThreads);
+    if (num_threads == numThreads())
+      return;
+
+    if (!threads_.empty()) {
+      running_ = false;
+      {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_.notify_all();
+      }
+      for (std::thread& thread : threads_)
+        thread.join();
+      threads_.clear();
+    }
+
+    running_ = true;
+    threads_.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i)
+      threads_.emplace_back(&WorkerPool::workerLoop, this, i + 1);
+  }
+
+  void WorkerPool::run(TaskFunction function, void* context, int num_tasks) {
+    if (threads_.empty() || num_tasks < 2) {
+      for (int i = 0; i < num_tasks; ++i)
+        function(context, i, 0);
+      return;
+    }
+
+    // Invalidate the ticket before touching the task so a late helper can't pair an old
+    // ticket with the new function.
+    uint64_t generation = (ticket_.load() >> 32) + 1;
+    ticket_ = (generation << 32) | kIndexMask;
+    function_ = function;
+    context_ = context;
+    num_tasks_ = num_tasks;
+    remaining_tasks_ = num_tasks;
+    float_state_ = getFloatState();
+    ticket_ = generation << 32;
+
+    // A helper counts itself as sleeping under the lock before it checks for work, so taking the
+    // lock here means it's either waiting and gets the notify or it will see the new ticket.
+    if (sleeping_threads_.load()) {
+      std::lock_guard<std::mutex> lock(wake_mutex_);
+      wake_.notify_all();
+    }
+
+    while (runTask(0))
+      ;
+
+    while (remaining_tasks_.load(std::memory_order_acquire))
+      pause();
+  }
+
+  bool WorkerPool::hasTask() const {
+    return (ticket_.load() & kIndexMask) < static_cast<uint64_t>(num_tasks_.load());
+  }
+
+  bool WorkerPool::runTask(int worker) {
+    uint64_t ticket = ticket_.load();
+    TaskFunction function = function_.load();
+    void* context = context_.load();
+    uint64_t index = ticket & kIndexMask;
+    if (index >= static_cast<uint64_t>(num_tasks_.load()))
+      return false;
+
+    if (!ticket_.compare_exchange_strong(ticket, ticket + 1))
+      return true;
+
+    function(context, static_cast<int>(index), worker);
+    remaining_tasks_.fetch_sub(1, std::memory_order_release);
+    return true;
+  }
+
+  void WorkerPool::workerLoop(int worker) {
+    int spins = 0;
+    while (running_) {
+      if (hasTask()) {
+        setFloatState(float_state_.load());
+        while (runTask(worker))
+          ;
+        spins = 0;
+      }
+      else if (spins < kSpinsBeforeSleep) {
+        spins++;
+        pause();
+      }
+      else {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        sleeping_threads_++;
+        wake_.wait(lock, [this] { return !running_ || hasTask(); });
+        sleeping_threads_--;
+        spins = 0;
+      }
+    }
+  }
+} // namespace vital
@@ -0,0 +1,76 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vital {
+
+  // Helper threads for splitting independent offline work, like rendering wavetable frames.
+  // The calling thread claims tasks alongside the helpers and spins until the last task finishes,
+  // so it is not meant for the audio thread. Keep a pool around between runs: idle helpers sleep
+  // until the next run() wakes them.
+  class WorkerPool {
+    public:
+      static constexpr int kMaxThreads = 16;
+
+      // worker is 0 for the calling thread and 1 to numThreads() for the helpers, so tasks can
+      // use scratch space per worker instead of allocating.
+      typedef void (*TaskFunction)(void* context, int task, int worker);
+
+      WorkerPool();
+      ~WorkerPool();
+
+      // Starts and joins threads so it must not be called from the audio thread or during run().
+      void setNumThreads(int num_threads);
+      force_inline int numThreads() const { return static_cast<int>(threads_.size()); }
+      force_inline int numWorkers() const { return numThreads() + 1; }
+
+      // Calls function(context, task, worker) for each task in [0, num_tasks) and returns when all
+      // are done.
+      void run(TaskFunction function, void* context, int num_tasks);
+
+    private:
+      static constexpr uint64_t kIndexMask = 0xffffffff;
+
+      bool hasTask() const;
+      bool runTask(int worker);
+      void workerLoop(int worker);
+
+      std::atomic<uint64_t> ticket_;
+      std::atomic<TaskFunction> function_;
+      std::atomic<void*> context_;
+      std::atomic<int> num_tasks_;
+      std::atomic<int> remaining_tasks_;
+      std::atomic<unsigned int> float_state_;
+      std::atomic<int> sleeping_threads_;
+      std::atomic<bool> running_;
+
+      std::mutex wake_mutex_;
+      std::condition_variable wake_;
+      std::vector<std::thread> threads_;
+
+      JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WorkerPool)
+  };
+} // namespace vital
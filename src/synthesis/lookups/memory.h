@@ -86,10 +86,27 @@ namespace vital {
           memset(buffers_[c], 0, 2 * size_ * sizeof(mono_float));
       }
 
+      // Copies one channel's history from another memory, lined up with this memory's write position.
+      void copyChannel(const MemoryTemplate& source, int source_channel, int destination_channel) {
+        if (source.size_ != size_)
+          return;
+
+        mono_float* destination = buffers_[destination_channel];
+        const mono_float* from = source.buffers_[source_channel];
+        for (unsigned int i = 0; i < size_; ++i)
+          destination[(offset_ + i) & bitmask_] = from[(source.offset_ + i) & bitmask_];
+        memcpy(destination + size_, destination, size_ * sizeof(mono_float));
+      }
+
       void readSamples(mono_float* output, int num_samples, int offset, int channel) const {
+        readSamples(output, num_samples, offset, channel, offset_);
+      }
+
+      // Reads relative to a write position captured earlier so a reader on another thread stays behind the writer.
+      void readSamples(mono_float* output, int num_samples, int offset, int channel, unsigned int head) const {
         mono_float* buffer = buffers_[channel];
         int bitmask = bitmask_;
-        int start_index = (offset_ - num_samples - offset) & bitmask;
+        int start_index = (head - num_samples - offset) & bitmask;
         for (int i = 0; i < num_samples; ++i)
           output[i] = buffer[(i + start_index) & bitmask];
       }
@@ -21,11 +21,17 @@
 
 namespace vital {
 
+  namespace {
+    // Versions are unique across every table in the process so a shared table's version never
+    // matches one an oscillator saw with a different number of frames.
+    std::atomic<int> next_table_version(1);
+  } // namespace
+
   const mono_float Wavetable::kZeroWaveform[kWaveformSize + kExtraValues] = { };
 
   Wavetable::Wavetable(int max_frames) :
       max_frames_(max_frames), current_data_(nullptr), 
-      active_audio_data_(nullptr), shepard_table_(false), fft_data_() {
+      active_audio_data_(nullptr), edit_count_(0), shepard_table_(false), fft_data_() {
     loadDefaultWavetable();
   }
 
@@ -41,19 +47,12 @@ namespace vital {
     if (data_ && num_frames == data_->num_frames)
       return;
 
-    int old_version = 0;
     int old_num_frames = 0;
-    if (data_) {
-      old_version = data_->version;
+    if (data_)
       old_num_frames = data_->num_frames;
-    }
 
-    std::unique_ptr<WavetableData> old_data = std::move(data_);
-    data_ = std::make_unique<WavetableData>(num_frames, old_version + 1);
-    data_->wave_data = std::make_unique<mono_float[][kWaveformSize]>(num_frames);
-    data_->frequency_amplitudes = std::make_unique<poly_float[][kPolyFrequencySize]>(num_frames);
-    data_->normalized_frequencies = std::make_unique<poly_float[][kPolyFrequencySize]>(num_frames);
-    data_->phases = std::make_unique<poly_float[][kPolyFrequencySize]>(num_frames);
+    std::shared_ptr<WavetableData> old_data = std::move(data_);
+    data_ = createData(num_frames, next_table_version++);
 
     int frame_size = kWaveformSize * sizeof(mono_float);
     int frequency_size = kPolyFrequencySize * sizeof(poly_float);
@@ -83,15 +82,18 @@ namespace vital {
     }
 
     current_data_ = data_.get();
+    edit_count_++;
     while (active_audio_data_.load())
       std::this_thread::yield(); // Wait for audio thread to finish using old_data.
   }
 
   void Wavetable::setFrequencyRatio(float frequency_ratio) {
+    ensureUniqueData();
     current_data_->frequency_ratio = frequency_ratio;
   }
 
   void Wavetable::setSampleRate(float rate) {
+    ensureUniqueData();
     current_data_->sample_rate = rate;
   }
 
@@ -103,22 +105,111 @@ namespace vital {
     if (to_index >= current_data_->num_frames)
       return;
 
-    loadFrequencyAmplitudes(wave_frame->frequency_domain, to_index);
-    loadNormalizedFrequencies(wave_frame->frequency_domain, to_index);
-    memcpy(current_data_->wave_data[to_index], wave_frame->time_domain, kWaveformSize * sizeof(mono_float));
+    ensureUniqueData();
+    loadWaveFrame(current_data_, wave_frame, to_index);
+    edit_count_++;
   }
 
   void Wavetable::postProcess(float max_span) {
+    ensureUniqueData();
+    postProcess(current_data_, max_span);
+    edit_count_++;
+  }
+
+  bool Wavetable::setStagingFrames(int num_frames) {
+    VITAL_ASSERT(num_frames <= max_frames_);
+    if (staging_data_ && num_frames == staging_data_->num_frames)
+      return false;
+
+    staging_data_ = createData(num_frames, 0);
+    return true;
+  }
+
+  void Wavetable::loadStagingFrame(const WaveFrame* wave_frame, int to_index) {
+    if (to_index >= staging_data_->num_frames)
+      return;
+
+    loadWaveFrame(staging_data_.get(), wave_frame, to_index);
+  }
+
+  void Wavetable::publishStaging(float max_span) {
+    // The table replaced by the last publish may be in use until the audio thread finishes its block.
+    while (spare_data_ && active_audio_data_.load() == spare_data_.get())
+      std::this_thread::yield();
+
+    int num_frames = staging_data_->num_frames;
+    std::shared_ptr<WavetableData> data = std::move(spare_data_);
+    if (data == nullptr || data.use_count() > 1 || data->num_frames != num_frames)
+      data = createData(num_frames, 0);
+
+    copyData(data.get(), staging_data_.get());
+    data->version = data_->num_frames == num_frames ? data_->version : next_table_version++;
+    postProcess(data.get(), max_span);
+    swapInData(std::move(data));
+    edit_count_++;
+  }
+
+  void Wavetable::loadSharedData(std::shared_ptr<const WavetableData> data) {
+    VITAL_ASSERT(data->num_frames <= max_frames_);
+    swapInData(std::const_pointer_cast<WavetableData>(data));
+    edit_count_++;
+  }
+
+  void Wavetable::ensureUniqueData() {
+    if (data_.use_count() <= 1)
+      return;
+
+    std::shared_ptr<WavetableData> data = createData(data_->num_frames, data_->version);
+    copyData(data.get(), data_.get());
+    swapInData(std::move(data));
+  }
+
+  void Wavetable::swapInData(std::shared_ptr<WavetableData> data) {
+    while (spare_data_ && active_audio_data_.load() == spare_data_.get())
+      std::this_thread::yield();
+
+    spare_data_ = std::move(data_);
+    data_ = std::move(data);
+    current_data_ = data_.get();
+  }
+
+  std::unique_ptr<Wavetable::WavetableData> Wavetable::createData(int num_frames, int version) {
+    std::unique_ptr<WavetableData> data = std::make_unique<WavetableData>(num_frames, version);
+    data->wave_data = std::make_unique<mono_float[][kWaveformSize]>(num_frames);
+    data->frequency_amplitudes = std::make_unique<poly_float[][kPolyFrequencySize]>(num_frames);
+    data->normalized_frequencies = std::make_unique<poly_float[][kPolyFrequencySize]>(num_frames);
+    data->phases = std::make_unique<poly_float[][kPolyFrequencySize]>(num_frames);
+    return data;
+  }
+
+  void Wavetable::copyData(WavetableData* destination, const WavetableData* source) {
+    int num_frames = source->num_frames;
+    int frequency_size = num_frames * kPolyFrequencySize * sizeof(poly_float);
+    memcpy(destination->wave_data.get(), source->wave_data.get(), num_frames * kWaveformSize * sizeof(mono_float));
+    memcpy(destination->frequency_amplitudes.get(), source->frequency_amplitudes.get(), frequency_size);
+    memcpy(destination->normalized_frequencies.get(), source->normalized_frequencies.get(), frequency_size);
+    memcpy(destination->phases.get(), source->phases.get(), frequency_size);
+    destination->frequency_ratio = source->frequency_ratio;
+    destination->sample_rate = source->sample_rate;
+  }
+
+  void Wavetable::loadWaveFrame(WavetableData* data, const WaveFrame* wave_frame, int to_index) {
+    loadFrequencyAmplitudes(data, wave_frame->frequency_domain, to_index);
+    loadNormalizedFrequencies(data, wave_frame->frequency_domain, to_index);
+    memcpy(data->wave_data[to_index], wave_frame->time_domain, kWaveformSize * sizeof(mono_float));
+  }
+
+  void Wavetable::postProcess(WavetableData* data, float max_span) {
     static constexpr float kMinAmplitudePhase = 0.1f;
 
     if (max_span > 0.0f) {
       float scale = 2.0f / max_span;
-      for (int w = 0; w < current_data_->num_frames; ++w) {
-        poly_float* frequency_amplitudes = current_data_->frequency_amplitudes[w];
+      for (int w = 0; w < data->num_frames; ++w) {
+        poly_float* frequency_amplitudes = data->frequency_amplitudes[w];
         for (int i = 0; i < kPolyFrequencySize; ++i)
           frequency_amplitudes[i] *= scale;
 
-        mono_float* wave_data = current_data_->wave_data[w];
+        mono_float* wave_data = data->wave_data[w];
         for (int i = 0; i < kWaveformSize; ++i)
           wave_data[i] *= scale;
       }
@@ -131,9 +222,9 @@ namespace vital {
 
       int last_min_amp_frame = -1;
       std::complex<float> last_normalized_frequency = std::complex<float>(0.0f, 1.0f);
-      for (int w = 0; w < current_data_->num_frames; ++w) {
-        mono_float amplitude = ((mono_float*)current_data_->frequency_amplitudes[w])[amp_index];
-        std::complex<float> normalized_frequency = ((std::complex<float>*)current_data_->normalized_frequencies[w])[i];
+      for (int w = 0; w < data->num_frames; ++w) {
+        mono_float amplitude = ((mono_float*)data->frequency_amplitudes[w])[amp_index];
+        std::complex<float> normalized_frequency = ((std::complex<float>*)data->normalized_frequencies[w])[i];
 
         if (amplitude > kMinAmplitudePhase) {
           if (last_min_amp_frame < 0) {
@@ -146,19 +237,20 @@ namespace vital {
           for (int frame = last_min_amp_frame + 1; frame < w; ++frame) {
             float t = (frame - last_min_amp_frame) * 1.0f / (w - last_min_amp_frame);
             std::complex<float> normalized = delta_normalized_frequency * t + last_normalized_frequency;
-            ((std::complex<float>*)current_data_->normalized_frequencies[frame])[i] = normalized;
+            ((std::complex<float>*)data->normalized_frequencies[frame])[i] = normalized;
           }
           last_normalized_frequency = normalized_frequency;
           last_min_amp_frame = w;
         }
       }
-      for (int frame = last_min_amp_frame + 1; frame < current_data_->num_frames; ++frame)
-        ((std::complex<float>*)current_data_->normalized_frequencies[frame])[i] = last_normalized_frequency;
+      for (int frame = last_min_amp_frame + 1; frame < data->num_frames; ++frame)
+        ((std::complex<float>*)data->normalized_frequencies[frame])[i] = last_normalized_frequency;
     }
   }
 
-  void Wavetable::loadFrequencyAmplitudes(const std::complex<float>* frequencies, int to_index) {
-    mono_float* amplitudes = (mono_float*)current_data_->frequency_amplitudes[to_index];
+  void Wavetable::loadFrequencyAmplitudes(WavetableData* data, const std::complex<float>* frequencies,
+                                          int to_index) {
+    mono_float* amplitudes = (mono_float*)data->frequency_amplitudes[to_index];
     for (int i = 0; i < kNumHarmonics; ++i) {
       float amplitude = std::abs(frequencies[i]);
       amplitudes[2 * i] = amplitude;
@@ -166,9 +258,10 @@ namespace vital {
     }
   }
 
-  void Wavetable::loadNormalizedFrequencies(const std::complex<float>* frequencies, int to_index) {
-    std::complex<float>* normalized = (std::complex<float>*)current_data_->normalized_frequencies[to_index];
-    mono_float* phases = (mono_float*)current_data_->phases[to_index];
+  void Wavetable::loadNormalizedFrequencies(WavetableData* data, const std::complex<float>* frequencies,
+                                            int to_index) {
+    std::complex<float>* normalized = (std::complex<float>*)data->normalized_frequencies[to_index];
+    mono_float* phases = (mono_float*)data->phases[to_index];
     for (int i = 0; i < kNumHarmonics; ++i) {
       mono_float arg = std::arg(frequencies[i]);
       normalized[i] = std::polar(1.0f, arg);
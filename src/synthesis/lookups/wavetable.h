@@ -93,6 +93,11 @@ namespace vital {
         return current_data_->version;
       }
 
+      // Changes whenever frame contents change so display caches know when to rebuild.
+      force_inline int getEditCount() const {
+        return edit_count_.load();
+      }
+
       force_inline int clampActiveFrame(int frame) {
         return std::min(frame, active_audio_data_.load()->num_frames - 1);
       }
@@ -125,6 +130,24 @@ namespace vital {
       void loadWaveFrame(const WaveFrame* wave_frame, int to_index);
       void postProcess(float max_span);
 
+      // Full renders go through a staging table that keeps unprocessed frames between renders so
+      // only changed frames have to be loaded again. Staged frames can be loaded from several
+      // threads at once as long as each thread loads its own indices.
+      bool setStagingFrames(int num_frames);
+      void loadStagingFrame(const WaveFrame* wave_frame, int to_index);
+      void setStagingFrequencyRatio(float frequency_ratio) { staging_data_->frequency_ratio = frequency_ratio; }
+      void setStagingSampleRate(float rate) { staging_data_->sample_rate = rate; }
+
+      // Post processes a copy of the staging table and swaps it in with a single pointer change so
+      // the audio thread never reads a partially rendered table.
+      void publishStaging(float max_span);
+      void clearStaging() { staging_data_ = nullptr; }
+
+      // Shared tables are never written again. Loading one swaps it in like a publish and any later
+      // edit works on a private copy.
+      std::shared_ptr<const WavetableData> shareData() const { return data_; }
+      void loadSharedData(std::shared_ptr<const WavetableData> data);
+
       force_inline int numFrames() const { return current_data_->num_frames; }
       force_inline int numActiveFrames() const { return active_audio_data_.load()->num_frames; }
 
@@ -137,8 +160,16 @@ namespace vital {
     protected:
       Wavetable() = default;
     
-      void loadFrequencyAmplitudes(const std::complex<float>* frequencies, int to_index);
-      void loadNormalizedFrequencies(const std::complex<float>* frequencies, int to_index);
+      static std::unique_ptr<WavetableData> createData(int num_frames, int version);
+      static void copyData(WavetableData* destination, const WavetableData* source);
+      static void loadWaveFrame(WavetableData* data, const WaveFrame* wave_frame, int to_index);
+      static void postProcess(WavetableData* data, float max_span);
+      static void loadFrequencyAmplitudes(WavetableData* data, const std::complex<float>* frequencies, int to_index);
+      static void loadNormalizedFrequencies(WavetableData* data, const std::complex<float>* frequencies,
+                                            int to_index);
+
+      void ensureUniqueData();
+      void swapInData(std::shared_ptr<WavetableData> data);
 
       static const mono_float kZeroWaveform[kWaveformSize + kExtraValues];
 
@@ -147,7 +178,10 @@ namespace vital {
       int max_frames_;
       WavetableData* current_data_;
       std::atomic<WavetableData*> active_audio_data_;
-      std::unique_ptr<WavetableData> data_;
+      std::atomic<int> edit_count_;
+      std::shared_ptr<WavetableData> data_;
+      std::shared_ptr<WavetableData> spare_data_;
+      std::unique_ptr<WavetableData> staging_data_;
       bool shepard_table_;
 
       mono_float fft_data_[2 * kWaveformSize];
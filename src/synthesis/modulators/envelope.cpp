@@ -31,6 +31,19 @@ namespace vital {
       processAudioRate(num_samples);
   }
 
+  void Envelope::copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) {
+    const Envelope* source_envelope = static_cast<const Envelope*>(source);
+    copy(current_value_, source_envelope->current_value_);
+    copy(position_, source_envelope->position_);
+    copy(value_, source_envelope->value_);
+    copy(poly_state_, source_envelope->poly_state_);
+    copy(start_value_, source_envelope->start_value_);
+    copy(attack_power_, source_envelope->attack_power_);
+    copy(decay_power_, source_envelope->decay_power_);
+    copy(release_power_, source_envelope->release_power_);
+    copy(sustain_, source_envelope->sustain_);
+  }
+
   void Envelope::processControlRate(int num_samples) {
     poly_mask trigger_mask = input(kTrigger)->source->trigger_mask;
     poly_float trigger_value = input(kTrigger)->source->trigger_value;
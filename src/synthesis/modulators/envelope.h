@@ -48,6 +48,7 @@ namespace vital {
 
       virtual Processor* clone() const override { return new Envelope(*this); }
       virtual void process(int num_samples) override;
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override;
 
     private:
       void processControlRate(int num_samples);
@@ -38,6 +38,10 @@ namespace vital {
       void process(int num_samples) override;
       void process(poly_float phase);
 
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override {
+        copy(offset_, static_cast<const LineMap*>(source)->offset_);
+      }
+
     protected:
       poly_float offset_;
       LineGenerator* source_;
@@ -113,13 +113,11 @@ namespace vital {
 
         poly_float* dest = output()->buffer;
         int update_samples = isControlRate() ? 1 : num_samples;
-        for (int i = 0; i < update_samples; ++i) {
-          poly_float value = dest[i] & constants::kFirstMask;
-          dest[i] = value + utils::swapVoices(value);
-        }
+        for (int i = 0; i < update_samples; ++i)
+          dest[i] = poly_float(dest[i][0], dest[i][1]);
 
-        poly_float trigger_value = output()->trigger_value & constants::kFirstMask;
-        output()->trigger_value = trigger_value + utils::swapVoices(trigger_value);
+        poly_float trigger_value = output()->trigger_value;
+        output()->trigger_value = poly_float(trigger_value[0], trigger_value[1]);
         *last_sync_ = *sync_seconds_;
       }
     }
@@ -127,6 +125,17 @@ namespace vital {
       process(&state_, num_samples);
   }
 
+  void RandomLfo::copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) {
+    const RandomLfo* source_lfo = static_cast<const RandomLfo*>(source);
+    copy(state_.offset, source_lfo->state_.offset);
+    copy(state_.last_random_value, source_lfo->state_.last_random_value);
+    copy(state_.next_random_value, source_lfo->state_.next_random_value);
+    copy(state_.state1, source_lfo->state_.state1);
+    copy(state_.state2, source_lfo->state_.state2);
+    copy(state_.state3, source_lfo->state_.state3);
+    copy(last_value_, source_lfo->last_value_);
+  }
+
   void RandomLfo::process(RandomState* state, int num_samples) {
     int random_type_int = std::round(utils::clamp(input(kStyle)->at(0)[0], 0.0f, kNumStyles - 1.0f));
     RandomType random_type = static_cast<RandomType>(random_type_int);
@@ -68,6 +68,7 @@ namespace vital {
       void processSampleAndHold(RandomState* state, int num_samples);
       void processLorenzAttractor(RandomState* state, int num_samples);
       void correctToTime(double seconds);
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override;
 
     protected:
       void doReset(RandomState* state, bool mono, poly_float frequency);
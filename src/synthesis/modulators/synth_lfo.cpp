@@ -442,6 +442,24 @@ namespace vital {
     processControlRate(num_samples);
   }
 
+  void SynthLfo::copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) {
+    const SynthLfo* source_lfo = static_cast<const SynthLfo*>(source);
+    const LfoState* source_states[] = { &source_lfo->control_rate_state_, &source_lfo->audio_rate_state_ };
+    LfoState* states[] = { &control_rate_state_, &audio_rate_state_ };
+    for (int i = 0; i < 2; ++i) {
+      copy(states[i]->delay_time_passed, source_states[i]->delay_time_passed);
+      copy(states[i]->fade_amplitude, source_states[i]->fade_amplitude);
+      copy(states[i]->smooth_value, source_states[i]->smooth_value);
+      copy(states[i]->fade_amount, source_states[i]->fade_amount);
+      copy(states[i]->offset, source_states[i]->offset);
+      copy(states[i]->phase, source_states[i]->phase);
+    }
+
+    copy(held_mask_, source_lfo->held_mask_);
+    copy(trigger_sample_, source_lfo->trigger_sample_);
+    copy(trigger_delay_, source_lfo->trigger_delay_);
+  }
+
   void SynthLfo::correctToTime(double seconds) {
     *sync_seconds_ = seconds;
   }
@@ -107,6 +107,7 @@ namespace vital {
 
       void process(int num_samples) override;
       void correctToTime(double seconds);
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override;
 
     protected:
       void processTrigger();
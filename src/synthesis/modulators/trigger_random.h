@@ -34,6 +34,10 @@ namespace vital {
       virtual Processor* clone() const override { return new TriggerRandom(*this); }
       virtual void process(int num_samples) override;
 
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override {
+        copy(value_, static_cast<const TriggerRandom*>(source)->value_);
+      }
+
     private:
       poly_float value_;
       utils::RandomGenerator random_generator_;
@@ -34,6 +34,7 @@ namespace vital {
 
       void processWithInput(const poly_float* audio_in, int num_samples) override;
       void correctToTime(double seconds) override;
+      int getTailSamples() const override { return (kMaxChorusDelay + kMaxChorusModulation) * getSampleRate(); }
       Processor* clone() const override { VITAL_ASSERT(false); return nullptr; }
 
       int getNextNumVoicePairs();
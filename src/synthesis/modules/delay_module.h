@@ -41,6 +41,7 @@ namespace vital {
       virtual void setSampleRate(int sample_rate) override;
       virtual void setOversampleAmount(int oversample) override;
       virtual void processWithInput(const poly_float* audio_in, int num_samples) override;
+      virtual int getTailSamples() const override { return kMaxDelayTime * getSampleRate(); }
       virtual Processor* clone() const override { return new DelayModule(*this); }
     
     protected:
@@ -16,13 +16,16 @@
 
 #include "distortion_module.h"
 
+#include "decimator.h"
 #include "distortion.h"
 #include "digital_svf.h"
+#include "iir_halfband_upsampler.h"
 
 namespace vital {
 
   DistortionModule::DistortionModule() :
-      SynthModule(0, 1), distortion_(nullptr), filter_(nullptr), mix_(0.0f) { }
+      SynthModule(0, 1), distortion_(nullptr), filter_(nullptr), mix_(0.0f),
+      local_oversample_(1), upsampler_(nullptr), decimator_(nullptr) { }
 
   DistortionModule::~DistortionModule() {
   }
@@ -53,6 +56,15 @@ namespace vital {
     filter_->setBasic(true);
     addIdleProcessor(filter_);
 
+    upsampler_ = new IirHalfbandUpsampler();
+    addIdleProcessor(upsampler_);
+
+    decimator_ = new Decimator(3);
+    decimator_->plug(output());
+    decimator_->useOutput(output());
+    decimator_->init();
+    addIdleProcessor(decimator_);
+
     SynthModule::init();
   }
 
@@ -60,9 +72,25 @@ namespace vital {
     SynthModule::setSampleRate(sample_rate);
     distortion_->setSampleRate(sample_rate);
     filter_->setSampleRate(sample_rate);
+    decimator_->setSampleRate(sample_rate);
   }
 
-  void DistortionModule::processWithInput(const poly_float* audio_in, int num_samples) {
+  void DistortionModule::setOversampleAmount(int oversample) {
+    SynthModule::setOversampleAmount(oversample * local_oversample_);
+    if (upsampler_)
+      upsampler_->setOversampleAmount(local_oversample_);
+  }
+
+  void DistortionModule::setLocalOversampleAmount(int local_oversample) {
+    int chain_oversample = getOversampleAmount() / local_oversample_;
+    VITAL_ASSERT(local_oversample == 1 || chain_oversample == 1);
+    local_oversample_ = local_oversample;
+    setOversampleAmount(chain_oversample);
+    upsampler_->reset(constants::kFullMask);
+    decimator_->reset(constants::kFullMask);
+  }
+
+  void DistortionModule::processDistortion(const poly_float* audio_in, int num_samples) {
     SynthModule::process(num_samples);
 
     if (filter_order_->output()->buffer[0][0] < 1.0f)
@@ -75,7 +103,18 @@ namespace vital {
       filter_->processWithInput(audio_in, num_samples);
       distortion_->processWithInput(output()->buffer, num_samples);
     }
-    
+  }
+
+  void DistortionModule::processWithInput(const poly_float* audio_in, int num_samples) {
+    if (local_oversample_ > 1) {
+      // The decimator filters the output buffer in place down to the chain's rate.
+      upsampler_->processWithInput(audio_in, num_samples);
+      processDistortion(upsampler_->output()->buffer, num_samples * local_oversample_);
+      decimator_->process(num_samples);
+    }
+    else
+      processDistortion(audio_in, num_samples);
+
     poly_float current_mix = mix_;
     mix_ = utils::clamp(distortion_mix_->buffer[0], 0.0f, 1.0f);
     poly_float delta_mix = (mix_ - current_mix) * (1.0f / num_samples);
@@ -21,8 +21,10 @@
 
 namespace vital {
 
+  class Decimator;
   class Distortion;
   class DigitalSvf;
+  class IirHalfbandUpsampler;
 
   class DistortionModule : public SynthModule {
     public:
@@ -31,16 +33,28 @@ namespace vital {
 
       virtual void init() override;
       virtual void setSampleRate(int sample_rate) override;
+      virtual void setOversampleAmount(int oversample) override;
       virtual void processWithInput(const poly_float* audio_in, int num_samples) override;
       virtual Processor* clone() const override { return new DistortionModule(*this); }
 
+      // Runs the distortion and its filter at this multiple of the chain's rate, upsampling the input and
+      // decimating the result back down so the nonlinearity doesn't alias when the chain runs at base rate.
+      void setLocalOversampleAmount(int local_oversample);
+      int getLocalOversampleAmount() const { return local_oversample_; }
+
     protected:
+      void processDistortion(const poly_float* audio_in, int num_samples);
+
       Distortion* distortion_;
       Value* filter_order_;
       DigitalSvf* filter_;
       Output* distortion_mix_;
       poly_float mix_;
 
+      int local_oversample_;
+      IirHalfbandUpsampler* upsampler_;
+      Decimator* decimator_;
+
       JUCE_LEAK_DETECTOR(DistortionModule)
   };
 } // namespace vital
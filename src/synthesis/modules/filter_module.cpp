@@ -47,6 +47,15 @@ namespace vital {
     addSubmodule(comb_filter_);
     addSubmodule(formant_filter_);
 
+    comb_filter_->setProfileName(prefix_ + "_comb");
+    digital_svf_->setProfileName(prefix_ + "_svf");
+    diode_filter_->setProfileName(prefix_ + "_diode");
+    dirty_filter_->setProfileName(prefix_ + "_dirty");
+    formant_filter_->setProfileName(prefix_ + "_formant");
+    ladder_filter_->setProfileName(prefix_ + "_ladder");
+    phaser_filter_->setProfileName(prefix_ + "_phaser");
+    sallen_key_filter_->setProfileName(prefix_ + "_sallen_key");
+
     addProcessor(comb_filter_);
     addProcessor(digital_svf_);
     addProcessor(diode_filter_);
@@ -170,6 +179,11 @@ namespace vital {
     sallen_key_filter_->hardReset();
   }
 
+  void FilterModule::copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) {
+    SynthModule::copyVoiceState(source, copy);
+    copy(mix_, static_cast<const FilterModule*>(source)->mix_);
+  }
+
   Output* FilterModule::createModControl(std::string name, bool audio_rate, bool smooth_value,
                                          Output* internal_modulation) {
     if (mono_)
@@ -218,7 +232,7 @@ namespace vital {
     bool on = on_ == nullptr || on_->value() > 0.5f;
     setModel(static_cast<int>(roundf(filter_model_->value())));
 
-    if (on) {
+    if (on && acquireOutputs()) {
       SynthModule::process(num_samples);
 
       poly_float current_mix = mix_;
@@ -233,8 +247,10 @@ namespace vital {
         audio_out[i] = utils::interpolate(audio_in[i], audio_out[i], current_mix);
       }
     }
-    else
+    else {
+      releaseOutputs();
       utils::zeroBuffer(output()->buffer, num_samples);
+    }
   }
 
   void FilterModule::setMono(bool mono) {
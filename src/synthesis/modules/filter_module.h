@@ -49,6 +49,7 @@ namespace vital {
                                Output* internal_modulation = nullptr);
       void init() override;
       void hardReset() override;
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override;
       virtual Processor* clone() const override {
         FilterModule* newModule = new FilterModule(*this);
         newModule->last_model_ = -1;
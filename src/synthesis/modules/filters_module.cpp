@@ -98,6 +98,11 @@ namespace vital {
     utils::copyBuffer(output()->buffer, filter_1_->output()->buffer, num_samples);
   }
 
+  void FiltersModule::setOutputArena(OutputArena* arena) {
+    filter_1_->setOutputArena(arena);
+    filter_2_->setOutputArena(arena);
+  }
+
   void FiltersModule::process(int num_samples) {
     if (filter_1_filter_input_->value() && filter_1_->getOnValue()->value())
       processSerialBackward(num_samples);
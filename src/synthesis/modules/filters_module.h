@@ -45,6 +45,7 @@ namespace vital {
 
       const Value* getFilter1OnValue() const { return filter_1_->getOnValue(); }
       const Value* getFilter2OnValue() const { return filter_2_->getOnValue(); }
+      void setOutputArena(OutputArena* arena) override;
 
       void setOversampleAmount(int oversample) override {
         SynthModule::setOversampleAmount(oversample);
@@ -23,12 +23,18 @@ namespace vital {
       SynthModule(kNumInputs, kNumOutputs), index_(index), polyphonic_(true), current_value_(nullptr),
       bipolar_(nullptr), stereo_(nullptr) {
     setControlRate(true);
+    setProfileName("modulation_" + std::to_string(index + 1));
 
     modulation_amount_ = 0.0f;
 
     destination_scale_ = std::make_shared<mono_float>();
     *destination_scale_ = 0.0f;
     last_destination_scale_ = 0.0f;
+    fade_ = std::make_shared<mono_float>();
+    *fade_ = 0.0f;
+    fade_ins_ = std::make_shared<int>();
+    *fade_ins_ = 0;
+    last_fade_ins_ = 0;
 
     power_ = 0.0f;
 
@@ -54,9 +60,10 @@ namespace vital {
     poly_float modulation_input = source->trigger_value;
     output(kModulationSource)->buffer[0] = modulation_input;
 
-    if (last_destination_scale_ != *destination_scale_)
+    if (last_destination_scale_ != *destination_scale_ || last_fade_ins_ != *fade_ins_)
       modulation_amount_ = 0.0f;
     last_destination_scale_ = *destination_scale_;
+    last_fade_ins_ = *fade_ins_;
 
     if (isControlRate() || source->isControlRate())
       processControlRate(source);
@@ -95,7 +102,7 @@ namespace vital {
     poly_float current_amount = modulation_amount_;
     poly_float stereo_scale = poly_float(1.0f) - (constants::kRightOne * 2.0f * stereo_->value());
     poly_float modulation_amount = utils::clamp(input(kModulationAmount)->at(0), -1.0f, 1.0f) * stereo_scale;
-    modulation_amount_ = modulation_amount * (*destination_scale_);
+    modulation_amount_ = modulation_amount * (*destination_scale_ * *fade_);
     current_amount = utils::maskLoad(current_amount, modulation_amount_, getResetMask(kReset));
     poly_float delta_amount = (modulation_amount_ - current_amount) * (1.0f / num_samples);
 
@@ -124,7 +131,7 @@ namespace vital {
     poly_float current_power = power_;
 
     poly_float modulation_amount = utils::clamp(input(kModulationAmount)->at(0), -1.0f, 1.0f);
-    modulation_amount_ = modulation_amount * (*destination_scale_);
+    modulation_amount_ = modulation_amount * (*destination_scale_ * *fade_);
 
     poly_mask reset_mask = getResetMask(kReset);
     current_amount = utils::maskLoad(current_amount, modulation_amount_, reset_mask);
@@ -167,7 +174,7 @@ namespace vital {
     poly_float current_power = power_;
 
     poly_float modulation_amount = utils::clamp(input(kModulationAmount)->at(0), -1.0f, 1.0f);
-    modulation_amount_ = modulation_amount * (*destination_scale_);
+    modulation_amount_ = modulation_amount * (*destination_scale_ * *fade_);
 
     poly_mask reset_mask = getResetMask(kReset);
     current_amount = utils::maskLoad(current_amount, modulation_amount_, reset_mask);
@@ -215,7 +222,7 @@ namespace vital {
     poly_float current_amount = modulation_amount_;
     poly_float stereo_scale = poly_float(1.0f) - (constants::kRightOne * 2.0f * stereo_->value());
     poly_float modulation_amount = utils::clamp(input(kModulationAmount)->at(0), -1.0f, 1.0f) * stereo_scale;
-    modulation_amount_ = modulation_amount * (*destination_scale_);
+    modulation_amount_ = modulation_amount * (*destination_scale_ * *fade_);
     current_amount = utils::maskLoad(current_amount, modulation_amount_, getResetMask(kReset));
     poly_float delta_amount = (modulation_amount_ - current_amount) * (1.0f / num_samples);
 
@@ -281,7 +288,7 @@ namespace vital {
     poly_float pre_modulation = modulation_amount * shifted_modulation;
     poly_float raw_modulation = (pre_modulation ^ sign_mask) * polarity_post_scale;
     output(kModulationPreScale)->buffer[0] = raw_modulation;
-    output(kModulationOutput)->buffer[0] = raw_modulation * (*destination_scale_);
+    output(kModulationOutput)->buffer[0] = raw_modulation * (*destination_scale_ * *fade_);
     VITAL_ASSERT(utils::isFinite(output()->buffer[0]));
   }
 } // namespace vital
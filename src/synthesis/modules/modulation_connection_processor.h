@@ -52,6 +52,14 @@ namespace vital {
 
       virtual Processor* clone() const override { return new ModulationConnectionProcessor(*this); }
 
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override {
+        SynthModule::copyVoiceState(source, copy);
+        const ModulationConnectionProcessor* source_connection =
+            static_cast<const ModulationConnectionProcessor*>(source);
+        copy(power_, source_connection->power_);
+        copy(modulation_amount_, source_connection->modulation_amount_);
+      }
+
       void initializeBaseValue(Value* base_value) { current_value_ = base_value; }
       void initializeMapping() { map_generator_->initLinear(); }
 
@@ -66,6 +74,15 @@ namespace vital {
       void setStereo(bool stereo) { stereo_->set(stereo ? 1.0f : 0.0f); }
       bool isBypassed() const { return bypass_->value() != 0.0f; }
       force_inline void setDestinationScale(mono_float scale) { *destination_scale_ = scale; }
+
+      // Fading out ramps audio rate modulation to zero over the next block so the connection can be removed cleanly.
+      // Fading in ramps it up from zero over the next block each voice processes.
+      force_inline void fadeOut() { *fade_ = 0.0f; }
+      force_inline void fadeIn() {
+        *fade_ = 1.0f;
+        (*fade_ins_)++;
+      }
+      force_inline bool isFadingOut() const { return *fade_ == 0.0f; }
       force_inline int index() const { return index_; }
 
       LineGenerator* lineMapGenerator() { return map_generator_.get(); }
@@ -82,6 +99,9 @@ namespace vital {
       poly_float modulation_amount_;
 
       std::shared_ptr<mono_float> destination_scale_;
+      std::shared_ptr<mono_float> fade_;
+      std::shared_ptr<int> fade_ins_;
+      int last_fade_ins_;
       mono_float last_destination_scale_;
       std::shared_ptr<LineGenerator> map_generator_;
 
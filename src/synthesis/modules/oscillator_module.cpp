@@ -29,6 +29,7 @@ namespace vital {
 
   void OscillatorModule::init() {
     oscillator_ = new SynthOscillator(wavetable_.get());
+    oscillator_->setProfileName(prefix_);
 
     createBaseControl(prefix_ + "_view_2d");
     on_ = createBaseControl(prefix_ + "_on");
@@ -107,6 +108,7 @@ namespace vital {
     else if (*was_on_) {
       output(kRaw)->clearBuffer();
       output(kLevelled)->clearBuffer();
+      releaseOutputs();
     }
 
     *was_on_ = on;
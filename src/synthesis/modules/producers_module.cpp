@@ -19,7 +19,8 @@
 namespace vital {
   ProducersModule::ProducersModule() :
       SynthModule(kNumInputs, kNumOutputs), sample_destination_(nullptr),
-      filter1_on_(nullptr), filter2_on_(nullptr) {
+      filter1_on_(std::make_shared<const Value*>(nullptr)),
+      filter2_on_(std::make_shared<const Value*>(nullptr)) {
     for (int i = 0; i < kNumOscillators; ++i) {
       std::string number = std::to_string(i + 1);
       oscillators_[i] = new OscillatorModule("osc_" + number);
@@ -61,6 +62,12 @@ namespace vital {
     }
   }
 
+  void ProducersModule::setOutputArena(OutputArena* arena) {
+    for (int i = 0; i < kNumOscillators; ++i)
+      oscillators_[i]->setOutputArena(arena);
+    sampler_->setOutputArena(arena);
+  }
+
   void ProducersModule::process(int num_samples) {
     SynthModule::process(num_samples);
 
@@ -65,16 +65,21 @@ namespace vital {
 
   ReorderableEffectChain::ReorderableEffectChain(const Output* beats_per_second, const Output* keytrack) :
       vital::SynthModule(kNumInputs, 1), equalizer_memory_(nullptr),
-      beats_per_second_(beats_per_second), keytrack_(keytrack), last_order_(0.0f) {
+      beats_per_second_(beats_per_second), keytrack_(keytrack), last_order_(0.0f),
+      sleep_enabled_(true), processed_blocks_(0), processed_samples_(0) {
     for (int i = 0; i < constants::kNumEffects; ++i) {
       SynthModule* effect_module = createEffectModule(i);
       VITAL_ASSERT(effect_module);
 
+      effect_module->setProfileName(strings::kEffectOrder[i]);
       addSubmodule(effect_module);
       addProcessor(effect_module);
       effects_on_[i] = createBaseControl(strings::kEffectOrder[i] + "_on");
       effects_[i] = effect_module;
       effect_order_[i] = i;
+      sleeping_[i] = false;
+      silent_samples_[i] = 0;
+      skipped_blocks_[i] = 0;
     }
 
     last_order_ = utils::encodeOrderToFloat(effect_order_, constants::kNumEffects);
@@ -108,6 +113,39 @@ namespace vital {
     }
   }
 
+  Convolver* ReorderableEffectChain::getReverbConvolver() {
+    return static_cast<ReverbModule*>(effects_[constants::kReverb])->getConvolver();
+  }
+
+  bool ReorderableEffectChain::isAsleep() const {
+    if (!sleep_enabled_)
+      return false;
+
+    for (int i = 0; i < constants::kNumEffects; ++i) {
+      if (effects_[i]->enabled() && !sleeping_[i])
+        return false;
+    }
+    return true;
+  }
+
+  int64_t ReorderableEffectChain::getSkippedBlocks() const {
+    int64_t total = 0;
+    for (int i = 0; i < constants::kNumEffects; ++i)
+      total += skipped_blocks_[i];
+    return total;
+  }
+
+  void ReorderableEffectChain::setSleepEnabled(bool enabled) {
+    sleep_enabled_ = enabled;
+    for (int i = 0; i < constants::kNumEffects; ++i)
+      wake(i);
+  }
+
+  void ReorderableEffectChain::wake(int index) {
+    sleeping_[index] = false;
+    silent_samples_[index] = 0;
+  }
+
   void ReorderableEffectChain::process(int num_samples) {
     const poly_float* audio_in = input(kAudio)->source->buffer;
     processWithInput(audio_in, num_samples);
@@ -123,24 +161,62 @@ namespace vital {
       VITAL_ASSERT(utils::isFinite(audio_in, num_samples));
 
       int index = effect_order_[i];
+      SynthModule* effect = effects_[index];
       bool on = effects_on_[index]->value();
-      bool enabled = effects_[index]->enabled();
-      if (on != enabled)
-        effects_[index]->enable(on);
+      bool enabled = effect->enabled();
+      if (on != enabled) {
+        effect->enable(on);
+        wake(index);
+      }
+
+      if (!on)
+        continue;
 
-      if (on) {
-        effects_[index]->processWithInput(audio_in, num_samples);
-        audio_in = effects_[index]->output(0)->buffer;
+      bool silent_input = sleep_enabled_ &&
+                          utils::maxFloat(utils::peak(audio_in, num_samples)) <= kSilenceThreshold;
+      Output* effect_output = effect->output(0);
+      if (silent_input && sleeping_[index]) {
+        skipped_blocks_[index]++;
+        audio_in = effect_output->buffer;
+        continue;
+      }
+
+      sleeping_[index] = false;
+      {
+        Profiler::Scope profile(Profiler::active(), effect->profileId());
+        effect->processWithInput(audio_in, num_samples);
+      }
+      audio_in = effect_output->buffer;
+
+      if (!silent_input || utils::maxFloat(utils::peak(audio_in, num_samples)) > kSilenceThreshold)
+        silent_samples_[index] = 0;
+      else {
+        silent_samples_[index] += num_samples;
+        int min_samples = kMinSleepSeconds * getSampleRate();
+        if (silent_samples_[index] > std::max(min_samples, effect->getTailSamples())) {
+          sleeping_[index] = true;
+          utils::zeroBuffer(effect_output->buffer, effect_output->buffer_size);
+        }
       }
     }
 
+    processed_blocks_++;
+    processed_samples_ += num_samples;
+
     VITAL_ASSERT(utils::isFinite(audio_in, num_samples));
     utils::copyBuffer(output()->buffer, audio_in, num_samples);
   }
 
   void ReorderableEffectChain::hardReset() {
-    for (int i = 0; i < constants::kNumEffects; ++i)
+    for (int i = 0; i < constants::kNumEffects; ++i) {
       effects_[i]->hardReset();
+      wake(i);
+    }
+  }
+
+  void ReorderableEffectChain::setLocalOversampleAmount(int local_oversample) {
+    DistortionModule* distortion = static_cast<DistortionModule*>(effects_[constants::kDistortion]);
+    distortion->setLocalOversampleAmount(local_oversample);
   }
 
   void ReorderableEffectChain::correctToTime(double seconds) {
@@ -22,10 +22,14 @@
 
 namespace vital {
 
+  class Convolver;
   class StereoMemory;
 
   class ReorderableEffectChain : public SynthModule {
     public:
+      static constexpr mono_float kSilenceThreshold = 0.000001f;
+      static constexpr mono_float kMinSleepSeconds = 0.1f;
+
       enum {
         kAudio,
         kOrder,
@@ -42,10 +46,26 @@ namespace vital {
       virtual void correctToTime(double seconds) override;
 
       SynthModule* getEffect(constants::Effect effect) { return effects_[effect]; }
+
+      // Oversamples the effects with a nonlinear stage by this amount around that stage only.
+      void setLocalOversampleAmount(int local_oversample);
       const StereoMemory* getEqualizerMemory() { return equalizer_memory_; }
+      Convolver* getReverbConvolver();
+
+      // An effect sleeps once its input and output have been silent for longer than its tail and long enough
+      // for parameter smoothing to settle. Sleeping effects are skipped and output zeros until their input has
+      // signal again. Counters are for display.
+      void setSleepEnabled(bool enabled);
+      bool isSleeping(constants::Effect effect) const { return sleeping_[effect]; }
+      bool isAsleep() const;
+      int64_t getSkippedBlocks(constants::Effect effect) const { return skipped_blocks_[effect]; }
+      int64_t getSkippedBlocks() const;
+      int64_t getProcessedBlocks() const { return processed_blocks_; }
+      int64_t getProcessedSamples() const { return processed_samples_; }
 
     protected:
       SynthModule* createEffectModule(int index);
+      void wake(int index);
 
       const StereoMemory* equalizer_memory_;
       const Output* beats_per_second_;
@@ -55,6 +75,13 @@ namespace vital {
       int effect_order_[constants::kNumEffects];
       float last_order_;
 
+      bool sleep_enabled_;
+      bool sleeping_[constants::kNumEffects];
+      int silent_samples_[constants::kNumEffects];
+      int64_t skipped_blocks_[constants::kNumEffects];
+      int64_t processed_blocks_;
+      int64_t processed_samples_;
+
       JUCE_LEAK_DETECTOR(ReorderableEffectChain)
   };
 } // namespace vital
@@ -42,6 +42,7 @@ namespace vital {
     Output* reverb_size = createMonoModControl("reverb_size");
     Output* reverb_delay = createMonoModControl("reverb_delay");
     Output* reverb_wet = createMonoModControl("reverb_dry_wet");
+    Value* reverb_mode = createBaseControl("reverb_mode");
 
     reverb_->plug(reverb_decay_time, Reverb::kDecayTime);
     reverb_->plug(reverb_pre_low_cutoff, Reverb::kPreLowCutoff);
@@ -55,10 +56,19 @@ namespace vital {
     reverb_->plug(reverb_delay, Reverb::kDelay);
     reverb_->plug(reverb_size, Reverb::kSize);
     reverb_->plug(reverb_wet, Reverb::kWet);
+    reverb_->plug(reverb_mode, Reverb::kMode);
 
     SynthModule::init();
   }
 
+  Convolver* ReverbModule::getConvolver() {
+    return reverb_->getConvolver();
+  }
+
+  int ReverbModule::getTailSamples() const {
+    return reverb_->getTailSamples();
+  }
+
   void ReverbModule::hardReset() {
     reverb_->hardReset();
   }
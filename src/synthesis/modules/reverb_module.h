@@ -21,6 +21,7 @@
 
 namespace vital {
 
+  class Convolver;
   class Reverb;
 
   class ReverbModule : public SynthModule {
@@ -34,8 +35,11 @@ namespace vital {
 
       void setSampleRate(int sample_rate) override;
       void processWithInput(const poly_float* audio_in, int num_samples) override;
+      int getTailSamples() const override;
       Processor* clone() const override { return new ReverbModule(*this); }
 
+      Convolver* getConvolver();
+
     protected:
       Reverb* reverb_;
 
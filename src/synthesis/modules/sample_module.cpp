@@ -64,6 +64,7 @@ namespace vital {
     else if (*was_on_) {
       output(kRaw)->clearBuffer();
       output(kLevelled)->clearBuffer();
+      releaseOutputs();
       getPhaseOutput()->buffer[0] = 0.0f;
     }
 
@@ -326,13 +326,11 @@ namespace vital {
       for (ModulationConnectionProcessor* processor : enabled_modulation_processors_) {
         poly_float* buffer = processor->output()->buffer;
         if (processor->isControlRate() || processor->isPolyphonicModulation()) {
-          poly_float masked_value = buffer[0] & last_active_voice_mask_;
-          buffer[0] = masked_value + utils::swapVoices(masked_value);
+          buffer[0] = utils::sumVoices(buffer[0] & last_active_voice_mask_);
         }
         else {
           for (int i = 0; i < num_samples; ++i) {
-            poly_float masked_value = buffer[i] & last_active_voice_mask_;
-            buffer[i] = masked_value + utils::swapVoices(masked_value);
+            buffer[i] = utils::sumVoices(buffer[i] & last_active_voice_mask_);
           }
         }
       }
@@ -385,6 +383,20 @@ namespace vital {
       getModulationSource(source)->owner->enable(false);
   }
 
+  void SynthVoiceHandler::setOutputArena(OutputArena* arena) {
+    for (int i = 0; i < kNumLfos; ++i)
+      lfos_[i]->setOutputArena(arena);
+
+    for (int i = 0; i < kNumEnvelopes; ++i)
+      envelopes_[i]->setOutputArena(arena);
+
+    for (int i = 0; i < kNumRandomLfos; ++i)
+      random_lfos_[i]->setOutputArena(arena);
+
+    producers_->setOutputArena(arena);
+    filters_module_->setOutputArena(arena);
+  }
+
   void SynthVoiceHandler::enableModulationConnection(ModulationConnectionProcessor* processor) {
     enabled_modulation_processors_.push_back(processor);
   }
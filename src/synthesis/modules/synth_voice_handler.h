@@ -52,6 +52,7 @@ namespace vital {
       void correctToTime(double seconds) override;
       void disableUnnecessaryModSources();
       void disableModSource(const std::string& source);
+      void setOutputArena(OutputArena* arena) override;
 
       output_map& getPolyModulations() override;
       ModulationConnectionBank& getModulationBank() { return modulation_bank_; }
@@ -24,6 +24,10 @@ namespace vital {
 
   namespace {
     const std::string kDefaultName = "White Noise";
+    constexpr int kStreamIdleMs = 50;
+    constexpr int kStreamStopTimeoutMs = 2000;
+    constexpr int kStreamHeadLevels = 3;
+    constexpr int kPeakBlockSize = 256;
     const mono_float kUpsampleCoefficients[SampleSource::kNumUpsampleTaps] = {
       -0.000159813115702086552469274316479186382f,
       0.000225405365781280835058009159865832771f,
@@ -137,18 +141,23 @@ namespace vital {
       -0.0013796309221920304f
     };
 
-    force_inline mono_float getFilteredSample(const mono_float* buffer, int index, int size) {
+    // Filters read buffer[i - offset] so streamed windows of a buffer give the same sums as the whole
+    // buffer does.
+    force_inline mono_float getFilteredSample(const mono_float* buffer, int offset, int index, int start, int end) {
       int radius = SampleSource::kNumDownsampleTaps / 2;
-      int start = std::max(0, index - radius);
-      int end = std::min(size - 1, index + radius);
       mono_float total = 0.0f;
       for (int i = start; i <= end; ++i) {
         mono_float coefficient = kDownsampleCoefficients[i - index + radius];
-        total += coefficient *  buffer[i];
+        total += coefficient * buffer[i - offset];
       }
       return total;
     }
 
+    force_inline mono_float getFilteredSample(const mono_float* buffer, int index, int size) {
+      int radius = SampleSource::kNumDownsampleTaps / 2;
+      return getFilteredSample(buffer, 0, index, std::max(0, index - radius), std::min(size - 1, index + radius));
+    }
+
     force_inline mono_float getFilteredLoopSample(const mono_float* buffer, int index, int size) {
       int radius = SampleSource::kNumDownsampleTaps / 2;
       int start = index - radius;
@@ -162,8 +171,7 @@ namespace vital {
       return total;
     }
 
-
-    force_inline mono_float getInterpolatedSample(const mono_float* buffer, int index, int size) {
+    force_inline mono_float getInterpolatedSample(const mono_float* buffer, int offset, int index, int size) {
       int radius = SampleSource::kNumUpsampleTaps / 2;
       int start = std::max(0, index - radius + 1);
       int end = std::min(size - 1, index + radius);
@@ -172,7 +180,7 @@ namespace vital {
         int coefficient_index = i - index + radius - 1;
         VITAL_ASSERT(coefficient_index >= 0 && coefficient_index < SampleSource::kNumUpsampleTaps);
         mono_float coefficient = kUpsampleCoefficients[coefficient_index];
-        total += coefficient * buffer[i];
+        total += coefficient * buffer[i - offset];
       }
       return total;
     }
@@ -180,7 +188,7 @@ namespace vital {
     void upsample(const mono_float* original, mono_float* dest, int original_size, int dest_size) {
       for (int i = 0; i < original_size; ++i) {
         float value1 = original[i];
-        float value2 = getInterpolatedSample(original, i, original_size);
+        float value2 = getInterpolatedSample(original, 0, i, original_size);
         dest[2 * i] = value1;
         dest[2 * i + 1] = value2;
       }
@@ -263,7 +271,375 @@ namespace vital {
     }
   }
 
-  Sample::Sample() : name_(kDefaultName), current_data_(nullptr), active_audio_data_(nullptr) {
+  namespace {
+    std::vector<int> getLevelSizes(int length) {
+      std::vector<int> sizes;
+      sizes.push_back(length * (1 << Sample::kUpsampleTimes));
+      int size = length;
+      sizes.push_back(size);
+      while (size >= Sample::kMinSize) {
+        size = (size + 1) / 2;
+        sizes.push_back(size);
+      }
+      return sizes;
+    }
+
+    int64 getBufferMemory(int length, bool stereo) {
+      int64 num_values = 0;
+      for (int size : getLevelSizes(length))
+        num_values += size + 2 * Sample::kBufferSamples;
+
+      int num_channels = stereo ? 2 : 1;
+      return 2 * num_channels * num_values * sizeof(mono_float);
+    }
+  } // namespace
+
+  const mono_float SampleStream::kSilence[kChunkValues] = { };
+
+  std::unique_ptr<SampleStream> SampleStream::create(const mono_float* left, const mono_float* right, int length) {
+    static_assert(kGuardSamples == Sample::kBufferSamples, "Streamed chunks must match sample buffer guards.");
+    static_assert(Sample::kUpsampleTimes == 1, "Streaming renders a single upsampled level.");
+
+    std::unique_ptr<SampleStream> stream(new SampleStream(length, right != nullptr));
+    if (!stream->writeSource(left, right))
+      return nullptr;
+
+    // Notes start at the beginning of the sample, so the start of the levels played near the original
+    // pitch never leaves memory.
+    int head_levels = std::min(kStreamHeadLevels, stream->numLevels());
+    for (int channel = 0; channel < stream->num_channels_; ++channel) {
+      for (int level = 0; level < head_levels; ++level) {
+        for (int loop = 0; loop < 2; ++loop) {
+          Chunk* chunk = stream->loadChunk(stream->getTable(channel, level, loop), 0, false);
+          if (chunk)
+            chunk->pinned = true;
+        }
+      }
+    }
+
+    stream->startThread();
+    return stream;
+  }
+
+  SampleStream::SampleStream(int length, bool stereo) :
+      Thread("Sample Stream"), length_(length), num_channels_(stereo ? 2 : 1),
+      level_sizes_(getLevelSizes(length)), request_write_(0), request_read_(0), reads_begun_(0),
+      reads_ended_(0), synchronous_(false), underruns_(0), resident_chunks_(0) {
+    for (int channel = 0; channel < num_channels_; ++channel) {
+      for (int size : level_sizes_) {
+        int num_chunks = size / kChunkSize + 1;
+        for (int loop = 0; loop < 2; ++loop) {
+          table_sizes_.push_back(num_chunks);
+          tables_.push_back(std::make_unique<std::atomic<Chunk*>[]>(num_chunks));
+          requested_.push_back(std::make_unique<std::atomic<bool>[]>(num_chunks));
+        }
+      }
+    }
+  }
+
+  SampleStream::~SampleStream() {
+    stopThread(kStreamStopTimeoutMs);
+    source_ = nullptr;
+    source_file_.deleteFile();
+  }
+
+  bool SampleStream::writeSource(const mono_float* left, const mono_float* right) {
+    source_file_ = File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("vital_sample", ".stream");
+    {
+      FileOutputStream output(source_file_);
+      if (output.failedToOpen() || !output.write(left, length_ * sizeof(mono_float)))
+        return false;
+      if (right && !output.write(right, length_ * sizeof(mono_float)))
+        return false;
+
+      output.flush();
+      if (output.getStatus().failed())
+        return false;
+    }
+
+    source_ = std::make_unique<FileInputStream>(source_file_);
+    if (!source_->openedOk())
+      return false;
+
+    int num_peaks = (length_ + kPeakBlockSize - 1) / kPeakBlockSize;
+    peaks_.resize(num_peaks);
+    for (int i = 0; i < num_peaks; ++i) {
+      int start = i * kPeakBlockSize;
+      int end = std::min(length_, start + kPeakBlockSize);
+      peaks_[i] = *std::max_element(left + start, left + end);
+    }
+    return true;
+  }
+
+  void SampleStream::run() {
+    while (!threadShouldExit()) {
+      bool loaded = false;
+      int read = request_read_.load(std::memory_order_relaxed);
+      while (read != request_write_.load(std::memory_order_acquire)) {
+        Request next = requests_[read % kRequestQueueSize];
+        loadChunk(next.table, next.index, false);
+        request_read_.store(++read, std::memory_order_release);
+        loaded = true;
+      }
+
+      if (!loaded) {
+        {
+          ScopedLock lock(load_lock_);
+          recycleRetired();
+        }
+        // New requests wake the thread, so this only bounds how long retired chunks wait to be recycled.
+        wait(kStreamIdleMs);
+      }
+    }
+  }
+
+  void SampleStream::prefetch(int table, int index, bool reverse) {
+    int chunk_index = index >> kChunkBits;
+    int direction = reverse ? -1 : 1;
+    bool requested = false;
+    for (int i = 0; i <= kPrefetchChunks; ++i) {
+      int prefetch_index = chunk_index + direction * i;
+      if (prefetch_index < 0 || prefetch_index >= table_sizes_[table])
+        break;
+
+      if (tables_[table][prefetch_index].load(std::memory_order_relaxed) == nullptr)
+        requested = request(table, prefetch_index) || requested;
+    }
+
+    if (requested)
+      notify();
+  }
+
+  SampleStream::Chunk* SampleStream::readMissing(int table, int index) {
+    if (synchronous_) {
+      Chunk* chunk = loadChunk(table, index, true);
+      if (chunk)
+        return chunk;
+    }
+
+    underruns_.store(underruns_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (request(table, index))
+      notify();
+    return nullptr;
+  }
+
+  bool SampleStream::request(int table, int index) {
+    if (requested_[table][index].exchange(true))
+      return false;
+
+    int write = request_write_.load(std::memory_order_relaxed);
+    if (write - request_read_.load(std::memory_order_acquire) >= kRequestQueueSize) {
+      requested_[table][index] = false;
+      return false;
+    }
+
+    requests_[write % kRequestQueueSize] = { table, index };
+    request_write_.store(write + 1, std::memory_order_release);
+    return true;
+  }
+
+  SampleStream::Chunk* SampleStream::loadChunk(int table, int index, bool from_reader) {
+    ScopedLock lock(load_lock_);
+    Chunk* chunk = tables_[table][index].load(std::memory_order_relaxed);
+    if (chunk == nullptr) {
+      chunk = takeFreeChunk(from_reader);
+      if (chunk) {
+        chunk->table = table;
+        chunk->index = index;
+        chunk->pinned = false;
+        chunk->last_used = reads_begun_.load();
+        renderChunk(chunk);
+        tables_[table][index].store(chunk, std::memory_order_release);
+        resident_chunks_++;
+      }
+    }
+
+    requested_[table][index] = false;
+    return chunk;
+  }
+
+  SampleStream::Chunk* SampleStream::takeFreeChunk(bool from_reader) {
+    recycleRetired();
+    if (!free_chunks_.empty()) {
+      Chunk* chunk = free_chunks_.back();
+      free_chunks_.pop_back();
+      return chunk;
+    }
+
+    if (chunks_.size() < kMaxChunks) {
+      chunks_.push_back(std::make_unique<Chunk>());
+      return chunks_.back().get();
+    }
+
+    unsigned int reads_begun = reads_begun_.load();
+    Chunk* oldest = nullptr;
+    unsigned int oldest_age = 0;
+    for (auto& chunk : chunks_) {
+      unsigned int age = reads_begun - chunk->last_used.load(std::memory_order_relaxed);
+      if (chunk->table >= 0 && !chunk->pinned && (oldest == nullptr || age > oldest_age)) {
+        oldest = chunk.get();
+        oldest_age = age;
+      }
+    }
+
+    if (oldest == nullptr)
+      return nullptr;
+
+    tables_[oldest->table][oldest->index].store(nullptr);
+    oldest->table = -1;
+    resident_chunks_--;
+
+    // A reader that started before the chunk was taken out may still hold it. A reader loading its
+    // own missing chunk is the only reader, and it hasn't touched chunks it didn't use this read.
+    if (reads_ended_.load() == reads_begun_.load() || (from_reader && oldest_age > 0))
+      return oldest;
+
+    retired_chunks_.push_back({ oldest, reads_begun_.load() });
+    return nullptr;
+  }
+
+  void SampleStream::recycleRetired() {
+    unsigned int reads_ended = reads_ended_.load();
+    for (int i = static_cast<int>(retired_chunks_.size()) - 1; i >= 0; --i) {
+      if (static_cast<int>(reads_ended - retired_chunks_[i].second) >= 0) {
+        free_chunks_.push_back(retired_chunks_[i].first);
+        retired_chunks_.erase(retired_chunks_.begin() + i);
+      }
+    }
+  }
+
+  void SampleStream::renderChunk(Chunk* chunk) {
+    int loop = chunk->table % 2;
+    int level = (chunk->table / 2) % numLevels();
+    int channel = chunk->table / (2 * numLevels());
+    readRaw(channel, level, loop, chunk->index * kChunkSize, kChunkValues, chunk->values);
+  }
+
+  void SampleStream::readRaw(int channel, int level, bool loop, int start, int count, mono_float* dest) {
+    ScopedLock lock(load_lock_);
+    // The upsampled loop buffer is a copy of the upsampled play buffer.
+    if (level == 0)
+      loop = false;
+
+    int guard = kGuardSamples;
+    int end = start + count;
+    int data_start = std::min(end, std::max(start, guard));
+    int data_end = std::max(data_start, std::min(end, level_sizes_[level] + guard));
+
+    for (int i = start; i < data_start; ++i)
+      dest[i - start] = getRawValue(channel, level, loop, i);
+    if (data_end > data_start)
+      getLevelData(channel, level, loop, data_start - guard, data_end - data_start, dest + data_start - start);
+    for (int i = data_end; i < end; ++i)
+      dest[i - start] = getRawValue(channel, level, loop, i);
+  }
+
+  mono_float SampleStream::getRawValue(int channel, int level, bool loop, int index) {
+    int guard = kGuardSamples;
+    int size = level_sizes_[level];
+    int data_index = index - guard;
+    mono_float value = 0.0f;
+    if (data_index >= 0 && data_index < size)
+      getLevelData(channel, level, loop, data_index, 1, &value);
+    else if (loop && level > 0 && data_index >= -guard && data_index < size + guard) {
+      // Loop guards wrap around. Downsampled levels copy their leading guard from the level above.
+      if (data_index >= size)
+        getLevelData(channel, level, loop, data_index - size, 1, &value);
+      else if (level == Sample::kUpsampleTimes)
+        getLevelData(channel, level, loop, size + data_index, 1, &value);
+      else
+        value = getRawValue(channel, level - 1, loop, size + index);
+    }
+    return value;
+  }
+
+  void SampleStream::getLevelData(int channel, int level, bool loop, int start, int count, mono_float* dest) {
+    int size = level_sizes_[level];
+    int chunk_size = kChunkSize;
+    while (count > 0) {
+      int index = start;
+      if (loop)
+        index = ((start % size) + size) % size;
+
+      int num = std::min(count, std::min(size - index, chunk_size));
+      getLevelRange(channel, level, loop, index, num, dest);
+      start += num;
+      dest += num;
+      count -= num;
+    }
+  }
+
+  void SampleStream::getLevelRange(int channel, int level, bool loop, int start, int count, mono_float* dest) {
+    if (level == Sample::kUpsampleTimes) {
+      readSource(channel, start, count, dest);
+      return;
+    }
+
+    if (level < Sample::kUpsampleTimes) {
+      int radius = SampleSource::kNumUpsampleTaps / 2;
+      int window_start = std::max(0, start / 2 - radius + 1);
+      int window_end = std::min(length_ - 1, (start + count - 1) / 2 + radius);
+      std::vector<mono_float> window(window_end - window_start + 1);
+      getLevelData(channel, level + 1, false, window_start, static_cast<int>(window.size()), window.data());
+
+      for (int i = 0; i < count; ++i) {
+        int index = start + i;
+        if (index % 2)
+          dest[i] = getInterpolatedSample(window.data(), window_start, index / 2, length_);
+        else
+          dest[i] = window[index / 2 - window_start];
+      }
+      return;
+    }
+
+    int radius = SampleSource::kNumDownsampleTaps / 2;
+    int previous_size = level_sizes_[level - 1];
+    int window_start = 2 * start - radius;
+    int window_end = 2 * (start + count - 1) + radius;
+    if (!loop) {
+      window_start = std::max(0, window_start);
+      window_end = std::min(previous_size - 1, window_end);
+    }
+
+    std::vector<mono_float> window(window_end - window_start + 1);
+    getLevelData(channel, level - 1, loop, window_start, static_cast<int>(window.size()), window.data());
+    for (int i = 0; i < count; ++i) {
+      int index = 2 * (start + i);
+      int filter_start = index - radius;
+      int filter_end = index + radius;
+      if (!loop) {
+        filter_start = std::max(0, filter_start);
+        filter_end = std::min(previous_size - 1, filter_end);
+      }
+      dest[i] = getFilteredSample(window.data(), window_start, index, filter_start, filter_end);
+    }
+  }
+
+  void SampleStream::readSource(int channel, int start, int count, mono_float* dest) {
+    int64 bytes = count * sizeof(mono_float);
+    source_->setPosition((static_cast<int64>(channel) * length_ + start) * sizeof(mono_float));
+    int read = source_->read(dest, static_cast<int>(bytes));
+    if (read < bytes)
+      memset(reinterpret_cast<char*>(dest) + std::max(0, read), 0, bytes - std::max(0, read));
+  }
+
+  mono_float SampleStream::getPeak(int start, int end) const {
+    int last_block = static_cast<int>(peaks_.size()) - 1;
+    int first = std::min(last_block, std::max(0, start / kPeakBlockSize));
+    int last = std::min(last_block, std::max(first, (end - 1) / kPeakBlockSize));
+    return *std::max_element(peaks_.begin() + first, peaks_.begin() + last + 1);
+  }
+
+  int64 SampleStream::getMemoryUsage() const {
+    ScopedLock lock(load_lock_);
+    int64 memory = chunks_.size() * sizeof(Chunk) + peaks_.size() * sizeof(mono_float);
+    for (int size : table_sizes_)
+      memory += size * (sizeof(std::atomic<Chunk*>) + sizeof(std::atomic<bool>));
+    return memory;
+  }
+
+  Sample::Sample() : name_(kDefaultName), streaming_length_(kDefaultStreamingLength),
+                     streaming_synchronous_(false), current_data_(nullptr), active_audio_data_(nullptr) {
     init();
   }
 
@@ -273,26 +649,79 @@ namespace vital {
     VITAL_ASSERT(active_audio_data_.is_lock_free());
 
     size = std::min(size, kMaxSize);
-    std::unique_ptr<SampleData> old_data = std::move(data_);
-    data_ = std::make_unique<SampleData>(size, sample_rate, false);
-    createBandLimitedBuffers(data_->left_buffers, data_->left_loop_buffers, buffer, size);
-
-    current_data_ = data_.get();
-    while (active_audio_data_.load())
-      std::this_thread::yield(); // Wait for audio thread to finish using old_data.
+    setData(createData(buffer, nullptr, size, sample_rate));
   }
 
   void Sample::loadSample(const mono_float* left_buffer, const mono_float* right_buffer, int size, int sample_rate) {
+    setData(createData(left_buffer, right_buffer, size, sample_rate));
+  }
+
+  std::unique_ptr<Sample::SampleData> Sample::createData(const mono_float* left_buffer,
+                                                         const mono_float* right_buffer,
+                                                         int size, int sample_rate) {
+    std::unique_ptr<SampleData> data = std::make_unique<SampleData>(size, sample_rate, right_buffer != nullptr);
+    if (streaming_length_ > 0 && size >= streaming_length_) {
+      data->stream = SampleStream::create(left_buffer, right_buffer, size);
+      if (data->stream) {
+        data->stream->setSynchronous(streaming_synchronous_);
+        return data;
+      }
+    }
+
+    createBandLimitedBuffers(data->left_buffers, data->left_loop_buffers, left_buffer, size);
+    if (right_buffer)
+      createBandLimitedBuffers(data->right_buffers, data->right_loop_buffers, right_buffer, size);
+    return data;
+  }
+
+  void Sample::setData(std::unique_ptr<SampleData> data) {
     std::unique_ptr<SampleData> old_data = std::move(data_);
-    data_ = std::make_unique<SampleData>(size, sample_rate, true);
-    createBandLimitedBuffers(data_->left_buffers, data_->left_loop_buffers, left_buffer, size);
-    createBandLimitedBuffers(data_->right_buffers, data_->right_loop_buffers, right_buffer, size);
+    data_ = std::move(data);
 
     current_data_ = data_.get();
     while (active_audio_data_.load())
       std::this_thread::yield(); // Wait for audio thread to finish using old_data.
   }
 
+  void Sample::setStreamingSynchronous(bool synchronous) {
+    streaming_synchronous_ = synchronous;
+    if (data_ && data_->stream)
+      data_->stream->setSynchronous(synchronous);
+  }
+
+  mono_float Sample::getPeak(int start, int end) const {
+    if (current_data_->stream)
+      return current_data_->stream->getPeak(start, end);
+
+    const mono_float* buffer = current_data_->left_buffers[kUpsampleTimes].get() + 1;
+    mono_float peak = buffer[start];
+    for (int i = start + 1; i < end; ++i)
+      peak = std::max(peak, buffer[i]);
+    return peak;
+  }
+
+  int64 Sample::getMemoryUsage() const {
+    if (current_data_->stream)
+      return current_data_->stream->getMemoryUsage();
+    return getBufferMemory(current_data_->length, current_data_->stereo);
+  }
+
+  void Sample::readSourcePcm(const SampleData* data, int channel, int16_t* dest) {
+    if (data->stream == nullptr) {
+      const auto& buffers = channel ? data->right_buffers : data->left_buffers;
+      utils::floatToPcmData(dest, buffers[kUpsampleTimes].get(), data->length);
+      return;
+    }
+
+    int chunk_size = SampleStream::kChunkSize;
+    mono_float block[SampleStream::kChunkSize];
+    for (int start = 0; start < data->length; start += chunk_size) {
+      int count = std::min(chunk_size, data->length - start);
+      data->stream->readRaw(channel, kUpsampleTimes, false, start, count, block);
+      utils::floatToPcmData(dest + start, block, count);
+    }
+  }
+
   void Sample::init() {
     name_ = kDefaultName;
     mono_float buffer[kDefaultSampleLength];
@@ -304,19 +733,17 @@ namespace vital {
     loadSample(buffer, kDefaultSampleLength, kDefaultSampleRate);
   }
 
-  json Sample::stateToJson() {
+  json Sample::stateToJson(bool raw_data) {
     json data;
     data["name"] = name_;
     data["length"] = data_->length;
     data["sample_rate"] = data_->sample_rate;
     std::unique_ptr<int16_t[]> pcm_data = std::make_unique<int16_t[]>(data_->length);
-    utils::floatToPcmData(pcm_data.get(), data_->left_buffers[kUpsampleTimes].get(), data_->length);
-    String encoded = Base64::toBase64(pcm_data.get(), sizeof(int16_t) * data_->length);
-    data["samples"] = encoded.toStdString();
+    readSourcePcm(data_.get(), 0, pcm_data.get());
+    data["samples"] = utils::encodeDataString(pcm_data.get(), sizeof(int16_t) * data_->length, raw_data);
     if (data_->stereo) {
-      utils::floatToPcmData(pcm_data.get(), data_->right_buffers[kUpsampleTimes].get(), data_->length);
-      String encoded_stereo = Base64::toBase64(pcm_data.get(), sizeof(int16_t) * data_->length);
-      data["samples_stereo"] = encoded_stereo.toStdString();
+      readSourcePcm(data_.get(), 1, pcm_data.get());
+      data["samples_stereo"] = utils::encodeDataString(pcm_data.get(), sizeof(int16_t) * data_->length, raw_data);
     }
     return data;
   }
@@ -329,23 +756,13 @@ namespace vital {
     int length = data["length"];
     int sample_rate = data["sample_rate"];
 
-    MemoryOutputStream decoded(length * sizeof(int16_t));
-    std::string wave_data = data["samples"];
-    Base64::convertFromBase64(decoded, wave_data);
-    std::unique_ptr<int16_t[]> pcm_data = std::make_unique<int16_t[]>(length);
-    memcpy(pcm_data.get(), decoded.getData(), length * sizeof(int16_t));
     std::unique_ptr<mono_float[]> buffer = std::make_unique<mono_float[]>(length);
-    utils::pcmToFloatData(buffer.get(), pcm_data.get(), length);
+    utils::pcmDataStringToFloatData(buffer.get(), data["samples"].get_ref<const std::string&>(), length);
 
     if (data.count("samples_stereo")) {
-      MemoryOutputStream decoded_stereo(length * sizeof(int16_t));
-      std::string wave_data_stereo = data["samples_stereo"];
-      Base64::convertFromBase64(decoded_stereo, wave_data_stereo);
-      std::unique_ptr<int16_t[]> pcm_data_stereo = std::make_unique<int16_t[]>(length);
-      memcpy(pcm_data_stereo.get(), decoded_stereo.getData(), length * sizeof(int16_t));
-
       std::unique_ptr<mono_float[]> buffer_stereo = std::make_unique<mono_float[]>(length);
-      utils::pcmToFloatData(buffer_stereo.get(), pcm_data_stereo.get(), length);
+      const std::string& samples_stereo = data["samples_stereo"].get_ref<const std::string&>();
+      utils::pcmDataStringToFloatData(buffer_stereo.get(), samples_stereo, length);
       loadSample(buffer.get(), buffer_stereo.get(), length, sample_rate);
     }
     else
@@ -412,11 +829,15 @@ namespace vital {
     else
       bounce_mask_ = 0;
 
+    SampleStream* stream = sample_->getActiveStream();
     const mono_float* audio_buffers[poly_float::kSize];
+    int stream_tables[poly_float::kSize];
     poly_float phase_mult = 1.0f;
-    for (int i = 0; i < poly_float::kSize; ++i) {
+    for (size_t i = 0; i < poly_float::kSize; ++i) {
       int index = sample_->getActiveIndex(phase_inc_[i]);
-      if (loop && !bounce) {
+      if (stream)
+        stream_tables[i] = stream->getTable(i % 2, index, loop && !bounce);
+      else if (loop && !bounce) {
         if (i % 2)
           audio_buffers[i] = sample_->getActiveRightLoopBuffer(index);
         else
@@ -442,6 +863,13 @@ namespace vital {
 
     poly_mask current_bounce = bounce_mask_;
     poly_int length = audio_length;
+    if (stream) {
+      poly_float adjusted = utils::maskLoad(current_index, poly_float(audio_length) - current_index, current_bounce);
+      poly_int start_indices = utils::floorToInt(utils::max(adjusted, 0.0f) * phase_mult);
+      for (size_t i = 0; i < poly_float::kSize; ++i)
+        stream->prefetch(stream_tables[i], start_indices[i], bounce);
+    }
+
     for (int i = 0; i < num_samples; ++i) {
       current_phase_inc += delta_phase_inc;
 
@@ -459,7 +887,15 @@ namespace vital {
       VITAL_ASSERT(poly_float::greaterThan(utils::toFloat(start_indices), audio_length).anyMask() == 0);
 
       matrix interpolation_matrix = utils::getCatmullInterpolationMatrix(t);
-      matrix value_matrix = utils::getValueMatrix(audio_buffers, start_indices);
+      matrix value_matrix;
+      if (stream) {
+        const mono_float* values[poly_float::kSize];
+        for (size_t v = 0; v < poly_float::kSize; ++v)
+          values[v] = stream->read(stream_tables[v], start_indices[v]);
+        value_matrix = utils::getValueMatrix(values, poly_int(0));
+      }
+      else
+        value_matrix = utils::getValueMatrix(audio_buffers, start_indices);
       value_matrix.transpose();
       raw_output[i] = interpolation_matrix.multiplyAndSumRows(value_matrix);
       VITAL_ASSERT(utils::isContained(raw_output[i]));
@@ -502,6 +938,16 @@ namespace vital {
     sample_->markUnused();
   }
 
+  void SampleSource::copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) {
+    const SampleSource* source_sample = static_cast<const SampleSource*>(source);
+    copy(pan_amplitude_, source_sample->pan_amplitude_);
+    copy(last_quantized_transpose_, source_sample->last_quantized_transpose_);
+    copy(sample_index_, source_sample->sample_index_);
+    copy(sample_fraction_, source_sample->sample_fraction_);
+    copy(phase_inc_, source_sample->phase_inc_);
+    copy(bounce_mask_, source_sample->bounce_mask_);
+  }
+
   force_inline poly_float SampleSource::snapTranspose(poly_float input_midi, poly_float transpose, int quantize) {
     if (quantize == 0)
       return input_midi + transpose;
@@ -20,16 +20,141 @@
 #include "json/json.h"
 #include "utils.h"
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 using json = nlohmann::json;
 
 namespace vital {
 
+  // Plays a long sample without building its band limited buffers up front. The source audio goes to a
+  // temporary file and the audio thread reads the buffers it plays in fixed size chunks. A background
+  // thread renders chunks ahead of each playhead and drops the least recently used ones once it runs out
+  // of its fixed chunk budget. Reads of chunks that aren't ready yet are silent and count as underruns.
+  class SampleStream : public Thread {
+    public:
+      static constexpr int kGuardSamples = 4;
+      static constexpr int kChunkBits = 12;
+      static constexpr int kChunkSize = 1 << kChunkBits;
+      static constexpr int kChunkValues = kChunkSize + kGuardSamples;
+      static constexpr int kMaxChunks = 1024;
+      static constexpr int kPrefetchChunks = 4;
+      static constexpr int kRequestQueueSize = 1024;
+
+      struct Chunk {
+        mono_float values[kChunkValues];
+        std::atomic<unsigned int> last_used;
+        int table;
+        int index;
+        bool pinned;
+      };
+
+      // Returns nullptr if the source audio can't be written to disk.
+      static std::unique_ptr<SampleStream> create(const mono_float* left, const mono_float* right, int length);
+
+      virtual ~SampleStream();
+
+      void run() override;
+
+      int numLevels() const { return static_cast<int>(level_sizes_.size()); }
+      force_inline int getTable(int channel, int level, bool loop) const {
+        return ((channel % num_channels_) * numLevels() + level) * 2 + (loop ? 1 : 0);
+      }
+
+      // Audio thread side. Reads are bracketed by beginRead and endRead so chunks are only recycled
+      // once no reader can still hold them.
+      force_inline void beginRead() { reads_begun_++; }
+      force_inline void endRead() { reads_ended_++; }
+
+      // Returns the raw buffer values starting at index, including the guard samples before and after
+      // the audio. Missing chunks read as silence unless the stream is synchronous.
+      force_inline const mono_float* read(int table, int index) {
+        int chunk_index = index >> kChunkBits;
+        Chunk* chunk = tables_[table][chunk_index].load(std::memory_order_acquire);
+        if (chunk == nullptr) {
+          chunk = readMissing(table, chunk_index);
+          if (chunk == nullptr)
+            return kSilence;
+        }
+
+        chunk->last_used.store(reads_begun_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return chunk->values + (index & (kChunkSize - 1));
+      }
+
+      void prefetch(int table, int index, bool reverse);
+
+      // Offline renders run faster than chunks stream in, so synchronous streams render missing chunks
+      // on the reading thread instead.
+      void setSynchronous(bool synchronous) { synchronous_ = synchronous; }
+
+      void readRaw(int channel, int level, bool loop, int start, int count, mono_float* dest);
+      mono_float getPeak(int start, int end) const;
+      int getUnderruns() const { return underruns_.load(); }
+      // Requests that haven't finished loading yet.
+      int getPendingRequests() const { return request_write_.load() - request_read_.load(); }
+      int getResidentChunks() const { return resident_chunks_.load(); }
+      int64 getMemoryUsage() const;
+
+    protected:
+      struct Request {
+        int table;
+        int index;
+      };
+
+      SampleStream(int length, bool stereo);
+
+      bool writeSource(const mono_float* left, const mono_float* right);
+      Chunk* readMissing(int table, int index);
+      // Returns true if the chunk was queued. The caller wakes the stream thread.
+      bool request(int table, int index);
+      Chunk* loadChunk(int table, int index, bool from_reader);
+      Chunk* takeFreeChunk(bool from_reader);
+      void recycleRetired();
+
+      void renderChunk(Chunk* chunk);
+      mono_float getRawValue(int channel, int level, bool loop, int index);
+      void getLevelData(int channel, int level, bool loop, int start, int count, mono_float* dest);
+      void getLevelRange(int channel, int level, bool loop, int start, int count, mono_float* dest);
+      void readSource(int channel, int start, int count, mono_float* dest);
+
+      static const mono_float kSilence[kChunkValues];
+
+      int length_;
+      int num_channels_;
+      std::vector<int> level_sizes_;
+      std::vector<int> table_sizes_;
+      std::vector<std::unique_ptr<std::atomic<Chunk*>[]>> tables_;
+      std::vector<std::unique_ptr<std::atomic<bool>[]>> requested_;
+      std::vector<mono_float> peaks_;
+
+      File source_file_;
+      std::unique_ptr<FileInputStream> source_;
+      CriticalSection load_lock_;
+      std::vector<std::unique_ptr<Chunk>> chunks_;
+      std::vector<Chunk*> free_chunks_;
+      std::vector<std::pair<Chunk*, unsigned int>> retired_chunks_;
+
+      Request requests_[kRequestQueueSize];
+      std::atomic<int> request_write_;
+      std::atomic<int> request_read_;
+
+      std::atomic<unsigned int> reads_begun_;
+      std::atomic<unsigned int> reads_ended_;
+      std::atomic<bool> synchronous_;
+      std::atomic<int> underruns_;
+      std::atomic<int> resident_chunks_;
+
+      JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleStream)
+  };
+
   class Sample {
     public:
       static constexpr int kDefaultSampleLength = 44100;
       static constexpr int kUpsampleTimes = 1;
       static constexpr int kBufferSamples = 4;
       static constexpr int kMinSize = 4;
+      static constexpr int kDefaultStreamingLength = 1 << 20;
 
       struct SampleData {
         SampleData(int l, int sr, bool s) : length(l), sample_rate(sr), stereo(s) { }
@@ -41,6 +166,11 @@ namespace vital {
         std::vector<std::unique_ptr<mono_float[]>> left_loop_buffers;
         std::vector<std::unique_ptr<mono_float[]>> right_buffers;
         std::vector<std::unique_ptr<mono_float[]>> right_loop_buffers;
+        std::unique_ptr<SampleStream> stream;
+
+        int numLevels() const {
+          return stream ? stream->numLevels() : static_cast<int>(left_buffers.size());
+        }
 
         JUCE_LEAK_DETECTOR(SampleData)
       };
@@ -61,29 +191,40 @@ namespace vital {
       force_inline int activeLength() const { return active_audio_data_.load()->length * (1 << kUpsampleTimes); }
       force_inline int activeSampleRate() const { return active_audio_data_.load()->sample_rate; }
 
-      force_inline const mono_float* buffer() const { return current_data_->left_buffers[kUpsampleTimes].get() + 1; }
       void init();
 
+      // Samples at least this long stream from disk instead of keeping every buffer in memory.
+      // Zero turns streaming off.
+      void setStreamingLength(int length) { streaming_length_ = length; }
+      void setStreamingSynchronous(bool synchronous);
+      bool isStreaming() const { return current_data_->stream != nullptr; }
+      SampleStream* getStream() const { return current_data_->stream.get(); }
+      force_inline SampleStream* getActiveStream() const { return active_audio_data_.load()->stream.get(); }
+
+      // Largest value in a range of the sample, from an overview when streaming.
+      mono_float getPeak(int start, int end) const;
+      int64 getMemoryUsage() const;
+
       int getActiveIndex(mono_float delta) {
         int octaves = utils::ilog2(std::max<int>(delta, 1));
-        return std::min(octaves, (int)active_audio_data_.load()->left_buffers.size() - 1);
+        return std::min(octaves, active_audio_data_.load()->numLevels() - 1);
       }
 
       force_inline const mono_float* getActiveLeftBuffer(int index) {
-        VITAL_ASSERT(index >= 0 && index < active_audio_data_.load()->left_buffers.size());
+        VITAL_ASSERT(index >= 0 && index < static_cast<int>(active_audio_data_.load()->left_buffers.size()));
 
         return active_audio_data_.load()->left_buffers[index].get();
       }
 
       force_inline const mono_float* getActiveLeftLoopBuffer(int index) {
-        VITAL_ASSERT(index >= 0 && index < active_audio_data_.load()->left_loop_buffers.size());
+        VITAL_ASSERT(index >= 0 && index < static_cast<int>(active_audio_data_.load()->left_loop_buffers.size()));
 
         return active_audio_data_.load()->left_loop_buffers[index].get();
       }
 
       force_inline const mono_float* getActiveRightBuffer(int index) {
         if (active_audio_data_.load()->stereo) {
-          VITAL_ASSERT(index >= 0 && index < active_audio_data_.load()->right_buffers.size());
+          VITAL_ASSERT(index >= 0 && index < static_cast<int>(active_audio_data_.load()->right_buffers.size()));
           return active_audio_data_.load()->right_buffers[index].get();
         }
         return getActiveLeftBuffer(index);
@@ -91,21 +232,40 @@ namespace vital {
 
       force_inline const mono_float* getActiveRightLoopBuffer(int index) {
         if (active_audio_data_.load()->stereo) {
-          VITAL_ASSERT(index >= 0 && index < active_audio_data_.load()->right_loop_buffers.size());
+          VITAL_ASSERT(index >= 0 && index < static_cast<int>(active_audio_data_.load()->right_loop_buffers.size()));
           return active_audio_data_.load()->right_loop_buffers[index].get();
         }
         return getActiveLeftLoopBuffer(index);
       }
 
-      force_inline void markUsed() { active_audio_data_ = current_data_; }
-      force_inline void markUnused() { active_audio_data_ = nullptr; }
+      force_inline void markUsed() {
+        SampleData* data = current_data_;
+        active_audio_data_ = data;
+        if (data->stream)
+          data->stream->beginRead();
+      }
 
-      json stateToJson();
+      force_inline void markUnused() {
+        SampleData* data = active_audio_data_.load();
+        if (data && data->stream)
+          data->stream->endRead();
+        active_audio_data_ = nullptr;
+      }
+
+      // Raw data keeps the pcm payloads as raw data strings instead of Base64, see utils::readDataString.
+      json stateToJson(bool raw_data = false);
       void jsonToState(json data);
 
     protected:
+      std::unique_ptr<SampleData> createData(const mono_float* left_buffer, const mono_float* right_buffer,
+                                             int size, int sample_rate);
+      void setData(std::unique_ptr<SampleData> data);
+      void readSourcePcm(const SampleData* data, int channel, int16_t* dest);
+
       std::string name_;
       std::string last_browsed_file_;
+      int streaming_length_;
+      bool streaming_synchronous_;
       SampleData* current_data_;
       std::atomic<SampleData*> active_audio_data_;
       std::unique_ptr<SampleData> data_;
@@ -148,6 +308,7 @@ namespace vital {
 
       virtual void process(int num_samples) override;
       virtual Processor* clone() const override { return new SampleSource(*this); }
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override;
       Sample* getSample() { return sample_.get(); }
       force_inline Output* getPhaseOutput() const { return phase_output_.get(); }
 
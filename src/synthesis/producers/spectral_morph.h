@@ -260,10 +260,11 @@ namespace vital {
       wave_start[i] = 0.0f;
 
     poly_float last_mult = 1.0f;
-    if (t >= 1.0f)
-      last_mult = poly_float(1.0f, 1.0f, t - 1.0f, t - 1.0f);
-    else
-      last_mult = poly_float(t, t, 0.0f, 0.0f);
+    for (size_t i = 0; i < poly_float::kSize; i += 2) {
+      float bin_mult = utils::clamp(t - i / 2, 0.0f, 1.0f);
+      last_mult.set(i, bin_mult);
+      last_mult.set(i + 1, bin_mult);
+    }
 
     wave_start[last_index] = wave_start[last_index] * last_mult;
 
@@ -294,10 +295,11 @@ namespace vital {
       wave_start[i] = 0.0f;
 
     poly_float last_mult = 1.0f;
-    if (t >= 1.0f)
-      last_mult = poly_float(0.0f, 0.0f, 2.0f - t, 2.0f - t);
-    else
-      last_mult = poly_float(1.0f - t, 1.0f - t, 1.0f, 1.0f);
+    for (size_t i = 0; i < poly_float::kSize; i += 2) {
+      float bin_mult = utils::clamp(i / 2 + 1.0f - t, 0.0f, 1.0f);
+      last_mult.set(i, bin_mult);
+      last_mult.set(i + 1, bin_mult);
+    }
 
     wave_start[start_index] = wave_start[start_index] * last_mult;
 
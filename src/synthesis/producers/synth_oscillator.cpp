@@ -21,11 +21,15 @@
 #include "matrix.h"
 #include "wavetable.h"
 
+#include <algorithm>
 #include <climits>
 
 namespace vital {
   namespace {
     constexpr int kNumVoicesPerProcess = poly_float::kSize / 2;
+    // A lone voice can borrow its partner's lanes for a second unison pair. That packing only exists
+    // for two voices per register, wider registers process inactive voice lanes as usual.
+    constexpr bool kCompactSingleVoice = kNumVoicesPerProcess == 2;
     constexpr int kWaveformBits = WaveFrame::kWaveformBits;
     constexpr int kIntermediateBits = 8 * sizeof(uint32_t) - kWaveformBits;
     constexpr int kHalfPhase = INT_MIN;
@@ -607,6 +611,75 @@ namespace vital {
     }
   }
 
+  void SynthOscillator::copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) {
+    const SynthOscillator* source_oscillator = static_cast<const SynthOscillator*>(source);
+    copy(phases_, source_oscillator->phases_, kNumPolyPhase);
+    copy(detunings_, source_oscillator->detunings_, kNumPolyPhase);
+    copy(phase_inc_mults_, source_oscillator->phase_inc_mults_, kNumPolyPhase);
+    copy(from_phase_inc_mults_, source_oscillator->from_phase_inc_mults_, kNumPolyPhase);
+    copy(shepard_double_masks_, source_oscillator->shepard_double_masks_, kNumPolyPhase);
+    copy(shepard_half_masks_, source_oscillator->shepard_half_masks_, kNumPolyPhase);
+    copy(waiting_shepard_double_masks_, source_oscillator->waiting_shepard_double_masks_, kNumPolyPhase);
+    copy(waiting_shepard_half_masks_, source_oscillator->waiting_shepard_half_masks_, kNumPolyPhase);
+    copy(spectral_morph_values_, source_oscillator->spectral_morph_values_, kNumPolyPhase);
+    copy(last_spectral_morph_values_, source_oscillator->last_spectral_morph_values_, kNumPolyPhase);
+    copy(distortion_values_, source_oscillator->distortion_values_, kNumPolyPhase);
+    copy(last_distortion_values_, source_oscillator->last_distortion_values_, kNumPolyPhase);
+
+    copy(pan_amplitude_, source_oscillator->pan_amplitude_);
+    copy(center_amplitude_, source_oscillator->center_amplitude_);
+    copy(detuned_amplitude_, source_oscillator->detuned_amplitude_);
+    copy(midi_note_, source_oscillator->midi_note_);
+    copy(distortion_phase_, source_oscillator->distortion_phase_);
+    copy(blend_stereo_multiply_, source_oscillator->blend_stereo_multiply_);
+    copy(blend_center_multiply_, source_oscillator->blend_center_multiply_);
+    copy(last_quantized_transpose_, source_oscillator->last_quantized_transpose_);
+    copy(last_quantize_ratio_, source_oscillator->last_quantize_ratio_);
+    copy(voice_block_.current_buffer_sample, source_oscillator->voice_block_.current_buffer_sample);
+    copy(voice_block_.distortion_phase, source_oscillator->voice_block_.distortion_phase);
+    copy(voice_block_.last_distortion_phase, source_oscillator->voice_block_.last_distortion_phase);
+
+    bool copied_frames[2][kNumBuffers + 1] = {};
+    for (int i = 0; i < kNumPolyPhase; ++i) {
+      for (int lane = 0; lane < VoiceLaneCopy::kLanesPerVoice; ++lane) {
+        int source_index = i * poly_float::kSize + copy.sourceLane() + lane;
+        int destination_index = i * poly_float::kSize + copy.destinationLane() + lane;
+        const mono_float* last_buffer = source_oscillator->last_buffers_[source_index];
+        const mono_float* wave_buffer = source_oscillator->wave_buffers_[source_index];
+        last_buffers_[destination_index] = copyWaveBuffer(source_oscillator, last_buffer, copy, copied_frames);
+        wave_buffers_[destination_index] = copyWaveBuffer(source_oscillator, wave_buffer, copy, copied_frames);
+      }
+    }
+  }
+
+  // Spectrally morphed waves live in the oscillator's own frames so they're copied over and pointed to again.
+  const mono_float* SynthOscillator::copyWaveBuffer(const SynthOscillator* source, const mono_float* buffer,
+                                                    const VoiceLaneCopy& copy, bool copied_frames[][kNumBuffers + 1]) {
+    static constexpr int kFrameSize = kSpectralBufferSize * poly_float::kSize;
+    const poly_float (*source_frames[])[kSpectralBufferSize] = { source->fourier_frames1_, source->fourier_frames2_ };
+    poly_float (*frames[])[kSpectralBufferSize] = { fourier_frames1_, fourier_frames2_ };
+
+    for (int f = 0; f < 2; ++f) {
+      const mono_float* start = (const mono_float*)source_frames[f];
+      if (buffer < start || buffer >= start + (kNumBuffers + 1) * kFrameSize)
+        continue;
+
+      int offset = static_cast<int>(buffer - start);
+      int row = offset / kFrameSize;
+      int lane = copy.destinationLane(row % poly_float::kSize);
+      if (lane < 0)
+        return Wavetable::null_waveform();
+
+      int destination_row = row - row % poly_float::kSize + lane;
+      if (!copied_frames[f][destination_row]) {
+        std::copy(source_frames[f][row], source_frames[f][row] + kSpectralBufferSize, frames[f][destination_row]);
+        copied_frames[f][destination_row] = true;
+      }
+      return ((const mono_float*)frames[f][destination_row]) + (offset - row * kFrameSize);
+    }
+    return buffer;
+  }
+
   void SynthOscillator::setPhaseIncMults() {
     poly_float range = input(kDetuneRange)->at(0);
     poly_float cents = range * input(kUnisonDetune)->at(0);
@@ -923,7 +996,7 @@ namespace vital {
   }
 
   force_inline void SynthOscillator::loadVoiceBlock(VoiceBlock& voice_block, int index, poly_mask active_mask) {
-    bool single_voice = (~active_mask).anyMask();
+    bool single_voice = kCompactSingleVoice && (~active_mask).anyMask();
     if (single_voice) {
       voice_block.phase = compactAndLoadVoice(phases_ + 2 * index, active_mask);
       voice_block.phase_inc_mult = compactAndLoadVoice(phase_inc_mults_ + 2 * index, active_mask);
@@ -1251,7 +1324,7 @@ namespace vital {
         else
           voice_block_.modulation_buffer = first_mod_oscillator_->buffer;
         
-        if (left_active && right_active)
+        if (!kCompactSingleVoice || (left_active && right_active))
           processOscillators<fmPhase, passThroughWindow>(num_samples, distortion_type);
         else if (left_active)
           processOscillators<fmPhaseLeft, passThroughWindow>(num_samples, distortion_type);
@@ -1268,7 +1341,7 @@ namespace vital {
         else
           voice_block_.modulation_buffer = first_mod_oscillator_->buffer;
 
-        if (left_active && right_active)
+        if (!kCompactSingleVoice || (left_active && right_active))
           processOscillators<passThroughPhase, rmWindow>(num_samples, distortion_type);
         else if (left_active)
           processOscillators<passThroughPhase, rmWindowLeft>(num_samples, distortion_type);
@@ -1284,10 +1357,10 @@ namespace vital {
   }
 
   force_inline void SynthOscillator::setActiveOscillators(int new_active_oscillators) {
-    for (int i = active_oscillators_; i < new_active_oscillators; ++i) {
-      wave_buffers_[2 * i] = Wavetable::null_waveform();
-      wave_buffers_[2 * i + 1] = Wavetable::null_waveform();
-    }
+    int start_buffer = active_oscillators_ * kNumVoicesPerProcess;
+    int end_buffer = new_active_oscillators * kNumVoicesPerProcess;
+    for (int i = start_buffer; i < end_buffer; ++i)
+      wave_buffers_[i] = Wavetable::null_waveform();
 
     active_oscillators_ = new_active_oscillators;
   }
@@ -1380,10 +1453,10 @@ namespace vital {
 
     poly_mask wave_buffer_mask = reset_mask | retrigger_mask;
     poly_float buffer_phase_inc = phase_inc_buffer_->buffer[num_samples - 1] * (1.0f / kPhaseMult);
-    if (wave_buffer_mask[0])
-      setWaveBuffers(buffer_phase_inc, 0);
-    if (wave_buffer_mask[2])
-      setWaveBuffers(buffer_phase_inc, 2);
+    for (size_t v = 0; v < poly_float::kSize; v += 2) {
+      if (wave_buffer_mask[v])
+        setWaveBuffers(buffer_phase_inc, v);
+    }
 
     if (reset_mask.anyMask())
       reset(reset_mask, trigger_offset);
@@ -1410,7 +1483,9 @@ namespace vital {
     voice_block_.current_buffer_sample &= active_voice_mask;
     while (voice_block_.start_sample < num_samples) {
       poly_int remaining_fade_samples = poly_int(voice_block_.num_buffer_samples) - voice_block_.current_buffer_sample;
-      int min_remaining_fade_samples = std::min(remaining_fade_samples[0], remaining_fade_samples[2]);
+      int min_remaining_fade_samples = remaining_fade_samples[0];
+      for (size_t v = 2; v < poly_float::kSize; v += 2)
+        min_remaining_fade_samples = std::min<int>(min_remaining_fade_samples, remaining_fade_samples[v]);
       int samples = std::min(min_remaining_fade_samples, num_samples - voice_block_.start_sample);
       voice_block_.end_sample = voice_block_.start_sample + samples;
       processChunk<phaseDistort, window>(current_center_amplitude, current_detuned_amplitude);
@@ -1422,13 +1497,12 @@ namespace vital {
       if (shepard && new_buffer_mask.anyMask())
         doShepardWrap(new_buffer_mask, transpose_quantize_);
 
-      if (new_buffer_mask[0])
-        setWaveBuffers(buffer_phase_inc, 0);
-      if (new_buffer_mask[2])
-        setWaveBuffers(buffer_phase_inc, 2);
+      for (size_t v = 0; v < poly_float::kSize; v += 2) {
+        if (new_buffer_mask[v])
+          setWaveBuffers(buffer_phase_inc, v);
 
-      VITAL_ASSERT((int)voice_block_.current_buffer_sample[0] < voice_block_.num_buffer_samples);
-      VITAL_ASSERT((int)voice_block_.current_buffer_sample[2] < voice_block_.num_buffer_samples);
+        VITAL_ASSERT((int)voice_block_.current_buffer_sample[v] < voice_block_.num_buffer_samples);
+      }
     }
 
     if (reset_mask.anyMask())
@@ -1444,8 +1518,9 @@ namespace vital {
     if (active_channels < 2)
       return;
 
-    VITAL_ASSERT(active_channels == 2 || active_channels == 4);
+    VITAL_ASSERT(active_channels % 2 == 0);
     int num_active_voices = active_channels / 2;
+    bool compact_voice = kCompactSingleVoice && num_active_voices < 2;
     poly_mask active_voice_mask = poly_float::equal(input(kActiveVoices)->at(0), 1.0f);
     int num_samples = voice_block_.end_sample - voice_block_.start_sample;
 
@@ -1455,7 +1530,7 @@ namespace vital {
     poly_float center_amplitude = center_amplitude_;
     poly_float detuned_amplitude = detuned_amplitude_;
 
-    if (num_active_voices < 2) {
+    if (compact_voice) {
       poly_float current_detuned_swap = utils::swapVoices(current_detuned_amplitude);
       current_detuned_amplitude = utils::maskLoad(current_detuned_swap, current_detuned_amplitude, active_voice_mask);
       current_center_amplitude = utils::maskLoad(current_detuned_amplitude,
@@ -1476,12 +1551,13 @@ namespace vital {
                                                            active_voice_mask);
     }
 
-    int num_phase_updates = (poly_float::kSize - 1 + num_active_voices * active_oscillators_) / poly_float::kSize;
+    int num_phase_voices = compact_voice ? num_active_voices : kNumVoicesPerProcess;
+    int num_phase_updates = (poly_float::kSize - 1 + num_phase_voices * active_oscillators_) / poly_float::kSize;
     for (int p = 1; p < num_phase_updates; ++p) {
       loadVoiceBlock(voice_block_, p, active_voice_mask);
 
       poly_int phase = processDetuned<phaseDistort, window>(voice_block_, audio_out);
-      if (num_active_voices < 2)
+      if (compact_voice)
         expandAndWriteVoice(phases_ + 2 * p, phase, active_voice_mask);
       else
         phases_[p] = phase;
@@ -1498,7 +1574,7 @@ namespace vital {
                                                                 current_center_amplitude, delta_center_amplitude,
                                                                 current_detuned_amplitude, delta_detuned_amplitude);
 
-    if (num_active_voices < 2) {
+    if (compact_voice) {
       expandAndWriteVoice(phases_, center_phase, active_voice_mask);
       convertVoiceChannels(num_samples, audio_out, active_voice_mask);
     }
@@ -211,6 +211,7 @@ namespace vital {
 
       void reset(poly_mask reset_mask, poly_int sample);
       void reset(poly_mask reset_mask) override;
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override;
       void setSpectralMorphValues(SpectralMorph spectral_morph);
       void setDistortionValues(DistortionType distortion_type);
       void process(int num_samples) override;
@@ -239,6 +240,8 @@ namespace vital {
       void loadVoiceBlock(VoiceBlock& voice_block, int index, poly_mask active_mask);
 
       void resetWavetableBuffers();
+      const mono_float* copyWaveBuffer(const SynthOscillator* source, const mono_float* buffer,
+                                       const VoiceLaneCopy& copy, bool copied_frames[][kNumBuffers + 1]);
       void setActiveOscillators(int new_active_oscillators);
       template<poly_float(*snapTranspose)(poly_float, poly_float, float*)>
       void setPhaseIncBufferSnap(int num_samples, poly_mask reset_mask,
@@ -32,10 +32,17 @@ namespace vital {
 
   SoundEngine::SoundEngine() : SynthModule(0, 1), voice_handler_(nullptr), effect_chain_(nullptr),
                                output_total_(nullptr), last_oversampling_amount_(-1), last_sample_rate_(-1),
-                               oversampling_(nullptr), legato_(nullptr), decimator_(nullptr), peak_meter_(nullptr) {
+                               oversampling_(nullptr), legato_(nullptr), decimator_(nullptr),
+                               voice_decimator_(nullptr), direct_decimator_(nullptr), effects_at_base_rate_(false),
+                               peak_meter_(nullptr), next_connection_id_(0), last_connection_id_(0),
+                               wake_requested_(false), dormant_enabled_(true), dormant_(false), silent_samples_(0),
+                               dormant_blocks_(0), expected_time_(0.0) {
     SoundEngine::init();
     bps_ = data_->controls["beats_per_minute"];
     modulation_processors_.reserve(kMaxModulationConnections);
+    fading_modulations_.reserve(kMaxModulationConnections);
+    pending_connections_.reserve(2 * kMaxModulationConnections);
+    pending_connection_ids_.reserve(2 * kMaxModulationConnections);
   }
 
   SoundEngine::~SoundEngine() {
@@ -61,6 +68,7 @@ namespace vital {
     Value* voice_override = createBaseControl("voice_override");
 
     voice_handler_ = new SynthVoiceHandler(beats_per_second_clamped->output());
+    voice_handler_->setProfileName("voice_handler");
     addSubmodule(voice_handler_);
     voice_handler_->setPolyphony(vital::kMaxPolyphony);
     voice_handler_->plug(polyphony, VoiceHandler::kPolyphony);
@@ -72,8 +80,23 @@ namespace vital {
     createBaseControl("pitch_wheel");
     createBaseControl("mod_wheel");
 
+    voice_decimator_ = new Decimator(3);
+    voice_decimator_->plug(voice_handler_);
+    voice_decimator_->enable(false);
+    addProcessor(voice_decimator_);
+
+    direct_decimator_ = new Decimator(3);
+    direct_decimator_->plug(voice_handler_->getDirectOutput());
+    direct_decimator_->enable(false);
+    addProcessor(direct_decimator_);
+
+    // The effects keep the buffer sizes they had while oversampled, so the decimated audio has to be as long.
+    voice_decimator_->output()->ensureBufferSize(kMaxBufferSize * kMaxOversample);
+    direct_decimator_->output()->ensureBufferSize(kMaxBufferSize * kMaxOversample);
+
     Value* effect_chain_order = createBaseControl("effect_chain_order");
     effect_chain_ = new ReorderableEffectChain(beats_per_second, voice_handler_->midi_offset_output());
+    effect_chain_->setProfileName("effect_chain");
     addSubmodule(effect_chain_);
     addProcessor(effect_chain_);
     effect_chain_->plug(voice_handler_, ReorderableEffectChain::kAudio);
@@ -132,33 +155,100 @@ namespace vital {
     clamp->useOutput(output());
 
     SynthModule::init();
+    voice_handler_->setOutputArena(&output_arena_);
     disableUnnecessaryModSources();
     setOversamplingAmount(kDefaultOversamplingAmount, kDefaultSampleRate);
   }
 
+  void SoundEngine::prepareModulationChange(modulation_change& change) const {
+    change.polyphonic = change.source->owner->isPolyphonic() && change.poly_destination;
+    change.destination = change.polyphonic ? change.poly_destination : change.mono_destination;
+    change.audio_rate = !change.destination->isControlRate() && !change.source->isControlRate();
+    change.modulation_input = nullptr;
+    change.modulation_output = nullptr;
+    change.connection_id = 0;
+  }
+
+  void SoundEngine::compileModulationConnection(modulation_change& change) {
+    std::lock_guard<std::mutex> lock(modulation_graph_mutex_);
+    compileConnection(change);
+  }
+
+  void SoundEngine::compileConnection(modulation_change& change) {
+    // Drop connections that were plugged in since, and any left from an earlier connection of this
+    // modulation processor. Those are disconnected before this one is applied.
+    int last_connection_id = last_connection_id_.load();
+    const Processor* modulation_processor = change.modulation_processor;
+    int num_kept = 0;
+    for (size_t i = 0; i < pending_connections_.size(); ++i) {
+      const ProcessorRouter::Connection& connection = pending_connections_[i];
+      if (pending_connection_ids_[i] > last_connection_id && connection.destination != modulation_processor &&
+          connection.source->owner != modulation_processor) {
+        pending_connections_[num_kept] = connection;
+        pending_connection_ids_[num_kept++] = pending_connection_ids_[i];
+      }
+    }
+    pending_connections_.resize(num_kept);
+    pending_connection_ids_.resize(num_kept);
+
+    change.connection_id = ++next_connection_id_;
+    ProcessorRouter* modulation_router = change.modulation_processor->router();
+    change.modulation_input = modulation_router->prepareConnection(change.modulation_processor, change.source,
+                                                                   pending_connections_);
+    pending_connection_ids_.push_back(change.connection_id);
+
+    ProcessorRouter* destination_router = change.destination->router();
+    change.modulation_output = destination_router->prepareConnection(change.destination,
+                                                                     change.modulation_processor->output(),
+                                                                     pending_connections_);
+    pending_connection_ids_.push_back(change.connection_id);
+  }
+
   void SoundEngine::connectModulation(const modulation_change& change) {
-    change.modulation_processor->plug(change.source, ModulationConnectionProcessor::kModulationInput);
+    wake();
+    const Output* modulation_input = change.modulation_input;
+    const Output* modulation_output = change.modulation_output;
+    int connection_id = change.connection_id;
+    if (modulation_output == nullptr) {
+      // Changes applied straight to the engine while processing is paused aren't compiled ahead of time.
+      modulation_change compiled = change;
+      compileConnection(compiled);
+      modulation_input = compiled.modulation_input;
+      modulation_output = compiled.modulation_output;
+      connection_id = compiled.connection_id;
+    }
+
+    for (int i = 0; i < fading_modulations_.size(); ++i) {
+      if (fading_modulations_[i].modulation_processor == change.modulation_processor) {
+        disconnectModulation(fading_modulations_[i]);
+        fading_modulations_.removeAt(i);
+        break;
+      }
+    }
+
+    change.modulation_processor->plugPrepared(modulation_input, ModulationConnectionProcessor::kModulationInput);
     change.modulation_processor->setDestinationScale(change.destination_scale);
+    // Primed silent and faded in below.
+    change.modulation_processor->fadeOut();
     VITAL_ASSERT(vital::utils::isFinite(change.destination_scale));
 
-    Processor* destination = change.mono_destination;
-    bool polyphonic = change.source->owner->isPolyphonic() && change.poly_destination;
-    change.modulation_processor->setPolyphonicModulation(polyphonic);
+    change.modulation_processor->setPolyphonicModulation(change.polyphonic);
     voice_handler_->enableModulationConnection(change.modulation_processor);
-    if (polyphonic) {
-      destination = change.poly_destination;
+    if (change.polyphonic)
       voice_handler_->setActiveNonaccumulatedOutput(change.poly_destination->output());
-    }
 
-    if (!destination->isControlRate() && !change.source->isControlRate()) {
+    if (change.audio_rate) {
       change.source->owner->setControlRate(false);
       change.modulation_processor->setControlRate(false);
     }
     change.source->owner->enable(true);
     change.modulation_processor->enable(true);
-    destination->plugNext(change.modulation_processor);
+    change.destination->plugNextPrepared(modulation_output);
+    last_connection_id_ = connection_id;
     change.modulation_processor->process(1);
-    destination->process(1);
+    change.destination->process(1);
+    // Fading in after priming keeps the one sample above from using up the ramp.
+    change.modulation_processor->fadeIn();
 
     change.mono_modulation_switch->set(1);
     if (change.poly_modulation_switch)
@@ -172,13 +262,10 @@ namespace vital {
   }
 
   void SoundEngine::disconnectModulation(const modulation_change& change) {
+    wake();
     change.modulation_processor->setDestinationScale(0.0f);
-
-    Processor* destination = change.mono_destination;
-    if (change.source->owner->isPolyphonic() && change.poly_destination)
-      destination = change.poly_destination;
-
-    destination->unplug(change.modulation_processor);
+    change.destination->router()->disconnectPrepared(change.destination, change.modulation_processor->output());
+    change.modulation_processor->router()->disconnectPrepared(change.modulation_processor, change.source);
     voice_handler_->disableModulationConnection(change.modulation_processor);
 
     if (change.mono_destination->connectedInputs() == 1 &&
@@ -199,10 +286,40 @@ namespace vital {
     modulation_processors_.remove(change.modulation_processor);
   }
 
+  void SoundEngine::fadeOutModulation(const modulation_change& change) {
+    wake();
+    VITAL_ASSERT(fading_modulations_.size() < fading_modulations_.capacity());
+    change.modulation_processor->fadeOut();
+    fading_modulations_.push_back(change);
+  }
+
+  void SoundEngine::finishModulationFades() {
+    for (const modulation_change& change : fading_modulations_)
+      disconnectModulation(change);
+    fading_modulations_.clear();
+  }
+
   int SoundEngine::getNumActiveVoices() {
     return voice_handler_->getNumActiveVoices();
   }
 
+  int SoundEngine::getNumActiveAggregateVoices() {
+    return voice_handler_->getNumActiveAggregateVoices();
+  }
+
+  int64_t SoundEngine::getVoiceRepackPasses() const {
+    return voice_handler_->getRepackPasses();
+  }
+
+  void SoundEngine::setVoiceRepacking(bool repack_voices) {
+    voice_handler_->setVoiceRepacking(repack_voices);
+  }
+
+  void SoundEngine::setOutputArenaEnabled(bool enabled) {
+    voice_handler_->setOutputArena(enabled ? &output_arena_ : nullptr);
+    output_arena_.trim();
+  }
+
   ModulationConnectionBank& SoundEngine::getModulationBank() {
     return voice_handler_->getModulationBank();
   }
@@ -212,6 +329,7 @@ namespace vital {
   }
 
   void SoundEngine::setTuning(const Tuning* tuning) {
+    wake();
     voice_handler_->setTuning(tuning);
   }
 
@@ -233,80 +351,149 @@ namespace vital {
       oversample >>= 1;
     }
     voice_handler_->setOversampleAmount(oversample);
-    effect_chain_->setOversampleAmount(oversample);
-    output_total_->setOversampleAmount(oversample);
+
+    if (effects_at_base_rate_) {
+      effect_chain_->setOversampleAmount(1);
+      effect_chain_->setLocalOversampleAmount(oversample);
+      output_total_->setOversampleAmount(1);
+    }
+    else {
+      effect_chain_->setLocalOversampleAmount(1);
+      effect_chain_->setOversampleAmount(oversample);
+      output_total_->setOversampleAmount(oversample);
+    }
+    output_arena_.trim();
     last_oversampling_amount_ = oversampling_amount;
     last_sample_rate_ = sample_rate;
   }
 
+  bool SoundEngine::isSilent(int num_samples, int num_active_voices) {
+    if (num_active_voices || !effect_chain_->isAsleep())
+      return false;
+
+    if (utils::maxFloat(utils::peak(output()->buffer, num_samples)) > ReorderableEffectChain::kSilenceThreshold)
+      return false;
+
+    CircularQueue<ModulationConnectionProcessor*>& connections = voice_handler_->enabledModulationConnection();
+    for (ModulationConnectionProcessor* modulation : connections) {
+      if (!modulation->isInputSourcePolyphonic() && !modulation->isControlRate())
+        return false;
+    }
+    return true;
+  }
+
   void SoundEngine::process(int num_samples) {
     VITAL_ASSERT(num_samples <= output()->buffer_size);
 
+    expected_time_ += num_samples / (1.0 * getSampleRate());
+    if (wake_requested_.exchange(false)) {
+      dormant_ = false;
+      silent_samples_ = 0;
+    }
+
+    if (dormant_) {
+      dormant_blocks_++;
+      return;
+    }
+
     FloatVectorOperations::disableDenormalisedNumberSupport();
+    profiler_.beginBlock();
     voice_handler_->setLegato(legato_->value());
     ProcessorRouter::process(num_samples);
 
-    if (getNumActiveVoices() == 0) {
+    int num_active_voices = getNumActiveVoices();
+    if (num_active_voices == 0) {
       CircularQueue<ModulationConnectionProcessor*>& connections = voice_handler_->enabledModulationConnection();
       for (ModulationConnectionProcessor* modulation : connections) {
-        if (!modulation->isInputSourcePolyphonic())
+        if (!modulation->isInputSourcePolyphonic()) {
+          Profiler::Scope profile(Profiler::active(), modulation->profileId());
           modulation->process(num_samples);
+        }
       }
     }
 
     for (auto& status_source : data_->status_outputs)
       status_source.second->update();
+
+    if (isSilent(num_samples, num_active_voices))
+      silent_samples_ += num_samples;
+    else
+      silent_samples_ = 0;
+
+    if (dormant_enabled_ && silent_samples_ > kDormantDelay * getSampleRate()) {
+      dormant_ = true;
+      utils::zeroBuffer(output()->buffer, output()->buffer_size);
+    }
+
+    profiler_.endBlock(num_samples, getSampleRate(), num_active_voices);
   }
 
   void SoundEngine::correctToTime(double seconds) {
+    if (std::abs(seconds - expected_time_) > kTransportTolerance)
+      wake();
+    expected_time_ = seconds;
+
     voice_handler_->correctToTime(seconds);
     effect_chain_->correctToTime(seconds);
   }
 
   void SoundEngine::allSoundsOff() {
+    wake();
     voice_handler_->allSoundsOff();
     effect_chain_->hardReset();
     decimator_->hardReset();
+    voice_decimator_->hardReset();
+    direct_decimator_->hardReset();
   }
 
   void SoundEngine::allNotesOff(int sample) {
+    wake();
     voice_handler_->allNotesOff(sample);
   }
 
   void SoundEngine::allNotesOff(int sample, int channel) {
+    wake();
     voice_handler_->allNotesOff(channel);
   }
 
   void SoundEngine::allNotesOffRange(int sample, int from_channel, int to_channel) {
+    wake();
     voice_handler_->allNotesOffRange(sample, from_channel, to_channel);
   }
 
   void SoundEngine::noteOn(int note, mono_float velocity, int sample, int channel) {
+    wake();
     voice_handler_->noteOn(note, velocity, sample, channel);
   }
 
   void SoundEngine::noteOff(int note, mono_float lift, int sample, int channel) {
+    wake();
     voice_handler_->noteOff(note, lift, sample, channel);
   }
 
   void SoundEngine::setModWheel(mono_float value, int channel) {
+    wake();
     voice_handler_->setModWheel(value, channel);
   }
 
   void SoundEngine::setModWheelAllChannels(mono_float value) {
+    wake();
     voice_handler_->setModWheelAllChannels(value);
   }
   
   void SoundEngine::setPitchWheel(mono_float value, int channel) {
+    wake();
     voice_handler_->setPitchWheel(value, channel);
   }
 
   void SoundEngine::setZonedPitchWheel(mono_float value, int from_channel, int to_channel) {
+    wake();
     voice_handler_->setZonedPitchWheel(value, from_channel, to_channel);
   }
 
   void SoundEngine::disableUnnecessaryModSources() {
     voice_handler_->disableUnnecessaryModSources();
+    output_arena_.trim();
   }
 
   void SoundEngine::enableModSource(const std::string& source) {
@@ -326,29 +513,36 @@ namespace vital {
   }
 
   void SoundEngine::setAftertouch(mono_float note, mono_float value, int sample, int channel) {
+    wake();
     voice_handler_->setAftertouch(note, value, sample, channel);
   }
 
   void SoundEngine::setChannelAftertouch(int channel, mono_float value, int sample) {
+    wake();
     voice_handler_->setChannelAftertouch(channel, value, sample);
   }
 
   void SoundEngine::setChannelRangeAftertouch(int from_channel, int to_channel, mono_float value, int sample) {
+    wake();
     voice_handler_->setChannelRangeAftertouch(from_channel, to_channel, value, sample);
   }
 
   void SoundEngine::setChannelSlide(int channel, mono_float value, int sample) {
+    wake();
     voice_handler_->setChannelSlide(channel, value, sample);
   }
 
   void SoundEngine::setChannelRangeSlide(int from_channel, int to_channel, mono_float value, int sample) {
+    wake();
     voice_handler_->setChannelRangeSlide(from_channel, to_channel, value, sample);
   }
 
   void SoundEngine::setBpm(mono_float bpm) {
     mono_float bps = bpm / 60.0f;
-    if (bps_->value() != bps)
+    if (bps_->value() != bps) {
       bps_->set(bps);
+      wake();
+    }
   }
 
   Wavetable* SoundEngine::getWavetable(int index) {
@@ -359,39 +553,78 @@ namespace vital {
     return voice_handler_->getSample();
   }
 
+  Convolver* SoundEngine::getReverbConvolver() {
+    return effect_chain_->getReverbConvolver();
+  }
+
+  void SoundEngine::setEffectSleepEnabled(bool enabled) {
+    effect_chain_->setSleepEnabled(enabled);
+  }
+
+  void SoundEngine::setEffectsAtBaseRate(bool effects_at_base_rate) {
+    if (effects_at_base_rate_ == effects_at_base_rate)
+      return;
+
+    wake();
+    effects_at_base_rate_ = effects_at_base_rate;
+    voice_decimator_->enable(effects_at_base_rate);
+    direct_decimator_->enable(effects_at_base_rate);
+    if (effects_at_base_rate) {
+      voice_decimator_->reset(constants::kFullMask);
+      direct_decimator_->reset(constants::kFullMask);
+      effect_chain_->plug(voice_decimator_, ReorderableEffectChain::kAudio);
+      output_total_->plug(direct_decimator_, 1);
+    }
+    else {
+      effect_chain_->plug(voice_handler_, ReorderableEffectChain::kAudio);
+      output_total_->plug(voice_handler_->getDirectOutput(), 1);
+    }
+
+    setOversamplingAmount(last_oversampling_amount_, last_sample_rate_);
+    effect_chain_->hardReset();
+  }
+
   LineGenerator* SoundEngine::getLfoSource(int index) {
     return voice_handler_->getLfoSource(index);
   }
 
   void SoundEngine::sustainOn(int channel) {
+    wake();
     voice_handler_->sustainOn(channel);
   }
 
   void SoundEngine::sustainOff(int sample, int channel) {
+    wake();
     voice_handler_->sustainOff(sample, channel);
   }
 
   void SoundEngine::sostenutoOn(int channel) {
+    wake();
     voice_handler_->sostenutoOn(channel);
   }
 
   void SoundEngine::sostenutoOff(int sample, int channel) {
+    wake();
     voice_handler_->sostenutoOff(sample, channel);
   }
 
   void SoundEngine::sustainOnRange(int from_channel, int to_channel) {
+    wake();
     voice_handler_->sustainOnRange(from_channel, to_channel);
   }
 
   void SoundEngine::sustainOffRange(int sample, int from_channel, int to_channel) {
+    wake();
     voice_handler_->sustainOffRange(sample, from_channel, to_channel);
   }
 
   void SoundEngine::sostenutoOnRange(int from_channel, int to_channel) {
+    wake();
     voice_handler_->sostenutoOnRange(from_channel, to_channel);
   }
 
   void SoundEngine::sostenutoOffRange(int sample, int from_channel, int to_channel) {
+    wake();
     voice_handler_->sostenutoOffRange(sample, from_channel, to_channel);
   }
 } // namespace vital
@@ -17,13 +17,18 @@
 #pragma once
 
 #include "circular_queue.h"
+#include "output_arena.h"
 #include "synth_module.h"
 #include "note_handler.h"
 
+#include <atomic>
+#include <mutex>
+
 class LineGenerator;
 class Tuning;
 
 namespace vital {
+  class Convolver;
   class Decimator;
   class PeakMeter;
   class Sample;
@@ -40,6 +45,8 @@ namespace vital {
     public:
       static constexpr int kDefaultOversamplingAmount = 2;
       static constexpr int kDefaultSampleRate = 44100;
+      static constexpr mono_float kDormantDelay = 0.1f;
+      static constexpr double kTransportTolerance = 0.001;
 
       SoundEngine();
       virtual ~SoundEngine();
@@ -49,9 +56,36 @@ namespace vital {
       void correctToTime(double seconds) override;
 
       int getNumPressedNotes();
+
+      // Fills in the parts of a change that only depend on the engine's structure. Call it off the audio thread.
+      void prepareModulationChange(modulation_change& change) const;
+
+      // Orders the routers for a connection and publishes their schedules ahead of time, so
+      // connectModulation() only plugs inputs. Call it off the audio thread, it waits for the graph lock.
+      void compileModulationConnection(modulation_change& change);
+
+      // Connecting and disconnecting need the graph lock, or processing to be paused.
+      std::mutex& getModulationGraphMutex() { return modulation_graph_mutex_; }
       void connectModulation(const modulation_change& change);
       void disconnectModulation(const modulation_change& change);
+
+      // Ramps the connection out over the next block and disconnects it in finishModulationFades().
+      void fadeOutModulation(const modulation_change& change);
+      void finishModulationFades();
+      int getNumFadingModulations() const { return fading_modulations_.size(); }
       int getNumActiveVoices();
+      int getNumActiveAggregateVoices();
+      int64_t getVoiceRepackPasses() const;
+      void setVoiceRepacking(bool repack_voices);
+      Profiler* profiler() { return &profiler_; }
+
+      // Buffers of voice modules that are switched off are parked in the arena. Switching modules never
+      // allocates, the pool is trimmed while processing is paused when mod sources are disabled and
+      // whenever needsOutputArenaTrim() asks for it.
+      OutputArena::Report getOutputMemoryReport() const { return output_arena_.report(); }
+      void setOutputArenaEnabled(bool enabled);
+      bool needsOutputArenaTrim() { return output_arena_.needsTrim(); }
+      void trimOutputArena() { output_arena_.trim(); }
       ModulationConnectionBank& getModulationBank();
       mono_float getLastActiveNote() const;
 
@@ -82,6 +116,22 @@ namespace vital {
       void setChannelRangeSlide(int from_channel, int to_channel, mono_float value, int sample);
       Wavetable* getWavetable(int index);
       Sample* getSample();
+      Convolver* getReverbConvolver();
+      ReorderableEffectChain* getEffectChain() { return effect_chain_; }
+      void setEffectSleepEnabled(bool enabled);
+
+      // Decimates the voices before the effect chain so effects run at the base rate. The distortion keeps
+      // the voices' oversampling locally around its nonlinear stage.
+      void setEffectsAtBaseRate(bool effects_at_base_rate);
+      bool getEffectsAtBaseRate() const { return effects_at_base_rate_; }
+
+      // The engine goes dormant after kDormantDelay seconds without voices, audible effect tails or audio
+      // rate mono modulation, and skips whole blocks until a note, controller, parameter, modulation or
+      // transport change wakes it. Waking can be requested from any thread.
+      void wake() { wake_requested_ = true; }
+      void setDormantEnabled(bool enabled) { dormant_enabled_ = enabled; wake(); }
+      bool isDormant() const { return dormant_; }
+      int64_t getDormantBlocks() const { return dormant_blocks_; }
       LineGenerator* getLfoSource(int index);
 
       void sustainOn(int channel);
@@ -99,6 +149,8 @@ namespace vital {
 
     private:
       void setOversamplingAmount(int oversampling_amount, int sample_rate);
+      void compileConnection(modulation_change& change);
+      bool isSilent(int num_samples, int num_active_voices);
     
       SynthVoiceHandler* voice_handler_;
       ReorderableEffectChain* effect_chain_;
@@ -110,9 +162,29 @@ namespace vital {
       Value* bps_;
       Value* legato_;
       Decimator* decimator_;
+      Decimator* voice_decimator_;
+      Decimator* direct_decimator_;
+      bool effects_at_base_rate_;
       PeakMeter* peak_meter_;
 
       CircularQueue<Processor*> modulation_processors_;
+      CircularQueue<modulation_change> fading_modulations_;
+
+      // Connections compiled into the schedules that the audio thread hasn't plugged in yet.
+      std::mutex modulation_graph_mutex_;
+      std::vector<ProcessorRouter::Connection> pending_connections_;
+      std::vector<int> pending_connection_ids_;
+      int next_connection_id_;
+      std::atomic<int> last_connection_id_;
+      Profiler profiler_;
+      OutputArena output_arena_;
+
+      std::atomic<bool> wake_requested_;
+      bool dormant_enabled_;
+      bool dormant_;
+      int silent_samples_;
+      int64_t dormant_blocks_;
+      double expected_time_;
 
       JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SoundEngine)
   };
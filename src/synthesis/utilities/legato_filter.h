@@ -41,6 +41,10 @@ namespace vital {
 
       void process(int num_samples) override;
 
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override {
+        copy(last_value_, static_cast<const LegatoFilter*>(source)->last_value_);
+      }
+
     private:
       poly_float last_value_;
 
@@ -46,6 +46,10 @@ namespace vital {
       void processBypass(int start);
       virtual void process(int num_samples) override;
 
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override {
+        copy(position_, static_cast<const PortamentoSlope*>(source)->position_);
+      }
+
     private:
       poly_float position_;
 
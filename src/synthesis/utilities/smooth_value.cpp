@@ -16,15 +16,21 @@
 
 #include "smooth_value.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "futils.h"
 
 namespace vital {
 
-  SmoothValue::SmoothValue(mono_float value) : Value(value), current_value_(value) { }
+  SmoothValue::SmoothValue(mono_float value) : Value(value), current_value_(value), ramp_samples_(0) { }
 
   void SmoothValue::process(int num_samples) {
+    if (ramp_samples_) {
+      processRamp(num_samples);
+      return;
+    }
+
     if (utils::equal(current_value_, value_) && utils::equal(current_value_, output()->buffer[0]) &&
         utils::equal(current_value_, output()->buffer[num_samples - 1])) {
       enable(false);
@@ -64,10 +70,41 @@ namespace vital {
       dest[i] = current_value_;
   }
 
+  void SmoothValue::processRamp(int num_samples) {
+    int ramp_samples = std::min(num_samples, ramp_samples_);
+    poly_float current_value = current_value_;
+    poly_float delta_value = (value_ - current_value) * (1.0f / ramp_samples_);
+    ramp_samples_ -= ramp_samples;
+    current_value_ = ramp_samples_ ? current_value + delta_value * ramp_samples : value_;
+
+    poly_float* dest = output()->buffer;
+    for (int i = 0; i < ramp_samples; ++i) {
+      current_value += delta_value;
+      dest[i] = current_value;
+    }
+    if (ramp_samples_ == 0)
+      dest[ramp_samples - 1] = value_;
+    for (int i = ramp_samples; i < num_samples; ++i)
+      dest[i] = current_value_;
+  }
+
   namespace cr {
-    SmoothValue::SmoothValue(mono_float value) : Value(value), current_value_(value) { }
+    SmoothValue::SmoothValue(mono_float value) : Value(value), current_value_(value), ramp_samples_(0) { }
 
     void SmoothValue::process(int num_samples) {
+      if (ramp_samples_) {
+        if (num_samples < ramp_samples_) {
+          current_value_ += (value_ - current_value_) * (num_samples * 1.0f / ramp_samples_);
+          ramp_samples_ -= num_samples;
+        }
+        else {
+          current_value_ = value_;
+          ramp_samples_ = 0;
+        }
+        output()->buffer[0] = current_value_;
+        return;
+      }
+
       mono_float decay = futils::exp(-2.0f * kPi * kSmoothCutoff * num_samples / getSampleRate());
       current_value_ = utils::interpolate(value_, current_value_, decay);
       output()->buffer[0] = current_value_;
@@ -33,19 +33,36 @@ namespace vital {
       virtual void process(int num_samples) override;
       void linearInterpolate(int num_samples, poly_mask linear_mask);
 
+      void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override {
+        copy(current_value_, static_cast<const SmoothValue*>(source)->current_value_);
+      }
+
       void set(poly_float value) override {
         enable(true);
         value_ = value;
+        ramp_samples_ = 0;
+      }
+
+      void ramp(poly_float value, int num_samples) override {
+        enable(true);
+        value_ = value;
+        ramp_samples_ = num_samples * getOversampleAmount();
       }
 
       void setHard(poly_float value) {
         enable(true);
         Value::set(value);
         current_value_ = value;
+        ramp_samples_ = 0;
       }
 
+      void settle() override { setHard(value_); }
+
     private:
+      void processRamp(int num_samples);
+
       poly_float current_value_;
+      int ramp_samples_;
   };
 
   namespace cr {
@@ -61,13 +78,35 @@ namespace vital {
 
         virtual void process(int num_samples) override;
 
+        void copyVoiceState(const Processor* source, const VoiceLaneCopy& copy) override {
+          copy(current_value_, static_cast<const SmoothValue*>(source)->current_value_);
+        }
+
+        void set(poly_float value) override {
+          Value::set(value);
+          ramp_samples_ = 0;
+        }
+
+        void ramp(poly_float value, int num_samples) override {
+          value_ = value;
+          ramp_samples_ = num_samples * getOversampleAmount();
+        }
+
         void setHard(mono_float value) {
           Value::set(value);
           current_value_ = value;
+          ramp_samples_ = 0;
+        }
+
+        void settle() override {
+          Value::set(value_);
+          current_value_ = value_;
+          ramp_samples_ = 0;
         }
 
       private:
         poly_float current_value_;
+        int ramp_samples_;
 
         JUCE_LEAK_DETECTOR(SmoothValue)
     };
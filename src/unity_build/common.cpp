@@ -25,8 +25,13 @@
 #include "synth_gui_interface.cpp"
 #include "synth_parameters.cpp"
 #include "load_save.cpp"
+#include "binary_preset.cpp"
+#include "preset_index.cpp"
+#include "profile_report.cpp"
 #include "synth_types.cpp"
+#include "engine_telemetry.cpp"
 #include "synth_base.cpp"
+#include "fourier_transform.cpp"
 #include "wavetable_component_factory.cpp"
 #include "wavetable_keyframe.cpp"
 #include "file_source.cpp"
@@ -34,6 +39,7 @@
 #include "frequency_filter_modifier.cpp"
 #include "wave_fold_modifier.cpp"
 #include "phase_modifier.cpp"
+#include "wavetable_cache.cpp"
 #include "wavetable_creator.cpp"
 #include "wave_line_source.cpp"
 #include "wave_source.cpp"
@@ -28,6 +28,7 @@
 #include "formant_manager.cpp"
 #include "dirty_filter.cpp"
 #include "iir_halfband_decimator.cpp"
+#include "iir_halfband_upsampler.cpp"
 #include "sallen_key_filter.cpp"
 #include "phaser_filter.cpp"
 #include "ladder_filter.cpp"
@@ -38,6 +39,9 @@
 #include "utils.cpp"
 #include "feedback.cpp"
 #include "voice_handler.cpp"
+#include "worker_pool.cpp"
+#include "profiler.cpp"
+#include "output_arena.cpp"
 #include "processor.cpp"
 #include "synth_module.cpp"
 #include "operators.cpp"
@@ -77,6 +81,7 @@
 #include "distortion.cpp"
 #include "compressor.cpp"
 #include "delay.cpp"
+#include "convolver.cpp"
 #include "reverb.cpp"
 #include "sound_engine.cpp"
 #include "synth_voice_handler.cpp"
@@ -0,0 +1,232 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "binary_preset_test.h"
+#include "binary_preset.h"
+#include "load_save.h"
+#include "synth_base.h"
+#include "synth_constants.h"
+#include "utils.h"
+#include "wave_frame.h"
+#include "wave_source.h"
+#include "wavetable.h"
+#include "wavetable_creator.h"
+#include "wavetable_group.h"
+
+namespace {
+  constexpr int kNumWavetables = 3;
+  constexpr int kNumKeyframes = 64;
+  constexpr int kWaveformSize = 2048;
+  constexpr int kSampleLength = 44100;
+  constexpr int kBinarySeed = 0xb1a5;
+
+  std::string randomPayload(Random& random, int num_bytes) {
+    MemoryBlock data(num_bytes);
+    random.fillBitsRandomly(data.getData(), data.getSize());
+    return Base64::toBase64(data.getData(), data.getSize()).toStdString();
+  }
+
+  json createPresetState(Random& random) {
+    json wavetables;
+    for (int w = 0; w < kNumWavetables; ++w) {
+      json keyframes;
+      for (int k = 0; k < kNumKeyframes; ++k) {
+        keyframes.push_back({
+          { "position", k * 4 },
+          { "wave_data", randomPayload(random, kWaveformSize * sizeof(float)) }
+        });
+      }
+
+      json component = { { "type", "Wave Source" }, { "interpolation", 1 }, { "keyframes", keyframes } };
+      json group = { { "components", json::array({ component }) } };
+      wavetables.push_back({ { "name", "Random " + std::to_string(w) }, { "groups", json::array({ group }) } });
+    }
+
+    json sample = {
+      { "name", "Noise" },
+      { "length", kSampleLength },
+      { "sample_rate", 44100 },
+      { "samples", randomPayload(random, kSampleLength * sizeof(int16_t)) },
+      { "samples_stereo", randomPayload(random, kSampleLength * sizeof(int16_t)) }
+    };
+
+    json settings = { { "osc_1_level", random.nextDouble() }, { "filter_1_cutoff", 60.0 + random.nextDouble() },
+                      { "wavetables", wavetables }, { "sample", sample } };
+
+    // Not a payload field so it has to stay Base64 text even though it decodes.
+    return { { "synth_version", "1.0.0" }, { "preset_name", "QUJDRA==" }, { "comments", "Binary round trip" },
+             { "settings", settings } };
+  }
+
+  json createWavetableState(Random& random) {
+    json keyframes;
+    float wave[vital::WaveFrame::kWaveformSize];
+    for (int k = 0; k < kNumKeyframes; ++k) {
+      for (float& sample : wave)
+        sample = 2.0f * random.nextFloat() - 1.0f;
+
+      keyframes.push_back({
+        { "position", k * 4 },
+        { "wave_data", Base64::toBase64(wave, sizeof(wave)).toStdString() }
+      });
+    }
+
+    json component = { { "type", "Wave Source" }, { "interpolation", 1 }, { "keyframes", keyframes } };
+    json group = { { "components", json::array({ component }) } };
+    return { { "name", "Random" }, { "version", ProjectInfo::versionString }, { "groups", json::array({ group }) } };
+  }
+} // namespace
+
+void BinaryPresetTest::roundTrip() {
+  beginTest("Round Trip");
+
+  Random random(kBinarySeed);
+  json state = createPresetState(random);
+  std::string text = state.dump();
+
+  MemoryOutputStream stream;
+  expect(BinaryPreset::writeToStream(state, stream));
+  expect(BinaryPreset::isBinaryPreset(stream.getData(), stream.getDataSize()));
+  expect(!BinaryPreset::isBinaryPreset(text.data(), text.size()));
+  expect(stream.getDataSize() < text.size());
+
+  json loaded;
+  expect(BinaryPreset::readFromMemory(stream.getData(), stream.getDataSize(), loaded));
+  const json& wave_data = loaded["settings"]["wavetables"][0]["groups"][0]["components"][0]["keyframes"][0]["wave_data"];
+  expect(vital::utils::isRawDataString(wave_data.get_ref<const std::string&>()),
+         "Binary preset payload wasn't loaded as raw bytes.");
+  BinaryPreset::encodePayloads(loaded);
+  expect(loaded == state, "Binary preset didn't convert back to the same json.");
+  expect(loaded.dump() == text);
+  expect(!BinaryPreset::readFromMemory(stream.getData(), BinaryPreset::kHeaderSize, loaded));
+
+  double start = Time::getMillisecondCounterHiRes();
+  json parsed = json::parse(text);
+  double json_time = Time::getMillisecondCounterHiRes() - start;
+
+  start = Time::getMillisecondCounterHiRes();
+  BinaryPreset::readFromMemory(stream.getData(), stream.getDataSize(), loaded);
+  double binary_time = Time::getMillisecondCounterHiRes() - start;
+
+  logMessage("json: " + String(text.size() / 1024) + " KB, " + String(json_time, 3) + " ms parse");
+  logMessage("binary: " + String(static_cast<int>(stream.getDataSize() / 1024)) + " KB, " +
+             String(binary_time, 3) + " ms parse");
+}
+
+void BinaryPresetTest::stateBuffer() {
+  beginTest("State Buffer");
+
+  Random random(kBinarySeed);
+  json wavetable_state = createWavetableState(random);
+  vital::Wavetable wavetable(vital::kNumOscillatorWaveFrames);
+  WavetableCreator creator(&wavetable);
+  MemoryOutputStream stream;
+  json loaded_state;
+  expect(BinaryPreset::writeToStream(wavetable_state, stream));
+  expect(BinaryPreset::readFromMemory(stream.getData(), stream.getDataSize(), loaded_state));
+  creator.jsonToState(loaded_state);
+  expect(creator.getStateHash() == 0);
+
+  double start = Time::getMillisecondCounterHiRes();
+  json saved = creator.stateToJson();
+  double first_time = Time::getMillisecondCounterHiRes() - start;
+
+  start = Time::getMillisecondCounterHiRes();
+  json saved_again = creator.stateToJson();
+  double cached_time = Time::getMillisecondCounterHiRes() - start;
+
+  expect(saved == saved_again);
+  json& keyframes = saved["groups"][0]["components"][0]["keyframes"];
+  json& original_keyframes = wavetable_state["groups"][0]["components"][0]["keyframes"];
+  expect(keyframes.size() == original_keyframes.size());
+  for (int k = 0; k < kNumKeyframes; ++k)
+    expect(keyframes[k]["wave_data"] == original_keyframes[k]["wave_data"], "Waveform changed on save.");
+
+  uint64_t hash = LoadSave::hashJson(saved);
+  expect(hash != 0 && hash == LoadSave::hashJson(saved_again));
+  creator.setStateHash(hash);
+  creator.render();
+  expect(creator.getStateHash() == 0, "Rendering didn't invalidate the state hash.");
+
+  WaveSource* source = dynamic_cast<WaveSource*>(creator.getGroup(0)->getComponent(0));
+  expect(source != nullptr);
+  source->getWaveFrame(3)->time_domain[7] = 0.25f;
+  json edited = creator.stateToJson();
+  json& edited_keyframes = edited["groups"][0]["components"][0]["keyframes"];
+  expect(edited_keyframes[3]["wave_data"] != keyframes[3]["wave_data"], "Edited waveform wasn't encoded again.");
+  expect(edited_keyframes[2]["wave_data"] == keyframes[2]["wave_data"]);
+  expect(LoadSave::hashJson(edited) != hash);
+
+  json state = { { "settings", { { "wavetables", json::array({ edited }) }, { "osc_1_level", 0.5 } } } };
+  std::vector<uint8_t> buffer;
+  BinaryPreset::StateWriter writer(buffer);
+  writer.writeJson(state);
+  writer.finish();
+  const uint8_t* buffer_data = buffer.data();
+  BinaryPreset::StateWriter writer_again(buffer);
+  writer_again.writeJson(state);
+  writer_again.finish();
+  expect(buffer.data() == buffer_data, "State buffer was reallocated for the same state.");
+
+  json loaded;
+  expect(BinaryPreset::readFromMemory(buffer.data(), buffer.size(), loaded));
+  expect(loaded == state);
+
+  logMessage("wavetable save: " + String(first_time, 3) + " ms, cached: " + String(cached_time, 3) + " ms");
+}
+
+void BinaryPresetTest::synthState() {
+  beginTest("Synth State");
+
+  HeadlessSynth synth;
+  synth.getControls()["osc_1_level"]->set(0.25f);
+  json extra_fields;
+  extra_fields["tuning"] = synth.getTuning()->stateToJson();
+
+  LoadSave::StateBuffers buffers;
+  LoadSave::stateToBuffer(&synth, extra_fields, buffers);
+  std::vector<uint8_t> first_state = buffers.state;
+
+  json loaded;
+  expect(BinaryPreset::readFromMemory(buffers.state.data(), buffers.state.size(), loaded));
+  BinaryPreset::encodePayloads(loaded);
+  json expected = LoadSave::stateToJson(&synth, synth.getCriticalSection());
+  expected["tuning"] = extra_fields["tuning"];
+  expect(loaded == expected, "Streamed state doesn't match the json state.");
+
+  LoadSave::stateToBuffer(&synth, extra_fields, buffers);
+  expect(buffers.state == first_state);
+
+  // Swapping the kept encoding shows whether an unchanged wavetable is encoded again.
+  BinaryPreset::encodeValue("kept", buffers.wavetables[0]);
+  LoadSave::stateToBuffer(&synth, extra_fields, buffers);
+  expect(BinaryPreset::readFromMemory(buffers.state.data(), buffers.state.size(), loaded));
+  expect(loaded["settings"]["wavetables"][0] == "kept", "Unchanged wavetable was encoded again.");
+
+  synth.getWavetableCreator(0)->render();
+  expect(synth.getWavetableCreator(0)->getStateHash() == 0);
+  LoadSave::stateToBuffer(&synth, extra_fields, buffers);
+  expect(buffers.state == first_state, "Edited wavetable wasn't encoded again.");
+  expect(synth.getWavetableCreator(0)->getStateHash() != 0);
+}
+
+void BinaryPresetTest::runTest() {
+  roundTrip();
+  stateBuffer();
+  synthState();
+}
+
+static BinaryPresetTest binary_preset_test;
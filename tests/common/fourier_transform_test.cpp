@@ -0,0 +1,65 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fourier_transform_test.h"
+#include "fourier_transform.h"
+#include "wave_frame.h"
+
+#include <complex>
+
+namespace {
+  constexpr int kBits = vital::WaveFrame::kWaveformBits;
+  constexpr int kSize = 1 << kBits;
+  constexpr float kMaxError = 0.0005f;
+
+  void randomize(float* data, int size) {
+    Random random(size);
+    for (int i = 0; i < size; ++i)
+      data[i] = 2.0f * random.nextFloat() - 1.0f;
+  }
+} // namespace
+
+void FourierTransformTest::compareToDft() {
+  beginTest("Compare To DFT");
+
+  float data[2 * kSize];
+  float original[kSize];
+  randomize(original, kSize);
+  memcpy(data, original, sizeof(original));
+  memset(data + kSize, 0, kSize * sizeof(float));
+
+  vital::FourierTransform* transform = vital::FFT<kBits>::transform();
+  transform->transformRealForward(data);
+
+  for (int k = 0; k <= kSize / 2; ++k) {
+    std::complex<double> expected = 0.0;
+    for (int s = 0; s < kSize; ++s)
+      expected += std::polar((double)original[s], -2.0 * MathConstants<double>::pi * k * s / kSize);
+
+    float error = std::abs(std::complex<float>(data[2 * k], data[2 * k + 1]) - std::complex<float>(expected));
+    expect(error < kMaxError * std::sqrt(kSize), "Forward transform differs from DFT at bin " + String(k));
+  }
+
+  transform->transformRealInverse(data);
+  for (int s = 0; s < kSize; ++s)
+    expect(std::abs(data[s] - original[s]) < kMaxError, "Inverse transform didn't recover input.");
+}
+
+void FourierTransformTest::runTest() {
+  compareToDft();
+}
+
+static FourierTransformTest fourier_transform_test;
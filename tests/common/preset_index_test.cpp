@@ -0,0 +1,180 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "preset_index_test.h"
+#include "binary_preset.h"
+#include "preset_index.h"
+#include "synth_constants.h"
+
+namespace {
+  constexpr int kNumIndexPresets = 200;
+  constexpr int kSettingsSize = 2000;
+  constexpr int kIndexSeed = 0x1dec;
+
+  json createIndexPreset(Random& random, int index) {
+    json settings;
+    for (int i = 0; i < kSettingsSize; ++i)
+      settings["param_" + std::to_string(i)] = random.nextDouble();
+    // Metadata keys inside the settings must not leak into the index.
+    settings["author"] = "Settings Author";
+
+    json tags = json::array({ "tag" + std::to_string(index % 7), "shared" });
+    return { { "author", "Author " + std::to_string(index % 13) },
+             { "preset_style", index % 2 ? "Bass" : "Lead" },
+             { "comments", "Comment " + std::to_string(index) },
+             { "tags", tags },
+             { "settings", settings } };
+  }
+
+  File getPresetFile(const File& directory, int index) {
+    File folder = directory.getChildFile("Folder " + String(index % 4));
+    return folder.getChildFile("Preset " + String(index) + "." + vital::kPresetExtension);
+  }
+
+  void writePreset(const File& file, const json& data) {
+    file.getParentDirectory().createDirectory();
+    file.replaceWithText(data.dump());
+  }
+
+  // Never started, only used to ask update() to stop.
+  class StoppedThread : public Thread {
+    public:
+      StoppedThread() : Thread("Stopped Preset Index Thread") { signalThreadShouldExit(); }
+      void run() override { }
+  };
+} // namespace
+
+void PresetIndexTest::incrementalUpdate() {
+  beginTest("Incremental Update");
+
+  File directory = File::createTempFile("preset_index_test");
+  directory.createDirectory();
+  File index_file = directory.getSiblingFile(directory.getFileName() + ".presetindex");
+
+  Random random(kIndexSeed);
+  for (int i = 0; i < kNumIndexPresets; ++i)
+    writePreset(getPresetFile(directory, i), createIndexPreset(random, i));
+
+  PresetIndex::Entry entry;
+  expect(PresetIndex::readEntry(getPresetFile(directory, 3), entry));
+  expect(entry.name == "Preset 3");
+  expect(entry.author == "Author 3");
+  expect(entry.style == "Bass");
+  expect(entry.comments == "Comment 3");
+  expect(entry.tags.size() == 2 && entry.tags[0] == "tag3" && entry.tags[1] == "shared");
+
+  double start = Time::getMillisecondCounterHiRes();
+  PresetIndex index(index_file, { directory });
+  expect(!index.isReady());
+  expect(index.update());
+  double full_time = Time::getMillisecondCounterHiRes() - start;
+  expect(index.isReady());
+  expect(index.getNumPresets() == kNumIndexPresets);
+  expect(index_file.existsAsFile());
+
+  start = Time::getMillisecondCounterHiRes();
+  expect(!index.update(), "Unchanged presets were re-read.");
+  double incremental_time = Time::getMillisecondCounterHiRes() - start;
+
+  File changed = getPresetFile(directory, 5);
+  json changed_data = createIndexPreset(random, 5);
+  changed_data["author"] = "Someone Else";
+  writePreset(changed, changed_data);
+  getPresetFile(directory, 6).deleteFile();
+  File added = getPresetFile(directory, kNumIndexPresets);
+  writePreset(added, createIndexPreset(random, kNumIndexPresets));
+
+  expect(index.update());
+  expect(index.getNumPresets() == kNumIndexPresets);
+  expect(index.getEntry(changed, entry) && entry.author == "Someone Else");
+  expect(!index.getEntry(getPresetFile(directory, 6), entry));
+  expect(index.getEntry(added, entry) && entry.comments == "Comment " + std::to_string(kNumIndexPresets));
+
+  File touched = getPresetFile(directory, 7);
+  touched.setLastModificationTime(touched.getLastModificationTime() - RelativeTime::hours(1.0));
+  expect(index.update(), "A new modification time didn't re-read the preset.");
+
+  File binary = getPresetFile(directory, 8);
+  json binary_data = createIndexPreset(random, 8);
+  binary_data["author"] = "Binary Author";
+  expect(BinaryPreset::writeToFile(binary_data, binary));
+  expect(index.update());
+  expect(index.getEntry(binary, entry) && entry.author == "Binary Author");
+
+  PresetIndex reloaded(index_file, { directory });
+  expect(!reloaded.update(), "Saved index didn't match the presets on disk.");
+  expect(reloaded.getNumPresets() == kNumIndexPresets);
+  expect(reloaded.getEntry(changed, entry) && entry.author == "Someone Else");
+  expect(entry.tags.size() == 2 && entry.tags[1] == "shared");
+
+  Array<File> presets;
+  reloaded.getPresets(presets);
+  expect(presets.size() == kNumIndexPresets);
+  expect(presets.contains(added) && !presets.contains(getPresetFile(directory, 6)));
+
+  logMessage("full scan: " + String(full_time, 3) + " ms, unchanged scan: " + String(incremental_time, 3) + " ms");
+
+  directory.deleteRecursively();
+  index_file.deleteFile();
+}
+
+void PresetIndexTest::interruptedUpdate() {
+  beginTest("Interrupted Update");
+
+  File directory = File::createTempFile("preset_index_test");
+  directory.createDirectory();
+  File index_file = directory.getSiblingFile(directory.getFileName() + ".presetindex");
+
+  Random random(kIndexSeed);
+  for (int i = 0; i < kNumIndexPresets; ++i)
+    writePreset(getPresetFile(directory, i), createIndexPreset(random, i));
+
+  StoppedThread stopped;
+  PresetIndex index(index_file, { directory });
+  expect(index.update(&stopped));
+  expectEquals(index.getNumPresets(), 1);
+
+  PresetIndex reloaded(index_file, { directory });
+  expect(reloaded.update(&stopped));
+  expectEquals(reloaded.getNumPresets(), 2, "Partial scan wasn't saved.");
+
+  expect(index.update());
+  expectEquals(index.getNumPresets(), kNumIndexPresets);
+
+  File changed = getPresetFile(directory, 9);
+  json changed_data = createIndexPreset(random, 9);
+  changed_data["author"] = "Someone Else";
+  writePreset(changed, changed_data);
+  getPresetFile(directory, 10).deleteFile();
+
+  PresetIndex::Entry entry;
+  expect(index.update(&stopped));
+  expectEquals(index.getNumPresets(), kNumIndexPresets, "Interrupted scan dropped presets it didn't get to.");
+  expect(index.getEntry(changed, entry) && entry.author == "Someone Else");
+
+  expect(index.update());
+  expectEquals(index.getNumPresets(), kNumIndexPresets - 1);
+
+  directory.deleteRecursively();
+  index_file.deleteFile();
+}
+
+void PresetIndexTest::runTest() {
+  incrementalUpdate();
+  interruptedUpdate();
+}
+
+static PresetIndexTest preset_index_test;
@@ -0,0 +1,104 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "line_renderer_test.h"
+#include "open_gl_line_renderer.h"
+
+namespace {
+  constexpr int kLineTestPoints = 64;
+  constexpr int kLineTestRounds = 200;
+  constexpr int kLineTestWidth = 400;
+  constexpr int kLineTestHeight = 200;
+  constexpr float kLineTestTolerance = 0.0001f;
+} // namespace
+
+void LineRendererTest::expectMatchesFullUpdate(OpenGlLineRenderer& renderer) {
+  std::unique_ptr<float[]> partial_line = std::make_unique<float[]>(renderer.numLineFloats());
+  std::unique_ptr<float[]> partial_fill = std::make_unique<float[]>(renderer.numFillFloats());
+  memcpy(partial_line.get(), renderer.lineData(), renderer.numLineFloats() * sizeof(float));
+  memcpy(partial_fill.get(), renderer.fillData(), renderer.numFillFloats() * sizeof(float));
+
+  renderer.setLineVertices(true);
+  renderer.setFillVertices(true);
+
+  for (int i = 0; i < renderer.numLineFloats(); ++i)
+    expectWithinAbsoluteError(partial_line[i], renderer.lineData()[i], kLineTestTolerance);
+  for (int i = 0; i < renderer.numFillFloats(); ++i)
+    expectWithinAbsoluteError(partial_fill[i], renderer.fillData()[i], kLineTestTolerance);
+}
+
+void LineRendererTest::testPartialUpdates(bool loop) {
+  OpenGlLineRenderer renderer(kLineTestPoints, loop);
+  renderer.setColour(Skin::kBody, Colours::black);
+  renderer.setBounds(0, 0, kLineTestWidth, kLineTestHeight);
+  renderer.setBoostAmount(1.0f);
+
+  for (int i = 0; i < kLineTestPoints; ++i) {
+    renderer.setXAt(i, kLineTestWidth * i / (kLineTestPoints - 1.0f));
+    renderer.setYAt(i, rand() % kLineTestHeight);
+  }
+
+  int start = 0;
+  int end = 0;
+  expect(renderer.updateDirtyVertices(true, start, end));
+  expectEquals(start, 0);
+  expectEquals(end, kLineTestPoints);
+  expect(!renderer.updateDirtyVertices(true, start, end), "Unchanged line still dirty");
+
+  for (int round = 0; round < kLineTestRounds; ++round) {
+    int num_changes = 1 + rand() % 3;
+    for (int i = 0; i < num_changes; ++i) {
+      int index = rand() % kLineTestPoints;
+      int decision = rand() % 4;
+      if (decision == 0 && index > 0)
+        renderer.setYAt(index, renderer.yAt(index - 1));
+      else if (decision == 1)
+        renderer.setBoostLeft(index, rand() / (1.0f * RAND_MAX));
+      else
+        renderer.setYAt(index, rand() % kLineTestHeight);
+    }
+
+    // Repeated points carry the previous direction forward, so collapse a few into each other.
+    if (round % 10 == 0) {
+      int index = 1 + rand() % (kLineTestPoints - 4);
+      for (int i = 1; i < 3; ++i) {
+        renderer.setXAt(index + i, renderer.xAt(index));
+        renderer.setYAt(index + i, renderer.yAt(index));
+      }
+    }
+
+    if (renderer.updateDirtyVertices(true, start, end)) {
+      expect(start >= 0 && start < end && end <= kLineTestPoints);
+      expectMatchesFullUpdate(renderer);
+    }
+  }
+
+  renderer.setYAt(kLineTestPoints / 2, renderer.yAt(kLineTestPoints / 2));
+  expect(!renderer.updateDirtyVertices(true, start, end), "Setting the same value dirtied the line");
+}
+
+void LineRendererTest::runTest() {
+  MessageManager::getInstance();
+  MessageManagerLock lock;
+
+  beginTest("Partial Updates");
+  testPartialUpdates(false);
+
+  beginTest("Partial Updates Looping");
+  testPartialUpdates(true);
+}
+
+static LineRendererTest line_renderer_test;
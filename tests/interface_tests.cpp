@@ -26,6 +26,7 @@
 #include "interface/full_interface_test.cpp"
 #include "interface/interface_test.cpp"
 #include "interface/lfo_section_test.cpp"
+#include "interface/line_renderer_test.cpp"
 #include "interface/oscillator_advanced_section_test.cpp"
 #include "interface/oscillator_section_test.cpp"
 #include "interface/phaser_section_test.cpp"
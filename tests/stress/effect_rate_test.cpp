@@ -0,0 +1,207 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "effect_rate_test.h"
+#include "decimator.h"
+#include "distortion.h"
+#include "distortion_module.h"
+#include "engine_test_setup.h"
+#include "reorderable_effect_chain.h"
+#include "sound_engine.h"
+#include "synth_constants.h"
+
+namespace {
+  constexpr int kRateNote = 48;
+  constexpr int kRateWarmupBlocks = 40;
+  constexpr int kRateTimedBlocks = 200;
+  constexpr int kRateBlocks = kRateWarmupBlocks + kRateTimedBlocks;
+  constexpr int kOversamplingSetting = 2;
+  constexpr int kOversampleAmount = 1 << kOversamplingSetting;
+  constexpr int kRateSampleRate = 44100;
+  constexpr int kAnalysisSize = 4096;
+  constexpr int kSineBin = 511;
+  constexpr float kSineAmplitude = 0.5f;
+  constexpr float kClipDrive = 12.0f;
+  constexpr const char* kRateEffects[] = {
+    "chorus_on", "compressor_on", "delay_on", "distortion_on", "eq_on",
+    "filter_fx_on", "flanger_on", "phaser_on", "reverb_on"
+  };
+
+  enum RateLayout {
+    kOversampledChain,
+    kBaseRateChain,
+    kBaseRateLocalOversampling,
+    kNumRateLayouts
+  };
+
+  void setupRateEngine(vital::SoundEngine& engine) {
+    engine.setDormantEnabled(false);
+    engine.setEffectSleepEnabled(false);
+    engine_test::setupSawEngine(engine);
+
+    vital::control_map controls = engine.getControls();
+    controls["oversampling"]->set(kOversamplingSetting);
+    for (const char* effect_on : kRateEffects)
+      controls[effect_on]->set(1.0f);
+
+    engine.checkOversampling();
+  }
+
+  // Renders kRateBlocks blocks and returns how many samples the effect chain processed. The average time of
+  // the blocks after the warmup goes in block_time.
+  int64_t renderEngineBlocks(vital::SoundEngine& engine, double& block_time) {
+    int64_t start_samples = engine.getEffectChain()->getProcessedSamples();
+    for (int i = 0; i < kRateWarmupBlocks; ++i)
+      engine.process(vital::kMaxBufferSize);
+
+    double start = Time::getMillisecondCounterHiRes();
+    for (int i = 0; i < kRateTimedBlocks; ++i)
+      engine.process(vital::kMaxBufferSize);
+    block_time = (Time::getMillisecondCounterHiRes() - start) / kRateTimedBlocks;
+    return engine.getEffectChain()->getProcessedSamples() - start_samples;
+  }
+
+  // Runs a sine through a hard clipping distortion module in the given layout and returns the left channel.
+  std::vector<float> renderClippedSine(RateLayout layout) {
+    int module_oversample = layout == kOversampledChain ? kOversampleAmount : 1;
+
+    vital::DistortionModule distortion;
+    distortion.init();
+    distortion.setOversampleAmount(module_oversample);
+    if (layout == kBaseRateLocalOversampling)
+      distortion.setLocalOversampleAmount(kOversampleAmount);
+    distortion.setSampleRate(kRateSampleRate);
+
+    vital::control_map controls = distortion.getControls();
+    controls["distortion_type"]->set(vital::Distortion::kHardClip);
+    controls["distortion_drive"]->set(kClipDrive);
+
+    vital::Decimator decimator(3);
+    decimator.plug(distortion.output());
+    decimator.init();
+    decimator.setSampleRate(kRateSampleRate);
+
+    int block_samples = vital::kMaxBufferSize * module_oversample;
+    std::unique_ptr<vital::poly_float[]> audio_in = std::make_unique<vital::poly_float[]>(block_samples);
+    double phase_delta = 2.0 * vital::kPi * kSineBin / (kAnalysisSize * module_oversample);
+
+    int num_blocks = kRateWarmupBlocks + kAnalysisSize / vital::kMaxBufferSize;
+    std::vector<float> result;
+    for (int block = 0; block < num_blocks; ++block) {
+      for (int i = 0; i < block_samples; ++i) {
+        int64 sample = static_cast<int64>(block) * block_samples + i;
+        audio_in[i] = kSineAmplitude * std::sin(phase_delta * (sample % (kAnalysisSize * module_oversample)));
+      }
+
+      distortion.processWithInput(audio_in.get(), block_samples);
+      const vital::poly_float* audio_out = distortion.output()->buffer;
+      if (layout == kOversampledChain) {
+        decimator.process(vital::kMaxBufferSize);
+        audio_out = decimator.output()->buffer;
+      }
+
+      if (block >= kRateWarmupBlocks) {
+        for (int i = 0; i < vital::kMaxBufferSize; ++i)
+          result.push_back(audio_out[i][0]);
+      }
+    }
+    return result;
+  }
+
+  double binPower(const std::vector<float>& audio, int bin) {
+    double real = 0.0;
+    double imaginary = 0.0;
+    for (int i = 0; i < kAnalysisSize; ++i) {
+      double phase = 2.0 * vital::kPi * ((static_cast<int64>(bin) * i) % kAnalysisSize) / kAnalysisSize;
+      real += audio[i] * std::cos(phase);
+      imaginary -= audio[i] * std::sin(phase);
+    }
+    double scale = bin == 0 ? 1.0 : 2.0;
+    return scale * (real * real + imaginary * imaginary) / (1.0 * kAnalysisSize * kAnalysisSize);
+  }
+
+  // Power that isn't at a harmonic of the input relative to the power that is. Harmonics above Nyquist fold
+  // back onto bins between the harmonics since the sine repeats exactly within the analysis window.
+  double aliasingRatio(const std::vector<float>& audio) {
+    double total_power = 0.0;
+    for (int i = 0; i < kAnalysisSize; ++i)
+      total_power += audio[i] * audio[i];
+    total_power /= kAnalysisSize;
+
+    double harmonic_power = 0.0;
+    for (int bin = kSineBin; bin < kAnalysisSize / 2; bin += kSineBin)
+      harmonic_power += binPower(audio, bin);
+
+    double alias_power = std::max(total_power - harmonic_power - binPower(audio, 0), 0.0);
+    return alias_power / harmonic_power;
+  }
+} // namespace
+
+void EffectRateTest::chainCost() {
+  vital::SoundEngine engine;
+  setupRateEngine(engine);
+  engine.noteOn(kRateNote, 1.0f, 0, 0);
+
+  int64_t base_rate_samples = static_cast<int64_t>(kRateBlocks) * vital::kMaxBufferSize;
+  int64_t oversampled_samples = kOversampleAmount * base_rate_samples;
+
+  double oversampled_time = 0.0;
+  expectEquals(renderEngineBlocks(engine, oversampled_time), oversampled_samples);
+  expect(vital::utils::isFinite(engine.output()->buffer, vital::kMaxBufferSize));
+
+  engine.setEffectsAtBaseRate(true);
+  expect(engine.getEffectChain()->getOversampleAmount() == 1);
+  double base_rate_time = 0.0;
+  expectEquals(renderEngineBlocks(engine, base_rate_time), base_rate_samples);
+  expect(vital::utils::isFinite(engine.output()->buffer, vital::kMaxBufferSize));
+  expect(vital::utils::maxFloat(vital::utils::peak(engine.output()->buffer, vital::kMaxBufferSize)) > 0.0f);
+
+  engine.setEffectsAtBaseRate(false);
+  expect(engine.getEffectChain()->getOversampleAmount() == kOversampleAmount);
+  double restored_time = 0.0;
+  expectEquals(renderEngineBlocks(engine, restored_time), oversampled_samples);
+  expect(vital::utils::isFinite(engine.output()->buffer, vital::kMaxBufferSize));
+
+  logMessage("Block with all effects at " + String(kOversampleAmount) + "x: " + String(oversampled_time, 3) +
+             " ms, effects at base rate: " + String(base_rate_time, 3) + " ms");
+}
+
+void EffectRateTest::distortionAliasing() {
+  double ratios[kNumRateLayouts];
+  for (int i = 0; i < kNumRateLayouts; ++i) {
+    std::vector<float> audio = renderClippedSine(static_cast<RateLayout>(i));
+    expect(static_cast<int>(audio.size()) == kAnalysisSize);
+    ratios[i] = aliasingRatio(audio);
+  }
+
+  expect(ratios[kBaseRateLocalOversampling] < 0.5 * ratios[kBaseRateChain]);
+
+  logMessage("Hard clip aliasing relative to harmonics, chain at " + String(kOversampleAmount) + "x: " +
+             String(10.0 * std::log10(ratios[kOversampledChain]), 1) + " dB, base rate: " +
+             String(10.0 * std::log10(ratios[kBaseRateChain]), 1) + " dB, base rate with local " +
+             String(kOversampleAmount) + "x: " +
+             String(10.0 * std::log10(ratios[kBaseRateLocalOversampling]), 1) + " dB");
+}
+
+void EffectRateTest::runTest() {
+  beginTest("Chain Cost");
+  chainCost();
+
+  beginTest("Distortion Aliasing");
+  distortionAliasing();
+}
+
+static EffectRateTest effect_rate_test;
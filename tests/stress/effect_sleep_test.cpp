@@ -0,0 +1,152 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "effect_sleep_test.h"
+#include "engine_test_setup.h"
+#include "reorderable_effect_chain.h"
+#include "sound_engine.h"
+#include "synth_constants.h"
+
+namespace {
+  constexpr int kSleepNote = 60;
+  constexpr int kNoteBlocks = 40;
+  constexpr int kMaxTailSeconds = 30;
+  constexpr int kSleepingBlocks = 100;
+  constexpr int kIdleBlocks = 200;
+  constexpr int kNumSleepEffects = 4;
+  constexpr vital::constants::Effect kSleepEffects[kNumSleepEffects] = {
+    vital::constants::kChorus, vital::constants::kDelay, vital::constants::kPhaser, vital::constants::kReverb
+  };
+
+  void setupSleepEngine(vital::SoundEngine& engine) {
+    engine.setDormantEnabled(false);
+    engine_test::setupSawEngine(engine);
+
+    vital::control_map controls = engine.getControls();
+    controls["chorus_on"]->set(1.0f);
+    controls["delay_on"]->set(1.0f);
+    controls["phaser_on"]->set(1.0f);
+    controls["reverb_on"]->set(1.0f);
+  }
+
+  bool allSleeping(vital::ReorderableEffectChain* chain) {
+    for (vital::constants::Effect effect : kSleepEffects) {
+      if (!chain->isSleeping(effect))
+        return false;
+    }
+    return true;
+  }
+
+  float outputPeak(vital::SoundEngine& engine) {
+    return vital::utils::maxFloat(vital::utils::peak(engine.output()->buffer, vital::kMaxBufferSize));
+  }
+} // namespace
+
+void EffectSleepTest::sleepsAfterTail() {
+  vital::SoundEngine engine;
+  setupSleepEngine(engine);
+  engine.getControls()["reverb_decay_time"]->set(-2.0f);
+  vital::ReorderableEffectChain* chain = engine.getEffectChain();
+
+  engine.noteOn(kSleepNote, 1.0f, 0, 0);
+  for (int i = 0; i < kNoteBlocks; ++i)
+    engine.process(vital::kMaxBufferSize);
+  expect(outputPeak(engine) > 0.0f);
+  expect(!allSleeping(chain));
+  engine.noteOff(kSleepNote, 0.0f, 0, 0);
+
+  int max_blocks = kMaxTailSeconds * engine.getSampleRate() / vital::kMaxBufferSize;
+  int tail_blocks = 0;
+  bool tail_audible = false;
+  while (!allSleeping(chain) && tail_blocks < max_blocks) {
+    engine.process(vital::kMaxBufferSize);
+    tail_audible = tail_audible || outputPeak(engine) > vital::ReorderableEffectChain::kSilenceThreshold;
+    tail_blocks++;
+  }
+  expect(allSleeping(chain), "Effects still awake after " + String(kMaxTailSeconds) + " seconds");
+  expect(tail_audible);
+
+  int64 skipped = chain->getSkippedBlocks();
+  for (int i = 0; i < kSleepingBlocks; ++i) {
+    engine.process(vital::kMaxBufferSize);
+    expect(outputPeak(engine) == 0.0f);
+  }
+  expect(allSleeping(chain));
+  expectEquals<int64>(chain->getSkippedBlocks() - skipped, kNumSleepEffects * kSleepingBlocks);
+  for (vital::constants::Effect effect : kSleepEffects)
+    expect(chain->getSkippedBlocks(effect) >= kSleepingBlocks);
+
+  engine.noteOn(kSleepNote, 1.0f, 0, 0);
+  engine.process(vital::kMaxBufferSize);
+  expect(outputPeak(engine) > 0.0f, "Output stayed silent after the note started");
+  for (vital::constants::Effect effect : kSleepEffects)
+    expect(!chain->isSleeping(effect));
+
+  for (int i = 0; i < kNoteBlocks; ++i)
+    engine.process(vital::kMaxBufferSize);
+  expect(vital::utils::isFinite(engine.output()->buffer, vital::kMaxBufferSize));
+  expect(outputPeak(engine) > 0.0f);
+
+  logMessage("Slept " + String(tail_blocks) + " blocks after note off, " +
+             String(chain->getSkippedBlocks()) + " effect blocks skipped of " +
+             String(chain->getProcessedBlocks()) + " chain blocks");
+}
+
+void EffectSleepTest::idleCost() {
+  vital::SoundEngine engine;
+  setupSleepEngine(engine);
+  vital::ReorderableEffectChain* chain = engine.getEffectChain();
+
+  engine.noteOn(kSleepNote, 1.0f, 0, 0);
+  engine.process(vital::kMaxBufferSize);
+  engine.noteOff(kSleepNote, 0.0f, 0, 0);
+  while (engine.getNumActiveVoices())
+    engine.process(vital::kMaxBufferSize);
+
+  int64 skipped = chain->getSkippedBlocks();
+  double start = Time::getMillisecondCounterHiRes();
+  for (int i = 0; i < kIdleBlocks; ++i)
+    engine.process(vital::kMaxBufferSize);
+  double awake_time = Time::getMillisecondCounterHiRes() - start;
+  expect(!allSleeping(chain));
+  int64 awake_skipped = chain->getSkippedBlocks() - skipped;
+
+  int max_blocks = kMaxTailSeconds * engine.getSampleRate() / vital::kMaxBufferSize;
+  for (int i = 0; i < max_blocks && !allSleeping(chain); ++i)
+    engine.process(vital::kMaxBufferSize);
+  expect(allSleeping(chain));
+
+  skipped = chain->getSkippedBlocks();
+  start = Time::getMillisecondCounterHiRes();
+  for (int i = 0; i < kIdleBlocks; ++i)
+    engine.process(vital::kMaxBufferSize);
+  double sleeping_time = Time::getMillisecondCounterHiRes() - start;
+  expectEquals<int64>(chain->getSkippedBlocks() - skipped, kNumSleepEffects * kIdleBlocks);
+
+  logMessage("Idle block with effects awake: " + String(awake_time / kIdleBlocks, 3) + " ms, " +
+             String(awake_skipped) + " effect blocks skipped, sleeping: " +
+             String(sleeping_time / kIdleBlocks, 3) + " ms");
+}
+
+void EffectSleepTest::runTest() {
+  beginTest("Sleeps After Tail");
+  sleepsAfterTail();
+
+  beginTest("Idle Cost");
+  idleCost();
+}
+
+static EffectSleepTest effect_sleep_test;
@@ -0,0 +1,135 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "engine_dormant_test.h"
+#include "engine_test_setup.h"
+#include "reorderable_effect_chain.h"
+#include "sound_engine.h"
+#include "synth_constants.h"
+
+namespace {
+  constexpr int kDormantNote = 48;
+  constexpr int kDormantNoteBlocks = 20;
+  constexpr int kMaxDormantSeconds = 30;
+  constexpr int kDormantBlocks = 200;
+  constexpr int kWakeOffset = 37;
+
+  void setupDormantEngine(vital::SoundEngine& engine) {
+    engine_test::setupSawEngine(engine);
+
+    vital::control_map controls = engine.getControls();
+    controls["delay_on"]->set(1.0f);
+    controls["reverb_on"]->set(1.0f);
+    controls["reverb_decay_time"]->set(-2.0f);
+  }
+
+  bool processUntilDormant(vital::SoundEngine& engine) {
+    int max_blocks = kMaxDormantSeconds * engine.getSampleRate() / vital::kMaxBufferSize;
+    for (int i = 0; i < max_blocks && !engine.isDormant(); ++i)
+      engine.process(vital::kMaxBufferSize);
+    return engine.isDormant();
+  }
+
+  float dormantPeak(vital::SoundEngine& engine, int start, int end) {
+    return vital::utils::maxFloat(vital::utils::peak(engine.output()->buffer + start, end - start));
+  }
+} // namespace
+
+void EngineDormantTest::wakesOnNote() {
+  vital::SoundEngine engine;
+  setupDormantEngine(engine);
+
+  engine.noteOn(kDormantNote, 1.0f, 0, 0);
+  for (int i = 0; i < kDormantNoteBlocks; ++i) {
+    engine.process(vital::kMaxBufferSize);
+    expect(!engine.isDormant());
+  }
+  engine.noteOff(kDormantNote, 0.0f, 0, 0);
+  expect(processUntilDormant(engine), "Engine still awake after " + String(kMaxDormantSeconds) + " seconds");
+
+  int64 dormant_blocks = engine.getDormantBlocks();
+  double start = Time::getMillisecondCounterHiRes();
+  for (int i = 0; i < kDormantBlocks; ++i) {
+    engine.process(vital::kMaxBufferSize);
+    expect(dormantPeak(engine, 0, vital::kMaxBufferSize) == 0.0f);
+  }
+  double dormant_time = Time::getMillisecondCounterHiRes() - start;
+  expect(engine.isDormant());
+  expectEquals<int64>(engine.getDormantBlocks() - dormant_blocks, kDormantBlocks);
+
+  engine.noteOn(kDormantNote, 1.0f, kWakeOffset, 0);
+  engine.process(vital::kMaxBufferSize);
+  expect(!engine.isDormant());
+  // Effect tails that were below the silence threshold when we went dormant pick up where they left off.
+  float pre_note_peak = dormantPeak(engine, 0, kWakeOffset);
+  expect(pre_note_peak <= vital::ReorderableEffectChain::kSilenceThreshold,
+         "Output started before the note: " + String(pre_note_peak));
+  expect(dormantPeak(engine, kWakeOffset, vital::kMaxBufferSize) > 0.0f, "Output stayed silent after the note");
+
+  dormant_blocks = engine.getDormantBlocks();
+  start = Time::getMillisecondCounterHiRes();
+  for (int i = 0; i < kDormantBlocks; ++i)
+    engine.process(vital::kMaxBufferSize);
+  double awake_time = Time::getMillisecondCounterHiRes() - start;
+  expectEquals<int64>(engine.getDormantBlocks(), dormant_blocks, "Engine skipped blocks while a note played");
+
+  logMessage("Dormant block: " + String(1000.0 * dormant_time / kDormantBlocks, 2) + " us, playing block: " +
+             String(1000.0 * awake_time / kDormantBlocks, 2) + " us");
+}
+
+void EngineDormantTest::wakesOnTransport() {
+  vital::SoundEngine engine;
+  setupDormantEngine(engine);
+  double sample_time = 1.0 / engine.getSampleRate();
+  double time = 0.0;
+
+  engine.noteOn(kDormantNote, 1.0f, 0, 0);
+  engine.process(vital::kMaxBufferSize);
+  engine.noteOff(kDormantNote, 0.0f, 0, 0);
+  expect(processUntilDormant(engine));
+
+  for (int i = 0; i < kDormantBlocks; ++i) {
+    engine.correctToTime(time);
+    engine.process(vital::kMaxBufferSize);
+    time += vital::kMaxBufferSize * sample_time;
+  }
+  expect(engine.isDormant(), "Continuous transport woke the engine");
+
+  time += 1.0;
+  engine.correctToTime(time);
+  engine.process(vital::kMaxBufferSize);
+  expect(!engine.isDormant(), "Transport jump didn't wake the engine");
+  expect(processUntilDormant(engine));
+
+  engine.setBpm(140.0f);
+  engine.process(vital::kMaxBufferSize);
+  expect(!engine.isDormant(), "Tempo change didn't wake the engine");
+  expect(processUntilDormant(engine));
+
+  engine.wake();
+  engine.process(vital::kMaxBufferSize);
+  expect(!engine.isDormant());
+}
+
+void EngineDormantTest::runTest() {
+  beginTest("Wakes On Note");
+  wakesOnNote();
+
+  beginTest("Wakes On Transport");
+  wakesOnTransport();
+}
+
+static EngineDormantTest engine_dormant_test;
@@ -0,0 +1,157 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "engine_telemetry_test.h"
+#include "engine_telemetry.h"
+#include "memory.h"
+#include "sound_engine.h"
+#include "synth_module.h"
+#include "triple_buffer.h"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+  constexpr int kTelemetryValues = 256;
+  constexpr int kTelemetryPublishes = 200000;
+  constexpr int kTelemetryNote = 60;
+  constexpr int kTelemetryBlocks = 8;
+
+  struct TelemetryBlock {
+    int values[kTelemetryValues];
+  };
+} // namespace
+
+void EngineTelemetryTest::snapshotsDontTear() {
+  vital::TripleBuffer<TelemetryBlock> buffer;
+  for (int i = 0; i < 3; ++i)
+    memset(buffer.getBuffer(i).values, 0, sizeof(TelemetryBlock));
+
+  expect(!buffer.consume());
+
+  std::atomic<bool> done(false);
+  std::thread producer([&buffer, &done] {
+    for (int i = 1; i <= kTelemetryPublishes; ++i) {
+      TelemetryBlock& block = buffer.getWriteBuffer();
+      for (int v = 0; v < kTelemetryValues; ++v)
+        block.values[v] = i;
+      buffer.publish();
+    }
+    done = true;
+  });
+
+  int last_value = 0;
+  int torn = 0;
+  int backwards = 0;
+  int consumed = 0;
+  bool finished = false;
+  while (!finished) {
+    finished = done;
+    if (!buffer.consume())
+      continue;
+
+    consumed++;
+    const TelemetryBlock& block = buffer.getReadBuffer();
+    for (int v = 1; v < kTelemetryValues; ++v) {
+      if (block.values[v] != block.values[0])
+        torn++;
+    }
+    if (block.values[0] < last_value)
+      backwards++;
+    last_value = block.values[0];
+  }
+  producer.join();
+
+  expectEquals(torn, 0, "Consumer saw a partially written snapshot");
+  expectEquals(backwards, 0, "Consumer saw an older snapshot after a newer one");
+  expectEquals(last_value, kTelemetryPublishes, "Consumer missed the last snapshot");
+  expect(consumed > 0);
+  expect(!buffer.consume());
+}
+
+void EngineTelemetryTest::readoutsFollowEngine() {
+  vital::SoundEngine engine;
+  vital::StereoMemory audio_memory(vital::kAudioMemorySamples);
+  EngineTelemetry telemetry;
+  telemetry.init(&engine, &audio_memory);
+
+  const vital::StatusOutput* voices = telemetry.getStatusOutput("num_voices");
+  const vital::StatusOutput* live_voices = engine.getStatusOutput("num_voices");
+  expect(voices != nullptr && live_voices != nullptr);
+  expect(voices != live_voices, "Interface read the engine's status output directly");
+  expect(telemetry.getStatusOutput("not_a_status_output") == nullptr);
+
+  vital::output_map& live_modulations = engine.getMonoModulations();
+  const vital::output_map& modulations = telemetry.getMonoModulations();
+  expectEquals(modulations.size(), live_modulations.size());
+  for (auto& modulation : modulations)
+    expect(modulation.second != live_modulations[modulation.first]);
+  expectEquals(telemetry.getPolyModulations().size(), engine.getPolyModulations().size());
+
+  expect(!telemetry.consume());
+
+  vital::poly_float oscilloscope[2 * vital::kOscilloscopeMemoryResolution];
+  for (int i = 0; i < 2 * vital::kOscilloscopeMemoryResolution; ++i)
+    oscilloscope[i] = i;
+
+  engine.noteOn(kTelemetryNote, 1.0f, 0, 0);
+  for (int b = 0; b < kTelemetryBlocks; ++b) {
+    engine.process(vital::kMaxBufferSize);
+    for (int i = 0; i < vital::kMaxBufferSize; ++i)
+      audio_memory.push(engine.output()->buffer[i]);
+    telemetry.publish(vital::kMaxBufferSize, oscilloscope, 1);
+  }
+
+  expect(live_voices->value()[0] > 0.0f);
+  expectEquals(voices->value()[0], 0.0f, "Readout changed before the interface consumed a snapshot");
+  expectEquals(telemetry.getOscilloscopeMemory()[3][0], 0.0f);
+
+  expect(telemetry.consume());
+  expect(telemetry.getVersion() > 0);
+  expectEquals(voices->value()[0], live_voices->value()[0]);
+  expectEquals(telemetry.getOscilloscopeMemory()[3][0], 3.0f);
+
+  for (auto& modulation : modulations) {
+    vital::Output* live = live_modulations[modulation.first];
+    expectEquals(modulation.second->trigger_value[0], live->trigger_value[0]);
+    expectEquals(modulation.second->trigger_value[1], live->trigger_value[1]);
+    expect(modulation.second->owner->enabled() == live->owner->enabled());
+  }
+
+  // Publishing is rate limited, so force one through to line up the audio ring's head.
+  telemetry.publish(engine.getSampleRate(), oscilloscope, 1);
+  expect(telemetry.consume());
+  expect(!telemetry.consume());
+
+  float expected[vital::kMaxBufferSize];
+  float read[vital::kMaxBufferSize];
+  audio_memory.readSamples(expected, vital::kMaxBufferSize, 0, 0);
+  for (int i = 0; i < vital::kMaxBufferSize; ++i)
+    audio_memory.push(0.0f);
+  telemetry.getAudioMemory()->readSamples(read, vital::kMaxBufferSize, 0, 0);
+  for (int i = 0; i < vital::kMaxBufferSize; ++i)
+    expectEquals(read[i], expected[i]);
+}
+
+void EngineTelemetryTest::runTest() {
+  beginTest("Snapshots Don't Tear");
+  snapshotsDontTear();
+
+  beginTest("Readouts Follow Engine");
+  readoutsFollowEngine();
+}
+
+static EngineTelemetryTest engine_telemetry_test;
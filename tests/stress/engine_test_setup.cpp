@@ -0,0 +1,34 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "engine_test_setup.h"
+#include "sound_engine.h"
+#include "wave_frame.h"
+#include "wavetable.h"
+
+namespace engine_test {
+  void setupSawEngine(vital::SoundEngine& engine, int num_wavetables) {
+    vital::control_map controls = engine.getControls();
+    for (int i = 0; i < num_wavetables; ++i) {
+      vital::Wavetable* wavetable = engine.getWavetable(i);
+      wavetable->loadDefaultWavetable();
+      wavetable->loadWaveFrame(vital::PredefinedWaveFrames::getWaveFrame(vital::PredefinedWaveFrames::kSaw));
+      controls["osc_" + std::to_string(i + 1) + "_random_phase"]->set(0.0f);
+    }
+
+    controls["osc_1_on"]->set(1.0f);
+  }
+} // namespace engine_test
@@ -0,0 +1,91 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fourier_benchmark_test.h"
+#include "fourier_transform.h"
+#include "kissfft/kissfft.h"
+#include "wave_frame.h"
+
+#include <complex>
+
+namespace {
+  constexpr int kBenchmarkBits = vital::WaveFrame::kWaveformBits;
+  constexpr int kBenchmarkSize = 1 << kBenchmarkBits;
+  constexpr int kBenchmarkIterations = 2000;
+
+  // What the Linux build used before: a complex kissfft of the zero padded input.
+  double timeKissFft(float* data) {
+    kissfft<float> forward(kBenchmarkSize, false);
+    kissfft<float> inverse(kBenchmarkSize, true);
+    std::unique_ptr<std::complex<float>[]> input = std::make_unique<std::complex<float>[]>(kBenchmarkSize);
+    std::unique_ptr<std::complex<float>[]> output = std::make_unique<std::complex<float>[]>(kBenchmarkSize);
+
+    int64 start = Time::getHighResolutionTicks();
+    for (int i = 0; i < kBenchmarkIterations; ++i) {
+      for (int s = 0; s < kBenchmarkSize; ++s)
+        input[s] = data[s];
+      forward.transform(input.get(), output.get());
+      inverse.transform(output.get(), input.get());
+      for (int s = 0; s < kBenchmarkSize; ++s)
+        data[s] = input[s].real() * (1.0f / kBenchmarkSize);
+    }
+    return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+  }
+
+  double timeJuceFft(float* data) {
+    dsp::FFT fft(kBenchmarkBits);
+
+    int64 start = Time::getHighResolutionTicks();
+    for (int i = 0; i < kBenchmarkIterations; ++i) {
+      fft.performRealOnlyForwardTransform(data, true);
+      fft.performRealOnlyInverseTransform(data);
+    }
+    return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+  }
+
+  double timeVitalFft(float* data) {
+    vital::FourierTransform* transform = vital::FFT<kBenchmarkBits>::transform();
+
+    int64 start = Time::getHighResolutionTicks();
+    for (int i = 0; i < kBenchmarkIterations; ++i) {
+      transform->transformRealForward(data);
+      transform->transformRealInverse(data);
+    }
+    return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+  }
+} // namespace
+
+void FourierBenchmarkTest::runTest() {
+  beginTest("Forward And Inverse");
+
+  float data[2 * kBenchmarkSize];
+  Random random(kBenchmarkSize);
+  for (int s = 0; s < kBenchmarkSize; ++s)
+    data[s] = 2.0f * random.nextFloat() - 1.0f;
+  memset(data + kBenchmarkSize, 0, kBenchmarkSize * sizeof(float));
+
+  double kiss_time = timeKissFft(data);
+  double juce_time = timeJuceFft(data);
+  double vital_time = timeVitalFft(data);
+  for (int s = 0; s < kBenchmarkSize; ++s)
+    expect(std::isfinite(data[s]));
+
+  double scale = 1000000.0 / kBenchmarkIterations;
+  logMessage("2048 point forward + inverse, kissfft: " + String(kiss_time * scale, 2) + " us, juce: " +
+             String(juce_time * scale, 2) + " us, vital: " + String(vital_time * scale, 2) + " us");
+}
+
+static FourierBenchmarkTest fourier_benchmark_test;
@@ -19,12 +19,20 @@
 #include "synth_types.h"
 #include "synth_parameters.h"
 #include "modulation_connection_processor.h"
+#include "synth_base.h"
 
 namespace {
   constexpr int kProcessAmount = 35;
   constexpr int kNumSamples = vital::kMaxBufferSize;
   constexpr float kLargeModulationAmount = 1000.0f;
   constexpr int kModulationHookupNumber = 35;
+  constexpr int kBurstRounds = 10;
+  constexpr int kPlaybackNotes = 8;
+  constexpr int kPlaybackLowestNote = 48;
+  constexpr int kPlaybackWarmupBlocks = 8;
+  constexpr int kPlaybackBlocks = 600;
+  constexpr int kMaxEditsPerBlock = 4;
+  constexpr int kRandomSeed = 0x5ced;
   const std::string kDefaultConnection = "osc_1_level";
 
   vital::modulation_change createModulationChange(vital::ModulationConnection* connection, vital::SoundEngine* engine) {
@@ -40,9 +48,17 @@ namespace {
     change.poly_modulation_switch = engine->getPolyModulationSwitch(connection->destination_name);
     change.poly_destination = engine->getPolyModulationDestination(connection->destination_name);
     change.modulation_processor = connection->modulation_processor.get();
+    engine->prepareModulationChange(change);
     return change;
   }
 
+  class ModulationSynth : public HeadlessSynth {
+    public:
+      using SynthBase::processModulationChanges;
+      using SynthBase::flushModulationChanges;
+      using SynthBase::getConnection;
+  };
+
   void turnEverythingOn(vital::SoundEngine* engine) {
     std::map<std::string, vital::ValueDetails> parameters = vital::Parameters::lookup_.getAllDetails();
     vital::control_map controls = engine->getControls();
@@ -227,9 +243,260 @@ void ModulationStressTest::randomModulations() {
   }
 }
 
+void ModulationStressTest::worstCaseBlockTime() {
+  beginTest("Worst Case Block Time");
+
+  ModulationSynth synth;
+  vital::SoundEngine* engine = synth.getEngine();
+  turnEverythingOn(engine);
+  engine->noteOn(60, 1.0f, 0, 0);
+  processAndCheckFinite(engine);
+
+  std::vector<std::string> sources;
+  for (auto& source_iter : engine->getModulationSources())
+    sources.push_back(source_iter.first);
+  std::vector<std::string> destinations;
+  for (auto& destination_iter : engine->getMonoModulationDestinations())
+    destinations.push_back(destination_iter.first);
+
+  for (int m = 0; m < vital::kMaxModulationConnections; ++m) {
+    std::string source = sources[(m * 7) % sources.size()];
+    synth.connectModulation(source, destinations[(m * 13) % destinations.size()]);
+  }
+
+  std::vector<std::pair<std::string, std::string>> connections;
+  for (vital::ModulationConnection* connection : synth.getModulationConnections())
+    connections.emplace_back(connection->source_name, connection->destination_name);
+  for (auto& connection : connections)
+    synth.disconnectModulation(connection.first, connection.second);
+  synth.flushModulationChanges();
+
+  int num_changes = static_cast<int>(connections.size());
+  int blocks_per_pass = (num_changes + vital::kMaxModulationChangesPerBlock - 1) / vital::kMaxModulationChangesPerBlock;
+  expect(blocks_per_pass > 1);
+
+  double burst_apply = 0.0;
+  double burst_block = 0.0;
+  double budget_apply = 0.0;
+  double budget_block = 0.0;
+  for (int round = 0; round < kBurstRounds; ++round) {
+    for (auto& connection : connections)
+      synth.connectModulation(connection.first, connection.second);
+    double start = Time::getMillisecondCounterHiRes();
+    synth.flushModulationChanges();
+    double applied = Time::getMillisecondCounterHiRes();
+    engine->process(kNumSamples);
+    double end = Time::getMillisecondCounterHiRes();
+    burst_apply = std::max(burst_apply, applied - start);
+    burst_block = std::max(burst_block, end - start);
+
+    for (auto& connection : connections)
+      synth.disconnectModulation(connection.first, connection.second);
+    synth.flushModulationChanges();
+    engine->process(kNumSamples);
+
+    // Connections queued past the budget would still be waiting when the disconnections start fading.
+    for (auto& connection : connections)
+      synth.connectModulation(connection.first, connection.second);
+    for (int b = 0; b < blocks_per_pass; ++b) {
+      start = Time::getMillisecondCounterHiRes();
+      synth.processModulationChanges();
+      applied = Time::getMillisecondCounterHiRes();
+      engine->process(kNumSamples);
+      end = Time::getMillisecondCounterHiRes();
+      budget_apply = std::max(budget_apply, applied - start);
+      budget_block = std::max(budget_block, end - start);
+      expect(vital::utils::isFinite(engine->output()->buffer, kNumSamples));
+    }
+
+    for (auto& connection : connections)
+      synth.disconnectModulation(connection.first, connection.second);
+    for (int b = 0; b <= blocks_per_pass; ++b) {
+      int remaining = num_changes - b * vital::kMaxModulationChangesPerBlock;
+      start = Time::getMillisecondCounterHiRes();
+      synth.processModulationChanges();
+      applied = Time::getMillisecondCounterHiRes();
+      expectEquals(engine->getNumFadingModulations(),
+                   std::max(0, std::min(remaining, vital::kMaxModulationChangesPerBlock)));
+      engine->process(kNumSamples);
+      end = Time::getMillisecondCounterHiRes();
+      budget_apply = std::max(budget_apply, applied - start);
+      budget_block = std::max(budget_block, end - start);
+      expect(vital::utils::isFinite(engine->output()->buffer, kNumSamples));
+    }
+  }
+
+  logMessage(String(num_changes) + " connections in one block: " + String(burst_apply, 3) + " ms to apply, " +
+             String(burst_block, 3) + " ms worst block");
+  logMessage(String(vital::kMaxModulationChangesPerBlock) + " per block: " + String(budget_apply, 3) +
+             " ms to apply, " + String(budget_block, 3) + " ms worst block");
+}
+
+void ModulationStressTest::fadeIn() {
+  beginTest("Fade In");
+
+  ModulationSynth synth;
+  vital::SoundEngine* engine = synth.getEngine();
+  turnEverythingOn(engine);
+  engine->noteOn(60, 1.0f, 0, 0);
+  processAndCheckFinite(engine);
+
+  std::string source;
+  std::string destination;
+  for (auto& source_iter : engine->getModulationSources()) {
+    if (source.empty() && !source_iter.second->isControlRate())
+      source = source_iter.first;
+  }
+  for (auto& destination_iter : engine->getMonoModulationDestinations()) {
+    vital::Processor* poly_destination = engine->getPolyModulationDestination(destination_iter.first);
+    if (destination.empty() && !engine->getMonoModulationDestination(destination_iter.first)->isControlRate() &&
+        (poly_destination == nullptr || !poly_destination->isControlRate())) {
+      destination = destination_iter.first;
+    }
+  }
+  expect(!source.empty() && !destination.empty());
+  if (source.empty() || destination.empty())
+    return;
+
+  synth.connectModulation(source, destination);
+  vital::ModulationConnection* connection = synth.getConnection(source, destination);
+  vital::ModulationConnectionProcessor* processor = connection->modulation_processor.get();
+  processor->setBaseValue(1.0f);
+  processor->setBipolar(true);
+  for (int i = 0; i < kProcessAmount; ++i)
+    engine->process(kNumSamples);
+
+  synth.processModulationChanges();
+  expect(!processor->isControlRate());
+
+  processor->process(kNumSamples);
+  const vital::poly_float* buffer = processor->output(vital::ModulationConnectionProcessor::kModulationOutput)->buffer;
+  float first = std::abs(buffer[0][0]);
+  float last = std::abs(buffer[kNumSamples - 1][0]);
+  expect(last > 0.0f);
+  expect(first < 2.0f * last / kNumSamples);
+
+  processor->process(kNumSamples);
+  expectWithinAbsoluteError(std::abs(buffer[0][0]), last, last * 0.01f);
+}
+
+void ModulationStressTest::connectDuringPlayback() {
+  beginTest("Connect During Playback");
+
+  Random random(kRandomSeed);
+  vital::SoundEngine engine;
+  vital::control_map controls = engine.getControls();
+  controls["polyphony"]->set(kPlaybackNotes);
+
+  std::vector<std::string> sources;
+  std::vector<std::string> destinations;
+  for (auto& source : engine.getModulationSources())
+    sources.push_back(source.first);
+  for (auto& destination : engine.getMonoModulationDestinations())
+    destinations.push_back(destination.first);
+
+  for (int i = 0; i < kPlaybackNotes; ++i)
+    engine.noteOn(kPlaybackLowestNote + 2 * i, 1.0f, 0, 0);
+
+  for (int i = 0; i < kPlaybackWarmupBlocks; ++i)
+    engine.process(vital::kMaxBufferSize);
+
+  vital::ModulationConnectionBank& modulation_bank = engine.getModulationBank();
+  std::vector<vital::ModulationConnection*> connections;
+  double quiet_worst = 0.0;
+  double quiet_total = 0.0;
+  double edit_worst = 0.0;
+  double edit_total = 0.0;
+  int quiet_blocks = 0;
+  int edit_blocks = 0;
+  int num_edits = 0;
+
+  for (int block = 0; block < kPlaybackBlocks; ++block) {
+    int edits = (block % 2) ? random.nextInt(kMaxEditsPerBlock + 1) : 0;
+
+    // Connections are compiled off the audio thread, only applying them is timed.
+    std::vector<vital::modulation_change> changes;
+    for (int e = 0; e < edits; ++e) {
+      bool connect = connections.empty() || (connections.size() < vital::kMaxModulationConnections &&
+                                             random.nextBool());
+      if (connect) {
+        std::string source = sources[random.nextInt(static_cast<int>(sources.size()))];
+        std::string destination = destinations[random.nextInt(static_cast<int>(destinations.size()))];
+        vital::ModulationConnection* connection = modulation_bank.createConnection(source, destination);
+        if (connection == nullptr)
+          connection = modulation_bank.createConnection(source, kDefaultConnection);
+        if (connection == nullptr)
+          continue;
+
+        connection->modulation_processor->setBaseValue(random.nextFloat() * 2.0f - 1.0f);
+        vital::modulation_change change = createModulationChange(connection, &engine);
+        change.disconnecting = false;
+        engine.compileModulationConnection(change);
+        changes.push_back(change);
+        connections.push_back(connection);
+      }
+      else {
+        int index = random.nextInt(static_cast<int>(connections.size()));
+        vital::ModulationConnection* connection = connections[index];
+        vital::modulation_change change = createModulationChange(connection, &engine);
+        change.disconnecting = true;
+        changes.push_back(change);
+        connection->source_name = "";
+        connection->destination_name = "";
+        connections.erase(connections.begin() + index);
+      }
+      num_edits++;
+    }
+
+    int64 start = Time::getHighResolutionTicks();
+    for (const vital::modulation_change& change : changes) {
+      if (change.disconnecting)
+        engine.disconnectModulation(change);
+      else
+        engine.connectModulation(change);
+    }
+
+    engine.process(vital::kMaxBufferSize);
+    double seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+    expect(vital::utils::isFinite(engine.output()->buffer, vital::kMaxBufferSize));
+
+    if (edits) {
+      edit_worst = std::max(edit_worst, seconds);
+      edit_total += seconds;
+      edit_blocks++;
+    }
+    else {
+      quiet_worst = std::max(quiet_worst, seconds);
+      quiet_total += seconds;
+      quiet_blocks++;
+    }
+  }
+
+  for (vital::ModulationConnection* connection : connections) {
+    vital::modulation_change change = createModulationChange(connection, &engine);
+    change.disconnecting = true;
+    engine.disconnectModulation(change);
+    connection->source_name = "";
+    connection->destination_name = "";
+  }
+
+  engine.process(vital::kMaxBufferSize);
+  expect(vital::utils::isFinite(engine.output()->buffer, vital::kMaxBufferSize));
+  expect(num_edits > 0);
+
+  logMessage(String(num_edits) + " edits over " + String(edit_blocks) + " blocks");
+  logMessage("Blocks with edits: " + String(1000.0 * edit_total / std::max(1, edit_blocks), 3) + " ms mean, " +
+             String(1000.0 * edit_worst, 3) + " ms worst");
+  logMessage("Blocks without edits: " + String(1000.0 * quiet_total / std::max(1, quiet_blocks), 3) + " ms mean, " +
+             String(1000.0 * quiet_worst, 3) + " ms worst");
+}
+
 void ModulationStressTest::runTest() {
   allModulations();
   randomModulations();
+  worstCaseBlockTime();
+  fadeIn();
+  connectDuringPlayback();
 }
 
 static ModulationStressTest modulation_stress_test;
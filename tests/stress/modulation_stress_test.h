@@ -27,6 +27,9 @@ class ModulationStressTest : public UnitTest {
     void runTest() override;
     void allModulations();
     void randomModulations();
+    void worstCaseBlockTime();
+    void fadeIn();
+    void connectDuringPlayback();
     void processAndCheckFinite(vital::Processor* processor);
 };
 
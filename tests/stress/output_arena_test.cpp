@@ -0,0 +1,219 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "output_arena_test.h"
+#include "engine_test_setup.h"
+#include "output_arena.h"
+#include "sound_engine.h"
+#include "synth_constants.h"
+
+namespace {
+  constexpr int kArenaNote = 60;
+  constexpr int kArenaWavetables = 2;
+  constexpr int kArenaPrimeBlocks = 8;
+  constexpr int kArenaBlocks = 100;
+  constexpr int kToggleBlocks = 4;
+  constexpr float kMaxArenaError = 1e-4f;
+  constexpr const char* kToggledModules[] = { "osc_2_on", "filter_2_on" };
+  constexpr const char* kReserveModules[] = { "osc_2_on", "osc_3_on", "filter_2_on", "sample_on" };
+
+  void setModules(vital::SoundEngine& engine, bool on) {
+    vital::control_map controls = engine.getControls();
+    for (const char* module_on : kToggledModules)
+      controls[module_on]->set(on ? 1.0f : 0.0f);
+  }
+
+  std::vector<float> renderNote(vital::SoundEngine& engine) {
+    std::vector<float> audio;
+    engine.noteOn(kArenaNote, 1.0f, 0, 0);
+    for (int i = 0; i < kArenaBlocks; ++i) {
+      engine.process(vital::kMaxBufferSize);
+      const vital::Output* output = engine.output();
+      for (int s = 0; s < vital::kMaxBufferSize; ++s) {
+        audio.push_back(output->buffer[s][0]);
+        audio.push_back(output->buffer[s][1]);
+      }
+    }
+    engine.noteOff(kArenaNote, 0.5f, 0, 0);
+    return audio;
+  }
+
+  // Plays and stops a note so modules that are off have been processed and handed their buffers back.
+  void primeVoices(vital::SoundEngine& engine) {
+    engine.noteOn(kArenaNote, 1.0f, 0, 0);
+    for (int i = 0; i < kArenaPrimeBlocks; ++i)
+      engine.process(vital::kMaxBufferSize);
+    engine.allSoundsOff();
+    engine.process(vital::kMaxBufferSize);
+  }
+
+  String kilobytes(size_t bytes) {
+    return String(bytes / 1024.0, 1) + " kB";
+  }
+} // namespace
+
+void OutputArenaTest::unusedModules() {
+  vital::SoundEngine engine;
+  engine_test::setupSawEngine(engine, kArenaWavetables);
+  renderNote(engine);
+
+  vital::OutputArena::Report report = engine.getOutputMemoryReport();
+  expect(report.num_outputs > 0);
+  expect(report.num_released > 0);
+  expect(report.num_released < report.num_outputs);
+  expect(report.released_bytes > 0);
+  expect(report.active_bytes > 0);
+  expect(vital::utils::isFinite(engine.output()->buffer, vital::kMaxBufferSize));
+
+  logMessage("One oscillator, " + String(report.num_released) + " of " + String(report.num_outputs) +
+             " module outputs released: " + kilobytes(report.released_bytes) + " released, " +
+             kilobytes(report.active_bytes) + " in use");
+}
+
+void OutputArenaTest::toggledModules() {
+  vital::SoundEngine reference;
+  reference.setOutputArenaEnabled(false);
+  engine_test::setupSawEngine(reference, kArenaWavetables);
+  setModules(reference, false);
+  primeVoices(reference);
+  setModules(reference, true);
+  std::vector<float> expected = renderNote(reference);
+  expect(reference.getOutputMemoryReport().num_outputs == 0);
+
+  vital::SoundEngine toggled;
+  engine_test::setupSawEngine(toggled, kArenaWavetables);
+  setModules(toggled, false);
+  primeVoices(toggled);
+  vital::OutputArena::Report off_report = toggled.getOutputMemoryReport();
+
+  setModules(toggled, true);
+  std::vector<float> audio = renderNote(toggled);
+  vital::OutputArena::Report on_report = toggled.getOutputMemoryReport();
+  expect(on_report.num_released < off_report.num_released);
+  expect(on_report.active_bytes > off_report.active_bytes);
+
+  expect(audio.size() == expected.size());
+  float peak = 0.0f;
+  float max_error = 0.0f;
+  for (size_t i = 0; i < expected.size(); ++i) {
+    peak = std::max(peak, std::abs(expected[i]));
+    max_error = std::max(max_error, std::abs(audio[i] - expected[i]));
+  }
+  expect(peak > 0.0f);
+  expect(max_error <= kMaxArenaError * peak, "Reacquired outputs render differently: " + String(max_error / peak));
+
+  setModules(toggled, false);
+  toggled.process(vital::kMaxBufferSize);
+  vital::OutputArena::Report pooled_report = toggled.getOutputMemoryReport();
+  expect(pooled_report.num_released > on_report.num_released);
+  expect(pooled_report.pooled_bytes > 0);
+
+  toggled.disableUnnecessaryModSources();
+  vital::OutputArena::Report disabled_report = toggled.getOutputMemoryReport();
+  expect(disabled_report.pooled_bytes < pooled_report.pooled_bytes, "Trimming didn't free pooled buffers.");
+  expect(disabled_report.num_released == pooled_report.num_released);
+  expect(disabled_report.peak_pooled_bytes >= pooled_report.pooled_bytes);
+
+  logMessage("Oscillator 2 and filter 2 off: " + kilobytes(off_report.active_bytes) + " in use, on: " +
+             kilobytes(on_report.active_bytes) + ", pooled after switching off: " +
+             kilobytes(pooled_report.pooled_bytes) + ", after trimming: " + kilobytes(disabled_report.pooled_bytes) +
+             ", max relative error: " + String(max_error / peak));
+}
+
+void OutputArenaTest::toggleWithoutAllocating() {
+  vital::SoundEngine engine;
+  engine_test::setupSawEngine(engine, kArenaWavetables);
+  engine.disableUnnecessaryModSources();
+  engine.noteOn(kArenaNote, 1.0f, 0, 0);
+  engine.process(vital::kMaxBufferSize);
+
+  vital::control_map controls = engine.getControls();
+  vital::OutputArena::Report on_report = engine.getOutputMemoryReport();
+  for (int i = 0; i < kToggleBlocks; ++i) {
+    controls["osc_1_on"]->set(i % 2 ? 1.0f : 0.0f);
+    engine.process(vital::kMaxBufferSize);
+  }
+
+  vital::OutputArena::Report toggled_report = engine.getOutputMemoryReport();
+  int num_allocations = toggled_report.num_allocations - on_report.num_allocations;
+  expect(num_allocations == 0, "Toggling oscillator 1 allocated " + String(num_allocations) + " buffers");
+  expect(toggled_report.num_released == on_report.num_released);
+  expect(!engine.needsOutputArenaTrim(), "Oscillator 1 had to wait for buffers.");
+  expect(vital::utils::isFinite(engine.output()->buffer, vital::kMaxBufferSize));
+  engine.noteOff(kArenaNote, 0.5f, 0, 0);
+}
+
+void OutputArenaTest::waitForTrim() {
+  vital::SoundEngine engine;
+  engine_test::setupSawEngine(engine, kArenaWavetables);
+  vital::control_map controls = engine.getControls();
+  for (const char* module_on : kReserveModules)
+    controls[module_on]->set(0.0f);
+  primeVoices(engine);
+  engine.disableUnnecessaryModSources();
+  vital::OutputArena::Report trimmed_report = engine.getOutputMemoryReport();
+
+  // Switching on more modules than the reserve covers leaves some waiting for the message thread.
+  engine.noteOn(kArenaNote, 1.0f, 0, 0);
+  for (const char* module_on : kReserveModules)
+    controls[module_on]->set(1.0f);
+  engine.process(vital::kMaxBufferSize);
+  vital::OutputArena::Report waiting_report = engine.getOutputMemoryReport();
+  expect(waiting_report.num_allocations == trimmed_report.num_allocations, "Switching modules on allocated.");
+  expect(engine.needsOutputArenaTrim(), "Waiting modules didn't ask for a trim.");
+  expect(vital::utils::isFinite(engine.output()->buffer, vital::kMaxBufferSize));
+
+  for (int i = 0; i < kToggleBlocks && engine.needsOutputArenaTrim(); ++i) {
+    engine.trimOutputArena();
+    engine.process(vital::kMaxBufferSize);
+  }
+  vital::OutputArena::Report on_report = engine.getOutputMemoryReport();
+  expect(!engine.needsOutputArenaTrim(), "Modules were still waiting after trimming.");
+  expect(on_report.num_released < waiting_report.num_released);
+  expect(on_report.num_allocations > waiting_report.num_allocations);
+  expect(vital::utils::isFinite(engine.output()->buffer, vital::kMaxBufferSize));
+
+  // Toggles that settle with more pooled than the reserve ask for a trim on the second poll.
+  for (const char* module_on : kReserveModules)
+    controls[module_on]->set(0.0f);
+  engine.process(vital::kMaxBufferSize);
+  expect(!engine.needsOutputArenaTrim());
+  expect(engine.needsOutputArenaTrim(), "Settled toggles didn't ask for a trim.");
+  size_t pooled_bytes = engine.getOutputMemoryReport().pooled_bytes;
+  engine.trimOutputArena();
+  expect(engine.getOutputMemoryReport().pooled_bytes < pooled_bytes);
+  engine.noteOff(kArenaNote, 0.5f, 0, 0);
+
+  logMessage("Pooled after switching " + String(sizeof(kReserveModules) / sizeof(kReserveModules[0])) +
+             " modules off: " + kilobytes(pooled_bytes) + ", after trimming: " +
+             kilobytes(engine.getOutputMemoryReport().pooled_bytes));
+}
+
+void OutputArenaTest::runTest() {
+  beginTest("Unused Modules");
+  unusedModules();
+
+  beginTest("Toggled Modules");
+  toggledModules();
+
+  beginTest("Toggle Without Allocating");
+  toggleWithoutAllocating();
+
+  beginTest("Wait For Trim");
+  waitForTrim();
+}
+
+static OutputArenaTest output_arena_test;
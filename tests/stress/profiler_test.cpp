@@ -0,0 +1,176 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "profiler_test.h"
+#include "modulation_connection_processor.h"
+#include "profile_report.h"
+#include "sound_engine.h"
+#include "synth_constants.h"
+#include "synth_strings.h"
+
+namespace {
+  constexpr int kProfileNotes = 4;
+  constexpr int kProfileLowestNote = 52;
+  constexpr int kProfileBlocks = 64;
+  constexpr int kExtraBlocks = 10;
+  constexpr int kProfileSeed = 0x9f0f;
+
+  void enableProfiledModules(vital::SoundEngine& engine) {
+    vital::control_map controls = engine.getControls();
+    controls["polyphony"]->set(kProfileNotes);
+    controls["filter_1_on"]->set(1.0f);
+    for (int i = 0; i < vital::constants::kNumEffects; ++i)
+      controls[std::string(strings::kEffectOrder[i]) + "_on"]->set(1.0f);
+  }
+
+  void connectProfiledModulation(vital::SoundEngine& engine) {
+    vital::ModulationConnection* connection = engine.getModulationBank().createConnection("lfo_1", "osc_1_level");
+    connection->modulation_processor->setBaseValue(0.5f);
+
+    vital::modulation_change change;
+    change.source = engine.getModulationSource(connection->source_name);
+    change.mono_destination = engine.getMonoModulationDestination(connection->destination_name);
+    change.mono_modulation_switch = engine.getMonoModulationSwitch(connection->destination_name);
+    change.poly_modulation_switch = engine.getPolyModulationSwitch(connection->destination_name);
+    change.poly_destination = engine.getPolyModulationDestination(connection->destination_name);
+    change.modulation_processor = connection->modulation_processor.get();
+    change.destination_scale = 1.0f;
+    engine.prepareModulationChange(change);
+    engine.connectModulation(change);
+  }
+
+  void playProfiledNotes(vital::SoundEngine& engine) {
+    Random random(kProfileSeed);
+    for (int i = 0; i < kProfileNotes; ++i)
+      engine.noteOn(kProfileLowestNote + random.nextInt(24), 0.5f + 0.5f * random.nextFloat(), 0, 0);
+  }
+} // namespace
+
+void ProfilerTest::engineEntries() {
+  beginTest("Engine Entries");
+
+  vital::SoundEngine engine;
+  enableProfiledModules(engine);
+  connectProfiledModulation(engine);
+  playProfiledNotes(engine);
+
+  ProfileReport report;
+  engine.profiler()->setEnabled(true);
+  for (int i = 0; i < kProfileBlocks; ++i) {
+    engine.process(vital::kMaxBufferSize);
+    report.read(engine.profiler());
+  }
+  engine.profiler()->setEnabled(false);
+
+  expectEquals(report.getNumBlocks(), kProfileBlocks);
+  expectEquals(report.getDroppedBlocks(), 0);
+  expect(report.getTotalTime() > 0);
+
+  ProfileReport::EntryStats voice_handler = report.getEntry("voice_handler");
+  expectEquals<int>(voice_handler.calls, kProfileBlocks);
+  expect(voice_handler.total <= report.getTotalTime());
+  expectEquals<int>(report.getEntry("effect_chain").calls, kProfileBlocks);
+  expect(report.getEntry("osc_1").calls >= kProfileBlocks);
+  expect(report.getEntry("modulation_1").calls >= kProfileBlocks);
+
+  int64 filter_calls = 0;
+  int num_entries = static_cast<int>(report.getEntries().size());
+  for (int i = 0; i < num_entries; ++i) {
+    if (String(vital::Profiler::getEntryName(i)).startsWith("filter_1_"))
+      filter_calls += report.getEntries()[i].calls;
+  }
+  expect(filter_calls >= kProfileBlocks);
+
+  for (int i = 0; i < vital::constants::kNumEffects; ++i) {
+    ProfileReport::EntryStats effect = report.getEntry(strings::kEffectOrder[i]);
+    expect(effect.calls > 0, strings::kEffectOrder[i]);
+  }
+
+  engine.process(vital::kMaxBufferSize);
+  expectEquals(report.read(engine.profiler()), 0);
+}
+
+void ProfilerTest::droppedBlocks() {
+  beginTest("Dropped Blocks");
+
+  vital::SoundEngine engine;
+  playProfiledNotes(engine);
+
+  for (int i = 0; i < kExtraBlocks; ++i)
+    engine.process(vital::kMaxBufferSize);
+  std::unique_ptr<vital::Profiler::BlockRecord> record = std::make_unique<vital::Profiler::BlockRecord>();
+  expect(!engine.profiler()->readBlock(*record));
+
+  engine.profiler()->setEnabled(true);
+  for (int i = 0; i < vital::Profiler::kRingSize + kExtraBlocks; ++i)
+    engine.process(vital::kMaxBufferSize);
+
+  ProfileReport report;
+  expectEquals(report.read(engine.profiler()), vital::Profiler::kRingSize);
+  expectEquals(report.getDroppedBlocks(), kExtraBlocks);
+
+  engine.process(vital::kMaxBufferSize);
+  expectEquals(report.read(engine.profiler()), 1);
+  expect(vital::utils::isFinite(engine.output()->buffer, vital::kMaxBufferSize));
+}
+
+void ProfilerTest::reportOutput() {
+  beginTest("Report Output");
+
+  vital::SoundEngine engine;
+  enableProfiledModules(engine);
+  playProfiledNotes(engine);
+
+  ProfileReport report(true);
+  engine.profiler()->setEnabled(true);
+  for (int i = 0; i < kProfileBlocks; ++i) {
+    engine.process(vital::kMaxBufferSize);
+    report.read(engine.profiler());
+  }
+
+  json summary = report.toJson();
+  expectEquals<int>(summary["blocks"], kProfileBlocks);
+  expectEquals<int>(summary["max_voices"], kProfileNotes);
+  expect(summary["entries"].size() > 0);
+
+  double last_total = summary["entries"][0]["total_ms"];
+  for (const json& entry : summary["entries"]) {
+    double total = entry["total_ms"];
+    expect(total <= last_total);
+    last_total = total;
+  }
+
+  int expected_events = kProfileBlocks;
+  for (const ProfileReport::EntryStats& entry : report.getEntries())
+    expected_events += entry.blocks;
+
+  json trace = report.toChromeTrace();
+  expectEquals<int>(trace["traceEvents"].size(), expected_events);
+  expect(trace["traceEvents"][0]["name"] == "block");
+  expect(trace["traceEvents"][0]["ph"] == "X");
+
+  report.clear();
+  expectEquals(report.getNumBlocks(), 0);
+  expectEquals<int>(report.toChromeTrace()["traceEvents"].size(), 0);
+}
+
+void ProfilerTest::runTest() {
+  engineEntries();
+  droppedBlocks();
+  reportOutput();
+}
+
+static ProfilerTest profiler_test;
@@ -0,0 +1,190 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sample_stream_test.h"
+#include "sample_source.h"
+#include "value.h"
+
+namespace {
+  constexpr int kStreamedLength = 1 << 16;
+  constexpr int kStreamedThreshold = 4096;
+  constexpr int kStreamSeed = 0x5a3e;
+  constexpr int kCompareBlocks = 300;
+  constexpr int kPacedBlocks = 400;
+  constexpr int kPacedSampleRate = 44100;
+  constexpr int kMaxRequestWaitMs = 5000;
+  constexpr float kStreamTolerance = 0.00001f;
+  constexpr int kNumStreamTransposes = 5;
+  constexpr float kStreamTransposes[kNumStreamTransposes] = { -24.0f, 0.0f, 7.0f, 19.0f, 31.0f };
+
+  std::vector<float> createStreamAudio(Random& random, int length, float frequency) {
+    std::vector<float> audio(length);
+    for (int i = 0; i < length; ++i)
+      audio[i] = 0.5f * sinf(i * frequency) + 0.2f * (2.0f * random.nextFloat() - 1.0f);
+    return audio;
+  }
+
+  // Gives the stream thread time to load the first block's chunks, as a host would while starting up.
+  bool waitForRequests(vital::SampleStream* stream) {
+    double start = Time::getMillisecondCounterHiRes();
+    while (stream->getPendingRequests()) {
+      if (Time::getMillisecondCounterHiRes() - start > kMaxRequestWaitMs)
+        return false;
+      Thread::sleep(1);
+    }
+    return true;
+  }
+
+  class StreamedVoice {
+    public:
+      StreamedVoice(int streaming_length, bool synchronous, const std::vector<float>& left,
+                    const std::vector<float>& right) : inputs_(vital::SampleSource::kNumInputs) {
+        vital::Sample* sample = source_.getSample();
+        sample->setStreamingLength(streaming_length);
+        sample->setStreamingSynchronous(synchronous);
+        sample->loadSample(left.data(), right.data(), static_cast<int>(left.size()), 44100);
+
+        for (int i = 0; i < vital::SampleSource::kNumInputs; ++i)
+          source_.plug(&inputs_[i], i);
+        inputs_[vital::SampleSource::kLevel].set(1.0f);
+        inputs_[vital::SampleSource::kMidi].set(60.0f);
+      }
+
+      void set(float transpose, bool loop, bool bounce) {
+        inputs_[vital::SampleSource::kTranspose].set(transpose);
+        inputs_[vital::SampleSource::kLoop].set(loop ? 1.0f : 0.0f);
+        inputs_[vital::SampleSource::kBounce].set(bounce ? 1.0f : 0.0f);
+      }
+
+      const vital::poly_float* process() {
+        source_.process(vital::kMaxBufferSize);
+        return source_.output(vital::SampleSource::kRaw)->buffer;
+      }
+
+      vital::Sample* sample() { return source_.getSample(); }
+
+    private:
+      vital::SampleSource source_;
+      std::vector<vital::Value> inputs_;
+  };
+} // namespace
+
+void SampleStreamTest::matchesMemory() {
+  Random random(kStreamSeed);
+  std::vector<float> left = createStreamAudio(random, kStreamedLength, 0.01f);
+  std::vector<float> right = createStreamAudio(random, kStreamedLength, 0.003f);
+
+  for (int mode = 0; mode < 3; ++mode) {
+    bool loop = mode > 0;
+    bool bounce = mode > 1;
+    for (float transpose : kStreamTransposes) {
+      StreamedVoice memory(0, false, left, right);
+      StreamedVoice streamed(kStreamedThreshold, true, left, right);
+      expect(!memory.sample()->isStreaming());
+      expect(streamed.sample()->isStreaming());
+      memory.set(transpose, loop, bounce);
+      streamed.set(transpose, loop, bounce);
+
+      float max_error = 0.0f;
+      for (int b = 0; b < kCompareBlocks; ++b) {
+        const vital::poly_float* expected = memory.process();
+        const vital::poly_float* result = streamed.process();
+        for (int i = 0; i < vital::kMaxBufferSize; ++i)
+          max_error = std::max(max_error, vital::utils::maxFloat(vital::poly_float::abs(expected[i] - result[i])));
+      }
+
+      expect(max_error < kStreamTolerance, "Streamed output differs by " + String(max_error));
+      expect(streamed.sample()->getStream()->getUnderruns() == 0);
+    }
+  }
+}
+
+void SampleStreamTest::backgroundStreaming() {
+  Random random(kStreamSeed + 1);
+  std::vector<float> left = createStreamAudio(random, kStreamedLength, 0.02f);
+  std::vector<float> right = createStreamAudio(random, kStreamedLength, 0.005f);
+
+  StreamedVoice streamed(kStreamedThreshold, false, left, right);
+  streamed.set(12.0f, true, false);
+  vital::SampleStream* stream = streamed.sample()->getStream();
+  expect(stream != nullptr);
+
+  // Nothing is resident before the first block so only it may miss chunks.
+  streamed.process();
+  expect(waitForRequests(stream));
+  int start_underruns = stream->getUnderruns();
+
+  // Blocks are paced to the wall clock like a real time host, so the stream thread gets no extra time.
+  double block_ms = 1000.0 * vital::kMaxBufferSize / kPacedSampleRate;
+  double start = Time::getMillisecondCounterHiRes();
+  for (int b = 0; b < kPacedBlocks; ++b) {
+    const vital::poly_float* output = streamed.process();
+    expect(vital::utils::isFinite(output, vital::kMaxBufferSize));
+
+    double next_block = start + (b + 1) * block_ms;
+    double now = Time::getMillisecondCounterHiRes();
+    if (now < next_block)
+      Thread::sleep(static_cast<int>(next_block - now));
+  }
+  double streamed_time = Time::getMillisecondCounterHiRes() - start;
+
+  int underruns = stream->getUnderruns() - start_underruns;
+  expectEquals(underruns, 0, "Prefetching didn't keep ahead of the reader");
+  expect(stream->getResidentChunks() > 0);
+  logMessage(String(start_underruns) + " underruns on the first block, " + String(underruns) + " over " +
+             String(kPacedBlocks) + " paced blocks taking " + String(streamed_time, 1) + " ms, " +
+             String(stream->getResidentChunks()) + " chunks resident");
+}
+
+void SampleStreamTest::memoryUsage() {
+  Random random(kStreamSeed + 2);
+  std::vector<float> left = createStreamAudio(random, vital::Sample::kDefaultStreamingLength, 0.01f);
+
+  vital::Sample memory;
+  memory.setStreamingLength(0);
+  double start = Time::getMillisecondCounterHiRes();
+  memory.loadSample(left.data(), vital::Sample::kDefaultStreamingLength, 44100);
+  double memory_time = Time::getMillisecondCounterHiRes() - start;
+
+  vital::Sample streamed;
+  start = Time::getMillisecondCounterHiRes();
+  streamed.loadSample(left.data(), vital::Sample::kDefaultStreamingLength, 44100);
+  double streamed_time = Time::getMillisecondCounterHiRes() - start;
+
+  expect(!memory.isStreaming());
+  expect(streamed.isStreaming());
+  expect(streamed.getMemoryUsage() * 4 < memory.getMemoryUsage());
+
+  int length = vital::Sample::kDefaultStreamingLength;
+  expectWithinAbsoluteError(streamed.getPeak(0, length), memory.getPeak(0, length), 0.01f);
+
+  logMessage("in memory: " + String(memory.getMemoryUsage() / 1024) + " KB, " + String(memory_time, 1) +
+             " ms load, streamed: " + String(streamed.getMemoryUsage() / 1024) + " KB, " +
+             String(streamed_time, 1) + " ms load");
+}
+
+void SampleStreamTest::runTest() {
+  beginTest("Matches Memory");
+  matchesMemory();
+
+  beginTest("Background Streaming");
+  backgroundStreaming();
+
+  beginTest("Memory Usage");
+  memoryUsage();
+}
+
+static SampleStreamTest sample_stream_test;
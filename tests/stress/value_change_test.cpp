@@ -0,0 +1,241 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "value_change_test.h"
+#include "synth_base.h"
+#include "synth_parameters.h"
+#include "smooth_value.h"
+#include "value.h"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+  constexpr int kValueChangeBlockSize = 512;
+  constexpr int kValueChangeProducerChanges = 100000;
+  constexpr int kLearnedController = 21;
+  constexpr int kUnlearnedController = 22;
+  constexpr float kRampTarget = 1.0f;
+  constexpr float kRampError = 1e-5f;
+
+  class ValueChangeSynth : public HeadlessSynth {
+    public:
+      using SynthBase::queueValueChange;
+      using SynthBase::getQueuedValue;
+      using SynthBase::collectValueChanges;
+      using SynthBase::applyValueChanges;
+      using SynthBase::getNextMidiLearnSample;
+
+      MidiManager* getMidiManager() { return midi_manager_.get(); }
+  };
+} // namespace
+
+void ValueChangeTest::controlsById() {
+  ValueChangeSynth synth;
+  vital::control_map& controls = synth.getControls();
+
+  int num_parameters = vital::Parameters::getNumParameters();
+  int num_controls = 0;
+  for (int i = 0; i < num_parameters; ++i) {
+    const vital::ValueDetails* details = vital::Parameters::getDetails(i);
+    expect(details->id == i);
+    expect(vital::Parameters::getId(details->name) == i);
+    expect(vital::Parameters::getDetails(details->name).id == i);
+
+    vital::Value* control = synth.getControl(i);
+    auto named_control = controls.find(details->name);
+    if (named_control == controls.end())
+      expect(control == nullptr);
+    else {
+      expect(control == named_control->second, "Control lookups by id and by name should agree.");
+      num_controls++;
+    }
+  }
+  expect(num_controls == static_cast<int>(controls.size()));
+
+  synth.valueChanged(vital::Parameters::getId("volume"), 1234.0f);
+  expect(controls["volume"]->value() == 1234.0f);
+}
+
+void ValueChangeTest::appliedInSampleOrder() {
+  ValueChangeSynth synth;
+  const std::string names[] = { "volume", "osc_1_level", "osc_2_level", "osc_3_level", "sample_level" };
+  int ids[5];
+  vital::Value* controls[5];
+  for (int i = 0; i < 5; ++i) {
+    ids[i] = vital::Parameters::getId(names[i]);
+    controls[i] = synth.getControl(ids[i]);
+    controls[i]->set(0.0f);
+  }
+
+  synth.queueValueChange(ids[0], 9.0f, 20);
+  synth.queueValueChange(ids[0], 4.0f, 300);
+  synth.queueValueChange(ids[1], 2.0f, 10);
+  synth.queueValueChange(ids[2], 3.0f, 10);
+  synth.queueValueChange(ids[3], 1.0f, 0);
+  synth.queueValueChange(ids[4], 5.0f, 2 * kValueChangeBlockSize);
+  expect(synth.collectValueChanges(kValueChangeBlockSize));
+
+  expect(synth.applyValueChanges(0, kValueChangeBlockSize) == 10);
+  expect(controls[3]->value() == 1.0f);
+  expect(synth.applyValueChanges(10, 128) == 128);
+  expect(controls[1]->value() == 2.0f);
+  expect(controls[2]->value() == 3.0f);
+  expect(synth.applyValueChanges(128, kValueChangeBlockSize) == 300);
+  expect(controls[0]->value() == 0.0f, "A parameter's later change should replace its earlier queued one.");
+  expect(synth.applyValueChanges(300, kValueChangeBlockSize) == kValueChangeBlockSize - 1);
+  expect(controls[0]->value() == 4.0f);
+  expect(synth.applyValueChanges(kValueChangeBlockSize - 1, kValueChangeBlockSize) == kValueChangeBlockSize);
+  expect(controls[4]->value() == 5.0f, "Changes past the block should land on its last sample.");
+  expect(!synth.collectValueChanges(kValueChangeBlockSize));
+}
+
+void ValueChangeTest::producerThreadLosesNothing() {
+  ValueChangeSynth synth;
+  int id = vital::Parameters::getId("volume");
+  vital::Value* control = synth.getControl(id);
+  control->set(0.0f);
+
+  std::atomic<bool> done(false);
+  std::thread producer([&synth, id, &done] {
+    for (int i = 1; i <= kValueChangeProducerChanges; ++i)
+      synth.queueValueChange(id, i);
+    done = true;
+  });
+
+  float last_value = 0.0f;
+  int backwards = 0;
+  bool finished = false;
+  bool last_block = false;
+  while (!last_block) {
+    last_block = finished;
+    finished = done;
+
+    synth.collectValueChanges(kValueChangeBlockSize);
+    synth.applyValueChanges(kValueChangeBlockSize, kValueChangeBlockSize);
+    if (control->value() < last_value)
+      backwards++;
+    last_value = control->value();
+  }
+  producer.join();
+
+  expect(backwards == 0, "Changes from one thread should apply in the order they were queued.");
+  expect(!synth.collectValueChanges(kValueChangeBlockSize), "The last change should already be applied.");
+  expect(control->value() == kValueChangeProducerChanges);
+}
+
+void ValueChangeTest::hostChangesRamp() {
+  ValueChangeSynth synth;
+  int audio_rate_id = vital::Parameters::getId("sample_level");
+  vital::SmoothValue* audio_rate_control = dynamic_cast<vital::SmoothValue*>(synth.getControl(audio_rate_id));
+  expect(audio_rate_control != nullptr);
+  if (audio_rate_control == nullptr)
+    return;
+
+  // No parameter uses a control rate smoothed value at the moment, so that one ramps the way applying a change would.
+  vital::cr::SmoothValue local_control_rate_control(0.0f);
+  vital::cr::SmoothValue* control_rate_control = &local_control_rate_control;
+  control_rate_control->setOversampleAmount(audio_rate_control->getOversampleAmount());
+  audio_rate_control->setHard(0.0f);
+  synth.queueValueChange(audio_rate_id, kRampTarget);
+  synth.collectValueChanges(kValueChangeBlockSize);
+  expect(synth.applyValueChanges(0, kValueChangeBlockSize) == kValueChangeBlockSize,
+         "Changes without a sample shouldn't split the block.");
+  control_rate_control->ramp(kRampTarget, kValueChangeBlockSize);
+
+  int ramp_samples = kValueChangeBlockSize * audio_rate_control->getOversampleAmount();
+  float max_error = 0.0f;
+  for (int sample_offset = 0; sample_offset < ramp_samples; sample_offset += vital::kMaxBufferSize) {
+    audio_rate_control->process(vital::kMaxBufferSize);
+    control_rate_control->process(vital::kMaxBufferSize);
+
+    for (int i = 0; i < vital::kMaxBufferSize; ++i) {
+      float expected = kRampTarget * (sample_offset + i + 1) / ramp_samples;
+      max_error = std::max(max_error, std::abs(audio_rate_control->output()->buffer[i][0] - expected));
+    }
+    float expected = kRampTarget * (sample_offset + vital::kMaxBufferSize) / ramp_samples;
+    max_error = std::max(max_error, std::abs(control_rate_control->output()->buffer[0][0] - expected));
+  }
+
+  expect(max_error < kRampError, "Changes without a sample should ramp linearly across the block.");
+  expect(audio_rate_control->output()->buffer[vital::kMaxBufferSize - 1][0] == kRampTarget);
+  expect(control_rate_control->output()->buffer[0][0] == kRampTarget);
+}
+
+void ValueChangeTest::midiLearnSplitsBlocks() {
+  ValueChangeSynth synth;
+  MidiManager::midi_map midi_learn_map;
+  midi_learn_map[kLearnedController]["volume"] = &vital::Parameters::getDetails("volume");
+  synth.getMidiManager()->setMidiLearnMap(midi_learn_map);
+
+  MidiBuffer buffer;
+  buffer.addEvent(MidiMessage::noteOn(1, 60, 1.0f), 5);
+  buffer.addEvent(MidiMessage::controllerEvent(1, kUnlearnedController, 10), 20);
+  buffer.addEvent(MidiMessage::controllerEvent(1, kLearnedController, 10), 50);
+  buffer.addEvent(MidiMessage::controllerEvent(2, kLearnedController, 20), 200);
+  for (int i = 1; i < SynthBase::kMinMidiLearnSamples; ++i)
+    buffer.addEvent(MidiMessage::controllerEvent(1, kLearnedController, i), 300 + i);
+
+  expect(synth.getNextMidiLearnSample(buffer, 0, 128) == 50);
+  expect(synth.getNextMidiLearnSample(buffer, 50, 128) == 128);
+  expect(synth.getNextMidiLearnSample(buffer, 128, 256) == 200);
+  expect(synth.getNextMidiLearnSample(buffer, 200, 256) == 256);
+  expect(synth.getNextMidiLearnSample(buffer, 300, 512) == 512,
+         "Learned controllers closer than kMinMidiLearnSamples shouldn't split the block.");
+}
+
+void ValueChangeTest::queuedValuesReadBack() {
+  ValueChangeSynth synth;
+  int id = vital::Parameters::getId("volume");
+  vital::Value* control = synth.getControl(id);
+  control->set(0.0f);
+
+  vital::mono_float value = 0.0f;
+  expect(!synth.getQueuedValue(id, value));
+
+  synth.queueValueChange(id, 0.25f);
+  synth.queueValueChange(id, 0.75f);
+  expect(synth.getQueuedValue(id, value));
+  expectEquals(value, 0.75f);
+  expectEquals(control->value(), 0.0f);
+
+  synth.collectValueChanges(kValueChangeBlockSize);
+  synth.applyValueChanges(0, kValueChangeBlockSize);
+  expect(!synth.getQueuedValue(id, value));
+  expectEquals(control->value(), 0.75f);
+}
+
+void ValueChangeTest::runTest() {
+  beginTest("Controls By Id");
+  controlsById();
+
+  beginTest("Applied In Sample Order");
+  appliedInSampleOrder();
+
+  beginTest("Producer Thread Loses Nothing");
+  producerThreadLosesNothing();
+
+  beginTest("Host Changes Ramp");
+  hostChangesRamp();
+
+  beginTest("Queued Values Read Back");
+  queuedValuesReadBack();
+
+  beginTest("Midi Learn Splits Blocks");
+  midiLearnSplitsBlocks();
+}
+
+static ValueChangeTest value_change_test;
@@ -0,0 +1,115 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "voice_repack_test.h"
+#include "engine_test_setup.h"
+#include "sound_engine.h"
+#include "synth_constants.h"
+
+namespace {
+  constexpr int kRepackNotes = 8;
+  constexpr int kRepackLowestNote = 48;
+  constexpr int kHeldBlocks = 16;
+  constexpr int kReleaseBlocks = 200;
+  constexpr int kRepackTimedBlocks = 200;
+  constexpr float kMaxRelativeError = 1e-4f;
+
+  struct RepackRender {
+    std::vector<float> audio;
+    int num_active_voices;
+    int num_aggregate_voices;
+    int64_t steady_repack_passes;
+    double block_time;
+  };
+
+  // Plays chords where every other note is released early so each aggregate voice is left with a dead lane.
+  RepackRender renderStaggeredReleases(bool repack_voices) {
+    vital::SoundEngine engine;
+    engine.setVoiceRepacking(repack_voices);
+    engine_test::setupSawEngine(engine);
+
+    vital::control_map controls = engine.getControls();
+    controls["polyphony"]->set(kRepackNotes);
+    controls["osc_1_unison_voices"]->set(4.0f);
+    controls["filter_1_on"]->set(1.0f);
+    controls["filter_1_cutoff"]->set(80.0f);
+    controls["filter_1_resonance"]->set(0.5f);
+    controls["env_1_release"]->set(0.2f);
+
+    RepackRender render;
+    for (int i = 0; i < kRepackNotes; ++i)
+      engine.noteOn(kRepackLowestNote + i, 1.0f, 0, 0);
+
+    for (int i = 0; i < kHeldBlocks + kReleaseBlocks; ++i) {
+      if (i == kHeldBlocks) {
+        for (int n = 1; n < kRepackNotes; n += 2)
+          engine.noteOff(kRepackLowestNote + n, 0.5f, 0, 0);
+      }
+
+      engine.process(vital::kMaxBufferSize);
+      const vital::Output* output = engine.output();
+      for (int s = 0; s < vital::kMaxBufferSize; ++s) {
+        render.audio.push_back(output->buffer[s][0]);
+        render.audio.push_back(output->buffer[s][1]);
+      }
+    }
+
+    render.num_active_voices = engine.getNumActiveVoices();
+    render.num_aggregate_voices = engine.getNumActiveAggregateVoices();
+
+    int64_t repack_passes = engine.getVoiceRepackPasses();
+    double start = Time::getMillisecondCounterHiRes();
+    for (int i = 0; i < kRepackTimedBlocks; ++i)
+      engine.process(vital::kMaxBufferSize);
+    render.block_time = (Time::getMillisecondCounterHiRes() - start) / kRepackTimedBlocks;
+    render.steady_repack_passes = engine.getVoiceRepackPasses() - repack_passes;
+
+    return render;
+  }
+} // namespace
+
+void VoiceRepackTest::staggeredReleases() {
+  RepackRender sparse = renderStaggeredReleases(false);
+  RepackRender packed = renderStaggeredReleases(true);
+
+  expect(sparse.num_active_voices == kRepackNotes / 2);
+  expect(packed.num_active_voices == kRepackNotes / 2);
+  expect(packed.num_aggregate_voices < sparse.num_aggregate_voices);
+  expect(sparse.steady_repack_passes == 0);
+  expect(packed.steady_repack_passes == 0, "Voices shouldn't be checked for repacking while no key state changes.");
+
+  expect(packed.audio.size() == sparse.audio.size());
+  float peak = 0.0f;
+  float max_error = 0.0f;
+  for (size_t i = 0; i < sparse.audio.size(); ++i) {
+    peak = std::max(peak, std::abs(sparse.audio[i]));
+    max_error = std::max(max_error, std::abs(packed.audio[i] - sparse.audio[i]));
+  }
+  expect(peak > 0.0f);
+  expect(max_error <= kMaxRelativeError * peak, "Repacked voices render differently: " + String(max_error / peak));
+
+  logMessage(String(kRepackNotes / 2) + " voices after staggered releases, aggregate voices: " +
+             String(sparse.num_aggregate_voices) + " -> " + String(packed.num_aggregate_voices) +
+             ", block: " + String(sparse.block_time, 3) + " ms -> " + String(packed.block_time, 3) +
+             " ms, max relative error: " + String(max_error / peak));
+}
+
+void VoiceRepackTest::runTest() {
+  beginTest("Staggered Releases");
+  staggeredReleases();
+}
+
+static VoiceRepackTest voice_repack_test;
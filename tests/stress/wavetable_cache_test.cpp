@@ -0,0 +1,198 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "wavetable_cache_test.h"
+#include "binary_preset.h"
+#include "load_save.h"
+#include "synth_constants.h"
+#include "wave_source.h"
+#include "wavetable.h"
+#include "wavetable_cache.h"
+#include "wavetable_creator.h"
+#include "wavetable_group.h"
+
+namespace {
+  constexpr int kCachedKeyframes = 5;
+  constexpr int kCachedKeyframeSpacing = 32;
+  constexpr int kCacheSeed = 0x51c3;
+
+  json createRandomTableJson(Random& random) {
+    vital::Wavetable wavetable(vital::kNumOscillatorWaveFrames);
+    WavetableCreator creator(&wavetable);
+    WavetableGroup* group = new WavetableGroup();
+    WaveSource* source = new WaveSource();
+    for (int k = 0; k < kCachedKeyframes; ++k) {
+      WaveSourceKeyframe* keyframe = static_cast<WaveSourceKeyframe*>(
+          source->insertNewKeyframe(k * kCachedKeyframeSpacing));
+      vital::WaveFrame* frame = keyframe->wave_frame();
+      for (int i = 0; i < vital::WaveFrame::kWaveformSize; ++i)
+        frame->time_domain[i] = 2.0f * random.nextFloat() - 1.0f;
+      frame->toFrequencyDomain();
+    }
+    group->addComponent(source);
+    creator.addGroup(group);
+    return creator.stateToJson();
+  }
+
+  bool cachedTablesMatch(const vital::Wavetable::WavetableData* a, const vital::Wavetable::WavetableData* b) {
+    int num_frames = a->num_frames;
+    int frequency_size = num_frames * vital::Wavetable::kPolyFrequencySize * sizeof(vital::poly_float);
+    return num_frames == b->num_frames && a->frequency_ratio == b->frequency_ratio &&
+           memcmp(a->wave_data.get(), b->wave_data.get(),
+                  num_frames * vital::Wavetable::kWaveformSize * sizeof(vital::mono_float)) == 0 &&
+           memcmp(a->frequency_amplitudes.get(), b->frequency_amplitudes.get(), frequency_size) == 0 &&
+           memcmp(a->normalized_frequencies.get(), b->normalized_frequencies.get(), frequency_size) == 0 &&
+           memcmp(a->phases.get(), b->phases.get(), frequency_size) == 0;
+  }
+} // namespace
+
+void WavetableCacheTest::sharedLoads() {
+  SharedResourcePointer<WavetableCache> cache;
+  cache->clear();
+  Random random(kCacheSeed);
+  json state = createRandomTableJson(random);
+
+  vital::Wavetable first_table(vital::kNumOscillatorWaveFrames);
+  WavetableCreator first_creator(&first_table);
+  first_creator.jsonToState(state);
+  expect(cache->getStats().misses == 1);
+  expect(cache->getStats().num_tables == 1);
+  expect(first_creator.getLastRenderedFrames() > 0);
+
+  vital::Wavetable second_table(vital::kNumOscillatorWaveFrames);
+  WavetableCreator second_creator(&second_table);
+  second_creator.jsonToState(state);
+  expect(cache->getStats().hits == 1);
+  expect(first_table.getAllData() == second_table.getAllData());
+
+  cache->clear();
+  vital::Wavetable fresh_table(vital::kNumOscillatorWaveFrames);
+  WavetableCreator fresh_creator(&fresh_table);
+  fresh_creator.jsonToState(state);
+  expect(first_table.getAllData() != fresh_table.getAllData());
+  expect(cachedTablesMatch(second_table.getAllData(), fresh_table.getAllData()));
+  cache->clear();
+}
+
+void WavetableCacheTest::copyOnEdit() {
+  SharedResourcePointer<WavetableCache> cache;
+  cache->clear();
+  Random random(kCacheSeed + 1);
+  json state = createRandomTableJson(random);
+
+  vital::Wavetable first_table(vital::kNumOscillatorWaveFrames);
+  WavetableCreator first_creator(&first_table);
+  first_creator.jsonToState(state);
+  vital::Wavetable second_table(vital::kNumOscillatorWaveFrames);
+  WavetableCreator second_creator(&second_table);
+  second_creator.jsonToState(state);
+  std::shared_ptr<const vital::Wavetable::WavetableData> shared = first_table.shareData();
+
+  WaveSource* source = static_cast<WaveSource*>(second_creator.getGroup(0)->getComponent(0));
+  vital::WaveFrame* frame = source->getWaveFrame(1);
+  for (int i = 0; i < vital::WaveFrame::kWaveformSize; ++i)
+    frame->time_domain[i] = 0.0f;
+  frame->toFrequencyDomain();
+  second_creator.render(kCachedKeyframeSpacing);
+  expect(second_table.getAllData() != shared.get());
+
+  second_creator.render();
+  expect(second_creator.getLastRenderedFrames() == second_table.getAllData()->num_frames);
+  expect(second_table.getAllData() != shared.get());
+  expect(first_table.getAllData() == shared.get());
+  expect(!cachedTablesMatch(first_table.getAllData(), second_table.getAllData()));
+
+  vital::Wavetable fresh_table(vital::kNumOscillatorWaveFrames);
+  WavetableCreator fresh_creator(&fresh_table);
+  cache->clear();
+  fresh_creator.jsonToState(state);
+  expect(cachedTablesMatch(first_table.getAllData(), fresh_table.getAllData()));
+  cache->clear();
+}
+
+void WavetableCacheTest::leastRecentlyUsed() {
+  SharedResourcePointer<WavetableCache> cache;
+  cache->clear();
+  int64 budget = cache->getMemoryBudget();
+  Random random(kCacheSeed + 2);
+
+  json states[3];
+  for (json& state : states)
+    state = createRandomTableJson(random);
+
+  vital::Wavetable wavetable(vital::kNumOscillatorWaveFrames);
+  WavetableCreator creator(&wavetable);
+  creator.jsonToState(states[0]);
+  cache->setMemoryBudget(2 * WavetableCache::getMemorySize(wavetable.getAllData()));
+  creator.jsonToState(states[1]);
+  creator.jsonToState(states[0]);
+  expect(cache->getStats().hits == 1);
+
+  creator.jsonToState(states[2]);
+  expect(cache->getStats().evictions == 1);
+  expect(cache->getStats().num_tables == 2);
+  expect(cache->getStats().memory <= cache->getMemoryBudget());
+
+  creator.jsonToState(states[0]);
+  expect(cache->getStats().hits == 2);
+  creator.jsonToState(states[1]);
+  expect(cache->getStats().misses == 4);
+
+  cache->setMemoryBudget(budget);
+  cache->clear();
+}
+
+void WavetableCacheTest::binaryLoads() {
+  SharedResourcePointer<WavetableCache> cache;
+  cache->clear();
+  Random random(kCacheSeed + 3);
+  json state = createRandomTableJson(random);
+
+  vital::Wavetable json_table(vital::kNumOscillatorWaveFrames);
+  WavetableCreator json_creator(&json_table);
+  json_creator.jsonToState(state, LoadSave::hashJson(state));
+  expect(cache->getStats().misses == 1);
+
+  MemoryOutputStream stream;
+  json binary_state;
+  expect(BinaryPreset::writeToStream(state, stream));
+  expect(BinaryPreset::readFromMemory(stream.getData(), stream.getDataSize(), binary_state));
+
+  // Binary payloads load as raw bytes but key by the same decoded data as the Base64 json.
+  vital::Wavetable binary_table(vital::kNumOscillatorWaveFrames);
+  WavetableCreator binary_creator(&binary_table);
+  binary_creator.jsonToState(binary_state);
+  expect(cache->getStats().hits == 1, "Loading a binary table didn't hit the json table's entry.");
+  expect(cache->getStats().num_tables == 1);
+  expect(json_table.getAllData() == binary_table.getAllData());
+  cache->clear();
+}
+
+void WavetableCacheTest::runTest() {
+  beginTest("Shared Loads");
+  sharedLoads();
+
+  beginTest("Copy On Edit");
+  copyOnEdit();
+
+  beginTest("Least Recently Used");
+  leastRecentlyUsed();
+
+  beginTest("Binary Loads");
+  binaryLoads();
+}
+
+static WavetableCacheTest wavetable_cache_test;
@@ -0,0 +1,156 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "wavetable_render_test.h"
+#include "synth_constants.h"
+#include "wave_source.h"
+#include "wavetable.h"
+#include "wavetable_creator.h"
+#include "wavetable_group.h"
+
+namespace {
+  constexpr int kRenderKeyframes = 17;
+  constexpr int kRenderKeyframeSpacing = 16;
+  constexpr int kRenderSeed = 0x3a7e;
+
+  void randomizeKeyframe(WaveSourceKeyframe* keyframe, Random& random) {
+    vital::WaveFrame* frame = keyframe->wave_frame();
+    for (int i = 0; i < vital::WaveFrame::kWaveformSize; ++i)
+      frame->time_domain[i] = 2.0f * random.nextFloat() - 1.0f;
+    frame->toFrequencyDomain();
+    keyframe->markEdited();
+  }
+
+  WaveSource* addRandomSource(WavetableCreator& creator, int num_keyframes, int spacing, Random& random) {
+    WavetableGroup* group = new WavetableGroup();
+    WaveSource* source = new WaveSource();
+    source->setInterpolationStyle(WavetableComponent::kCubic);
+    for (int i = 0; i < num_keyframes; ++i)
+      randomizeKeyframe(static_cast<WaveSourceKeyframe*>(source->insertNewKeyframe(i * spacing)), random);
+
+    group->addComponent(source);
+    creator.addGroup(group);
+    return source;
+  }
+
+  template<class T>
+  bool rowsMatch(const std::unique_ptr<T[]>& a, const std::unique_ptr<T[]>& b, int num_frames) {
+    return memcmp(a.get(), b.get(), num_frames * sizeof(T)) == 0;
+  }
+
+  bool tablesMatch(vital::Wavetable& a, vital::Wavetable& b) {
+    const vital::Wavetable::WavetableData* data_a = a.getAllData();
+    const vital::Wavetable::WavetableData* data_b = b.getAllData();
+    int num_frames = data_a->num_frames;
+    return num_frames == data_b->num_frames &&
+           data_a->frequency_ratio == data_b->frequency_ratio &&
+           data_a->sample_rate == data_b->sample_rate &&
+           rowsMatch(data_a->wave_data, data_b->wave_data, num_frames) &&
+           rowsMatch(data_a->frequency_amplitudes, data_b->frequency_amplitudes, num_frames) &&
+           rowsMatch(data_a->normalized_frequencies, data_b->normalized_frequencies, num_frames) &&
+           rowsMatch(data_a->phases, data_b->phases, num_frames);
+  }
+
+  bool matchesFreshRender(WavetableCreator& creator) {
+    vital::Wavetable fresh_table(vital::kNumOscillatorWaveFrames);
+    WavetableCreator fresh_creator(&fresh_table);
+    fresh_creator.jsonToState(creator.stateToJson());
+    return tablesMatch(*creator.getWavetable(), fresh_table);
+  }
+} // namespace
+
+void WavetableRenderTest::incrementalMatchesFull() {
+  Random random(kRenderSeed);
+  vital::Wavetable wavetable(vital::kNumOscillatorWaveFrames);
+  WavetableCreator creator(&wavetable);
+  WaveSource* source = addRandomSource(creator, kRenderKeyframes, kRenderKeyframeSpacing, random);
+  addRandomSource(creator, 3, 40, random);
+
+  creator.render();
+  int num_frames = wavetable.getAllData()->num_frames;
+  expect(creator.getLastRenderedFrames() == num_frames);
+  expect(matchesFreshRender(creator));
+
+  creator.render();
+  expect(creator.getLastRenderedFrames() == 0);
+
+  int edit_count = wavetable.getEditCount();
+  randomizeKeyframe(source->getKeyframe(kRenderKeyframes / 2), random);
+  creator.render();
+  expect(wavetable.getEditCount() != edit_count, "Edit count unchanged after a render");
+  expect(creator.getLastRenderedFrames() > 0);
+  expect(creator.getLastRenderedFrames() < num_frames);
+  expect(matchesFreshRender(creator));
+
+  WavetableKeyframe* moved = source->getKeyframe(3);
+  moved->setPosition(moved->position() + kRenderKeyframeSpacing / 2);
+  source->reposition(moved);
+  creator.render();
+  expect(creator.getLastRenderedFrames() < num_frames);
+  expect(matchesFreshRender(creator));
+
+  WavetableKeyframe* last = source->getKeyframe(kRenderKeyframes - 1);
+  last->setPosition(last->position() - kRenderKeyframeSpacing / 2);
+  creator.render();
+  expect(wavetable.getAllData()->num_frames < num_frames);
+  expect(creator.getLastRenderedFrames() == wavetable.getAllData()->num_frames);
+  expect(matchesFreshRender(creator));
+
+  source->setInterpolationMode(WaveSource::kTime);
+  creator.render();
+  expect(creator.getLastRenderedFrames() == wavetable.getAllData()->num_frames);
+  expect(matchesFreshRender(creator));
+}
+
+void WavetableRenderTest::parallelMatchesSerial() {
+  Random random(kRenderSeed + 1);
+  vital::Wavetable source_table(vital::kNumOscillatorWaveFrames);
+  WavetableCreator source_creator(&source_table);
+  addRandomSource(source_creator, kRenderKeyframes, kRenderKeyframeSpacing, random);
+  json state = source_creator.stateToJson();
+
+  vital::Wavetable serial_table(vital::kNumOscillatorWaveFrames);
+  WavetableCreator serial_creator(&serial_table);
+  serial_creator.setMaxRenderThreads(0);
+  serial_creator.jsonToState(state);
+  // Loading the same json again can come from the wavetable cache, so render each table here.
+  serial_creator.render();
+
+  vital::Wavetable parallel_table(vital::kNumOscillatorWaveFrames);
+  WavetableCreator parallel_creator(&parallel_table);
+  parallel_creator.setMaxRenderThreads(3);
+  parallel_creator.jsonToState(state);
+  parallel_creator.render();
+  expect(parallel_creator.getLastRenderedFrames() == parallel_table.getAllData()->num_frames);
+  expect(tablesMatch(serial_table, parallel_table));
+
+  // The pool and its scratch frames stay around, so a second edit renders on the same helpers.
+  WaveSource* source = dynamic_cast<WaveSource*>(parallel_creator.getGroup(0)->getComponent(0));
+  randomizeKeyframe(source->getKeyframe(0), random);
+  parallel_creator.render();
+  expect(parallel_creator.getLastRenderedFrames() > 0);
+  expect(matchesFreshRender(parallel_creator));
+}
+
+void WavetableRenderTest::runTest() {
+  beginTest("Incremental Matches Full");
+  incrementalMatchesFull();
+
+  beginTest("Parallel Matches Serial");
+  parallelMatchesSerial();
+}
+
+static WavetableRenderTest wavetable_render_test;
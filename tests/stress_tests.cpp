@@ -14,5 +14,18 @@
  * along with vital.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "stress/engine_test_setup.cpp"
 #include "stress/modulation_stress_test.cpp"
 #include "stress/engine_launch_test.cpp"
+#include "stress/profiler_test.cpp"
+#include "stress/wavetable_render_test.cpp"
+#include "stress/wavetable_cache_test.cpp"
+#include "stress/sample_stream_test.cpp"
+#include "stress/effect_sleep_test.cpp"
+#include "stress/engine_dormant_test.cpp"
+#include "stress/engine_telemetry_test.cpp"
+#include "stress/value_change_test.cpp"
+#include "stress/effect_rate_test.cpp"
+#include "stress/voice_repack_test.cpp"
+#include "stress/output_arena_test.cpp"
+#include "stress/fourier_benchmark_test.cpp"
@@ -0,0 +1,211 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "convolution_test.h"
+#include "convolver.h"
+#include "synth_constants.h"
+#include "utils.h"
+
+namespace {
+  constexpr int kConvolutionSeed = 0xc0417;
+  constexpr int kConvolutionRate = 44100;
+  constexpr int kConvolutionInputLength = 6000;
+  constexpr int kNumImpulseLengths = 5;
+  constexpr int kImpulseLengths[kNumImpulseLengths] = { 1, 100, 128, 129, 3001 };
+  constexpr float kConvolutionTolerance = 0.0005f;
+  constexpr int kLongImpulseSeconds = 2;
+  constexpr int kDirectSamples = 256;
+  constexpr int kLongProcessSamples = kConvolutionRate;
+
+  std::vector<float> createConvolutionNoise(Random& random, int length, float decay) {
+    std::vector<float> noise(length);
+    float amplitude = 1.0f;
+    for (int i = 0; i < length; ++i) {
+      noise[i] = amplitude * (2.0f * random.nextFloat() - 1.0f);
+      amplitude *= decay;
+    }
+    return noise;
+  }
+
+  float impulseScale(const std::vector<float>& left, const std::vector<float>& right) {
+    double left_energy = 0.0;
+    double right_energy = 0.0;
+    int length = static_cast<int>(left.size());
+    for (int i = 0; i < length; ++i) {
+      left_energy += left[i] * left[i];
+      right_energy += right[i] * right[i];
+    }
+    return 1.0f / sqrtf(std::max(left_energy, right_energy));
+  }
+
+  float directSample(const std::vector<float>& impulse, const std::vector<float>& input, int index) {
+    double total = 0.0;
+    int taps = std::min(index + 1, static_cast<int>(impulse.size()));
+    for (int t = 0; t < taps; ++t)
+      total += impulse[t] * input[index - t];
+    return total;
+  }
+
+  // Runs the whole input through in random block sizes and returns the first two lanes.
+  void runConvolver(vital::Convolver& convolver, Random& random, const std::vector<float>& left,
+                    const std::vector<float>& right, std::vector<float>& out_left, std::vector<float>& out_right) {
+    vital::poly_float audio_in[vital::kMaxBufferSize];
+    vital::poly_float audio_out[vital::kMaxBufferSize];
+    int length = static_cast<int>(left.size());
+    out_left.resize(length);
+    out_right.resize(length);
+
+    int position = 0;
+    while (position < length) {
+      int num_samples = std::min(length - position, 1 + random.nextInt(vital::kMaxBufferSize));
+      for (int i = 0; i < num_samples; ++i) {
+        audio_in[i] = 0.0f;
+        audio_in[i].set(0, left[position + i]);
+        audio_in[i].set(1, right[position + i]);
+      }
+
+      convolver.process(audio_in, audio_out, num_samples);
+      for (int i = 0; i < num_samples; ++i) {
+        out_left[position + i] = audio_out[i][0];
+        out_right[position + i] = audio_out[i][1];
+      }
+      position += num_samples;
+    }
+  }
+} // namespace
+
+void ConvolutionTest::matchesDirect() {
+  Random random(kConvolutionSeed);
+  std::vector<float> input_left = createConvolutionNoise(random, kConvolutionInputLength, 1.0f);
+  std::vector<float> input_right = createConvolutionNoise(random, kConvolutionInputLength, 1.0f);
+
+  for (int length : kImpulseLengths) {
+    std::vector<float> impulse_left = createConvolutionNoise(random, length, 0.999f);
+    std::vector<float> impulse_right = createConvolutionNoise(random, length, 0.998f);
+    float scale = impulseScale(impulse_left, impulse_right);
+
+    vital::Convolver convolver;
+    convolver.setSampleRate(kConvolutionRate);
+    convolver.loadImpulse(impulse_left.data(), impulse_right.data(), length, kConvolutionRate);
+    expect(convolver.hasImpulse());
+    expectEquals(convolver.getImpulseLength(), length);
+
+    std::vector<float> out_left, out_right;
+    runConvolver(convolver, random, input_left, input_right, out_left, out_right);
+
+    float max_error = 0.0f;
+    for (int i = 0; i < kConvolutionInputLength; ++i) {
+      float expected_left = scale * directSample(impulse_left, input_left, i);
+      float expected_right = scale * directSample(impulse_right, input_right, i);
+      max_error = std::max(max_error, fabsf(expected_left - out_left[i]));
+      max_error = std::max(max_error, fabsf(expected_right - out_right[i]));
+    }
+    expect(max_error < kConvolutionTolerance,
+           "Impulse of " + String(length) + " samples differs by " + String(max_error));
+  }
+}
+
+void ConvolutionTest::zeroLatency() {
+  Random random(kConvolutionSeed + 1);
+  int length = 4 * vital::Convolver::kPartitionSize;
+  std::vector<float> impulse = createConvolutionNoise(random, length, 0.99f);
+  impulse[0] = 1.0f;
+  float scale = impulseScale(impulse, impulse);
+
+  vital::Convolver convolver;
+  convolver.setSampleRate(kConvolutionRate);
+  convolver.loadImpulse(impulse.data(), nullptr, length, kConvolutionRate);
+  expectEquals(convolver.getNumPartitions(), 4);
+
+  vital::poly_float audio_in[vital::kMaxBufferSize];
+  vital::poly_float audio_out[vital::kMaxBufferSize];
+  for (int i = 0; i < vital::kMaxBufferSize; ++i)
+    audio_in[i] = 0.0f;
+  audio_in[0] = 1.0f;
+
+  convolver.process(audio_in, audio_out, 1);
+  for (size_t lane = 0; lane < vital::poly_float::kSize; ++lane)
+    expectWithinAbsoluteError(audio_out[0][lane], scale * impulse[0], 0.00001f);
+
+  audio_in[0] = 0.0f;
+  int position = 1;
+  while (position < length) {
+    int num_samples = std::min(length - position, vital::kMaxBufferSize);
+    convolver.process(audio_in, audio_out, num_samples);
+    for (int i = 0; i < num_samples; ++i)
+      expectWithinAbsoluteError(audio_out[i][0], scale * impulse[position + i], kConvolutionTolerance);
+    position += num_samples;
+  }
+
+  convolver.reset();
+  convolver.process(audio_in, audio_out, vital::kMaxBufferSize);
+  expect(vital::utils::maxFloat(vital::utils::peak(audio_out, vital::kMaxBufferSize)) == 0.0f);
+
+  convolver.clearImpulse();
+  expect(!convolver.hasImpulse());
+}
+
+void ConvolutionTest::longImpulse() {
+  Random random(kConvolutionSeed + 2);
+  int length = kLongImpulseSeconds * kConvolutionRate;
+  std::vector<float> impulse_left = createConvolutionNoise(random, length, 0.9999f);
+  std::vector<float> impulse_right = createConvolutionNoise(random, length, 0.9999f);
+  std::vector<float> input_left = createConvolutionNoise(random, kLongProcessSamples, 1.0f);
+  std::vector<float> input_right = createConvolutionNoise(random, kLongProcessSamples, 1.0f);
+
+  double start = Time::getMillisecondCounterHiRes();
+  vital::Convolver convolver;
+  convolver.setSampleRate(kConvolutionRate);
+  convolver.loadImpulse(impulse_left.data(), impulse_right.data(), length, kConvolutionRate);
+  double load_time = Time::getMillisecondCounterHiRes() - start;
+  int num_partitions = (length + vital::Convolver::kPartitionSize - 1) / vital::Convolver::kPartitionSize;
+  expectEquals(convolver.getNumPartitions(), num_partitions);
+
+  std::vector<float> out_left, out_right;
+  start = Time::getMillisecondCounterHiRes();
+  runConvolver(convolver, random, input_left, input_right, out_left, out_right);
+  double convolver_time = Time::getMillisecondCounterHiRes() - start;
+  bool finite = true;
+  for (int i = 0; i < kLongProcessSamples; ++i)
+    finite = finite && std::isfinite(out_left[i]) && std::isfinite(out_right[i]);
+  expect(finite);
+
+  start = Time::getMillisecondCounterHiRes();
+  float direct_total = 0.0f;
+  for (int i = kLongProcessSamples - kDirectSamples; i < kLongProcessSamples; ++i) {
+    direct_total += directSample(impulse_left, input_left, i);
+    direct_total += directSample(impulse_right, input_right, i);
+  }
+  double direct_time = (Time::getMillisecondCounterHiRes() - start) * kLongProcessSamples / kDirectSamples;
+  expect(std::isfinite(direct_total));
+
+  logMessage(String(kLongImpulseSeconds) + " second impulse, " + String(convolver.getNumPartitions()) +
+             " partitions: load " + String(load_time, 1) + " ms, partitioned " + String(convolver_time, 1) +
+             " ms, direct " + String(direct_time, 1) + " ms per second of audio");
+}
+
+void ConvolutionTest::runTest() {
+  beginTest("Matches Direct");
+  matchesDirect();
+
+  beginTest("Zero Latency");
+  zeroLatency();
+
+  beginTest("Long Impulse");
+  longImpulse();
+}
+
+static ConvolutionTest convolution_test;
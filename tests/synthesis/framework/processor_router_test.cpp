@@ -0,0 +1,292 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "processor_router_test.h"
+#include "feedback.h"
+#include "operators.h"
+#include "processor_router.h"
+#include "value.h"
+
+#include <memory>
+#include <thread>
+
+namespace {
+  constexpr int kNumEdits = 100;
+  constexpr int kReadDelayMs = 20;
+
+  // Exposes what a clone compiled from the shared schedule.
+  class ScheduleRouter : public vital::ProcessorRouter {
+    public:
+      ScheduleRouter() = default;
+      ScheduleRouter(const ScheduleRouter& original) = default;
+
+      virtual Processor* clone() const override { return new ScheduleRouter(*this); }
+
+      void update() {
+        if (shouldUpdate())
+          updateAllProcessors();
+      }
+
+      // Processors without state run their global instance instead of a copy.
+      int localIndex(const vital::Processor* global_processor) {
+        auto found = processors_.find(global_processor);
+        const vital::Processor* copy = found == processors_.end() ? nullptr : found->second.second.get();
+
+        for (int i = 0; i < local_order_.size(); ++i) {
+          if (local_order_[i] == global_processor || local_order_[i] == copy)
+            return i;
+        }
+        return -1;
+      }
+
+      bool hasCopy(const vital::Processor* global_processor) const {
+        return processors_.find(global_processor) != processors_.end();
+      }
+
+      int numLocalProcessors() const { return local_order_.size(); }
+      int numLocalFeedbacks() const { return static_cast<int>(local_feedback_order_.size()); }
+      const vital::Feedback* localFeedback(int index) const { return local_feedback_order_[index]; }
+      int numFeedbackNodes() const { return static_cast<int>(feedback_processors_.size()); }
+      bool upToDate() { return !shouldUpdate(); }
+
+      // Keeps the current schedule from being rewritten, like a clone in the middle of copying it.
+      Schedule* hold() const { return acquireSchedule(); }
+      void letGo(Schedule* schedule) const { releaseSchedule(schedule); }
+      void publish() { publishSchedule(); }
+
+      size_t scheduleCapacity() const {
+        size_t capacity = schedule_->schedules[0].order.capacity();
+        for (const Schedule& schedule : schedule_->schedules) {
+          capacity = std::min(capacity, schedule.order.capacity());
+          capacity = std::min(capacity, schedule.slots.capacity());
+          capacity = std::min(capacity, schedule.feedbacks.capacity());
+          capacity = std::min(capacity, schedule.feedback_slots.capacity());
+        }
+        return capacity;
+      }
+  };
+
+  // Adds the processors so _second_ is scheduled before _first_ until they get connected.
+  struct Chain {
+    Chain(ScheduleRouter& router) : value(new vital::cr::Value(1.0f)),
+                                    first(new vital::cr::Add()), second(new vital::cr::Add()) {
+      router.addProcessor(second);
+      router.addProcessor(first);
+      router.addProcessor(value);
+    }
+
+    void connect() {
+      first->plug(value, 0);
+      first->plug(value, 1);
+      second->plug(first, 0);
+      second->plug(value, 1);
+    }
+
+    vital::cr::Value* value;
+    vital::cr::Add* first;
+    vital::cr::Add* second;
+  };
+} // namespace
+
+void ProcessorRouterTest::runTest() {
+  testReordering();
+  testFeedback();
+  testScheduleCapacity();
+  testPreparedConnections();
+  testPublishWhileReading();
+  testSlotCopies();
+}
+
+void ProcessorRouterTest::testReordering() {
+  beginTest("Reordering");
+
+  ScheduleRouter router;
+  Chain chain(router);
+  std::unique_ptr<ScheduleRouter> clone(static_cast<ScheduleRouter*>(router.clone()));
+  expect(clone->localIndex(chain.second) < clone->localIndex(chain.first));
+
+  chain.connect();
+  expect(router.areOrdered(chain.value, chain.first));
+  expect(router.areOrdered(chain.first, chain.second));
+
+  clone->update();
+  expectEquals(clone->numLocalProcessors(), 3);
+  expect(clone->localIndex(chain.value) < clone->localIndex(chain.first));
+  expect(clone->localIndex(chain.first) < clone->localIndex(chain.second));
+
+  std::unique_ptr<ScheduleRouter> late_clone(static_cast<ScheduleRouter*>(router.clone()));
+  expect(late_clone->localIndex(chain.value) < late_clone->localIndex(chain.first));
+  expect(late_clone->localIndex(chain.first) < late_clone->localIndex(chain.second));
+}
+
+void ProcessorRouterTest::testFeedback() {
+  beginTest("Feedback");
+
+  ScheduleRouter router;
+  Chain chain(router);
+  chain.connect();
+  std::unique_ptr<ScheduleRouter> clone(static_cast<ScheduleRouter*>(router.clone()));
+  expectEquals(clone->numLocalFeedbacks(), 0);
+
+  chain.first->plug(chain.second, 1);
+  clone->update();
+  router.update();
+  expectEquals(clone->numLocalFeedbacks(), 1);
+  expectEquals(router.numLocalFeedbacks(), 1);
+  expectEquals(clone->numLocalProcessors(), 3);
+  expect(clone->localIndex(chain.first) < clone->localIndex(chain.second));
+  expect(clone->localFeedback(0) != router.localFeedback(0), "The clone runs the global Feedback node");
+
+  chain.first->unplug(chain.second);
+  clone->update();
+  router.update();
+  expectEquals(clone->numLocalFeedbacks(), 0);
+  expectEquals(router.numLocalFeedbacks(), 0);
+  expectEquals(clone->numLocalProcessors(), 3);
+}
+
+void ProcessorRouterTest::testScheduleCapacity() {
+  beginTest("Schedule Capacity");
+
+  ScheduleRouter router;
+  Chain chain(router);
+  std::unique_ptr<ScheduleRouter> clone(static_cast<ScheduleRouter*>(router.clone()));
+  size_t capacity = router.scheduleCapacity();
+  expect(capacity >= 3);
+
+  chain.connect();
+  for (int i = 0; i < kNumEdits; ++i) {
+    chain.first->plug(chain.second, 1);
+    clone->update();
+    chain.first->unplug(chain.second);
+    chain.first->plug(chain.value, 1);
+    clone->update();
+  }
+
+  expectEquals(clone->numLocalFeedbacks(), 0);
+  expectEquals(router.numFeedbackNodes(), 1);
+  expect(router.scheduleCapacity() == capacity, "Editing the graph grew the compiled schedules");
+}
+
+void ProcessorRouterTest::testPreparedConnections() {
+  beginTest("Prepared Connections");
+
+  ScheduleRouter router;
+  Chain chain(router);
+  std::unique_ptr<ScheduleRouter> clone(static_cast<ScheduleRouter*>(router.clone()));
+
+  // The schedules are ordered before anything gets plugged in.
+  std::vector<vital::ProcessorRouter::Connection> pending;
+  const vital::Output* value = router.prepareConnection(chain.first, chain.value->output(), pending);
+  const vital::Output* first = router.prepareConnection(chain.second, chain.first->output(), pending);
+  expect(value == chain.value->output());
+  expect(first == chain.first->output());
+  expectEquals(static_cast<int>(pending.size()), 2);
+
+  clone->update();
+  expect(clone->localIndex(chain.value) < clone->localIndex(chain.first));
+  expect(clone->localIndex(chain.first) < clone->localIndex(chain.second));
+
+  chain.first->plugPrepared(value, 0);
+  chain.first->plugPrepared(value, 1);
+  chain.second->plugPrepared(first, 0);
+  chain.second->plugPrepared(value, 1);
+  expect(clone->upToDate(), "Plugging in a prepared connection changed the schedule");
+
+  // Closing a cycle goes through a Feedback node that the clone already has a copy of.
+  const vital::Output* second = router.prepareConnection(chain.first, chain.second->output(), pending);
+  expect(second != chain.second->output());
+  chain.first->plugPrepared(second, 1);
+  clone->update();
+  expectEquals(clone->numLocalFeedbacks(), 1);
+  expect(clone->localIndex(chain.first) < clone->localIndex(chain.second));
+  const vital::Feedback* feedback_copy = clone->localFeedback(0);
+
+  for (int i = 0; i < kNumEdits; ++i) {
+    router.disconnectPrepared(chain.first, chain.second->output());
+    expectEquals(chain.first->connectedInputs(), 1);
+    expect(feedback_copy->input()->source == chain.second->output(), "Disconnecting unplugged the Feedback node");
+
+    pending.clear();
+    second = router.prepareConnection(chain.first, chain.second->output(), pending);
+    chain.first->plugPrepared(second, 1);
+    clone->update();
+  }
+
+  expectEquals(router.numFeedbackNodes(), 1);
+  expectEquals(clone->numLocalFeedbacks(), 1);
+  expect(clone->localFeedback(0) == feedback_copy, "Reconnecting the cycle made a new Feedback copy");
+}
+
+void ProcessorRouterTest::testPublishWhileReading() {
+  beginTest("Publish While Reading");
+
+  ScheduleRouter router;
+  Chain chain(router);
+  std::unique_ptr<ScheduleRouter> clone(static_cast<ScheduleRouter*>(router.clone()));
+
+  // Two readers leave one spare schedule, holding that too makes publishing wait for a reader.
+  auto first_read = clone->hold();
+  router.publish();
+  auto second_read = clone->hold();
+  router.publish();
+  auto third_read = clone->hold();
+
+  std::thread reader([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(kReadDelayMs));
+    clone->letGo(first_read);
+  });
+
+  std::vector<vital::ProcessorRouter::Connection> pending;
+  router.prepareConnection(chain.second, chain.first->output(), pending);
+  reader.join();
+  clone->letGo(second_read);
+  clone->letGo(third_read);
+
+  clone->update();
+  expect(clone->upToDate(), "A schedule published while clones were reading got dropped");
+  expect(clone->localIndex(chain.first) < clone->localIndex(chain.second));
+}
+
+void ProcessorRouterTest::testSlotCopies() {
+  beginTest("Slot Copies");
+
+  // Clones made while the graph is built get their copies once it's initialized.
+  ScheduleRouter router;
+  std::unique_ptr<ScheduleRouter> clone(static_cast<ScheduleRouter*>(router.clone()));
+  Chain chain(router);
+  expect(!clone->hasCopy(chain.value));
+  router.init();
+  expect(clone->hasCopy(chain.value), "The clone's copy wasn't made when the graph was initialized");
+  clone->update();
+  expectEquals(clone->numLocalProcessors(), 3);
+
+  // Later copies are made and dropped with the global processor, picking up the schedule only finds them.
+  std::unique_ptr<vital::cr::Value> value(new vital::cr::Value(0.5f));
+  router.addProcessor(value.get());
+  expect(clone->hasCopy(value.get()), "The clone's copy wasn't made when the processor was added");
+  clone->update();
+  expectEquals(clone->numLocalProcessors(), 4);
+  expect(clone->localIndex(value.get()) >= 0);
+
+  router.removeProcessor(value.get());
+  expect(!clone->hasCopy(value.get()), "The clone's copy wasn't dropped when the processor was removed");
+  clone->update();
+  expectEquals(clone->numLocalProcessors(), 3);
+  expect(clone->localIndex(value.get()) < 0);
+}
+
+static ProcessorRouterTest processor_router_test;
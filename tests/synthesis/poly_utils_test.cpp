@@ -35,15 +35,30 @@ void PolyUtilsTest::runTest() {
 
   beginTest("Swap Voices");
   vital::poly_float swap_voices = vital::utils::swapVoices(test_value);
-  for (int i = 0; i < vital::poly_float::kSize / 2; ++i) {
-    expect(swap_voices[i] == i + vital::poly_float::kSize / 2);
-    expect(swap_voices[i + vital::poly_float::kSize / 2] == i);
+  for (size_t i = 0; i < vital::poly_float::kSize; i += 4) {
+    expect(swap_voices[i] == i + 2);
+    expect(swap_voices[i + 1] == i + 3);
+    expect(swap_voices[i + 2] == i);
+    expect(swap_voices[i + 3] == i + 1);
+  }
+
+  beginTest("Sum Voices");
+  vital::poly_float sum_voices = vital::utils::sumVoices(test_value);
+  for (size_t i = 0; i < vital::poly_float::kSize; i += 2) {
+    vital::mono_float left_total = 0.0f;
+    vital::mono_float right_total = 0.0f;
+    for (size_t v = 0; v < vital::poly_float::kSize; v += 2) {
+      left_total += v;
+      right_total += v + 1;
+    }
+    expect(sum_voices[i] == left_total);
+    expect(sum_voices[i + 1] == right_total);
   }
 
   beginTest("Reverse");
   vital::poly_float reverse = vital::utils::reverse(test_value);
   for (int i = 0; i < vital::poly_float::kSize; ++i)
-    expect(reverse[i] == vital::poly_float::kSize - 1 - i);
+    expect(reverse[i] == (i & ~3) + 3 - (i & 3));
 
   beginTest("Mid Side Encoding");
   vital::poly_float encode_mid_side = vital::utils::encodeMidSide(test_value);
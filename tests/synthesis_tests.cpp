@@ -20,11 +20,13 @@
 #include "synthesis/framework/circular_queue_test.cpp"
 #include "synthesis/framework/matrix_test.cpp"
 #include "synthesis/framework/poly_values_test.cpp"
+#include "synthesis/framework/processor_router_test.cpp"
 #include "synthesis/lookups/wave_frame_test.cpp"
 #include "synthesis/producers/synth_oscillator_test.cpp"
 #include "synthesis/producers/sample_source_test.cpp"
 #include "synthesis/effects/distortion_test.cpp"
 #include "synthesis/effects/compressor_test.cpp"
+#include "synthesis/effects/convolution_test.cpp"
 #include "synthesis/effects/phaser_test.cpp"
 #include "synthesis/effects/delay_test.cpp"
 #include "synthesis/effects/reverb_test.cpp"
@@ -50,3 +52,6 @@
 #include "synthesis/utilities/smooth_value_test.cpp"
 #include "synthesis/utilities/value_switch_test.cpp"
 #include "synthesis/utilities/legato_filter_test.cpp"
+#include "common/binary_preset_test.cpp"
+#include "common/fourier_transform_test.cpp"
+#include "common/preset_index_test.cpp"